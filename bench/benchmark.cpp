@@ -0,0 +1,619 @@
+/*
+ * Image Processing Accelerator - Benchmark Harness
+ * Throughput and latency of the CPU and C-simulation paths
+ *
+ * Runs every filter_mode_t over a matrix of resolutions (QVGA to 4K)
+ * on:
+ *   cpu_scalar  - CPU reference engine, scalar kernels
+ *   cpu_<isa>   - CPU reference engine, best SIMD kernels
+ *   cpu_tiled   - tiled engine on all hardware threads
+ *   csim        - the HLS C model (image_pros profile for the width)
+ * and reports pixels/s (from the median frame time) and per-frame
+ * latency percentiles. Hardware
+ * cycle counts come from csynth.rpt: the synthesized frame latency is
+ * split into per-pixel work and fixed overhead and scaled to each
+ * resolution.
+ *
+ * Results are written as JSON, one result per line. Given a baseline
+ * JSON from an earlier run, any configuration whose throughput drops
+ * (or whose synthesized latency grows) by more than the tolerance is
+ * reported and the exit code is 1.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "image_processing.h"
+#include "cpu_ref.h"
+#include "cpu_tiled.h"
+
+using namespace std;
+
+#define BENCH_OK          0
+#define BENCH_REGRESSION  1
+#define BENCH_ERR_USAGE   2
+
+// ============================================
+// Configuration Matrix
+// ============================================
+struct resolution_t {
+    const char *name;
+    int width;
+    int height;
+};
+
+const resolution_t RESOLUTIONS[] = {
+    {"qvga",  320,  240},
+    {"vga",   640,  480},
+    {"720p",  1280, 720},
+    {"1080p", 1920, 1080},
+    {"4k",    3840, 2160}
+};
+const int NUM_RESOLUTIONS = sizeof(RESOLUTIONS) / sizeof(RESOLUTIONS[0]);
+
+const char *MODE_NAMES[] = {
+    "bypass", "grayscale", "sobel", "threshold", "gaussian", "negative", "sharpen",
+    "blur", "conv", "median", "erode", "dilate", "open", "close", "canny",
+    "adaptive", "otsu", "lut", "equalize", "grad_x", "grad_y"
+};
+const int NUM_MODES = FILTER_GRAD_Y + 1;
+
+// Every path runs the blur the C model was built with (blur_coeffs = 0)
+// and a 5x5 box convolution (all taps 1, shift 5), the widest window;
+// Canny uses the threshold (128) as low and 256 as high; the LUT is
+// a negative
+static cpu_ref_config_t bench_config() {
+    cpu_ref_config_t config;
+    cpu_ref_config_init(&config);
+    config.blur_kernel_size = BLUR_KERNEL_SIZE;
+    for (int i = 0; i < CPU_REF_CONV_WORDS; i++) {
+        config.conv_coeffs[i] = (i == CPU_REF_CONV_WORDS - 1) ? 0x01 : 0x01010101;
+    }
+    config.conv_ctrl = (1 << CONV_CTRL_SIZE5_BIT) | 5;
+    config.threshold_high = 256;
+    for (int i = 0; i < CPU_REF_LUT_ENTRIES; i++) {
+        config.lut[i] = (uint8_t)(255 - i);
+    }
+    return config;
+}
+const cpu_ref_config_t CPU_CONFIG = bench_config();
+
+struct options_t {
+    bool res_enabled[NUM_RESOLUTIONS];
+    bool mode_enabled[NUM_MODES];
+    int cpu_iters;
+    int csim_iters;
+    bool csim;
+    string csynth;
+    string json;
+    string baseline;
+    double tolerance;           // Percent
+    double clock_mhz;           // 0 = clock of the csynth run
+};
+
+struct result_t {
+    string path;
+    const resolution_t *res;
+    int mode;
+    double mpix_s;
+    double p50_ms;
+    double p90_ms;
+    double p99_ms;
+    long hw_cycles;             // -1 without csynth data
+    double hw_fps;
+};
+
+// ============================================
+// csynth.rpt Cycle Counts
+// ============================================
+struct csynth_t {
+    bool valid;
+    string top;
+    long latency_cycles;
+    long interval_cycles;
+    long frame_pixels;          // Trip count of the pixel loop
+    double clock_ns;
+    long bram;                  // Top module resources, -1 when not reported
+    long dsp;
+    long ff;
+    long lut;
+};
+
+static vector<string> split_columns(const string &line) {
+    vector<string> cols;
+    stringstream ss(line);
+    string col;
+    while (getline(ss, col, '|')) {
+        size_t b = col.find_first_not_of(' ');
+        size_t e = col.find_last_not_of(' ');
+        cols.push_back(b == string::npos ? "" : col.substr(b, e - b + 1));
+    }
+    return cols;
+}
+
+// Reads the top module row ("|+ image_pros ...") for latency, interval
+// and BRAM/DSP/FF/LUT, and the largest loop trip count as pixels per frame.
+static csynth_t parse_csynth(const string &path) {
+    csynth_t rpt;
+    rpt.valid = false;
+    rpt.latency_cycles = 0;
+    rpt.interval_cycles = 0;
+    rpt.frame_pixels = 0;
+    rpt.clock_ns = 0;
+    rpt.bram = rpt.dsp = rpt.ff = rpt.lut = -1;
+
+    ifstream in(path.c_str());
+    string line;
+    while (getline(in, line)) {
+        vector<string> cols = split_columns(line);
+        // | name | issue | slack | cycles | ns | iter | II | trip | pipelined
+        // | BRAM | DSP | FF | LUT | URAM |
+        if (cols.size() < 9) {
+            continue;
+        }
+        const string &name = cols[1];
+        if (!rpt.valid && name.compare(0, 2, "+ ") == 0) {
+            rpt.top = name.substr(2);
+            rpt.latency_cycles = atol(cols[4].c_str());
+            rpt.interval_cycles = atol(cols[7].c_str());
+            double ns = atof(cols[5].c_str());
+            if (rpt.latency_cycles > 0) {
+                rpt.clock_ns = ns / rpt.latency_cycles;
+                rpt.valid = true;
+            }
+            if (cols.size() >= 14) {
+                rpt.bram = atol(cols[10].c_str());
+                rpt.dsp = atol(cols[11].c_str());
+                rpt.ff = atol(cols[12].c_str());
+                rpt.lut = atol(cols[13].c_str());
+            }
+        } else if (rpt.valid && name.compare(0, 2, "o ") == 0) {
+            rpt.frame_pixels = max(rpt.frame_pixels, atol(cols[8].c_str()));
+        }
+    }
+    if (rpt.frame_pixels == 0 || rpt.frame_pixels > rpt.latency_cycles) {
+        rpt.valid = false;
+    }
+    return rpt;
+}
+
+// 1 pixel/clock plus the report's fixed pipeline overhead
+static long hw_frame_cycles(const csynth_t &rpt, const resolution_t &res) {
+    return (long)res.width * res.height + (rpt.latency_cycles - rpt.frame_pixels);
+}
+
+// ============================================
+// Timing
+// ============================================
+static double now_ms() {
+    return chrono::duration<double, milli>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const vector<double> &sorted, double p) {
+    size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > sorted.size()) rank = sorted.size();
+    return sorted[rank - 1];
+}
+
+static void summarize(result_t &r, vector<double> &samples) {
+    sort(samples.begin(), samples.end());
+    r.p50_ms = percentile(samples, 50);
+    // Median frame time: robust against scheduler noise in the gate
+    r.mpix_s = (r.p50_ms > 0)
+        ? (double)r.res->width * r.res->height / (r.p50_ms * 1000.0) : 0;
+    r.p90_ms = percentile(samples, 90);
+    r.p99_ms = percentile(samples, 99);
+}
+
+// ============================================
+// Benchmark Paths
+// ============================================
+enum path_kind_t { PATH_CPU, PATH_TILED, PATH_CSIM };
+
+typedef void (*kernel_t)(stream_t &, stream_rgb_t &, stream_t &, stream_grad_t &,
+                         ap_uint<8>, ap_uint<16>, ap_uint<16>, ap_uint<16>, ap_uint<8> &,
+                         ap_uint<2>, ap_uint<32>, ap_uint<32>, conv_coeffs_t,
+                         ap_uint<32>, ap_uint<32>, hist_bin_t *, pixel_t &,
+                         pixel_t &, stats_sum_t &, stats_sum_t &, pixel_t *,
+                         ap_uint<1>, ap_uint<1>, frame_count_t &, ap_uint<8>,
+                         ap_uint<16>, ap_uint<16>, ap_uint<4>, roi_rects_t,
+                         ap_uint<16>, ap_uint<1>);
+
+// Narrowest line-buffer profile that holds the width
+static kernel_t csim_kernel(int width) {
+    if (width <= MAX_WIDTH) return image_pros;
+    if (width <= MAX_WIDTH_1080P) return image_pros_1080p;
+    return image_pros_4k;
+}
+
+// One frame through the C model; stream setup is outside the timing
+static double run_csim(const uint8_t *frame, const resolution_t &res, int mode) {
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    stream_grad_t grad_stream;
+
+    for (int y = 0; y < res.height; y++) {
+        for (int x = 0; x < res.width; x++) {
+            axis_pixel_t pixel;
+            pixel.data = frame[y * res.width + x];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;
+            pixel.last = (x == res.width - 1) ? 1 : 0;
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+    }
+
+    conv_coeffs_t conv_coeffs = 0;
+    for (int i = 0; i < CPU_REF_CONV_WORDS; i++) {
+        int hi = (i == CPU_REF_CONV_WORDS - 1) ? 8 * CONV_TAPS - 1 : 32 * i + 31;
+        conv_coeffs.range(hi, 32 * i) = CPU_CONFIG.conv_coeffs[i];
+    }
+
+    ap_uint<8> status;
+    static hist_bin_t histogram[HIST_BINS];
+    pixel_t stats_min, stats_max;
+    stats_sum_t stats_sum, stats_sum_sq;
+    static pixel_t lut[LUT_BANKS * LUT_ENTRIES];
+    frame_count_t frame_errors;
+    for (int i = 0; i < LUT_ENTRIES; i++) {
+        lut[i] = CPU_CONFIG.lut[i];
+    }
+    double t0 = now_ms();
+    csim_kernel(res.width)(src_stream, src_rgb_stream, dst_stream, grad_stream,
+                           mode, 128, res.width, res.height, status, INPUT_GRAY, 0,
+                           CPU_CONFIG.blur_coeffs, conv_coeffs, CPU_CONFIG.conv_ctrl,
+                           CPU_CONFIG.threshold_high, histogram, stats_min, stats_max,
+                           stats_sum, stats_sum_sq, lut, 0, 0, frame_errors, 0, 0, 0,
+                           0, 0, 0, 0);
+    double elapsed = now_ms() - t0;
+
+    while (!dst_stream.empty()) {
+        dst_stream.read();
+    }
+    return (status == STATUS_OK) ? elapsed : -1;
+}
+
+static bool run_path(
+    result_t &r, path_kind_t kind, cpu_isa_t isa, cpu_pool_t *pool,
+    const uint8_t *frame, uint8_t *out, int iters
+) {
+    vector<double> samples;
+
+    for (int i = 0; i < iters; i++) {
+        double elapsed;
+        if (kind == PATH_CSIM) {
+            elapsed = run_csim(frame, *r.res, r.mode);
+            if (elapsed < 0) {
+                cerr << "csim rejected " << r.res->name << endl;
+                return false;
+            }
+        } else {
+            double t0 = now_ms();
+            if (kind == PATH_TILED) {
+                cpu_tiled_filter(pool, frame, out, r.res->width, r.res->height,
+                                 r.mode, 128, 0, isa, &CPU_CONFIG);
+            } else {
+                cpu_ref_filter(frame, out, r.res->width, r.res->height,
+                               r.mode, 128, isa, &CPU_CONFIG);
+            }
+            elapsed = now_ms() - t0;
+        }
+        samples.push_back(elapsed);
+    }
+
+    summarize(r, samples);
+    return true;
+}
+
+// ============================================
+// JSON Output and Baseline Comparison
+// ============================================
+static void write_json(ostream &out, const csynth_t &rpt, cpu_pool_t *pool,
+                       const vector<result_t> &results) {
+    char buf[512];
+
+    out << "{\n";
+    out << "  \"isa\": \"" << cpu_ref_isa_name(cpu_ref_best_isa()) << "\",\n";
+    out << "  \"threads\": " << cpu_pool_threads(pool) << ",\n";
+    if (rpt.valid) {
+        snprintf(buf, sizeof(buf),
+                 "  \"csynth\": {\"top\": \"%s\", \"clock_ns\": %.3f, "
+                 "\"latency_cycles\": %ld, \"interval_cycles\": %ld, "
+                 "\"frame_pixels\": %ld, \"fps\": %.1f, \"bram\": %ld, "
+                 "\"dsp\": %ld, \"ff\": %ld, \"lut\": %ld},\n",
+                 rpt.top.c_str(), rpt.clock_ns, rpt.latency_cycles,
+                 rpt.interval_cycles, rpt.frame_pixels,
+                 1e9 / (rpt.clock_ns * rpt.latency_cycles),
+                 rpt.bram, rpt.dsp, rpt.ff, rpt.lut);
+        out << buf;
+    } else {
+        out << "  \"csynth\": null,\n";
+    }
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const result_t &r = results[i];
+        snprintf(buf, sizeof(buf),
+                 "    {\"path\": \"%s\", \"resolution\": \"%s\", \"width\": %d, "
+                 "\"height\": %d, \"mode\": %d, \"filter\": \"%s\", "
+                 "\"mpix_s\": %.2f, \"p50_ms\": %.3f, \"p90_ms\": %.3f, "
+                 "\"p99_ms\": %.3f, \"hw_cycles\": %ld, \"hw_fps\": %.1f}%s\n",
+                 r.path.c_str(), r.res->name, r.res->width, r.res->height,
+                 r.mode, MODE_NAMES[r.mode], r.mpix_s, r.p50_ms, r.p90_ms,
+                 r.p99_ms, r.hw_cycles, r.hw_fps,
+                 (i + 1 < results.size()) ? "," : "");
+        out << buf;
+    }
+    out << "  ]\n}\n";
+}
+
+// Value of "key" in one line of our own JSON output
+static bool json_field(const string &line, const char *key, string &value) {
+    string tag = string("\"") + key + "\": ";
+    size_t pos = line.find(tag);
+    if (pos == string::npos) {
+        return false;
+    }
+    pos += tag.size();
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        value = line.substr(pos + 1, end - pos - 1);
+    } else {
+        size_t end = line.find_first_of(",}", pos);
+        value = line.substr(pos, end - pos);
+    }
+    return true;
+}
+
+static int compare_baseline(const string &path, double tolerance,
+                            const csynth_t &rpt,
+                            const vector<result_t> &results) {
+    ifstream in(path.c_str());
+    if (!in) {
+        cerr << "Cannot read baseline " << path << endl;
+        return -1;
+    }
+
+    int regressions = 0;
+    int matched = 0;
+    double keep = 1.0 - tolerance / 100.0;
+    string line, value;
+
+    while (getline(in, line)) {
+        if (json_field(line, "latency_cycles", value) && rpt.valid) {
+            long base = atol(value.c_str());
+            if (rpt.latency_cycles > base * (1.0 + tolerance / 100.0)) {
+                cout << "REGRESSION: csynth latency " << rpt.latency_cycles
+                     << " cycles, baseline " << base << endl;
+                regressions++;
+            }
+            continue;
+        }
+
+        string bpath, bres, bmode, bmpix;
+        if (!json_field(line, "path", bpath) ||
+            !json_field(line, "resolution", bres) ||
+            !json_field(line, "mode", bmode) ||
+            !json_field(line, "mpix_s", bmpix)) {
+            continue;
+        }
+        for (size_t i = 0; i < results.size(); i++) {
+            const result_t &r = results[i];
+            if (r.path != bpath || bres != r.res->name ||
+                r.mode != atoi(bmode.c_str())) {
+                continue;
+            }
+            matched++;
+            double base = atof(bmpix.c_str());
+            if (r.mpix_s < base * keep) {
+                cout << "REGRESSION: " << r.path << " " << r.res->name << " "
+                     << MODE_NAMES[r.mode] << ": " << r.mpix_s
+                     << " Mpix/s, baseline " << base << endl;
+                regressions++;
+            }
+        }
+    }
+
+    cout << "Baseline: " << matched << " configurations compared, "
+         << regressions << " regressions (tolerance " << tolerance << "%)" << endl;
+    return regressions;
+}
+
+// ============================================
+// Command Line
+// ============================================
+static void usage() {
+    cerr << "usage: benchmark [options]\n"
+            "  --res LIST         qvga,vga,720p,1080p,4k (default all)\n"
+            "  --modes LIST       bypass,grayscale,...,conv,...,grad_y (default all)\n"
+            "  --iters N          frames per CPU configuration (default 20)\n"
+            "  --csim-iters N     frames per csim configuration (default 2)\n"
+            "  --no-csim          skip the HLS C model\n"
+            "  --csynth PATH      report (default solution1/syn/report/csynth.rpt)\n"
+            "  --clock-mhz F      project hw fps to this clock (default: report's)\n"
+            "  --json PATH        write results (default stdout)\n"
+            "  --baseline PATH    fail on regressions against an earlier JSON\n"
+            "  --tolerance PCT    allowed slowdown (default 10)\n";
+}
+
+static bool parse_list(const char *arg, bool *enabled, int count, bool by_name) {
+    for (int i = 0; i < count; i++) {
+        enabled[i] = false;
+    }
+    stringstream ss(arg);
+    string item;
+    while (getline(ss, item, ',')) {
+        int index = -1;
+        for (int i = 0; i < count; i++) {
+            if (by_name ? item == RESOLUTIONS[i].name : item == MODE_NAMES[i]) {
+                index = i;
+            }
+        }
+        if (!by_name && index < 0 && !item.empty() &&
+            item.find_first_not_of("0123456789") == string::npos) {
+            index = atoi(item.c_str());
+        }
+        if (index < 0 || index >= count) {
+            cerr << "Unknown entry '" << item << "'" << endl;
+            return false;
+        }
+        enabled[index] = true;
+    }
+    return true;
+}
+
+static bool parse_args(int argc, char **argv, options_t &opt) {
+    for (int i = 0; i < NUM_RESOLUTIONS; i++) opt.res_enabled[i] = true;
+    for (int i = 0; i < NUM_MODES; i++) opt.mode_enabled[i] = true;
+    opt.cpu_iters = 20;
+    opt.csim_iters = 2;
+    opt.csim = true;
+    opt.csynth = "solution1/syn/report/csynth.rpt";
+    opt.tolerance = 10.0;
+    opt.clock_mhz = 0;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (arg == "--no-csim") {
+            opt.csim = false;
+        } else if (arg == "--res" && has_value) {
+            if (!parse_list(argv[++i], opt.res_enabled, NUM_RESOLUTIONS, true)) return false;
+        } else if (arg == "--modes" && has_value) {
+            if (!parse_list(argv[++i], opt.mode_enabled, NUM_MODES, false)) return false;
+        } else if (arg == "--iters" && has_value) {
+            opt.cpu_iters = atoi(argv[++i]);
+        } else if (arg == "--csim-iters" && has_value) {
+            opt.csim_iters = atoi(argv[++i]);
+        } else if (arg == "--csynth" && has_value) {
+            opt.csynth = argv[++i];
+        } else if (arg == "--clock-mhz" && has_value) {
+            opt.clock_mhz = atof(argv[++i]);
+        } else if (arg == "--json" && has_value) {
+            opt.json = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            opt.baseline = argv[++i];
+        } else if (arg == "--tolerance" && has_value) {
+            opt.tolerance = atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return opt.cpu_iters > 0 && opt.csim_iters > 0 && opt.tolerance >= 0 &&
+           opt.clock_mhz >= 0;
+}
+
+// ============================================
+// Main
+// ============================================
+int main(int argc, char **argv) {
+    options_t opt;
+    if (!parse_args(argc, argv, opt)) {
+        usage();
+        return BENCH_ERR_USAGE;
+    }
+
+    csynth_t rpt = parse_csynth(opt.csynth);
+    if (!rpt.valid) {
+        cerr << "No usable csynth report at " << opt.csynth
+             << "; hw_cycles will be -1" << endl;
+    } else if (opt.clock_mhz > 0) {
+        rpt.clock_ns = 1000.0 / opt.clock_mhz;
+    }
+
+    cpu_isa_t best = cpu_ref_best_isa();
+    cpu_pool_t *pool = cpu_pool_create(0);
+
+    struct path_t {
+        string name;
+        path_kind_t kind;
+        cpu_isa_t isa;
+    };
+    vector<path_t> paths;
+    paths.push_back({"cpu_scalar", PATH_CPU, CPU_ISA_SCALAR});
+    if (best != CPU_ISA_SCALAR) {
+        paths.push_back({string("cpu_") + cpu_ref_isa_name(best), PATH_CPU, best});
+    }
+    paths.push_back({"cpu_tiled", PATH_TILED, best});
+    if (opt.csim) {
+        paths.push_back({"csim", PATH_CSIM, CPU_ISA_SCALAR});
+    }
+
+    vector<result_t> results;
+    printf("%-12s %-6s %-10s %10s %9s %9s %9s %10s\n", "path", "res", "filter",
+           "Mpix/s", "p50 ms", "p90 ms", "p99 ms", "hw fps");
+
+    for (int ri = 0; ri < NUM_RESOLUTIONS; ri++) {
+        if (!opt.res_enabled[ri]) {
+            continue;
+        }
+        const resolution_t &res = RESOLUTIONS[ri];
+        size_t size = (size_t)res.width * res.height;
+        vector<uint8_t> frame(size), out(size);
+        unsigned int seed = 2024;
+        for (size_t i = 0; i < size; i++) {
+            seed = seed * 1103515245 + 12345;
+            frame[i] = (seed >> 16) & 0xFF;
+        }
+
+        for (int mode = 0; mode < NUM_MODES; mode++) {
+            if (!opt.mode_enabled[mode]) {
+                continue;
+            }
+            for (size_t p = 0; p < paths.size(); p++) {
+                result_t r;
+                r.path = paths[p].name;
+                r.res = &res;
+                r.mode = mode;
+                r.hw_cycles = rpt.valid ? hw_frame_cycles(rpt, res) : -1;
+                r.hw_fps = rpt.valid ? 1e9 / (rpt.clock_ns * r.hw_cycles) : 0;
+
+                int iters = (paths[p].kind == PATH_CSIM) ? opt.csim_iters : opt.cpu_iters;
+                if (!run_path(r, paths[p].kind, paths[p].isa, pool,
+                              frame.data(), out.data(), iters)) {
+                    continue;
+                }
+                results.push_back(r);
+                printf("%-12s %-6s %-10s %10.2f %9.3f %9.3f %9.3f %10.1f\n",
+                       r.path.c_str(), res.name, MODE_NAMES[mode], r.mpix_s,
+                       r.p50_ms, r.p90_ms, r.p99_ms, r.hw_fps);
+                fflush(stdout);
+            }
+        }
+    }
+
+    if (opt.json.empty()) {
+        write_json(cout, rpt, pool, results);
+    } else {
+        ofstream json(opt.json.c_str());
+        write_json(json, rpt, pool, results);
+        cout << "Results written to " << opt.json << endl;
+    }
+
+    int status = BENCH_OK;
+    if (!opt.baseline.empty()) {
+        int regressions = compare_baseline(opt.baseline, opt.tolerance, rpt, results);
+        if (regressions < 0) {
+            status = BENCH_ERR_USAGE;
+        } else if (regressions > 0) {
+            status = BENCH_REGRESSION;
+        }
+    }
+
+    cpu_pool_destroy(pool);
+    return status;
+}
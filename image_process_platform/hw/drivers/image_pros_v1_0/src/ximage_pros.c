@@ -142,6 +142,570 @@ u32 XImage_pros_Get_height(XImage_pros *InstancePtr) {
     return Data;
 }
 
+u32 XImage_pros_Get_status(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATUS_DATA);
+    return Data;
+}
+
+u32 XImage_pros_Get_status_vld(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATUS_CTRL);
+    return Data & 0x1;
+}
+
+void XImage_pros_Set_input_format(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_INPUT_FORMAT_DATA, Data);
+}
+
+u32 XImage_pros_Get_input_format(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_INPUT_FORMAT_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_filter_chain(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_FILTER_CHAIN_DATA, Data);
+}
+
+u32 XImage_pros_Get_filter_chain(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_FILTER_CHAIN_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_blur_coeffs(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_BLUR_COEFFS_DATA, Data);
+}
+
+u32 XImage_pros_Get_blur_coeffs(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_BLUR_COEFFS_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_conv_coeffs(XImage_pros *InstancePtr, XImage_pros_Conv_coeffs Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 0, Data.word_0);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 4, Data.word_1);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 8, Data.word_2);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 12, Data.word_3);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 16, Data.word_4);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 20, Data.word_5);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 24, Data.word_6);
+}
+
+XImage_pros_Conv_coeffs XImage_pros_Get_conv_coeffs(XImage_pros *InstancePtr) {
+    XImage_pros_Conv_coeffs Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data.word_0 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 0);
+    Data.word_1 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 4);
+    Data.word_2 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 8);
+    Data.word_3 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 12);
+    Data.word_4 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 16);
+    Data.word_5 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 20);
+    Data.word_6 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA + 24);
+    return Data;
+}
+
+void XImage_pros_Set_conv_ctrl(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_CTRL_DATA, Data);
+}
+
+u32 XImage_pros_Get_conv_ctrl(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_CONV_CTRL_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_threshold_high(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_THRESHOLD_HIGH_DATA, Data);
+}
+
+u32 XImage_pros_Get_threshold_high(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_THRESHOLD_HIGH_DATA);
+    return Data;
+}
+
+u32 XImage_pros_Get_stats_min(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_MIN_DATA);
+    return Data;
+}
+
+u32 XImage_pros_Get_stats_min_vld(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_MIN_CTRL);
+    return Data & 0x1;
+}
+
+u32 XImage_pros_Get_stats_max(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_MAX_DATA);
+    return Data;
+}
+
+u32 XImage_pros_Get_stats_max_vld(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_MAX_CTRL);
+    return Data & 0x1;
+}
+
+u64 XImage_pros_Get_stats_sum(XImage_pros *InstancePtr) {
+    u64 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_DATA);
+    Data += (u64)XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_DATA + 4) << 32;
+    return Data;
+}
+
+u32 XImage_pros_Get_stats_sum_vld(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_CTRL);
+    return Data & 0x1;
+}
+
+u64 XImage_pros_Get_stats_sum_sq(XImage_pros *InstancePtr) {
+    u64 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_SQ_DATA);
+    Data += (u64)XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_SQ_DATA + 4) << 32;
+    return Data;
+}
+
+u32 XImage_pros_Get_stats_sum_sq_vld(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_SQ_CTRL);
+    return Data & 0x1;
+}
+
+u64 XImage_pros_Get_histogram_BaseAddress(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return (InstancePtr->Control_BaseAddress + XIMAGE_PROS_CONTROL_BASE_HISTOGRAM);
+}
+
+u64 XImage_pros_Get_histogram_HighAddress(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return (InstancePtr->Control_BaseAddress + XIMAGE_PROS_CONTROL_HIGH_HISTOGRAM);
+}
+
+u32 XImage_pros_Get_histogram_TotalBytes(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return (XIMAGE_PROS_CONTROL_HIGH_HISTOGRAM - XIMAGE_PROS_CONTROL_BASE_HISTOGRAM + 1);
+}
+
+u32 XImage_pros_Get_histogram_BitWidth(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return XIMAGE_PROS_CONTROL_WIDTH_HISTOGRAM;
+}
+
+u32 XImage_pros_Get_histogram_Depth(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return XIMAGE_PROS_CONTROL_DEPTH_HISTOGRAM;
+}
+
+u32 XImage_pros_Read_histogram_Words(XImage_pros *InstancePtr, int offset, word_type *data, int length) {
+    int i;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    if ((offset + length) * 4 > (XIMAGE_PROS_CONTROL_HIGH_HISTOGRAM - XIMAGE_PROS_CONTROL_BASE_HISTOGRAM + 1))
+        return 0;
+
+    for (i = 0; i < length; i++) {
+        data[i] = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_BASE_HISTOGRAM + (offset + i) * 4);
+    }
+    return length;
+}
+
+void XImage_pros_Set_lut_bank(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_LUT_BANK_DATA, Data);
+}
+
+u32 XImage_pros_Get_lut_bank(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_LUT_BANK_DATA);
+    return Data;
+}
+
+u64 XImage_pros_Get_lut_BaseAddress(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return (InstancePtr->Control_BaseAddress + XIMAGE_PROS_CONTROL_BASE_LUT);
+}
+
+u64 XImage_pros_Get_lut_HighAddress(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return (InstancePtr->Control_BaseAddress + XIMAGE_PROS_CONTROL_HIGH_LUT);
+}
+
+u32 XImage_pros_Get_lut_TotalBytes(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return (XIMAGE_PROS_CONTROL_HIGH_LUT - XIMAGE_PROS_CONTROL_BASE_LUT + 1);
+}
+
+u32 XImage_pros_Get_lut_BitWidth(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return XIMAGE_PROS_CONTROL_WIDTH_LUT;
+}
+
+u32 XImage_pros_Get_lut_Depth(XImage_pros *InstancePtr) {
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    return XIMAGE_PROS_CONTROL_DEPTH_LUT;
+}
+
+u32 XImage_pros_Write_lut_Words(XImage_pros *InstancePtr, int offset, word_type *data, int length) {
+    int i;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    if ((offset + length) * 4 > (XIMAGE_PROS_CONTROL_HIGH_LUT - XIMAGE_PROS_CONTROL_BASE_LUT + 1))
+        return 0;
+
+    for (i = 0; i < length; i++) {
+        XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_BASE_LUT + (offset + i) * 4, data[i]);
+    }
+    return length;
+}
+
+u32 XImage_pros_Read_lut_Words(XImage_pros *InstancePtr, int offset, word_type *data, int length) {
+    int i;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    if ((offset + length) * 4 > (XIMAGE_PROS_CONTROL_HIGH_LUT - XIMAGE_PROS_CONTROL_BASE_LUT + 1))
+        return 0;
+
+    for (i = 0; i < length; i++) {
+        data[i] = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_BASE_LUT + (offset + i) * 4);
+    }
+    return length;
+}
+
+u32 XImage_pros_Write_lut_Bytes(XImage_pros *InstancePtr, int offset, char *data, int length) {
+    int i;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    if ((offset + length) > (XIMAGE_PROS_CONTROL_HIGH_LUT - XIMAGE_PROS_CONTROL_BASE_LUT + 1))
+        return 0;
+
+    for (i = 0; i < length; i++) {
+        *(char *)(InstancePtr->Control_BaseAddress + XIMAGE_PROS_CONTROL_BASE_LUT + offset + i) = data[i];
+    }
+    return length;
+}
+
+u32 XImage_pros_Read_lut_Bytes(XImage_pros *InstancePtr, int offset, char *data, int length) {
+    int i;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    if ((offset + length) > (XIMAGE_PROS_CONTROL_HIGH_LUT - XIMAGE_PROS_CONTROL_BASE_LUT + 1))
+        return 0;
+
+    for (i = 0; i < length; i++) {
+        data[i] = *(char *)(InstancePtr->Control_BaseAddress + XIMAGE_PROS_CONTROL_BASE_LUT + offset + i);
+    }
+    return length;
+}
+
+void XImage_pros_Set_frame_sync(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_FRAME_SYNC_DATA, Data);
+}
+
+u32 XImage_pros_Get_frame_sync(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_FRAME_SYNC_DATA);
+    return Data;
+}
+
+u32 XImage_pros_Get_frame_errors(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_FRAME_ERRORS_DATA);
+    return Data;
+}
+
+u32 XImage_pros_Get_frame_errors_vld(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_FRAME_ERRORS_CTRL);
+    return Data & 0x1;
+}
+
+void XImage_pros_Set_scale_ctrl(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_SCALE_CTRL_DATA, Data);
+}
+
+u32 XImage_pros_Get_scale_ctrl(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_SCALE_CTRL_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_out_width(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_OUT_WIDTH_DATA, Data);
+}
+
+u32 XImage_pros_Get_out_width(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_OUT_WIDTH_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_out_height(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_OUT_HEIGHT_DATA, Data);
+}
+
+u32 XImage_pros_Get_out_height(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_OUT_HEIGHT_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_roi_count(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_COUNT_DATA, Data);
+}
+
+u32 XImage_pros_Get_roi_count(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_COUNT_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_roi_rects(XImage_pros *InstancePtr, XImage_pros_Roi_rects Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 0, Data.word_0);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 4, Data.word_1);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 8, Data.word_2);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 12, Data.word_3);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 16, Data.word_4);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 20, Data.word_5);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 24, Data.word_6);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 28, Data.word_7);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 32, Data.word_8);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 36, Data.word_9);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 40, Data.word_10);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 44, Data.word_11);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 48, Data.word_12);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 52, Data.word_13);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 56, Data.word_14);
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 60, Data.word_15);
+}
+
+XImage_pros_Roi_rects XImage_pros_Get_roi_rects(XImage_pros *InstancePtr) {
+    XImage_pros_Roi_rects Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data.word_0 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 0);
+    Data.word_1 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 4);
+    Data.word_2 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 8);
+    Data.word_3 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 12);
+    Data.word_4 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 16);
+    Data.word_5 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 20);
+    Data.word_6 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 24);
+    Data.word_7 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 28);
+    Data.word_8 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 32);
+    Data.word_9 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 36);
+    Data.word_10 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 40);
+    Data.word_11 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 44);
+    Data.word_12 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 48);
+    Data.word_13 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 52);
+    Data.word_14 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 56);
+    Data.word_15 = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA + 60);
+    return Data;
+}
+
+void XImage_pros_Set_border_ctrl(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_BORDER_CTRL_DATA, Data);
+}
+
+u32 XImage_pros_Get_border_ctrl(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_BORDER_CTRL_DATA);
+    return Data;
+}
+
+void XImage_pros_Set_grad_enable(XImage_pros *InstancePtr, u32 Data) {
+    Xil_AssertVoid(InstancePtr != NULL);
+    Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    XImage_pros_WriteReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_GRAD_ENABLE_DATA, Data);
+}
+
+u32 XImage_pros_Get_grad_enable(XImage_pros *InstancePtr) {
+    u32 Data;
+
+    Xil_AssertNonvoid(InstancePtr != NULL);
+    Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+    Data = XImage_pros_ReadReg(InstancePtr->Control_BaseAddress, XIMAGE_PROS_CONTROL_ADDR_GRAD_ENABLE_DATA);
+    return Data;
+}
+
 void XImage_pros_InterruptGlobalEnable(XImage_pros *InstancePtr) {
     Xil_AssertVoid(InstancePtr != NULL);
     Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
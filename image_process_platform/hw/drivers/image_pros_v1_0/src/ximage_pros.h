@@ -50,6 +50,35 @@ typedef struct {
 
 typedef u32 word_type;
 
+typedef struct {
+    u32 word_0;
+    u32 word_1;
+    u32 word_2;
+    u32 word_3;
+    u32 word_4;
+    u32 word_5;
+    u32 word_6;
+} XImage_pros_Conv_coeffs;
+
+typedef struct {
+    u32 word_0;
+    u32 word_1;
+    u32 word_2;
+    u32 word_3;
+    u32 word_4;
+    u32 word_5;
+    u32 word_6;
+    u32 word_7;
+    u32 word_8;
+    u32 word_9;
+    u32 word_10;
+    u32 word_11;
+    u32 word_12;
+    u32 word_13;
+    u32 word_14;
+    u32 word_15;
+} XImage_pros_Roi_rects;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 #ifndef __linux__
 #define XImage_pros_WriteReg(BaseAddress, RegOffset, Data) \
@@ -66,8 +95,10 @@ typedef u32 word_type;
 #define Xil_AssertNonvoid(expr) assert(expr)
 
 #define XST_SUCCESS             0
+#define XST_FAILURE             1
 #define XST_DEVICE_NOT_FOUND    2
 #define XST_OPEN_DEVICE_FAILED  3
+#define XST_NO_DATA             13
 #define XIL_COMPONENT_IS_READY  1
 #endif
 
@@ -79,6 +110,7 @@ int XImage_pros_CfgInitialize(XImage_pros *InstancePtr, XImage_pros_Config *Conf
 #else
 int XImage_pros_Initialize(XImage_pros *InstancePtr, const char* InstanceName);
 int XImage_pros_Release(XImage_pros *InstancePtr);
+int XImage_pros_WaitForInterrupt(XImage_pros *InstancePtr, int TimeoutMs);
 #endif
 
 void XImage_pros_Start(XImage_pros *InstancePtr);
@@ -96,6 +128,63 @@ void XImage_pros_Set_width(XImage_pros *InstancePtr, u32 Data);
 u32 XImage_pros_Get_width(XImage_pros *InstancePtr);
 void XImage_pros_Set_height(XImage_pros *InstancePtr, u32 Data);
 u32 XImage_pros_Get_height(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_status(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_status_vld(XImage_pros *InstancePtr);
+void XImage_pros_Set_input_format(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_input_format(XImage_pros *InstancePtr);
+void XImage_pros_Set_filter_chain(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_filter_chain(XImage_pros *InstancePtr);
+void XImage_pros_Set_blur_coeffs(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_blur_coeffs(XImage_pros *InstancePtr);
+void XImage_pros_Set_conv_coeffs(XImage_pros *InstancePtr, XImage_pros_Conv_coeffs Data);
+XImage_pros_Conv_coeffs XImage_pros_Get_conv_coeffs(XImage_pros *InstancePtr);
+void XImage_pros_Set_conv_ctrl(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_conv_ctrl(XImage_pros *InstancePtr);
+void XImage_pros_Set_threshold_high(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_threshold_high(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_stats_min(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_stats_min_vld(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_stats_max(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_stats_max_vld(XImage_pros *InstancePtr);
+u64 XImage_pros_Get_stats_sum(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_stats_sum_vld(XImage_pros *InstancePtr);
+u64 XImage_pros_Get_stats_sum_sq(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_stats_sum_sq_vld(XImage_pros *InstancePtr);
+u64 XImage_pros_Get_histogram_BaseAddress(XImage_pros *InstancePtr);
+u64 XImage_pros_Get_histogram_HighAddress(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_histogram_TotalBytes(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_histogram_BitWidth(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_histogram_Depth(XImage_pros *InstancePtr);
+u32 XImage_pros_Read_histogram_Words(XImage_pros *InstancePtr, int offset, word_type *data, int length);
+void XImage_pros_Set_lut_bank(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_lut_bank(XImage_pros *InstancePtr);
+u64 XImage_pros_Get_lut_BaseAddress(XImage_pros *InstancePtr);
+u64 XImage_pros_Get_lut_HighAddress(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_lut_TotalBytes(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_lut_BitWidth(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_lut_Depth(XImage_pros *InstancePtr);
+u32 XImage_pros_Write_lut_Words(XImage_pros *InstancePtr, int offset, word_type *data, int length);
+u32 XImage_pros_Read_lut_Words(XImage_pros *InstancePtr, int offset, word_type *data, int length);
+u32 XImage_pros_Write_lut_Bytes(XImage_pros *InstancePtr, int offset, char *data, int length);
+u32 XImage_pros_Read_lut_Bytes(XImage_pros *InstancePtr, int offset, char *data, int length);
+void XImage_pros_Set_frame_sync(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_frame_sync(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_frame_errors(XImage_pros *InstancePtr);
+u32 XImage_pros_Get_frame_errors_vld(XImage_pros *InstancePtr);
+void XImage_pros_Set_scale_ctrl(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_scale_ctrl(XImage_pros *InstancePtr);
+void XImage_pros_Set_out_width(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_out_width(XImage_pros *InstancePtr);
+void XImage_pros_Set_out_height(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_out_height(XImage_pros *InstancePtr);
+void XImage_pros_Set_roi_count(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_roi_count(XImage_pros *InstancePtr);
+void XImage_pros_Set_roi_rects(XImage_pros *InstancePtr, XImage_pros_Roi_rects Data);
+XImage_pros_Roi_rects XImage_pros_Get_roi_rects(XImage_pros *InstancePtr);
+void XImage_pros_Set_border_ctrl(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_border_ctrl(XImage_pros *InstancePtr);
+void XImage_pros_Set_grad_enable(XImage_pros *InstancePtr, u32 Data);
+u32 XImage_pros_Get_grad_enable(XImage_pros *InstancePtr);
 
 void XImage_pros_InterruptGlobalEnable(XImage_pros *InstancePtr);
 void XImage_pros_InterruptGlobalDisable(XImage_pros *InstancePtr);
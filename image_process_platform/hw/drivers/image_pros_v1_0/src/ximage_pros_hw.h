@@ -3,6 +3,12 @@
 // Tool Version Limit: 2019.12
 // Copyright 1986-2022 Xilinx, Inc. All Rights Reserved.
 // ==============================================================
+// This map is for the PIXEL_BITS=8 build. Deeper builds widen
+// stats_min/stats_max to PIXEL_BITS and the lut memory to 512 pixel_t
+// entries (1 KiB at 10-16 bits), which no longer fits 0x200-0x3ff:
+// the lut accessors in ximage_pros.c would write the wrong entries.
+// Regenerate the driver from the deeper build instead.
+// ==============================================================
 // control
 // 0x00 : Control signals
 //        bit 0  - ap_start (Read/Write/COH)
@@ -24,12 +30,12 @@
 //        bit 1 - ap_ready (Read/TOW)
 //        others - reserved
 // 0x10 : Data signal of filter_select
-//        bit 2~0 - filter_select[2:0] (Read/Write)
+//        bit 7~0 - filter_select[7:0] (Read/Write)
 //        others  - reserved
 // 0x14 : reserved
 // 0x18 : Data signal of threshold_val
-//        bit 7~0 - threshold_val[7:0] (Read/Write)
-//        others  - reserved
+//        bit 15~0 - threshold_val[15:0] (Read/Write)
+//        others   - reserved
 // 0x1c : reserved
 // 0x20 : Data signal of width
 //        bit 15~0 - width[15:0] (Read/Write)
@@ -39,6 +45,150 @@
 //        bit 15~0 - height[15:0] (Read/Write)
 //        others   - reserved
 // 0x2c : reserved
+// 0x30 : Data signal of status
+//        bit 7~0 - status[7:0] (Read)
+//        others  - reserved
+// 0x34 : Control signal of status
+//        bit 0  - status_ap_vld (Read/COR)
+//        others - reserved
+// 0x38 : Data signal of input_format
+//        bit 1~0 - input_format[1:0] (Read/Write)
+//        others  - reserved
+// 0x3c : reserved
+// 0x40 : Data signal of filter_chain
+//        bit 31~0 - filter_chain[31:0] (Read/Write)
+// 0x44 : reserved
+// 0x48 : Data signal of blur_coeffs
+//        bit 31~0 - blur_coeffs[31:0] (Read/Write)
+// 0x4c : reserved
+// 0x50 : Data signal of conv_coeffs
+//        bit 31~0 - conv_coeffs[31:0] (Read/Write)
+// 0x54 : Data signal of conv_coeffs
+//        bit 31~0 - conv_coeffs[63:32] (Read/Write)
+// 0x58 : Data signal of conv_coeffs
+//        bit 31~0 - conv_coeffs[95:64] (Read/Write)
+// 0x5c : Data signal of conv_coeffs
+//        bit 31~0 - conv_coeffs[127:96] (Read/Write)
+// 0x60 : Data signal of conv_coeffs
+//        bit 31~0 - conv_coeffs[159:128] (Read/Write)
+// 0x64 : Data signal of conv_coeffs
+//        bit 31~0 - conv_coeffs[191:160] (Read/Write)
+// 0x68 : Data signal of conv_coeffs
+//        bit 7~0 - conv_coeffs[199:192] (Read/Write)
+//        others  - reserved
+// 0x6c : reserved
+// 0x70 : Data signal of conv_ctrl
+//        bit 31~0 - conv_ctrl[31:0] (Read/Write)
+// 0x74 : reserved
+// 0x78 : Data signal of threshold_high
+//        bit 31~0 - threshold_high[31:0] (Read/Write)
+// 0x7c : reserved
+// 0x80 : Data signal of stats_min
+//        bit 7~0 - stats_min[7:0] (Read)
+//        others  - reserved
+// 0x84 : Control signal of stats_min
+//        bit 0  - stats_min_ap_vld (Read/COR)
+//        others - reserved
+// 0x88 : Data signal of stats_max
+//        bit 7~0 - stats_max[7:0] (Read)
+//        others  - reserved
+// 0x8c : Control signal of stats_max
+//        bit 0  - stats_max_ap_vld (Read/COR)
+//        others - reserved
+// 0x90 : Data signal of stats_sum
+//        bit 31~0 - stats_sum[31:0] (Read)
+// 0x94 : Data signal of stats_sum
+//        bit 31~0 - stats_sum[63:32] (Read)
+// 0x98 : Control signal of stats_sum
+//        bit 0  - stats_sum_ap_vld (Read/COR)
+//        others - reserved
+// 0x9c : reserved
+// 0xa0 : Data signal of stats_sum_sq
+//        bit 31~0 - stats_sum_sq[31:0] (Read)
+// 0xa4 : Data signal of stats_sum_sq
+//        bit 31~0 - stats_sum_sq[63:32] (Read)
+// 0xa8 : Control signal of stats_sum_sq
+//        bit 0  - stats_sum_sq_ap_vld (Read/COR)
+//        others - reserved
+// 0xac : reserved
+// 0xb0 : Data signal of lut_bank
+//        bit 0  - lut_bank[0] (Read/Write)
+//        others - reserved
+// 0xb4 : reserved
+// 0xb8 : Data signal of frame_sync
+//        bit 0  - frame_sync[0] (Read/Write)
+//        others - reserved
+// 0xbc : reserved
+// 0xc0 : Data signal of frame_errors
+//        bit 31~0 - frame_errors[31:0] (Read)
+// 0xc4 : Control signal of frame_errors
+//        bit 0  - frame_errors_ap_vld (Read/COR)
+//        others - reserved
+// 0xc8 : Data signal of scale_ctrl
+//        bit 7~0 - scale_ctrl[7:0] (Read/Write)
+//        others  - reserved
+// 0xcc : reserved
+// 0xd0 : Data signal of out_width
+//        bit 15~0 - out_width[15:0] (Read/Write)
+//        others   - reserved
+// 0xd4 : reserved
+// 0xd8 : Data signal of out_height
+//        bit 15~0 - out_height[15:0] (Read/Write)
+//        others   - reserved
+// 0xdc : reserved
+// 0xe0 : Data signal of roi_count
+//        bit 3~0 - roi_count[3:0] (Read/Write)
+//        others  - reserved
+// 0xe4 : reserved
+// 0xe8 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[31:0] (Read/Write)
+// 0xec : Data signal of roi_rects
+//        bit 31~0 - roi_rects[63:32] (Read/Write)
+// 0xf0 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[95:64] (Read/Write)
+// 0xf4 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[127:96] (Read/Write)
+// 0xf8 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[159:128] (Read/Write)
+// 0xfc : Data signal of roi_rects
+//        bit 31~0 - roi_rects[191:160] (Read/Write)
+// 0x100 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[223:192] (Read/Write)
+// 0x104 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[255:224] (Read/Write)
+// 0x108 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[287:256] (Read/Write)
+// 0x10c : Data signal of roi_rects
+//        bit 31~0 - roi_rects[319:288] (Read/Write)
+// 0x110 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[351:320] (Read/Write)
+// 0x114 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[383:352] (Read/Write)
+// 0x118 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[415:384] (Read/Write)
+// 0x11c : Data signal of roi_rects
+//        bit 31~0 - roi_rects[447:416] (Read/Write)
+// 0x120 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[479:448] (Read/Write)
+// 0x124 : Data signal of roi_rects
+//        bit 31~0 - roi_rects[511:480] (Read/Write)
+// 0x128 : Data signal of border_ctrl
+//         bit 15~0 - border_ctrl[15:0] (Read/Write)
+//         others   - reserved
+// 0x12c : reserved
+// 0x130 : Data signal of grad_enable
+//         bit 0  - grad_enable[0] (Read/Write)
+//         others - reserved
+// 0x134 : reserved
+// 0x200 ~
+// 0x3ff : Memory 'lut' (512 * 8b)
+//         Word n : bit [ 7: 0] - lut[4n]
+//                  bit [15: 8] - lut[4n+1]
+//                  bit [23:16] - lut[4n+2]
+//                  bit [31:24] - lut[4n+3]
+// 0x400 ~
+// 0x7ff : Memory 'histogram' (256 * 32b)
+//         Word n : bit [31:0] - histogram[n]
 // (SC = Self Clear, COR = Clear on Read, TOW = Toggle on Write, COH = Clear on Handshake)
 
 #define XIMAGE_PROS_CONTROL_ADDR_AP_CTRL            0x00
@@ -46,11 +196,68 @@
 #define XIMAGE_PROS_CONTROL_ADDR_IER                0x08
 #define XIMAGE_PROS_CONTROL_ADDR_ISR                0x0c
 #define XIMAGE_PROS_CONTROL_ADDR_FILTER_SELECT_DATA 0x10
-#define XIMAGE_PROS_CONTROL_BITS_FILTER_SELECT_DATA 3
+#define XIMAGE_PROS_CONTROL_BITS_FILTER_SELECT_DATA 8
 #define XIMAGE_PROS_CONTROL_ADDR_THRESHOLD_VAL_DATA 0x18
-#define XIMAGE_PROS_CONTROL_BITS_THRESHOLD_VAL_DATA 8
+#define XIMAGE_PROS_CONTROL_BITS_THRESHOLD_VAL_DATA 16
 #define XIMAGE_PROS_CONTROL_ADDR_WIDTH_DATA         0x20
 #define XIMAGE_PROS_CONTROL_BITS_WIDTH_DATA         16
 #define XIMAGE_PROS_CONTROL_ADDR_HEIGHT_DATA        0x28
 #define XIMAGE_PROS_CONTROL_BITS_HEIGHT_DATA        16
+#define XIMAGE_PROS_CONTROL_ADDR_STATUS_DATA        0x30
+#define XIMAGE_PROS_CONTROL_BITS_STATUS_DATA        8
+#define XIMAGE_PROS_CONTROL_ADDR_STATUS_CTRL        0x34
+#define XIMAGE_PROS_CONTROL_ADDR_INPUT_FORMAT_DATA  0x38
+#define XIMAGE_PROS_CONTROL_BITS_INPUT_FORMAT_DATA  2
+#define XIMAGE_PROS_CONTROL_ADDR_FILTER_CHAIN_DATA  0x40
+#define XIMAGE_PROS_CONTROL_BITS_FILTER_CHAIN_DATA  32
+#define XIMAGE_PROS_CONTROL_ADDR_BLUR_COEFFS_DATA   0x48
+#define XIMAGE_PROS_CONTROL_BITS_BLUR_COEFFS_DATA   32
+#define XIMAGE_PROS_CONTROL_ADDR_CONV_COEFFS_DATA   0x50
+#define XIMAGE_PROS_CONTROL_BITS_CONV_COEFFS_DATA   200
+#define XIMAGE_PROS_CONTROL_ADDR_CONV_CTRL_DATA     0x70
+#define XIMAGE_PROS_CONTROL_BITS_CONV_CTRL_DATA     32
+#define XIMAGE_PROS_CONTROL_ADDR_THRESHOLD_HIGH_DATA 0x78
+#define XIMAGE_PROS_CONTROL_BITS_THRESHOLD_HIGH_DATA 32
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_MIN_DATA     0x80
+#define XIMAGE_PROS_CONTROL_BITS_STATS_MIN_DATA     8
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_MIN_CTRL     0x84
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_MAX_DATA     0x88
+#define XIMAGE_PROS_CONTROL_BITS_STATS_MAX_DATA     8
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_MAX_CTRL     0x8c
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_DATA     0x90
+#define XIMAGE_PROS_CONTROL_BITS_STATS_SUM_DATA     64
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_CTRL     0x98
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_SQ_DATA  0xa0
+#define XIMAGE_PROS_CONTROL_BITS_STATS_SUM_SQ_DATA  64
+#define XIMAGE_PROS_CONTROL_ADDR_STATS_SUM_SQ_CTRL  0xa8
+#define XIMAGE_PROS_CONTROL_ADDR_LUT_BANK_DATA      0xb0
+#define XIMAGE_PROS_CONTROL_BITS_LUT_BANK_DATA      1
+#define XIMAGE_PROS_CONTROL_ADDR_FRAME_SYNC_DATA    0xb8
+#define XIMAGE_PROS_CONTROL_BITS_FRAME_SYNC_DATA    1
+#define XIMAGE_PROS_CONTROL_ADDR_FRAME_ERRORS_DATA  0xc0
+#define XIMAGE_PROS_CONTROL_BITS_FRAME_ERRORS_DATA  32
+#define XIMAGE_PROS_CONTROL_ADDR_FRAME_ERRORS_CTRL  0xc4
+#define XIMAGE_PROS_CONTROL_ADDR_SCALE_CTRL_DATA    0xc8
+#define XIMAGE_PROS_CONTROL_BITS_SCALE_CTRL_DATA    8
+#define XIMAGE_PROS_CONTROL_ADDR_OUT_WIDTH_DATA     0xd0
+#define XIMAGE_PROS_CONTROL_BITS_OUT_WIDTH_DATA     16
+#define XIMAGE_PROS_CONTROL_ADDR_OUT_HEIGHT_DATA    0xd8
+#define XIMAGE_PROS_CONTROL_BITS_OUT_HEIGHT_DATA    16
+#define XIMAGE_PROS_CONTROL_ADDR_ROI_COUNT_DATA     0xe0
+#define XIMAGE_PROS_CONTROL_BITS_ROI_COUNT_DATA     4
+#define XIMAGE_PROS_CONTROL_ADDR_ROI_RECTS_DATA     0xe8
+#define XIMAGE_PROS_CONTROL_BITS_ROI_RECTS_DATA     512
+#define XIMAGE_PROS_CONTROL_ADDR_BORDER_CTRL_DATA   0x128
+#define XIMAGE_PROS_CONTROL_BITS_BORDER_CTRL_DATA   16
+#define XIMAGE_PROS_CONTROL_ADDR_GRAD_ENABLE_DATA   0x130
+#define XIMAGE_PROS_CONTROL_BITS_GRAD_ENABLE_DATA   1
+// 8-bit entries (PIXEL_BITS=8 build only)
+#define XIMAGE_PROS_CONTROL_BASE_LUT                0x200
+#define XIMAGE_PROS_CONTROL_HIGH_LUT                0x3ff
+#define XIMAGE_PROS_CONTROL_WIDTH_LUT               8
+#define XIMAGE_PROS_CONTROL_DEPTH_LUT               512
+#define XIMAGE_PROS_CONTROL_BASE_HISTOGRAM          0x400
+#define XIMAGE_PROS_CONTROL_HIGH_HISTOGRAM          0x7ff
+#define XIMAGE_PROS_CONTROL_WIDTH_HISTOGRAM         32
+#define XIMAGE_PROS_CONTROL_DEPTH_HISTOGRAM         256
 
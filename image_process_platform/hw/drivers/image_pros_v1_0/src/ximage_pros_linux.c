@@ -6,12 +6,14 @@
 #ifdef __linux__
 
 /***************************** Include Files *********************************/
+#include <poll.h>
 #include "ximage_pros.h"
 
 /***************** Macros (Inline Functions) Definitions *********************/
 #define MAX_UIO_PATH_SIZE       256
 #define MAX_UIO_NAME_SIZE       64
 #define MAX_UIO_MAPS            5
+#define MAX_UIO_INSTANCES       8
 #define UIO_INVALID_ADDR        0
 
 /**************************** Type Definitions ******************************/
@@ -21,6 +23,7 @@ typedef struct {
 } XImage_pros_uio_map;
 
 typedef struct {
+    XImage_pros *owner;
     int  uio_fd;
     int  uio_num;
     char name[ MAX_UIO_NAME_SIZE ];
@@ -29,9 +32,17 @@ typedef struct {
 } XImage_pros_uio_info;
 
 /***************** Variable Definitions **************************************/
-static XImage_pros_uio_info uio_info;
+static XImage_pros_uio_info uio_info[ MAX_UIO_INSTANCES ];
 
 /************************** Function Implementation *************************/
+static XImage_pros_uio_info* uio_info_find(XImage_pros *InstancePtr) {
+    int i;
+    for (i = 0; i < MAX_UIO_INSTANCES; i++) {
+        if (uio_info[i].owner == InstancePtr) return &uio_info[i];
+    }
+    return NULL;
+}
+
 static int line_from_file(char* filename, char* linebuf) {
     char* s;
     int i;
@@ -85,7 +96,7 @@ static int uio_info_read_map_size(XImage_pros_uio_info* info, int n) {
 }
 
 int XImage_pros_Initialize(XImage_pros *InstancePtr, const char* InstanceName) {
-	XImage_pros_uio_info *InfoPtr = &uio_info;
+	XImage_pros_uio_info *InfoPtr;
 	struct dirent **namelist;
     int i, n;
     char* s;
@@ -95,6 +106,11 @@ int XImage_pros_Initialize(XImage_pros *InstancePtr, const char* InstanceName) {
 
     assert(InstancePtr != NULL);
 
+    // One slot per open instance
+    InfoPtr = uio_info_find(InstancePtr);
+    if (InfoPtr == NULL) InfoPtr = uio_info_find(NULL);
+    if (InfoPtr == NULL) return XST_OPEN_DEVICE_FAILED;
+
     n = scandir("/sys/class/uio", &namelist, 0, alphasort);
     if (n < 0)  return XST_DEVICE_NOT_FOUND;
     for (i = 0;  i < n; i++) {
@@ -122,6 +138,7 @@ int XImage_pros_Initialize(XImage_pros *InstancePtr, const char* InstanceName) {
     if ((InfoPtr->uio_fd = open(file, O_RDWR)) < 0) {
         return XST_OPEN_DEVICE_FAILED;
     }
+    InfoPtr->owner = InstancePtr;
 
     // NOTE: slave interface 'Control' should be mapped to uioX/map0
     InstancePtr->Control_BaseAddress = (u64)mmap(NULL, InfoPtr->maps[0].size, PROT_READ|PROT_WRITE, MAP_SHARED, InfoPtr->uio_fd, 0 * getpagesize());
@@ -133,14 +150,57 @@ int XImage_pros_Initialize(XImage_pros *InstancePtr, const char* InstanceName) {
 }
 
 int XImage_pros_Release(XImage_pros *InstancePtr) {
-	XImage_pros_uio_info *InfoPtr = &uio_info;
+	XImage_pros_uio_info *InfoPtr = uio_info_find(InstancePtr);
 
     assert(InstancePtr != NULL);
     assert(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+    assert(InfoPtr != NULL);
 
     munmap((void*)InstancePtr->Control_BaseAddress, InfoPtr->maps[0].size);
 
     close(InfoPtr->uio_fd);
+    InfoPtr->owner = NULL;
+    InstancePtr->IsReady = 0;
+
+    return XST_SUCCESS;
+}
+
+// Block on /dev/uioN until the IP raises its interrupt or TimeoutMs
+// expires (negative waits forever). The UIO interrupt is re-armed by
+// writing 1 to the device; the IP must have its interrupts enabled
+// (InterruptEnable + InterruptGlobalEnable). The IP interrupt status
+// is cleared before returning so the line drops.
+// Returns XST_SUCCESS, XST_NO_DATA on timeout or XST_FAILURE.
+int XImage_pros_WaitForInterrupt(XImage_pros *InstancePtr, int TimeoutMs) {
+	XImage_pros_uio_info *InfoPtr = uio_info_find(InstancePtr);
+    struct pollfd pfd;
+    u32 irq_on = 1;
+    u32 irq_count;
+    int ret;
+
+    assert(InstancePtr != NULL);
+    assert(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+    assert(InfoPtr != NULL);
+
+    if (write(InfoPtr->uio_fd, &irq_on, sizeof(irq_on)) != sizeof(irq_on)) {
+        return XST_FAILURE;
+    }
+
+    pfd.fd = InfoPtr->uio_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    ret = poll(&pfd, 1, TimeoutMs);
+    if (ret == 0) {
+        return XST_NO_DATA;
+    }
+    if (ret < 0 || !(pfd.revents & POLLIN)) {
+        return XST_FAILURE;
+    }
+    if (read(InfoPtr->uio_fd, &irq_count, sizeof(irq_count)) != sizeof(irq_count)) {
+        return XST_FAILURE;
+    }
+
+    XImage_pros_InterruptClear(InstancePtr, XImage_pros_InterruptGetStatus(InstancePtr));
 
     return XST_SUCCESS;
 }
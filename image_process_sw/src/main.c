@@ -2,11 +2,16 @@
 #include "xparameters.h"
 #include "xil_io.h"
 #include "xil_printf.h"
+#include "xil_exception.h"
+#include "xintc.h"
 
 // === Update these from xparameters.h ===
 #define IMG_PROC_BASE   XPAR_IMAGE_PROS_0_S_AXI_CONTROL_BASEADDR
 #define GPIO_BASE       XPAR_AXI_GPIO_0_BASEADDR      // optional if you have GPIO
 #define BRAM_BASE       XPAR_AXI_BRAM_CTRL_0_S_AXI_BASEADDR // optional if you use BRAM
+#define INTC_ID         XPAR_MICROBLAZE_0_AXI_INTC_DEVICE_ID
+#define IMG_PROC_IRQ    XPAR_MICROBLAZE_0_AXI_INTC_IMAGE_PROS_0_INTERRUPT_INTR
+#define WAIT_LOOPS      10000000
 
 // Image Processing IP register map (from HLS IP)
 #define REG_CTRL        0x00   // bit0: ap_start, bit1: ap_done, bit2: ap_idle, bit3: ap_ready
@@ -17,6 +22,8 @@
 #define REG_THRESH      0x18   // threshold_val
 #define REG_WIDTH       0x20
 #define REG_HEIGHT      0x28
+#define REG_STATUS      0x30   // 0: ok, 1: width exceeds IP maximum
+#define REG_INPUT_FMT   0x38   // 0: gray, 1: RGB BT.601, 2: RGB BT.709
 
 // Filter modes
 #define FILTER_BYPASS     0
@@ -34,17 +41,44 @@ static void ip_config(uint8_t filter, uint8_t thresh, uint16_t w, uint16_t h) {
     Xil_Out32(IMG_PROC_BASE + REG_HEIGHT, h);
 }
 
+static XIntc intc;
+static volatile int ip_done;
+
+static void ip_isr(void *ref) {
+    // ISR bits toggle on write: writing back what is set clears them
+    uint32_t isr = Xil_In32(IMG_PROC_BASE + REG_ISR);
+    Xil_Out32(IMG_PROC_BASE + REG_ISR, isr);
+    if (isr & 0x01) ip_done = 1;   // ap_done
+}
+
+static int ip_irq_init(void) {
+    if (XIntc_Initialize(&intc, INTC_ID) != XST_SUCCESS) return -1;
+    if (XIntc_Connect(&intc, IMG_PROC_IRQ, ip_isr, NULL) != XST_SUCCESS) return -1;
+    if (XIntc_Start(&intc, XIN_REAL_MODE) != XST_SUCCESS) return -1;
+    XIntc_Enable(&intc, IMG_PROC_IRQ);
+
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+                                 (Xil_ExceptionHandler)XIntc_InterruptHandler, &intc);
+    Xil_ExceptionEnable();
+
+    // Interrupt on ap_done only
+    Xil_Out32(IMG_PROC_BASE + REG_IER, 0x01);
+    Xil_Out32(IMG_PROC_BASE + REG_GIE, 0x01);
+    return 0;
+}
+
 static void ip_start(void) {
+    ip_done = 0;
+
     // Write ap_start=1 (bit0)
     Xil_Out32(IMG_PROC_BASE + REG_CTRL, 0x01);
 }
 
 static int ip_wait_done(void) {
-    // Poll ap_done (bit1) or ap_ready (bit3)
-    while (1) {
-        uint32_t st = Xil_In32(IMG_PROC_BASE + REG_CTRL);
-        if (st & 0x02) return 0;   // ap_done
-        if (st & 0x08) return 0;   // ap_ready
+    // Set by ip_isr; no AXI-Lite traffic while waiting
+    for (uint32_t i = 0; i < WAIT_LOOPS; i++) {
+        if (ip_done) return 0;
     }
     return -1;
 }
@@ -59,6 +93,11 @@ int main() {
     uint8_t  thresh = 128;
     uint8_t  filter = FILTER_SOBEL;
 
+    if (ip_irq_init() != 0) {
+        xil_printf("Interrupt setup failed.\r\n");
+        return -1;
+    }
+
     ip_config(filter, thresh, width, height);
     xil_printf("Configured: filter=%d, thresh=%d, size=%dx%d\r\n",
                filter, thresh, width, height);
@@ -67,8 +106,12 @@ int main() {
 
     // Start processing
     ip_start();
-    ip_wait_done();
-    xil_printf("Processing done.\r\n");
+    if (ip_wait_done() != 0) {
+        xil_printf("Timed out waiting for ap_done.\r\n");
+        return -1;
+    }
+    xil_printf("Processing done, status=%d.\r\n",
+               Xil_In32(IMG_PROC_BASE + REG_STATUS));
 
     // If you wrote output to BRAM, you can read it back here.
     // Example read first pixel (optional):
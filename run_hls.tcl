@@ -3,18 +3,49 @@
 # Run with: vitis_hls -f run_hls.tcl
 # ============================================
 
+# Select Top Function
+# Default is the 1 pixel/clock, 640-wide image_pros. Pass a variant
+# to build it instead, e.g. vitis_hls -f run_hls.tcl -tclargs image_pros_4k
+#   image_pros_1080p / image_pros_4k               (1 pixel/clock)
+#   image_pros_ppc2 / image_pros_ppc4 / image_pros_ppc8  (4096 wide)
+set top_name image_pros
+if {[info exists argv] && [llength $argv] > 0} {
+    set top_name [lindex $argv 0]
+}
+
+# Separable blur kernel size (3, 5 or 7) as an optional second
+# argument, e.g. -tclargs image_pros_1080p 7
+set blur_kernel_size 5
+if {[info exists argv] && [llength $argv] > 1} {
+    set blur_kernel_size [lindex $argv 1]
+}
+
+# Pixel depth (8, 10, 12 or 16) as an optional third argument, e.g.
+# -tclargs image_pros_1080p 5 12. Deeper builds skip the 8-bit
+# reference tests in csim.
+set pixel_bits 8
+if {[info exists argv] && [llength $argv] > 2} {
+    set pixel_bits [lindex $argv 2]
+}
+set blur_cflags "-DBLUR_KERNEL_SIZE=$blur_kernel_size -DPIXEL_BITS=$pixel_bits"
+
 # Create/Open Project
-open_project image_pros
+open_project $top_name
 
 # Set Top Function
-set_top image_pros
+set_top $top_name
 
 # Add Source Files
-add_files src/image_processing.cpp
+add_files src/image_processing.cpp -cflags $blur_cflags
+add_files src/image_processing_ppc.cpp -cflags $blur_cflags
 add_files src/image_processing.h
 
 # Add Testbench Files
-add_files -tb src/testbench.cpp
+add_files -tb src/testbench.cpp -cflags $blur_cflags
+add_files -tb src/cpu_ref.cpp
+add_files -tb src/cpu_tiled.cpp
+add_files -tb src/pnm_io.cpp
+add_files -tb src/golden
 
 # Open Solution
 open_solution "solution1" -flow_target vivado
@@ -32,7 +63,8 @@ set_clock_uncertainty 0.5
 puts "=========================================="
 puts " Running C Simulation..."
 puts "=========================================="
-csim_design
+# The tiled CPU fallback in the testbench uses std::thread
+csim_design -ldflags {-lpthread}
 
 # ============================================
 # Run C Synthesis
@@ -48,7 +80,7 @@ csynth_design
 puts "=========================================="
 puts " Running Co-Simulation..."
 puts "=========================================="
-cosim_design
+cosim_design -ldflags {-lpthread}
 
 # ============================================
 # Export IP for Vivado
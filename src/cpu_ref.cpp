@@ -0,0 +1,1613 @@
+/*
+ * Image Processing Accelerator - CPU Reference Engine
+ * Scalar, SSE4.1, AVX2 and NEON kernels bit-exact with image_pros
+ *
+ * Every kernel works on 16-bit lanes, which hold all intermediate
+ * values of the 3x3 filters exactly (Sobel |gx|+|gy| <= 2040,
+ * Gaussian sum <= 4080, Sharpen -1020..1275), and narrows with
+ * unsigned saturation, which is the hardware's clamp to 0..255.
+ * Median, erode and dilate use the same lanes with min/max.
+ * SIMD loops stop at the last full vector; the scalar code finishes
+ * the row.
+ */
+
+#include <string.h>
+#include "cpu_ref.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CPU_REF_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#define CPU_REF_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Mirrors filter_mode_t (image_processing.h pulls in the HLS types)
+enum {
+    MODE_BYPASS    = 0,
+    MODE_GRAYSCALE = 1,
+    MODE_SOBEL     = 2,
+    MODE_THRESHOLD = 3,
+    MODE_GAUSSIAN  = 4,
+    MODE_NEGATIVE  = 5,
+    MODE_SHARPEN   = 6,
+    MODE_BLUR      = 7,
+    MODE_CONV      = 8,
+    MODE_MEDIAN    = 9,
+    MODE_ERODE     = 10,
+    MODE_DILATE    = 11,
+    MODE_OPEN      = 12,
+    MODE_CLOSE     = 13,
+    MODE_CANNY     = 14,
+    MODE_ADAPTIVE  = 15,
+    MODE_OTSU      = 16,
+    MODE_LUT       = 17,
+    MODE_EQUALIZE  = 18,
+    MODE_GRAD_X    = 19,
+    MODE_GRAD_Y    = 20
+};
+
+static inline bool is_rank_mode(int mode) {
+    return mode == MODE_MEDIAN || mode == MODE_ERODE || mode == MODE_DILATE;
+}
+
+static inline bool is_grad_mode(int mode) {
+    return mode == MODE_GRAD_X || mode == MODE_GRAD_Y;
+}
+
+// Sobel and the signed gradients write a black border
+static inline bool black_border(int mode) {
+    return mode == MODE_SOBEL || is_grad_mode(mode);
+}
+
+// Mirrors MEDIAN9_NETWORK: (lower, upper) pairs over the window in
+// row-major order; p[4] is the median afterwards
+static const int MEDIAN9_NETWORK[19][2] = {
+    {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2}, {4, 5},
+    {7, 8}, {0, 3}, {5, 8}, {4, 7}, {3, 6}, {1, 4}, {2, 5}, {4, 7},
+    {4, 2}, {6, 4}, {4, 2}
+};
+
+// Mirrors BLUR_BINOMIAL
+static const int BLUR_BINOMIAL[3][4] = {
+    {128, 64,  0, 0},
+    { 96, 64, 16, 0},
+    { 80, 60, 24, 4}
+};
+
+// ============================================
+// Scalar Kernels
+// ============================================
+// Median of nine, or their minimum (erode) / maximum (dilate)
+static inline uint8_t rank_pixel(int mode, uint8_t p[9]) {
+    if (mode == MODE_MEDIAN) {
+        // Branch-free: the swaps are data-dependent and unpredictable
+        for (int k = 0; k < 19; k++) {
+            uint8_t x = p[MEDIAN9_NETWORK[k][0]];
+            uint8_t y = p[MEDIAN9_NETWORK[k][1]];
+            p[MEDIAN9_NETWORK[k][0]] = (x < y) ? x : y;
+            p[MEDIAN9_NETWORK[k][1]] = (x < y) ? y : x;
+        }
+        return p[4];
+    }
+    uint8_t v = p[0];
+    for (int i = 1; i < 9; i++) {
+        v = (mode == MODE_ERODE) ? (p[i] < v ? p[i] : v) : (p[i] > v ? p[i] : v);
+    }
+    return v;
+}
+
+// a, b, d are input rows r-2, r-1, r; window[i][j] = row_i[c-2+j].
+static inline uint8_t window_pixel(
+    int mode,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    int c
+) {
+    switch (mode) {
+        case MODE_SOBEL: {
+            int gx = (a[c] - a[c - 2]) + 2 * (b[c] - b[c - 2]) + (d[c] - d[c - 2]);
+            int gy = (d[c - 2] + 2 * d[c - 1] + d[c]) - (a[c - 2] + 2 * a[c - 1] + a[c]);
+            int magnitude = (gx < 0 ? -gx : gx) + (gy < 0 ? -gy : gy);
+            return (magnitude > 255) ? 255 : (uint8_t)magnitude;
+        }
+        case MODE_GRAD_X:
+        case MODE_GRAD_Y: {
+            // Two's complement of the gradient saturated to -128..127
+            int g = (mode == MODE_GRAD_X)
+                  ? (a[c] - a[c - 2]) + 2 * (b[c] - b[c - 2]) + (d[c] - d[c - 2])
+                  : (d[c - 2] + 2 * d[c - 1] + d[c]) - (a[c - 2] + 2 * a[c - 1] + a[c]);
+            g = (g > 127) ? 127 : (g < -128) ? -128 : g;
+            return (uint8_t)g;
+        }
+        case MODE_GAUSSIAN: {
+            int sum = (a[c - 2] + 2 * a[c - 1] + a[c])
+                    + 2 * (b[c - 2] + 2 * b[c - 1] + b[c])
+                    + (d[c - 2] + 2 * d[c - 1] + d[c]);
+            return (uint8_t)(sum >> 4);
+        }
+        case MODE_MEDIAN:
+        case MODE_ERODE:
+        case MODE_DILATE: {
+            uint8_t p[9] = {a[c - 2], a[c - 1], a[c], b[c - 2], b[c - 1], b[c],
+                            d[c - 2], d[c - 1], d[c]};
+            return rank_pixel(mode, p);
+        }
+        default: {
+            int sum = 5 * b[c - 1] - a[c - 1] - d[c - 1] - b[c - 2] - b[c];
+            return (sum < 0) ? 0 : (sum > 255) ? 255 : (uint8_t)sum;
+        }
+    }
+}
+
+static void window_row_scalar(
+    int mode,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    uint8_t *out, int c, int width
+) {
+    for (; c < width; c++) {
+        out[c] = window_pixel(mode, a, b, d, c);
+    }
+}
+
+static void point_row_scalar(
+    int mode, uint8_t threshold,
+    const uint8_t *in, uint8_t *out, int c, int width
+) {
+    if (mode == MODE_THRESHOLD) {
+        for (; c < width; c++) {
+            out[c] = (in[c] > threshold) ? 255 : 0;
+        }
+    } else {
+        for (; c < width; c++) {
+            out[c] = 255 - in[c];
+        }
+    }
+}
+
+#ifdef CPU_REF_X86
+// ============================================
+// SSE4.1 Kernels (8 pixels per step)
+// ============================================
+#define SSE41 __attribute__((target("sse4.1")))
+
+static SSE41 inline __m128i load8_sse41(const uint8_t *p) {
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)p));
+}
+
+// a[c-2] + 2 * a[c-1] + a[c] and the two outer taps
+static SSE41 inline __m128i smooth_sse41(__m128i l, __m128i m, __m128i r) {
+    return _mm_add_epi16(_mm_add_epi16(l, r), _mm_slli_epi16(m, 1));
+}
+
+// rank_pixel() on eight pixels; p holds the window row-major
+static SSE41 inline __m128i rank_sse41(int mode, __m128i p[9]) {
+    if (mode == MODE_MEDIAN) {
+        for (int k = 0; k < 19; k++) {
+            __m128i lo = _mm_min_epi16(p[MEDIAN9_NETWORK[k][0]], p[MEDIAN9_NETWORK[k][1]]);
+            __m128i hi = _mm_max_epi16(p[MEDIAN9_NETWORK[k][0]], p[MEDIAN9_NETWORK[k][1]]);
+            p[MEDIAN9_NETWORK[k][0]] = lo;
+            p[MEDIAN9_NETWORK[k][1]] = hi;
+        }
+        return p[4];
+    }
+    __m128i v = p[0];
+    for (int i = 1; i < 9; i++) {
+        v = (mode == MODE_ERODE) ? _mm_min_epi16(v, p[i]) : _mm_max_epi16(v, p[i]);
+    }
+    return v;
+}
+
+static SSE41 int window_row_sse41(
+    int mode,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    uint8_t *out, int width
+) {
+    int c = 2;
+    for (; c + 8 <= width; c += 8) {
+        __m128i a0 = load8_sse41(a + c - 2), a1 = load8_sse41(a + c - 1), a2 = load8_sse41(a + c);
+        __m128i b0 = load8_sse41(b + c - 2), b1 = load8_sse41(b + c - 1), b2 = load8_sse41(b + c);
+        __m128i d0 = load8_sse41(d + c - 2), d1 = load8_sse41(d + c - 1), d2 = load8_sse41(d + c);
+        __m128i v;
+
+        if (mode == MODE_SOBEL) {
+            __m128i gx = _mm_add_epi16(
+                _mm_add_epi16(_mm_sub_epi16(a2, a0), _mm_sub_epi16(d2, d0)),
+                _mm_slli_epi16(_mm_sub_epi16(b2, b0), 1));
+            __m128i gy = _mm_sub_epi16(smooth_sse41(d0, d1, d2),
+                                       smooth_sse41(a0, a1, a2));
+            v = _mm_add_epi16(_mm_abs_epi16(gx), _mm_abs_epi16(gy));
+        } else if (mode == MODE_GAUSSIAN) {
+            v = _mm_add_epi16(
+                _mm_add_epi16(smooth_sse41(a0, a1, a2), smooth_sse41(d0, d1, d2)),
+                _mm_slli_epi16(smooth_sse41(b0, b1, b2), 1));
+            v = _mm_srli_epi16(v, 4);
+        } else if (is_rank_mode(mode)) {
+            __m128i p[9] = {a0, a1, a2, b0, b1, b2, d0, d1, d2};
+            v = rank_sse41(mode, p);
+        } else {
+            v = _mm_sub_epi16(
+                _mm_add_epi16(_mm_slli_epi16(b1, 2), b1),
+                _mm_add_epi16(_mm_add_epi16(a1, d1), _mm_add_epi16(b0, b2)));
+        }
+        _mm_storel_epi64((__m128i *)(out + c), _mm_packus_epi16(v, v));
+    }
+    return c;
+}
+
+static SSE41 int point_row_sse41(
+    int mode, uint8_t threshold,
+    const uint8_t *in, uint8_t *out, int width
+) {
+    const __m128i t = _mm_set1_epi8((char)threshold);
+    const __m128i ones = _mm_set1_epi8(-1);
+    int c = 0;
+    for (; c + 16 <= width; c += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(in + c));
+        __m128i v;
+        if (mode == MODE_THRESHOLD) {
+            // in > t  <=>  saturating in - t is non-zero
+            v = _mm_xor_si128(_mm_cmpeq_epi8(_mm_subs_epu8(p, t),
+                                             _mm_setzero_si128()), ones);
+        } else {
+            v = _mm_xor_si128(p, ones);
+        }
+        _mm_storeu_si128((__m128i *)(out + c), v);
+    }
+    return c;
+}
+
+// ============================================
+// AVX2 Kernels (16 pixels per step)
+// ============================================
+#define AVX2 __attribute__((target("avx2")))
+
+static AVX2 inline __m256i load16_avx2(const uint8_t *p) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+static AVX2 inline __m256i smooth_avx2(__m256i l, __m256i m, __m256i r) {
+    return _mm256_add_epi16(_mm256_add_epi16(l, r), _mm256_slli_epi16(m, 1));
+}
+
+static AVX2 inline __m256i rank_avx2(int mode, __m256i p[9]) {
+    if (mode == MODE_MEDIAN) {
+        for (int k = 0; k < 19; k++) {
+            __m256i lo = _mm256_min_epi16(p[MEDIAN9_NETWORK[k][0]], p[MEDIAN9_NETWORK[k][1]]);
+            __m256i hi = _mm256_max_epi16(p[MEDIAN9_NETWORK[k][0]], p[MEDIAN9_NETWORK[k][1]]);
+            p[MEDIAN9_NETWORK[k][0]] = lo;
+            p[MEDIAN9_NETWORK[k][1]] = hi;
+        }
+        return p[4];
+    }
+    __m256i v = p[0];
+    for (int i = 1; i < 9; i++) {
+        v = (mode == MODE_ERODE) ? _mm256_min_epi16(v, p[i]) : _mm256_max_epi16(v, p[i]);
+    }
+    return v;
+}
+
+static AVX2 int window_row_avx2(
+    int mode,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    uint8_t *out, int width
+) {
+    int c = 2;
+    for (; c + 16 <= width; c += 16) {
+        __m256i a0 = load16_avx2(a + c - 2), a1 = load16_avx2(a + c - 1), a2 = load16_avx2(a + c);
+        __m256i b0 = load16_avx2(b + c - 2), b1 = load16_avx2(b + c - 1), b2 = load16_avx2(b + c);
+        __m256i d0 = load16_avx2(d + c - 2), d1 = load16_avx2(d + c - 1), d2 = load16_avx2(d + c);
+        __m256i v;
+
+        if (mode == MODE_SOBEL) {
+            __m256i gx = _mm256_add_epi16(
+                _mm256_add_epi16(_mm256_sub_epi16(a2, a0), _mm256_sub_epi16(d2, d0)),
+                _mm256_slli_epi16(_mm256_sub_epi16(b2, b0), 1));
+            __m256i gy = _mm256_sub_epi16(smooth_avx2(d0, d1, d2),
+                                          smooth_avx2(a0, a1, a2));
+            v = _mm256_add_epi16(_mm256_abs_epi16(gx), _mm256_abs_epi16(gy));
+        } else if (mode == MODE_GAUSSIAN) {
+            v = _mm256_add_epi16(
+                _mm256_add_epi16(smooth_avx2(a0, a1, a2), smooth_avx2(d0, d1, d2)),
+                _mm256_slli_epi16(smooth_avx2(b0, b1, b2), 1));
+            v = _mm256_srli_epi16(v, 4);
+        } else if (is_rank_mode(mode)) {
+            __m256i p[9] = {a0, a1, a2, b0, b1, b2, d0, d1, d2};
+            v = rank_avx2(mode, p);
+        } else {
+            v = _mm256_sub_epi16(
+                _mm256_add_epi16(_mm256_slli_epi16(b1, 2), b1),
+                _mm256_add_epi16(_mm256_add_epi16(a1, d1), _mm256_add_epi16(b0, b2)));
+        }
+        // 256-bit packus works per lane; narrow the two halves instead
+        __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(v),
+                                          _mm256_extracti128_si256(v, 1));
+        _mm_storeu_si128((__m128i *)(out + c), packed);
+    }
+    return c;
+}
+
+static AVX2 int point_row_avx2(
+    int mode, uint8_t threshold,
+    const uint8_t *in, uint8_t *out, int width
+) {
+    const __m256i t = _mm256_set1_epi8((char)threshold);
+    const __m256i ones = _mm256_set1_epi8(-1);
+    int c = 0;
+    for (; c + 32 <= width; c += 32) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(in + c));
+        __m256i v;
+        if (mode == MODE_THRESHOLD) {
+            v = _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_subs_epu8(p, t),
+                                                   _mm256_setzero_si256()), ones);
+        } else {
+            v = _mm256_xor_si256(p, ones);
+        }
+        _mm256_storeu_si256((__m256i *)(out + c), v);
+    }
+    return c;
+}
+#endif // CPU_REF_X86
+
+#ifdef CPU_REF_NEON
+// ============================================
+// NEON Kernels (8 pixels per step)
+// ============================================
+static inline int16x8_t load8_neon(const uint8_t *p) {
+    return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(p)));
+}
+
+static inline int16x8_t smooth_neon(int16x8_t l, int16x8_t m, int16x8_t r) {
+    return vaddq_s16(vaddq_s16(l, r), vshlq_n_s16(m, 1));
+}
+
+static inline int16x8_t rank_neon(int mode, int16x8_t p[9]) {
+    if (mode == MODE_MEDIAN) {
+        for (int k = 0; k < 19; k++) {
+            int16x8_t lo = vminq_s16(p[MEDIAN9_NETWORK[k][0]], p[MEDIAN9_NETWORK[k][1]]);
+            int16x8_t hi = vmaxq_s16(p[MEDIAN9_NETWORK[k][0]], p[MEDIAN9_NETWORK[k][1]]);
+            p[MEDIAN9_NETWORK[k][0]] = lo;
+            p[MEDIAN9_NETWORK[k][1]] = hi;
+        }
+        return p[4];
+    }
+    int16x8_t v = p[0];
+    for (int i = 1; i < 9; i++) {
+        v = (mode == MODE_ERODE) ? vminq_s16(v, p[i]) : vmaxq_s16(v, p[i]);
+    }
+    return v;
+}
+
+static int window_row_neon(
+    int mode,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    uint8_t *out, int width
+) {
+    int c = 2;
+    for (; c + 8 <= width; c += 8) {
+        int16x8_t a0 = load8_neon(a + c - 2), a1 = load8_neon(a + c - 1), a2 = load8_neon(a + c);
+        int16x8_t b0 = load8_neon(b + c - 2), b1 = load8_neon(b + c - 1), b2 = load8_neon(b + c);
+        int16x8_t d0 = load8_neon(d + c - 2), d1 = load8_neon(d + c - 1), d2 = load8_neon(d + c);
+        int16x8_t v;
+
+        if (mode == MODE_SOBEL) {
+            int16x8_t gx = vaddq_s16(
+                vaddq_s16(vsubq_s16(a2, a0), vsubq_s16(d2, d0)),
+                vshlq_n_s16(vsubq_s16(b2, b0), 1));
+            int16x8_t gy = vsubq_s16(smooth_neon(d0, d1, d2),
+                                     smooth_neon(a0, a1, a2));
+            v = vaddq_s16(vabsq_s16(gx), vabsq_s16(gy));
+        } else if (mode == MODE_GAUSSIAN) {
+            v = vaddq_s16(
+                vaddq_s16(smooth_neon(a0, a1, a2), smooth_neon(d0, d1, d2)),
+                vshlq_n_s16(smooth_neon(b0, b1, b2), 1));
+            v = vshrq_n_s16(v, 4);
+        } else if (is_rank_mode(mode)) {
+            int16x8_t p[9] = {a0, a1, a2, b0, b1, b2, d0, d1, d2};
+            v = rank_neon(mode, p);
+        } else {
+            v = vsubq_s16(
+                vaddq_s16(vshlq_n_s16(b1, 2), b1),
+                vaddq_s16(vaddq_s16(a1, d1), vaddq_s16(b0, b2)));
+        }
+        vst1_u8(out + c, vqmovun_s16(v));
+    }
+    return c;
+}
+
+static int point_row_neon(
+    int mode, uint8_t threshold,
+    const uint8_t *in, uint8_t *out, int width
+) {
+    const uint8x16_t t = vdupq_n_u8(threshold);
+    int c = 0;
+    for (; c + 16 <= width; c += 16) {
+        uint8x16_t p = vld1q_u8(in + c);
+        uint8x16_t v = (mode == MODE_THRESHOLD) ? vcgtq_u8(p, t) : vmvnq_u8(p);
+        vst1q_u8(out + c, v);
+    }
+    return c;
+}
+#endif // CPU_REF_NEON
+
+// ============================================
+// Instruction Set Selection
+// ============================================
+bool cpu_ref_isa_supported(cpu_isa_t isa) {
+    switch (isa) {
+        case CPU_ISA_SCALAR:
+            return true;
+#ifdef CPU_REF_X86
+        case CPU_ISA_SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case CPU_ISA_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef CPU_REF_NEON
+        case CPU_ISA_NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+cpu_isa_t cpu_ref_best_isa() {
+    if (cpu_ref_isa_supported(CPU_ISA_AVX2)) return CPU_ISA_AVX2;
+    if (cpu_ref_isa_supported(CPU_ISA_NEON)) return CPU_ISA_NEON;
+    if (cpu_ref_isa_supported(CPU_ISA_SSE41)) return CPU_ISA_SSE41;
+    return CPU_ISA_SCALAR;
+}
+
+const char *cpu_ref_isa_name(cpu_isa_t isa) {
+    switch (isa) {
+        case CPU_ISA_SCALAR: return "scalar";
+        case CPU_ISA_SSE41:  return "sse4.1";
+        case CPU_ISA_AVX2:   return "avx2";
+        case CPU_ISA_NEON:   return "neon";
+        default:             return "unknown";
+    }
+}
+
+// ============================================
+// Row Dispatch
+// ============================================
+// SIMD kernels return the first column they did not write; the
+// signed gradients have none.
+static void window_row(
+    int mode, cpu_isa_t isa,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    uint8_t *out, int width
+) {
+    int c = 2;
+    if (is_grad_mode(mode)) {
+        isa = CPU_ISA_SCALAR;
+    }
+    switch (isa) {
+#ifdef CPU_REF_X86
+        case CPU_ISA_AVX2:  c = window_row_avx2(mode, a, b, d, out, width); break;
+        case CPU_ISA_SSE41: c = window_row_sse41(mode, a, b, d, out, width); break;
+#endif
+#ifdef CPU_REF_NEON
+        case CPU_ISA_NEON:  c = window_row_neon(mode, a, b, d, out, width); break;
+#endif
+        default: break;
+    }
+    window_row_scalar(mode, a, b, d, out, c, width);
+}
+
+static void point_row(
+    int mode, uint8_t threshold, cpu_isa_t isa,
+    const uint8_t *in, uint8_t *out, int width
+) {
+    int c = 0;
+    switch (isa) {
+#ifdef CPU_REF_X86
+        case CPU_ISA_AVX2:  c = point_row_avx2(mode, threshold, in, out, width); break;
+        case CPU_ISA_SSE41: c = point_row_sse41(mode, threshold, in, out, width); break;
+#endif
+#ifdef CPU_REF_NEON
+        case CPU_ISA_NEON:  c = point_row_neon(mode, threshold, in, out, width); break;
+#endif
+        default: break;
+    }
+    point_row_scalar(mode, threshold, in, out, c, width);
+}
+
+// One row of a 3x3 window filter with its border; a and b are null
+// for the first two rows, which have no full window. Sobel and the
+// signed gradients write a black border, the others pass d through.
+static void window_mode_row(
+    int mode, cpu_isa_t isa,
+    const uint8_t *a, const uint8_t *b, const uint8_t *d,
+    uint8_t *out, int width
+) {
+    int border = (!a) ? width : (width < 2 ? width : 2);
+    if (black_border(mode)) {
+        memset(out, 0, border);
+    } else {
+        memcpy(out, d, border);
+    }
+    if (a) {
+        window_row(mode, isa, a, b, d, out, width);
+    }
+}
+
+// ============================================
+// Separable Blur (scalar)
+// ============================================
+// Same arithmetic as apply_separable_blur(): horizontal sums wrap to
+// 16 bits (uint16_t line cache), the result is bits 23..16 of the
+// vertical sum. Horizontal sums of the last K input rows are cached
+// in a ring so each row is summed once.
+static inline uint32_t blur_dot(const int *taps, int k, const uint8_t *p) {
+    int c = (k - 1) / 2;
+    uint32_t sum = taps[0] * p[c];
+    for (int i = 1; i <= c; i++) {
+        sum += taps[i] * (p[c - i] + p[c + i]);
+    }
+    return sum;
+}
+
+static void blur_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    const cpu_ref_config_t *config
+) {
+    int k = config->blur_kernel_size;
+    uint32_t coeffs = config->blur_coeffs;
+    int c = (k - 1) / 2;
+    int taps[4];
+    for (int i = 0; i <= c; i++) {
+        taps[i] = coeffs ? (int)((coeffs >> (8 * i)) & 0xFF) : BLUR_BINOMIAL[c - 1][i];
+    }
+
+    uint16_t *sums = new uint16_t[(size_t)k * width];
+    long sum_row[7];
+    for (int i = 0; i < k; i++) {
+        sum_row[i] = -1;
+    }
+
+    for (int r = row_begin; r < row_end; r++) {
+        const uint8_t *in = src + (long)r * src_stride;
+        uint8_t *out = dst + (long)r * dst_stride;
+
+        // Border: rows and columns before the first full window pass
+        // through
+        if (r < k - 1) {
+            memcpy(out, in, width);
+            continue;
+        }
+        memcpy(out, in, (width < k - 1) ? width : k - 1);
+
+        const uint16_t *h[7];
+        for (int i = 0; i < k; i++) {
+            long q = r - k + 1 + i;
+            int slot = (int)(q % k);
+            uint16_t *line = sums + (size_t)slot * width;
+            if (sum_row[slot] != q) {
+                const uint8_t *row = src + q * src_stride;
+                for (int col = k - 1; col < width; col++) {
+                    line[col] = (uint16_t)blur_dot(taps, k, row + col - k + 1);
+                }
+                sum_row[slot] = q;
+            }
+            h[i] = line;
+        }
+
+        for (int col = k - 1; col < width; col++) {
+            uint32_t v = taps[0] * h[c][col];
+            for (int i = 1; i <= c; i++) {
+                v += taps[i] * (h[c - i][col] + h[c + i][col]);
+            }
+            out[col] = (uint8_t)(v >> 16);
+        }
+    }
+    delete[] sums;
+}
+
+// ============================================
+// Programmable Convolution (scalar)
+// ============================================
+// Same as apply_conv(): a 3x3 kernel covers the newest three rows
+// and columns of the 5x5 window; the sum is shifted arithmetically,
+// biased and saturated.
+static void conv_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    const cpu_ref_config_t *config
+) {
+    uint32_t ctrl = config->conv_ctrl;
+    int size = ((ctrl >> 4) & 1) ? 5 : 3;
+    int shift = ctrl & 0xF;
+    int bias = (int16_t)(ctrl >> 16);
+    int taps[25];
+    for (int i = 0; i < size * size; i++) {
+        taps[i] = (int8_t)(config->conv_coeffs[i / 4] >> (8 * (i % 4)));
+    }
+
+    for (int r = row_begin; r < row_end; r++) {
+        const uint8_t *in = src + (long)r * src_stride;
+        uint8_t *out = dst + (long)r * dst_stride;
+
+        // Border: rows and columns before the first full window pass
+        // through
+        if (r < size - 1) {
+            memcpy(out, in, width);
+            continue;
+        }
+        memcpy(out, in, (width < size - 1) ? width : size - 1);
+
+        const uint8_t *top = src + (long)(r - size + 1) * src_stride;
+        for (int col = size - 1; col < width; col++) {
+            int sum = 0;
+            for (int i = 0; i < size; i++) {
+                const uint8_t *p = top + (long)i * src_stride + col - size + 1;
+                for (int j = 0; j < size; j++) {
+                    sum += taps[i * size + j] * p[j];
+                }
+            }
+            int value = (sum >> shift) + bias;
+            out[col] = (uint8_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+        }
+    }
+}
+
+// ============================================
+// Adaptive Threshold (scalar)
+// ============================================
+// Same test as apply_adaptive(): 255 where 25 * (centre + offset)
+// exceeds the 5x5 sum; 0 before the first full window.
+static void adaptive_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    uint8_t offset
+) {
+    for (int r = row_begin; r < row_end; r++) {
+        uint8_t *out = dst + (long)r * dst_stride;
+        if (r < 4) {
+            memset(out, 0, width);
+            continue;
+        }
+        memset(out, 0, (width < 4) ? width : 4);
+
+        const uint8_t *top = src + (long)(r - 4) * src_stride;
+        for (int col = 4; col < width; col++) {
+            int sum = 0;
+            for (int i = 0; i < 5; i++) {
+                const uint8_t *p = top + (long)i * src_stride + col - 4;
+                sum += p[0] + p[1] + p[2] + p[3] + p[4];
+            }
+            int centre = top[2L * src_stride + col - 2];
+            out[col] = (25 * (centre + offset) > sum) ? 255 : 0;
+        }
+    }
+}
+
+// ============================================
+// Lookup Table (scalar)
+// ============================================
+static void lut_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    const uint8_t *table
+) {
+    for (int r = row_begin; r < row_end; r++) {
+        const uint8_t *in = src + (long)r * src_stride;
+        uint8_t *out = dst + (long)r * dst_stride;
+        for (int c = 0; c < width; c++) {
+            out[c] = table[in[c]];
+        }
+    }
+}
+
+// ============================================
+// Canny (scalar)
+// ============================================
+// Same steps as apply_canny(): gradient, NMS class and hysteresis
+// rows each go into a ring of three rows, so output row r reads input
+// rows r-6..r. Every step is 0 where its window is not full.
+enum { CANNY_H = 0, CANNY_D45 = 1, CANNY_V = 2, CANNY_D135 = 3 };
+enum { CANNY_NONE = 0, CANNY_WEAK = 1, CANNY_STRONG = 2 };
+
+static void canny_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    uint8_t threshold_low, const cpu_ref_config_t *config
+) {
+    int high = (int)(config->threshold_high & 0xFFFF);
+    uint16_t *mag = new uint16_t[3 * (size_t)width];
+    uint8_t *dir = new uint8_t[3 * (size_t)width];
+    uint8_t *cls = new uint8_t[3 * (size_t)width];
+    int nms_begin = (row_begin < 2) ? 0 : row_begin - 2;
+
+    for (int r = (row_begin < 4) ? 0 : row_begin - 4; r < row_end; r++) {
+        // Rows r-2, r-1, r of each ring
+        size_t o0 = (size_t)((r + 1) % 3) * width;
+        size_t o1 = (size_t)((r + 2) % 3) * width;
+        size_t o2 = (size_t)(r % 3) * width;
+
+        // Gradient
+        const uint8_t *d = src + (long)r * src_stride;
+        for (int c = 0; c < width; c++) {
+            mag[o2 + c] = 0;
+            dir[o2 + c] = CANNY_H;
+            if (r < 2 || c < 2) {
+                continue;
+            }
+            const uint8_t *a = d - 2L * src_stride;
+            const uint8_t *b = d - src_stride;
+            int gx = (a[c] - a[c - 2]) + 2 * (b[c] - b[c - 2]) + (d[c] - d[c - 2]);
+            int gy = (d[c - 2] + 2 * d[c - 1] + d[c]) - (a[c - 2] + 2 * a[c - 1] + a[c]);
+            int ax = (gx < 0) ? -gx : gx;
+            int ay = (gy < 0) ? -gy : gy;
+            mag[o2 + c] = (uint16_t)(ax + ay);
+            if (ay * 128 <= ax * 53) {
+                dir[o2 + c] = CANNY_H;
+            } else if (ay * 128 >= ax * 309) {
+                dir[o2 + c] = CANNY_V;
+            } else {
+                dir[o2 + c] = ((gx < 0) == (gy < 0)) ? CANNY_D45 : CANNY_D135;
+            }
+        }
+        if (r < nms_begin) {
+            continue;
+        }
+
+        // Non-maximum suppression around (r-1, c-1)
+        const uint16_t *m0 = mag + o0, *m1 = mag + o1, *m2 = mag + o2;
+        for (int c = 0; c < width; c++) {
+            cls[o2 + c] = CANNY_NONE;
+            if (r < 2 || c < 2) {
+                continue;
+            }
+            int before, after;
+            switch (dir[o1 + c - 1]) {
+                case CANNY_H:   before = m1[c - 2]; after = m1[c];     break;
+                case CANNY_D45: before = m0[c - 2]; after = m2[c];     break;
+                case CANNY_V:   before = m0[c - 1]; after = m2[c - 1]; break;
+                default:        before = m0[c];     after = m2[c - 2]; break;
+            }
+            int centre = m1[c - 1];
+            if (centre < before || centre <= after) {
+                continue;
+            }
+            cls[o2 + c] = (centre >= high) ? CANNY_STRONG :
+                          (centre >= threshold_low) ? CANNY_WEAK : CANNY_NONE;
+        }
+        if (r < row_begin) {
+            continue;
+        }
+
+        // Hysteresis around (r-1, c-1)
+        uint8_t *out = dst + (long)r * dst_stride;
+        const uint8_t *k0 = cls + o0, *k1 = cls + o1, *k2 = cls + o2;
+        for (int c = 0; c < width; c++) {
+            out[c] = 0;
+            if (r < 2 || c < 2) {
+                continue;
+            }
+            bool strong = false;
+            for (int j = c - 2; j <= c; j++) {
+                strong |= (k0[j] == CANNY_STRONG) || (k1[j] == CANNY_STRONG) ||
+                          (k2[j] == CANNY_STRONG);
+            }
+            int centre = k1[c - 1];
+            if (centre == CANNY_STRONG || (centre == CANNY_WEAK && strong)) {
+                out[c] = 255;
+            }
+        }
+    }
+    delete[] mag;
+    delete[] dir;
+    delete[] cls;
+}
+
+// ============================================
+// Open / Close (cascaded 3x3 passes)
+// ============================================
+// Same as the filter_stage cascade: output row r needs first-pass
+// rows r-2..r, which are kept in a ring of three rows.
+static void morph_cascade_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    int filter_mode, cpu_isa_t isa
+) {
+    int first = (filter_mode == MODE_OPEN) ? MODE_ERODE : MODE_DILATE;
+    int second = (filter_mode == MODE_OPEN) ? MODE_DILATE : MODE_ERODE;
+    uint8_t *ring = new uint8_t[3 * (size_t)width];
+
+    for (int r = (row_begin < 2) ? 0 : row_begin - 2; r < row_end; r++) {
+        const uint8_t *in = src + (long)r * src_stride;
+        uint8_t *mid = ring + (size_t)(r % 3) * width;
+        bool full = (r >= 2);
+        window_mode_row(first, isa, full ? in - 2L * src_stride : 0,
+                        full ? in - src_stride : 0, in, mid, width);
+        if (r >= row_begin) {
+            window_mode_row(second, isa,
+                            full ? ring + (size_t)((r + 1) % 3) * width : 0,
+                            full ? ring + (size_t)((r + 2) % 3) * width : 0,
+                            mid, dst + (long)r * dst_stride, width);
+        }
+    }
+    delete[] ring;
+}
+
+// ============================================
+// Border Modes (scalar)
+// ============================================
+// Same rules as filter_stage() with a centred border_ctrl: the window
+// is centred on the output pixel, and each step of a filter reads
+// the taps outside the frame from the edge (replicate), mirrored
+// about it (reflect) or as the constant. Legacy borders and crop
+// filter full windows only and keep each filter's border elsewhere.
+struct border_t {
+    int mode;
+    int width;
+    int height;
+};
+
+static inline bool border_fills(int mode) {
+    return mode == CPU_REF_BORDER_REPLICATE || mode == CPU_REF_BORDER_REFLECT ||
+           mode == CPU_REF_BORDER_CONSTANT;
+}
+
+// Same as border_index()
+static inline int border_index(int pos, int size, int mode) {
+    if (mode == CPU_REF_BORDER_REFLECT) {
+        pos = (pos < 0) ? -pos : (pos >= size) ? 2 * (size - 1) - pos : pos;
+    }
+    return (pos < 0) ? 0 : (pos >= size) ? size - 1 : pos;
+}
+
+// Sample (r, c) of a plane, extended past its edges
+template<typename T>
+static inline T border_tap(const T *plane, const border_t &b, int r, int c, T constant) {
+    bool outside = r < 0 || r >= b.height || c < 0 || c >= b.width;
+    if (outside && b.mode == CPU_REF_BORDER_CONSTANT) {
+        return constant;
+    }
+    r = border_index(r, b.height, b.mode);
+    c = border_index(c, b.width, b.mode);
+    return plane[(long)r * b.width + c];
+}
+
+// 3x3 neighbourhood of (r, c): p[i][j] = (r - 1 + i, c - 1 + j)
+template<typename T>
+static inline void border_3x3(const T *plane, const border_t &b, int r, int c,
+                              T constant, T p[3][3]) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            p[i][j] = border_tap(plane, b, r - 1 + i, c - 1 + j, constant);
+        }
+    }
+}
+
+// The filling modes give every window a value; the others need it
+// inside the frame
+static inline bool border_usable(const border_t &b, int r, int c, int radius) {
+    return border_fills(b.mode) ||
+           (r >= radius && r < b.height - radius && c >= radius && c < b.width - radius);
+}
+
+// Same as stage_radius()
+static int border_radius(int filter_mode, const cpu_ref_config_t *config) {
+    switch (filter_mode) {
+        case MODE_SOBEL:
+        case MODE_GAUSSIAN:
+        case MODE_SHARPEN:
+        case MODE_MEDIAN:
+        case MODE_ERODE:
+        case MODE_DILATE:
+        case MODE_GRAD_X:
+        case MODE_GRAD_Y:
+            return 1;
+        case MODE_BLUR:
+            return (config->blur_kernel_size - 1) / 2;
+        case MODE_CONV:
+            return ((config->conv_ctrl >> 4) & 1) ? 2 : 1;
+        case MODE_OPEN:
+        case MODE_CLOSE:
+        case MODE_ADAPTIVE:
+            return 2;
+        case MODE_CANNY:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+// One centred 3x3 window filter; the Sobel and gradient borders are
+// black, the others pass the centre through
+static void border_window_pass(
+    const uint8_t *src, uint8_t *dst, const border_t &b,
+    int mode, uint8_t constant
+) {
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            uint8_t *out = dst + (long)r * b.width + c;
+            if (!border_usable(b, r, c, 1)) {
+                *out = black_border(mode) ? 0 : src[(long)r * b.width + c];
+                continue;
+            }
+            uint8_t p[3][3];
+            border_3x3(src, b, r, c, constant, p);
+            *out = window_pixel(mode, p[0], p[1], p[2], 2);
+        }
+    }
+}
+
+static void border_blur(
+    const uint8_t *src, uint8_t *dst, const border_t &b,
+    uint8_t constant, const cpu_ref_config_t *config
+) {
+    int k = config->blur_kernel_size;
+    int c0 = (k - 1) / 2;
+    int taps[4];
+    for (int i = 0; i <= c0; i++) {
+        taps[i] = config->blur_coeffs ? (int)((config->blur_coeffs >> (8 * i)) & 0xFF)
+                                      : BLUR_BINOMIAL[c0 - 1][i];
+    }
+    uint8_t row[7];
+    memset(row, constant, sizeof(row));
+    uint16_t constant_sum = (uint16_t)blur_dot(taps, k, row);
+
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            long at = (long)r * b.width + c;
+            if (!border_usable(b, r, c, c0)) {
+                dst[at] = src[at];
+                continue;
+            }
+            // Horizontal sums of the rows the vertical pass reads
+            uint16_t h[7];
+            for (int i = 0; i < k; i++) {
+                int pos = r - c0 + i;
+                if ((pos < 0 || pos >= b.height) && b.mode == CPU_REF_BORDER_CONSTANT) {
+                    h[i] = constant_sum;
+                    continue;
+                }
+                int rr = border_index(pos, b.height, b.mode);
+                for (int j = 0; j < k; j++) {
+                    row[j] = border_tap(src, b, rr, c - c0 + j, constant);
+                }
+                h[i] = (uint16_t)blur_dot(taps, k, row);
+            }
+            uint32_t v = taps[0] * h[c0];
+            for (int i = 1; i <= c0; i++) {
+                v += taps[i] * (h[c0 - i] + h[c0 + i]);
+            }
+            dst[at] = (uint8_t)(v >> 16);
+        }
+    }
+}
+
+static void border_conv(
+    const uint8_t *src, uint8_t *dst, const border_t &b,
+    uint8_t constant, const cpu_ref_config_t *config
+) {
+    uint32_t ctrl = config->conv_ctrl;
+    int size = ((ctrl >> 4) & 1) ? 5 : 3;
+    int radius = size / 2;
+    int shift = ctrl & 0xF;
+    int bias = (int16_t)(ctrl >> 16);
+    int taps[25];
+    for (int i = 0; i < size * size; i++) {
+        taps[i] = (int8_t)(config->conv_coeffs[i / 4] >> (8 * (i % 4)));
+    }
+
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            long at = (long)r * b.width + c;
+            if (!border_usable(b, r, c, radius)) {
+                dst[at] = src[at];
+                continue;
+            }
+            int sum = 0;
+            for (int i = 0; i < size; i++) {
+                for (int j = 0; j < size; j++) {
+                    sum += taps[i * size + j] *
+                           border_tap(src, b, r - radius + i, c - radius + j, constant);
+                }
+            }
+            int value = (sum >> shift) + bias;
+            dst[at] = (uint8_t)((value < 0) ? 0 : (value > 255) ? 255 : value);
+        }
+    }
+}
+
+static void border_adaptive(
+    const uint8_t *src, uint8_t *dst, const border_t &b,
+    uint8_t constant, uint8_t offset
+) {
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            long at = (long)r * b.width + c;
+            if (!border_usable(b, r, c, 2)) {
+                dst[at] = 0;
+                continue;
+            }
+            int sum = 0;
+            for (int i = -2; i <= 2; i++) {
+                for (int j = -2; j <= 2; j++) {
+                    sum += border_tap(src, b, r + i, c + j, constant);
+                }
+            }
+            dst[at] = (25 * (src[at] + offset) > sum) ? 255 : 0;
+        }
+    }
+}
+
+// Each step extends its own input: magnitudes with 0, classes with
+// CANNY_NONE
+static void border_canny(
+    const uint8_t *src, uint8_t *dst, const border_t &b,
+    uint8_t constant, uint8_t threshold_low, const cpu_ref_config_t *config
+) {
+    int high = (int)(config->threshold_high & 0xFFFF);
+    size_t frame_size = (size_t)b.width * b.height;
+    uint16_t *mag = new uint16_t[frame_size];
+    uint8_t *dir = new uint8_t[frame_size];
+    uint8_t *cls = new uint8_t[frame_size];
+
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            long at = (long)r * b.width + c;
+            mag[at] = 0;
+            dir[at] = CANNY_H;
+            if (!border_usable(b, r, c, 1)) {
+                continue;
+            }
+            uint8_t p[3][3];
+            border_3x3(src, b, r, c, constant, p);
+            int gx = (p[0][2] - p[0][0]) + 2 * (p[1][2] - p[1][0]) + (p[2][2] - p[2][0]);
+            int gy = (p[2][0] + 2 * p[2][1] + p[2][2]) - (p[0][0] + 2 * p[0][1] + p[0][2]);
+            int ax = (gx < 0) ? -gx : gx;
+            int ay = (gy < 0) ? -gy : gy;
+            mag[at] = (uint16_t)(ax + ay);
+            if (ay * 128 <= ax * 53) {
+                dir[at] = CANNY_H;
+            } else if (ay * 128 >= ax * 309) {
+                dir[at] = CANNY_V;
+            } else {
+                dir[at] = ((gx < 0) == (gy < 0)) ? CANNY_D45 : CANNY_D135;
+            }
+        }
+    }
+
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            long at = (long)r * b.width + c;
+            cls[at] = CANNY_NONE;
+            if (!border_usable(b, r, c, 1)) {
+                continue;
+            }
+            uint16_t m[3][3];
+            border_3x3(mag, b, r, c, (uint16_t)0, m);
+            int before, after;
+            switch (dir[at]) {
+                case CANNY_H:   before = m[1][0]; after = m[1][2]; break;
+                case CANNY_D45: before = m[0][0]; after = m[2][2]; break;
+                case CANNY_V:   before = m[0][1]; after = m[2][1]; break;
+                default:        before = m[0][2]; after = m[2][0]; break;
+            }
+            int centre = m[1][1];
+            if (centre < before || centre <= after) {
+                continue;
+            }
+            cls[at] = (centre >= high) ? CANNY_STRONG :
+                      (centre >= threshold_low) ? CANNY_WEAK : CANNY_NONE;
+        }
+    }
+
+    for (int r = 0; r < b.height; r++) {
+        for (int c = 0; c < b.width; c++) {
+            long at = (long)r * b.width + c;
+            dst[at] = 0;
+            if (!border_usable(b, r, c, 1)) {
+                continue;
+            }
+            uint8_t k[3][3];
+            border_3x3(cls, b, r, c, (uint8_t)CANNY_NONE, k);
+            bool strong = false;
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) {
+                    strong |= (k[i][j] == CANNY_STRONG);
+                }
+            }
+            if (k[1][1] == CANNY_STRONG || (k[1][1] == CANNY_WEAK && strong)) {
+                dst[at] = 255;
+            }
+        }
+    }
+    delete[] mag;
+    delete[] dir;
+    delete[] cls;
+}
+
+// A window filter with centred borders; crop copies the middle of
+// the full-size result to dst
+static void border_filter(
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_mode, uint8_t threshold,
+    const cpu_ref_config_t *config
+) {
+    border_t b = {(int)(config->border_ctrl & 0x7), width, height};
+    uint8_t constant = (uint8_t)(config->border_ctrl >> CPU_REF_BORDER_CONST_LSB);
+    size_t frame_size = (size_t)width * height;
+    uint8_t *out = new uint8_t[frame_size];
+
+    switch (filter_mode) {
+        case MODE_BLUR:
+            border_blur(src, out, b, constant, config);
+            break;
+        case MODE_CONV:
+            border_conv(src, out, b, constant, config);
+            break;
+        case MODE_ADAPTIVE:
+            border_adaptive(src, out, b, constant, threshold);
+            break;
+        case MODE_CANNY:
+            border_canny(src, out, b, constant, threshold, config);
+            break;
+        case MODE_OPEN:
+        case MODE_CLOSE: {
+            uint8_t *mid = new uint8_t[frame_size];
+            border_window_pass(src, mid, b, (filter_mode == MODE_OPEN) ? MODE_ERODE
+                                                                      : MODE_DILATE,
+                               constant);
+            border_window_pass(mid, out, b, (filter_mode == MODE_OPEN) ? MODE_DILATE
+                                                                      : MODE_ERODE,
+                               constant);
+            delete[] mid;
+            break;
+        }
+        default:
+            border_window_pass(src, out, b, filter_mode, constant);
+            break;
+    }
+
+    int crop = cpu_ref_border_crop(filter_mode, config);
+    int out_width = width - 2 * crop;
+    for (int r = crop; r < height - crop; r++) {
+        memcpy(dst + (long)(r - crop) * out_width, out + (long)r * width + crop,
+               out_width);
+    }
+    delete[] out;
+}
+
+// ============================================
+// Filter Passes
+// ============================================
+void cpu_ref_config_init(cpu_ref_config_t *config) {
+    memset(config, 0, sizeof(*config));
+    config->blur_kernel_size = CPU_REF_BLUR_SIZE_DEFAULT;
+    memset(config->otsu_level, CPU_REF_OTSU_RESET, sizeof(config->otsu_level));
+    for (int i = 0; i < CPU_REF_CHAIN_STAGES; i++) {
+        for (int v = 0; v < CPU_REF_LUT_ENTRIES; v++) {
+            config->equalize_lut[i][v] = (uint8_t)v;
+        }
+    }
+}
+
+void cpu_ref_stage_config(
+    const cpu_ref_config_t *config, int stage,
+    cpu_ref_config_t *stage_config
+) {
+    if (config) {
+        *stage_config = *config;
+    } else {
+        cpu_ref_config_init(stage_config);
+    }
+    stage_config->otsu_level[0] = stage_config->otsu_level[stage];
+    memcpy(stage_config->equalize_lut[0], stage_config->equalize_lut[stage],
+           CPU_REF_LUT_ENTRIES);
+}
+
+void cpu_ref_filter_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    int filter_mode, uint8_t threshold,
+    cpu_isa_t isa, const cpu_ref_config_t *config
+) {
+    cpu_ref_config_t defaults;
+    if (!config) {
+        cpu_ref_config_init(&defaults);
+        config = &defaults;
+    }
+    if (filter_mode == MODE_BLUR) {
+        blur_rows(src, src_stride, dst, dst_stride, width, row_begin, row_end, config);
+        return;
+    }
+    if (filter_mode == MODE_CONV) {
+        conv_rows(src, src_stride, dst, dst_stride, width, row_begin, row_end, config);
+        return;
+    }
+    if (filter_mode == MODE_CANNY) {
+        canny_rows(src, src_stride, dst, dst_stride, width, row_begin, row_end,
+                   threshold, config);
+        return;
+    }
+    if (filter_mode == MODE_ADAPTIVE) {
+        adaptive_rows(src, src_stride, dst, dst_stride, width, row_begin, row_end,
+                      threshold);
+        return;
+    }
+    if (filter_mode == MODE_LUT || filter_mode == MODE_EQUALIZE) {
+        lut_rows(src, src_stride, dst, dst_stride, width, row_begin, row_end,
+                 (filter_mode == MODE_LUT) ? config->lut : config->equalize_lut[0]);
+        return;
+    }
+    if (filter_mode == MODE_OTSU) {
+        // A plain threshold at the stage's learned level
+        filter_mode = MODE_THRESHOLD;
+        threshold = config->otsu_level[0];
+    }
+    if (!cpu_ref_isa_supported(isa)) {
+        isa = CPU_ISA_SCALAR;
+    }
+    if (filter_mode == MODE_OPEN || filter_mode == MODE_CLOSE) {
+        morph_cascade_rows(src, src_stride, dst, dst_stride, width,
+                           row_begin, row_end, filter_mode, isa);
+        return;
+    }
+
+    for (int r = row_begin; r < row_end; r++) {
+        const uint8_t *in = src + (long)r * src_stride;
+        uint8_t *out = dst + (long)r * dst_stride;
+
+        switch (filter_mode) {
+            case MODE_THRESHOLD:
+            case MODE_NEGATIVE:
+                point_row(filter_mode, threshold, isa, in, out, width);
+                break;
+
+            case MODE_SOBEL:
+            case MODE_GAUSSIAN:
+            case MODE_SHARPEN:
+            case MODE_MEDIAN:
+            case MODE_ERODE:
+            case MODE_DILATE:
+            case MODE_GRAD_X:
+            case MODE_GRAD_Y: {
+                bool full = (r >= 2);
+                window_mode_row(filter_mode, isa, full ? in - 2L * src_stride : 0,
+                                full ? in - src_stride : 0, in, out, width);
+                break;
+            }
+
+            default:
+                // Bypass, grayscale (luma is done on input), unknown
+                memcpy(out, in, width);
+                break;
+        }
+    }
+}
+
+void cpu_ref_filter(
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_mode, uint8_t threshold,
+    cpu_isa_t isa, const cpu_ref_config_t *config
+) {
+    bool centred = config && (config->border_ctrl & (0x7 | CPU_REF_BORDER_ALIGN));
+    if (centred && border_radius(filter_mode, config) > 0) {
+        border_filter(src, dst, width, height, filter_mode, threshold, config);
+        return;
+    }
+    cpu_ref_filter_rows(src, width, dst, width, width, 0, height,
+                        filter_mode, threshold, isa, config);
+}
+
+int cpu_ref_border_crop(int filter_mode, const cpu_ref_config_t *config) {
+    cpu_ref_config_t defaults;
+    if (!config) {
+        cpu_ref_config_init(&defaults);
+        config = &defaults;
+    }
+    bool crop = (config->border_ctrl & 0x7) == CPU_REF_BORDER_CROP;
+    return crop ? border_radius(filter_mode, config) : 0;
+}
+
+// Same stage decode as chain_stage_mode()
+static int chain_stage_mode(int filter_select, uint32_t filter_chain, int stage) {
+    if (filter_chain == 0) {
+        return (stage == 0) ? (filter_select & 0xFF) : MODE_BYPASS;
+    }
+    return (filter_chain >> (8 * stage)) & 0xFF;
+}
+
+int cpu_ref_chain_modes(
+    int filter_select, uint32_t filter_chain,
+    int modes[CPU_REF_CHAIN_STAGES], int stages[CPU_REF_CHAIN_STAGES]
+) {
+    int num_modes = 0;
+
+    // Bypass stages are no-ops
+    if (filter_chain == 0) {
+        if (stages) {
+            stages[num_modes] = 0;
+        }
+        modes[num_modes++] = filter_select & 0xFF;
+    } else {
+        for (int i = 0; i < CPU_REF_CHAIN_STAGES; i++) {
+            int mode = chain_stage_mode(filter_select, filter_chain, i);
+            if (mode != MODE_BYPASS) {
+                if (stages) {
+                    stages[num_modes] = i;
+                }
+                modes[num_modes++] = mode;
+            }
+        }
+    }
+    return num_modes;
+}
+
+void cpu_ref_filter_chain(
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_select, uint32_t filter_chain, uint8_t threshold,
+    cpu_isa_t isa, const cpu_ref_config_t *config
+) {
+    int modes[CPU_REF_CHAIN_STAGES];
+    int stages[CPU_REF_CHAIN_STAGES];
+    int num_modes = cpu_ref_chain_modes(filter_select, filter_chain, modes, stages);
+
+    size_t frame_size = (size_t)width * height;
+    if (num_modes == 0) {
+        memcpy(dst, src, frame_size);
+        return;
+    }
+
+    // Ping-pong between dst and one scratch frame so the last pass
+    // lands in dst
+    uint8_t *scratch = (num_modes > 1) ? new uint8_t[frame_size] : 0;
+    const uint8_t *in = src;
+    for (int i = 0; i < num_modes; i++) {
+        uint8_t *out = ((num_modes - 1 - i) % 2 == 0) ? dst : scratch;
+        cpu_ref_config_t stage_config;
+        cpu_ref_stage_config(config, stages[i], &stage_config);
+        cpu_ref_filter(in, out, width, height, modes[i], threshold, isa, &stage_config);
+        int crop = cpu_ref_border_crop(modes[i], &stage_config);
+        width -= 2 * crop;
+        height -= 2 * crop;
+        in = out;
+    }
+    delete[] scratch;
+}
+
+// ============================================
+// Learned State
+// ============================================
+// Same search as hist_analyze(), in the same fixed point
+uint8_t cpu_ref_otsu_level(const uint8_t *frame, size_t size) {
+    uint32_t hist[256] = {0};
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i++) {
+        hist[frame[i]]++;
+        sum += frame[i];
+    }
+
+    uint32_t total = (uint32_t)size;
+    uint8_t level = 0;
+    uint64_t best = 0;
+    uint32_t w0 = 0;
+    uint64_t s0 = 0;
+    for (int t = 0; t < 256; t++) {
+        w0 += hist[t];
+        s0 += (uint64_t)hist[t] * t;
+        uint32_t w1 = total - w0;
+        if (w0 == 0 || w1 == 0) {
+            continue;
+        }
+        uint32_t mu0 = (uint32_t)((s0 << 8) / w0);
+        uint32_t mu1 = (uint32_t)(((sum - s0) << 8) / w1);
+        uint32_t q0 = (uint32_t)(((uint64_t)w0 << 16) / total);
+        uint32_t q = q0 * (65536 - q0);
+        uint32_t d = mu1 - mu0;
+        uint64_t variance = (uint64_t)q * (d * d);
+        if (variance > best) {
+            best = variance;
+            level = (uint8_t)t;
+        }
+    }
+    return level;
+}
+
+void cpu_ref_equalize_lut(const uint8_t *frame, size_t size,
+                          uint8_t lut[CPU_REF_LUT_ENTRIES]) {
+    uint32_t hist[256] = {0};
+    for (size_t i = 0; i < size; i++) {
+        hist[frame[i]]++;
+    }
+
+    uint32_t total = (uint32_t)size;
+    uint32_t cdf = 0;
+    uint32_t cdf_min = 0;
+    for (int v = 0; v < 256; v++) {
+        cdf += hist[v];
+        if (cdf_min == 0) {
+            cdf_min = cdf;
+        }
+        uint32_t span = total - cdf_min;
+        lut[v] = (span == 0) ? (uint8_t)v
+               : (uint8_t)(((uint64_t)(cdf - cdf_min) * 255 + span / 2) / span);
+    }
+}
+
+void cpu_ref_learn_frame(
+    const uint8_t *src, int width, int height,
+    int filter_select, uint32_t filter_chain, uint8_t threshold,
+    cpu_isa_t isa, cpu_ref_config_t *config
+) {
+    size_t frame_size = (size_t)width * height;
+    uint8_t *frames[2] = { new uint8_t[frame_size], new uint8_t[frame_size] };
+    uint8_t level[CPU_REF_CHAIN_STAGES];
+    uint8_t equalize[CPU_REF_CHAIN_STAGES][CPU_REF_LUT_ENTRIES];
+    memcpy(level, config->otsu_level, sizeof(level));
+    memcpy(equalize, config->equalize_lut, sizeof(equalize));
+
+    // Otsu and equalize stages learn from their input, the others keep
+    // their state; the frame itself is filtered with the old state
+    const uint8_t *in = src;
+    int passes = 0;
+    for (int i = 0; i < CPU_REF_CHAIN_STAGES; i++) {
+        int mode = chain_stage_mode(filter_select, filter_chain, i);
+        if (mode == MODE_OTSU || mode == MODE_EQUALIZE) {
+            level[i] = cpu_ref_otsu_level(in, (size_t)width * height);
+            cpu_ref_equalize_lut(in, (size_t)width * height, equalize[i]);
+        }
+        if (mode != MODE_BYPASS) {
+            cpu_ref_config_t stage_config;
+            cpu_ref_stage_config(config, i, &stage_config);
+            uint8_t *out = frames[passes++ % 2];
+            cpu_ref_filter(in, out, width, height, mode, threshold, isa, &stage_config);
+            int crop = cpu_ref_border_crop(mode, &stage_config);
+            width -= 2 * crop;
+            height -= 2 * crop;
+            in = out;
+        }
+    }
+    memcpy(config->otsu_level, level, sizeof(level));
+    memcpy(config->equalize_lut, equalize, sizeof(equalize));
+    delete[] frames[0];
+    delete[] frames[1];
+}
+
+// ============================================
+// Scaler
+// ============================================
+// Same bins and Q16/Q8 fixed point as scale_stage()
+void cpu_ref_scale(
+    const uint8_t *src, int width, int height,
+    uint8_t *dst, int out_width, int out_height, int scale_mode
+) {
+    if (scale_mode == CPU_REF_SCALE_BOX) {
+        // Input row/column y belongs to output row y * out_height / height
+        for (int oy = 0, y0 = 0; oy < out_height; oy++) {
+            int y1 = y0;
+            while (y1 < height && (int)((int64_t)y1 * out_height / height) == oy) {
+                y1++;
+            }
+            for (int ox = 0, x0 = 0; ox < out_width; ox++) {
+                int x1 = x0;
+                while (x1 < width && (int)((int64_t)x1 * out_width / width) == ox) {
+                    x1++;
+                }
+                uint32_t sum = 0;
+                for (int y = y0; y < y1; y++) {
+                    for (int x = x0; x < x1; x++) {
+                        sum += src[y * width + x];
+                    }
+                }
+                uint32_t total = (uint32_t)((x1 - x0) * (y1 - y0));
+                dst[oy * out_width + ox] = (uint8_t)((sum + total / 2) / total);
+                x0 = x1;
+            }
+            y0 = y1;
+        }
+    } else if (scale_mode == CPU_REF_SCALE_BILINEAR) {
+        uint32_t step_x = ((uint32_t)width << 16) / out_width;
+        uint32_t step_y = ((uint32_t)height << 16) / out_height;
+        uint32_t sy = (step_y >> 1) - 32768;
+        for (int oy = 0; oy < out_height; oy++, sy += step_y) {
+            int y0 = sy >> 16;
+            uint32_t wy = (sy >> 8) & 255;
+            const uint8_t *top = src + y0 * width;
+            const uint8_t *bottom = wy ? top + width : top;
+            uint32_t sx = (step_x >> 1) - 32768;
+            for (int ox = 0; ox < out_width; ox++, sx += step_x) {
+                int x0 = sx >> 16;
+                uint32_t wx = (sx >> 8) & 255;
+                int x1 = wx ? x0 + 1 : x0;
+                uint32_t t = top[x0] * (256 - wx) + top[x1] * wx;
+                uint32_t b = bottom[x0] * (256 - wx) + bottom[x1] * wx;
+                uint32_t blend = t * (256 - wy) + b * wy;
+                dst[oy * out_width + ox] = (uint8_t)((blend + 32768) >> 16);
+            }
+        }
+    } else {
+        memcpy(dst, src, (size_t)width * height);
+    }
+}
+
+// ============================================
+// Gradient Output
+// ============================================
+// Mirrors GRAD_ORIENT_COS_Q14 and GRAD_ORIENT_SIN_Q14
+static const int GRAD_ORIENT_COS_Q14[CPU_REF_GRAD_ORIENT_BINS - 1] = {
+    15396, 12551, 8192, 2845, -2845, -8192, -12551, -15396
+};
+static const int GRAD_ORIENT_SIN_Q14[CPU_REF_GRAD_ORIENT_BINS - 1] = {
+    5604, 10531, 14189, 16135, 16135, 14189, 10531, 5604
+};
+
+// Same packing as grad_pack(); 8-bit sums never reach the 16-bit
+// saturation
+static uint64_t grad_pack(const uint8_t p[3][3]) {
+    int gx = (p[0][2] + 2 * p[1][2] + p[2][2]) - (p[0][0] + 2 * p[1][0] + p[2][0]);
+    int gy = (p[2][0] + 2 * p[2][1] + p[2][2]) - (p[0][0] + 2 * p[0][1] + p[0][2]);
+    int ax = (gx < 0) ? -gx : gx;
+    int ay = (gy < 0) ? -gy : gy;
+    int hi = (ax > ay) ? ax : ay;
+    int lo = (ax > ay) ? ay : ax;
+    uint64_t mag = (uint64_t)((123 * hi + 51 * lo + 64) >> 7);
+
+    // Fold into 0-180 degrees and count the boundaries passed
+    bool fold = (gy < 0) || (gy == 0 && gx < 0);
+    int fx = fold ? -gx : gx;
+    int fy = fold ? -gy : gy;
+    uint64_t bin = 0;
+    for (int b = 0; b < CPU_REF_GRAD_ORIENT_BINS - 1 && (gx || gy); b++) {
+        if (fy * GRAD_ORIENT_COS_Q14[b] - fx * GRAD_ORIENT_SIN_Q14[b] >= 0) {
+            bin++;
+        }
+    }
+    return (uint64_t)(uint16_t)gx | (uint64_t)(uint16_t)gy << 16 | mag << 32 | bin << 48;
+}
+
+void cpu_ref_gradient(
+    const uint8_t *src, uint64_t *dst,
+    int width, int height, const cpu_ref_config_t *config
+) {
+    uint32_t border_ctrl = config ? config->border_ctrl : 0;
+    border_t b = {(int)(border_ctrl & 0x7), width, height};
+    uint8_t constant = (uint8_t)(border_ctrl >> CPU_REF_BORDER_CONST_LSB);
+    bool centred = (border_ctrl & (0x7 | CPU_REF_BORDER_ALIGN)) != 0;
+
+    for (int r = 0; r < height; r++) {
+        for (int c = 0; c < width; c++) {
+            uint64_t *out = dst + (long)r * width + c;
+            uint8_t p[3][3];
+            if (centred) {
+                // Centred window, black where it is unusable
+                if (!border_usable(b, r, c, 1)) {
+                    *out = 0;
+                    continue;
+                }
+                border_3x3(src, b, r, c, constant, p);
+            } else {
+                // Rows r-2..r and columns c-2..c, black until full
+                if (r < 2 || c < 2) {
+                    *out = 0;
+                    continue;
+                }
+                for (int i = 0; i < 3; i++) {
+                    for (int j = 0; j < 3; j++) {
+                        p[i][j] = src[(long)(r - 2 + i) * width + c - 2 + j];
+                    }
+                }
+            }
+            *out = grad_pack(p);
+        }
+    }
+}
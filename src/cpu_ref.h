@@ -0,0 +1,195 @@
+/*
+ * Image Processing Accelerator - CPU Reference Engine
+ * Bit-exact software model of image_pros for fallback and checking
+ *
+ * Reproduces the hardware byte for byte, including its window
+ * alignment and border rules: output pixel (row, col) filters input
+ * rows row-2..row and columns col-2..col, and pixels with row < 2 or
+ * col < 2 are 0 for Sobel and the signed gradients and pass through
+ * for the other window filters. The centred border modes of
+ * border_ctrl are modelled too, on whole frames. It models the 8-bit
+ * build (PIXEL_BITS = 8) only.
+ * Kernels exist for AVX2, SSE4.1 and NEON with a scalar fallback,
+ * selected at run time; the separable blur, the programmable
+ * convolution, the signed gradients, Canny and the adaptive threshold
+ * are scalar only. No HLS headers are needed.
+ */
+
+#ifndef CPU_REF_H
+#define CPU_REF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================
+// Instruction Sets
+// ============================================
+typedef enum {
+    CPU_ISA_SCALAR = 0,
+    CPU_ISA_SSE41  = 1,
+    CPU_ISA_AVX2   = 2,
+    CPU_ISA_NEON   = 3
+} cpu_isa_t;
+
+#define CPU_ISA_COUNT 4
+
+// Fastest instruction set supported by this CPU and build
+cpu_isa_t cpu_ref_best_isa();
+bool cpu_ref_isa_supported(cpu_isa_t isa);
+const char *cpu_ref_isa_name(cpu_isa_t isa);
+
+// ============================================
+// IP Configuration
+// ============================================
+// Build options and registers behind FILTER_BLUR, FILTER_CONV and
+// FILTER_CANNY (whose low threshold is the threshold argument), the
+// FILTER_LUT table, and the Otsu levels and equalization tables the
+// stages learned from earlier frames.
+// Passing NULL means the defaults of cpu_ref_config_init().
+#define CPU_REF_BLUR_SIZE_DEFAULT 5
+#define CPU_REF_CONV_WORDS        7     // conv_coeffs is 200 bits
+#define CPU_REF_CHAIN_STAGES      4
+#define CPU_REF_OTSU_RESET        128   // OTSU_LEVEL_RESET
+#define CPU_REF_LUT_ENTRIES       256
+
+typedef struct {
+    int blur_kernel_size;                       // BLUR_KERNEL_SIZE: 3, 5 or 7
+    uint32_t blur_coeffs;                       // blur_coeffs register
+    uint32_t conv_coeffs[CPU_REF_CONV_WORDS];   // conv_coeffs, bits 31~0 first
+    uint32_t conv_ctrl;                         // conv_ctrl register
+    uint32_t threshold_high;                    // threshold_high register
+    uint32_t border_ctrl;                       // border_ctrl register
+    uint8_t lut[CPU_REF_LUT_ENTRIES];           // lut bank selected by lut_bank
+    uint8_t otsu_level[CPU_REF_CHAIN_STAGES];   // FILTER_OTSU level per stage
+    uint8_t equalize_lut[CPU_REF_CHAIN_STAGES][CPU_REF_LUT_ENTRIES];
+} cpu_ref_config_t;
+
+// Default build (blur size 5), every register and lut entry 0, Otsu
+// levels reset, identity equalization tables
+void cpu_ref_config_init(cpu_ref_config_t *config);
+
+// config for chain stage stage alone: its Otsu level and equalization
+// table move to index 0, which single passes use
+void cpu_ref_stage_config(
+    const cpu_ref_config_t *config, int stage,
+    cpu_ref_config_t *stage_config
+);
+
+// ============================================
+// Filters
+// ============================================
+// filter_mode uses the filter_mode_t values; unknown modes pass
+// through like the hardware. src and dst must not overlap.
+
+// Output rows [row_begin, row_end) of one filter pass. Reads input
+// rows row_begin-2 .. row_end-1 (row_begin-K+1 for FILTER_BLUR and
+// FILTER_CONV, row_begin-4 for FILTER_OPEN and FILTER_CLOSE,
+// row_begin-4 for FILTER_ADAPTIVE, row_begin-6 for FILTER_CANNY,
+// clamped at 0), so bands of a frame can be processed independently.
+// FILTER_OTSU thresholds at config->otsu_level[0] and FILTER_EQUALIZE
+// maps through config->equalize_lut[0].
+void cpu_ref_filter_rows(
+    const uint8_t *src, int src_stride,
+    uint8_t *dst, int dst_stride,
+    int width, int row_begin, int row_end,
+    int filter_mode, uint8_t threshold,
+    cpu_isa_t isa, const cpu_ref_config_t *config = 0
+);
+
+// Whole frame, rows packed (stride = width). A config->border_ctrl
+// other than 0 centres the windows like image_pros (scalar); with
+// CPU_REF_BORDER_CROP dst gets the frame cpu_ref_border_crop() pixels
+// smaller on each side. cpu_ref_filter_rows() always uses the
+// default borders.
+void cpu_ref_filter(
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_mode, uint8_t threshold,
+    cpu_isa_t isa, const cpu_ref_config_t *config = 0
+);
+
+// Filter modes image_pros applies for filter_select and filter_chain,
+// bypass stages dropped; returns how many were written to modes.
+// stages, if given, receives the chain stage of each mode.
+int cpu_ref_chain_modes(
+    int filter_select, uint32_t filter_chain,
+    int modes[CPU_REF_CHAIN_STAGES], int stages[CPU_REF_CHAIN_STAGES] = 0
+);
+
+// Same result as image_pros with the given filter_select and
+// filter_chain registers (one pass per non-zero chain byte); with
+// CPU_REF_BORDER_CROP every pass shrinks the frame
+void cpu_ref_filter_chain(
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_select, uint32_t filter_chain, uint8_t threshold,
+    cpu_isa_t isa, const cpu_ref_config_t *config = 0
+);
+
+// ============================================
+// Border Modes
+// ============================================
+// border_ctrl bits 2~0 (border_mode_t), bit 3 and bits 15~8
+#define CPU_REF_BORDER_LEGACY     0
+#define CPU_REF_BORDER_REPLICATE  1
+#define CPU_REF_BORDER_REFLECT    2
+#define CPU_REF_BORDER_CONSTANT   3
+#define CPU_REF_BORDER_CROP       4
+#define CPU_REF_BORDER_ALIGN      0x08
+#define CPU_REF_BORDER_CONST_LSB  8
+
+// Pixels filter_mode trims off each side under CPU_REF_BORDER_CROP
+// (its window radius), else 0
+int cpu_ref_border_crop(int filter_mode, const cpu_ref_config_t *config);
+
+// ============================================
+// Learned State
+// ============================================
+// Level FILTER_OTSU learns from one frame (0 for a frame of one value)
+uint8_t cpu_ref_otsu_level(const uint8_t *frame, size_t size);
+
+// Table FILTER_EQUALIZE learns from one frame
+void cpu_ref_equalize_lut(const uint8_t *frame, size_t size,
+                          uint8_t lut[CPU_REF_LUT_ENTRIES]);
+
+// Advances config->otsu_level and config->equalize_lut the way
+// image_pros does after a frame with these registers: each stage in
+// FILTER_OTSU or FILTER_EQUALIZE mode learns from its own input, the
+// others keep their state. Call after filtering the frame.
+void cpu_ref_learn_frame(
+    const uint8_t *src, int width, int height,
+    int filter_select, uint32_t filter_chain, uint8_t threshold,
+    cpu_isa_t isa, cpu_ref_config_t *config
+);
+
+// ============================================
+// Scaler
+// ============================================
+// scale_ctrl bits 1~0 (scale_mode_t)
+#define CPU_REF_SCALE_NONE      0
+#define CPU_REF_SCALE_BOX       1
+#define CPU_REF_SCALE_BILINEAR  2
+
+// Resizes width x height to out_width x out_height (no larger) like
+// the image_pros scaler; CPU_REF_SCALE_NONE copies the frame. Filter
+// before or after it as scale_ctrl places the scaler.
+void cpu_ref_scale(
+    const uint8_t *src, int width, int height,
+    uint8_t *dst, int out_width, int out_height, int scale_mode
+);
+
+// ============================================
+// Gradient Output
+// ============================================
+// The dst_grad beats image_pros writes with grad_enable set for an
+// output frame src of width x height: Gx, Gy, the alpha-max-beta-min
+// magnitude and the orientation bin, packed the same way, with the
+// window and border config->border_ctrl gives.
+#define CPU_REF_GRAD_ORIENT_BINS 9  // GRAD_ORIENT_BINS
+
+void cpu_ref_gradient(
+    const uint8_t *src, uint64_t *dst,
+    int width, int height, const cpu_ref_config_t *config = 0
+);
+
+#endif // CPU_REF_H
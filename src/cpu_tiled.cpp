@@ -0,0 +1,286 @@
+/*
+ * Image Processing Accelerator - Tiled CPU Fallback
+ * Work-stealing thread pool and row-band scheduling
+ */
+
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "cpu_tiled.h"
+
+// ============================================
+// Band Job
+// ============================================
+struct band_job {
+    const uint8_t *src;
+    uint8_t *dst;
+    int width;
+    int height;
+    int band_rows;
+    int filter_mode;
+    uint8_t threshold;
+    cpu_isa_t isa;
+    const cpu_ref_config_t *config;
+};
+
+static void run_band(const band_job *job, int band) {
+    int row_begin = band * job->band_rows;
+    int row_end = row_begin + job->band_rows;
+    if (row_end > job->height) {
+        row_end = job->height;
+    }
+    // Halo rows above row_begin are read from src by the row kernel;
+    // dst rows are disjoint between bands
+    cpu_ref_filter_rows(job->src, job->width, job->dst, job->width,
+                        job->width, row_begin, row_end,
+                        job->filter_mode, job->threshold, job->isa, job->config);
+}
+
+// ============================================
+// Thread Pool
+// ============================================
+struct worker_queue {
+    std::mutex lock;
+    std::deque<int> bands;
+};
+
+struct cpu_pool {
+    int num_threads;
+    std::vector<std::thread> threads;
+    std::vector<worker_queue *> queues;     // [0] is the caller's
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation;
+    int active;                             // Workers still in the job
+    bool stop;
+    const band_job *job;
+
+    std::atomic<uint64_t> steals;
+};
+
+static bool pop_own(worker_queue *q, int &band) {
+    std::lock_guard<std::mutex> guard(q->lock);
+    if (q->bands.empty()) {
+        return false;
+    }
+    band = q->bands.front();
+    q->bands.pop_front();
+    return true;
+}
+
+static bool steal(cpu_pool *pool, int self, int &band) {
+    for (int i = 1; i < pool->num_threads; i++) {
+        worker_queue *victim = pool->queues[(self + i) % pool->num_threads];
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if (!victim->bands.empty()) {
+            // Take the far end: the victim keeps its cache-warm bands
+            band = victim->bands.back();
+            victim->bands.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Work until no deque has a band left
+static void drain(cpu_pool *pool, int self, const band_job *job) {
+    int band;
+    for (;;) {
+        if (pop_own(pool->queues[self], band)) {
+            run_band(job, band);
+        } else if (steal(pool, self, band)) {
+            pool->steals.fetch_add(1, std::memory_order_relaxed);
+            run_band(job, band);
+        } else {
+            return;
+        }
+    }
+}
+
+static void worker_main(cpu_pool *pool, int self) {
+    uint64_t seen = 0;
+    for (;;) {
+        const band_job *job;
+        {
+            std::unique_lock<std::mutex> guard(pool->lock);
+            pool->wake.wait(guard, [&] {
+                return pool->stop || pool->generation != seen;
+            });
+            if (pool->stop) {
+                return;
+            }
+            seen = pool->generation;
+            job = pool->job;
+        }
+
+        drain(pool, self, job);
+
+        std::lock_guard<std::mutex> guard(pool->lock);
+        if (--pool->active == 0) {
+            pool->done.notify_one();
+        }
+    }
+}
+
+cpu_pool_t *cpu_pool_create(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
+    }
+
+    cpu_pool *pool = new cpu_pool;
+    pool->num_threads = num_threads;
+    pool->generation = 0;
+    pool->active = 0;
+    pool->stop = false;
+    pool->job = 0;
+    pool->steals = 0;
+    for (int i = 0; i < num_threads; i++) {
+        pool->queues.push_back(new worker_queue);
+    }
+    for (int i = 1; i < num_threads; i++) {
+        pool->threads.push_back(std::thread(worker_main, pool, i));
+    }
+    return pool;
+}
+
+void cpu_pool_destroy(cpu_pool_t *pool) {
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->stop = true;
+    }
+    pool->wake.notify_all();
+    for (size_t i = 0; i < pool->threads.size(); i++) {
+        pool->threads[i].join();
+    }
+    for (size_t i = 0; i < pool->queues.size(); i++) {
+        delete pool->queues[i];
+    }
+    delete pool;
+}
+
+int cpu_pool_threads(const cpu_pool_t *pool) {
+    return pool->num_threads;
+}
+
+uint64_t cpu_pool_steals(const cpu_pool_t *pool) {
+    return pool->steals.load();
+}
+
+// Seed the deques with contiguous runs of bands, then work alongside
+// the pool until every worker has left the job
+static void run_job(cpu_pool *pool, const band_job *job, int num_bands) {
+    int n = pool->num_threads;
+    for (int w = 0; w < n; w++) {
+        int first = (int)((long)num_bands * w / n);
+        int last = (int)((long)num_bands * (w + 1) / n);
+        std::lock_guard<std::mutex> guard(pool->queues[w]->lock);
+        for (int b = first; b < last; b++) {
+            pool->queues[w]->bands.push_back(b);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->job = job;
+        pool->active = n - 1;
+        pool->generation++;
+    }
+    pool->wake.notify_all();
+
+    drain(pool, 0, job);
+
+    std::unique_lock<std::mutex> guard(pool->lock);
+    pool->done.wait(guard, [&] { return pool->active == 0; });
+}
+
+// ============================================
+// Tiled Filters
+// ============================================
+// Centred borders read rows below the band and need the frame height,
+// which the row kernel does not have
+static bool centred_borders(const cpu_ref_config_t *config) {
+    return config && (config->border_ctrl & (0x7 | CPU_REF_BORDER_ALIGN));
+}
+
+void cpu_tiled_filter(
+    cpu_pool_t *pool,
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_mode, uint8_t threshold,
+    int band_rows, cpu_isa_t isa, const cpu_ref_config_t *config
+) {
+    if (height <= 0) {
+        return;
+    }
+    if (centred_borders(config)) {
+        cpu_ref_filter(src, dst, width, height, filter_mode, threshold, isa, config);
+        return;
+    }
+    if (band_rows <= 0) {
+        int bands = pool->num_threads * CPU_TILED_BANDS_PER_THREAD;
+        band_rows = (height + bands - 1) / bands;
+        if (band_rows < CPU_TILED_MIN_BAND) {
+            band_rows = CPU_TILED_MIN_BAND;
+        }
+    }
+
+    band_job job;
+    job.src = src;
+    job.dst = dst;
+    job.width = width;
+    job.height = height;
+    job.band_rows = band_rows;
+    job.filter_mode = filter_mode;
+    job.threshold = threshold;
+    job.isa = isa;
+    job.config = config;
+
+    run_job(pool, &job, (height + band_rows - 1) / band_rows);
+}
+
+void cpu_tiled_filter_chain(
+    cpu_pool_t *pool,
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_select, uint32_t filter_chain, uint8_t threshold,
+    int band_rows, cpu_isa_t isa, const cpu_ref_config_t *config
+) {
+    if (centred_borders(config)) {
+        cpu_ref_filter_chain(src, dst, width, height, filter_select, filter_chain,
+                             threshold, isa, config);
+        return;
+    }
+
+    int modes[CPU_REF_CHAIN_STAGES];
+    int stages[CPU_REF_CHAIN_STAGES];
+    int num_modes = cpu_ref_chain_modes(filter_select, filter_chain, modes, stages);
+
+    size_t frame_size = (size_t)width * height;
+    if (num_modes == 0) {
+        memcpy(dst, src, frame_size);
+        return;
+    }
+
+    // A stage's halo rows come from the previous stage's output, so
+    // each stage is a full pass; ping-pong so the last lands in dst
+    uint8_t *scratch = (num_modes > 1) ? new uint8_t[frame_size] : 0;
+    const uint8_t *in = src;
+    for (int i = 0; i < num_modes; i++) {
+        uint8_t *out = ((num_modes - 1 - i) % 2 == 0) ? dst : scratch;
+        cpu_ref_config_t stage_config;
+        cpu_ref_stage_config(config, stages[i], &stage_config);
+        cpu_tiled_filter(pool, in, out, width, height, modes[i], threshold,
+                         band_rows, isa, &stage_config);
+        in = out;
+    }
+    delete[] scratch;
+}
@@ -0,0 +1,67 @@
+/*
+ * Image Processing Accelerator - Tiled CPU Fallback
+ * Row-band scheduler on a work-stealing thread pool
+ *
+ * A frame is cut into bands of whole rows. Each band is filtered by
+ * cpu_ref_filter_rows(), which reads the KERNEL_SIZE - 1 = 2 input
+ * rows above the band as a halo (more for the separable blur, the
+ * 5x5 convolution, open/close, Canny and the adaptive threshold), so
+ * every band sees exactly the windows image_pros sees and the output
+ * is identical to the hardware for any band size and thread count.
+ * A config with centred borders (border_ctrl) runs the whole frame on
+ * the calling thread through cpu_ref_filter().
+ *
+ * Every worker owns a deque seeded with a contiguous run of bands
+ * (neighbouring bands share halo rows in cache). It pops from the
+ * front of its own deque and, once empty, steals from the back of the
+ * others. The calling thread works as worker 0.
+ */
+
+#ifndef CPU_TILED_H
+#define CPU_TILED_H
+
+#include <stdint.h>
+#include "cpu_ref.h"
+
+#define CPU_TILED_HALO_ROWS 2       // KERNEL_SIZE - 1
+#define CPU_TILED_MIN_BAND  16      // Smallest automatic band height
+#define CPU_TILED_BANDS_PER_THREAD 4
+
+typedef struct cpu_pool cpu_pool_t;
+
+// ============================================
+// Thread Pool
+// ============================================
+// num_threads counts the caller; 0 uses every hardware thread.
+cpu_pool_t *cpu_pool_create(int num_threads);
+void cpu_pool_destroy(cpu_pool_t *pool);
+int cpu_pool_threads(const cpu_pool_t *pool);
+
+// Bands taken from another worker's deque since creation
+uint64_t cpu_pool_steals(const cpu_pool_t *pool);
+
+// ============================================
+// Tiled Filters
+// ============================================
+// band_rows = 0 picks CPU_TILED_BANDS_PER_THREAD bands per thread,
+// at least CPU_TILED_MIN_BAND rows each. Blocks until the frame is
+// done; one call at a time per pool.
+void cpu_tiled_filter(
+    cpu_pool_t *pool,
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_mode, uint8_t threshold,
+    int band_rows, cpu_isa_t isa, const cpu_ref_config_t *config = 0
+);
+
+// Same result as image_pros with filter_select and filter_chain; the
+// chain stages run as consecutive tiled passes.
+void cpu_tiled_filter_chain(
+    cpu_pool_t *pool,
+    const uint8_t *src, uint8_t *dst,
+    int width, int height,
+    int filter_select, uint32_t filter_chain, uint8_t threshold,
+    int band_rows, cpu_isa_t isa, const cpu_ref_config_t *config = 0
+);
+
+#endif // CPU_TILED_H
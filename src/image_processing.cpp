@@ -5,17 +5,67 @@
  * 
  * Supported Filters:
  *   0 - Bypass (no processing)
- *   1 - Grayscale (pass-through for grayscale input)
+ *   1 - Grayscale (luma of RGB input, pass-through for grayscale)
  *   2 - Sobel Edge Detection
  *   3 - Binary Thresholding
  *   4 - Gaussian Blur (3x3)
  *   5 - Negative/Inversion
  *   6 - Sharpening
+ *   7 - Separable Gaussian/box blur (BLUR_KERNEL_SIZE = 3, 5 or 7)
+ *   8 - Programmable 3x3/5x5 convolution (conv_coeffs, conv_ctrl)
+ *   9 - Median (3x3)
+ *  10 - Erode (3x3 minimum)
+ *  11 - Dilate (3x3 maximum)
+ *  12 - Open (erode then dilate, cascaded line buffers)
+ *  13 - Close (dilate then erode, cascaded line buffers)
+ *  14 - Canny edges (gradient, non-maximum suppression, hysteresis)
+ *  15 - Adaptive threshold (5x5 local mean)
+ *  16 - Otsu threshold (level from the previous frame's histogram)
+ *  17 - Lookup table (double-buffered, written over AXI-Lite)
+ *  18 - Histogram equalization (table from the previous frame)
+ *  19 - Signed Sobel Gx (two's complement, saturated)
+ *  20 - Signed Sobel Gy (two's complement, saturated)
+ *
+ * Up to CHAIN_STAGES filters can be fused into one streaming pass
+ * through the filter_chain register (one byte per stage). The output
+ * histogram, min, max, sum and sum of squares are read back over
+ * AXI-Lite after every frame.
+ *
+ * Top functions (select one with set_top):
+ *   image_pros       - up to 640 pixels wide
+ *   image_pros_1080p - up to 1920 pixels wide
+ *   image_pros_4k    - up to 4096 pixels wide
  */
 
 #include "image_processing.h"
 #include <hls_math.h>
 
+// ============================================
+// RGB to Grayscale Conversion
+// ============================================
+// Fixed-point luma: Y = (Kr*R + Kg*G + Kb*B) / 2^(16 - PIXEL_BITS),
+// rounded, so the 8-bit channels fill the whole pixel depth
+pixel_t rgb_to_gray(
+    pixel_rgb_t rgb,
+    ap_uint<2>  input_format
+) {
+#pragma HLS INLINE
+    
+    ap_uint<8> r = rgb.range(23, 16);
+    ap_uint<8> g = rgb.range(15, 8);
+    ap_uint<8> b = rgb.range(7, 0);
+    
+    bool bt709 = (input_format == INPUT_RGB_709);
+    ap_uint<8> kr = bt709 ? LUMA_BT709[0] : LUMA_BT601[0];
+    ap_uint<8> kg = bt709 ? LUMA_BT709[1] : LUMA_BT601[1];
+    ap_uint<8> kb = bt709 ? LUMA_BT709[2] : LUMA_BT601[2];
+    
+    const int LUMA_SHIFT = 16 - PIXEL_BITS;
+    ap_uint<17> luma = r * kr + g * kg + b * kb + ((1 << LUMA_SHIFT) >> 1);
+    
+    return (pixel_t)(luma >> LUMA_SHIFT);
+}
+
 // ============================================
 // Sobel Edge Detection Filter
 // ============================================
@@ -25,8 +75,8 @@ void apply_sobel(
 ) {
 #pragma HLS INLINE
     
-    pixel_s16_t gx = 0;
-    pixel_s16_t gy = 0;
+    pixel_sum_t gx = 0;
+    pixel_sum_t gy = 0;
     
     // Apply Sobel kernels
     SOBEL_X_LOOP:
@@ -40,18 +90,49 @@ void apply_sobel(
     }
     
     // Compute gradient magnitude (approximation)
-    pixel_s16_t abs_gx = (gx < 0) ? (pixel_s16_t)(-gx) : gx;
-    pixel_s16_t abs_gy = (gy < 0) ? (pixel_s16_t)(-gy) : gy;
-    pixel_s16_t magnitude = abs_gx + abs_gy;
+    pixel_sum_t abs_gx = (gx < 0) ? (pixel_sum_t)(-gx) : gx;
+    pixel_sum_t abs_gy = (gy < 0) ? (pixel_sum_t)(-gy) : gy;
+    pixel_sum_t magnitude = abs_gx + abs_gy;
     
-    // Saturate to 8-bit
-    if (magnitude > 255) {
-        result = 255;
+    // Saturate to the pixel depth
+    if (magnitude > PIXEL_MAX) {
+        result = PIXEL_MAX;
     } else {
         result = (pixel_t)magnitude;
     }
 }
 
+// ============================================
+// Signed Sobel Gradient
+// ============================================
+// Gx (vertical = false) or Gy, saturated to GRAD_MIN..GRAD_MAX and
+// returned as its two's complement bits
+void apply_gradient(
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    bool vertical,
+    pixel_t &result
+) {
+#pragma HLS INLINE
+    
+    pixel_sum_t g = 0;
+    
+    GRADIENT_LOOP:
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+            g += window[i][j] * (vertical ? SOBEL_Y[i][j] : SOBEL_X[i][j]);
+        }
+    }
+    
+    if (g > GRAD_MAX) {
+        g = GRAD_MAX;
+    } else if (g < GRAD_MIN) {
+        g = GRAD_MIN;
+    }
+    result = g.range(PIXEL_BITS - 1, 0);
+}
+
 // ============================================
 // Gaussian Blur Filter (3x3)
 // ============================================
@@ -61,7 +142,7 @@ void apply_gaussian(
 ) {
 #pragma HLS INLINE
     
-    pixel_s16_t sum = 0;
+    pixel_sum_t sum = 0;
     
     GAUSSIAN_LOOP:
     for (int i = 0; i < KERNEL_SIZE; i++) {
@@ -85,7 +166,7 @@ void apply_sharpen(
 ) {
 #pragma HLS INLINE
     
-    pixel_s16_t sum = 0;
+    pixel_sum_t sum = 0;
     
     SHARPEN_LOOP:
     for (int i = 0; i < KERNEL_SIZE; i++) {
@@ -96,149 +177,2389 @@ void apply_sharpen(
         }
     }
     
-    // Saturate to 0-255
+    // Saturate to 0-PIXEL_MAX
     if (sum < 0) {
         result = 0;
-    } else if (sum > 255) {
-        result = 255;
+    } else if (sum > PIXEL_MAX) {
+        result = PIXEL_MAX;
     } else {
         result = (pixel_t)sum;
     }
 }
 
 // ============================================
-// Main Image Processing Function (Top-Level)
+// Median Filter (3x3 Sorting Network)
 // ============================================
-void image_pros(
-    stream_t &src,
-    stream_t &dst,
-    ap_uint<3>  filter_select,
-    ap_uint<8>  threshold_val,
-    ap_uint<16> width,
-    ap_uint<16> height
+// MEDIAN9_NETWORK is 19 compare-exchanges in 9 layers, all
+// comparators, so it pipelines at II=1 with no control flow.
+void apply_median(
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    pixel_t &result
 ) {
-    // ========================================
-    // Interface Pragmas
-    // ========================================
-#pragma HLS INTERFACE axis port=src
-#pragma HLS INTERFACE axis port=dst
-#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
-#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
-#pragma HLS INTERFACE s_axilite port=width bundle=control
-#pragma HLS INTERFACE s_axilite port=height bundle=control
-#pragma HLS INTERFACE s_axilite port=return bundle=control
+#pragma HLS INLINE
+    
+    pixel_t p[KERNEL_SIZE * KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=p complete
+    
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+            p[i * KERNEL_SIZE + j] = window[i][j];
+        }
+    }
+    
+    MEDIAN_LOOP:
+    for (int k = 0; k < 19; k++) {
+#pragma HLS UNROLL
+        pixel_t lo = p[MEDIAN9_NETWORK[k][0]];
+        pixel_t hi = p[MEDIAN9_NETWORK[k][1]];
+        if (lo > hi) {
+            p[MEDIAN9_NETWORK[k][0]] = hi;
+            p[MEDIAN9_NETWORK[k][1]] = lo;
+        }
+    }
+    
+    result = p[4];
+}
 
-    // ========================================
-    // Line Buffers for 3x3 Window
-    // ========================================
-    static pixel_t line_buffer[2][MAX_WIDTH];
-#pragma HLS ARRAY_PARTITION variable=line_buffer complete dim=1
+// ============================================
+// Erode / Dilate (3x3 Minimum / Maximum)
+// ============================================
+void apply_morph(
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    bool dilate,
+    pixel_t &result
+) {
+#pragma HLS INLINE
     
-    pixel_t window[KERNEL_SIZE][KERNEL_SIZE];
-#pragma HLS ARRAY_PARTITION variable=window complete dim=0
+    pixel_t lo = window[0][0];
+    pixel_t hi = window[0][0];
+    
+    MORPH_LOOP:
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+            lo = (window[i][j] < lo) ? window[i][j] : lo;
+            hi = (window[i][j] > hi) ? window[i][j] : hi;
+        }
+    }
+    
+    result = dilate ? hi : lo;
+}
 
-    // ========================================
-    // Process Image Row by Row
-    // ========================================
-    ROW_LOOP:
-    for (int row = 0; row < height; row++) {
-#pragma HLS LOOP_TRIPCOUNT min=480 max=480
-        
-        COL_LOOP:
-        for (int col = 0; col < width; col++) {
-#pragma HLS LOOP_TRIPCOUNT min=640 max=640
-#pragma HLS PIPELINE II=1
-            
-            // Read input pixel from stream
-            axis_pixel_t src_pixel = src.read();
-            pixel_t current_pixel = src_pixel.data;
-            
-            // Shift window columns
-            for (int i = 0; i < KERNEL_SIZE; i++) {
+// ============================================
+// Border Handling
+// ============================================
+// Replicate, reflect and constant give every tap of a centred window
+// a value; legacy borders and crop only use full windows.
+bool border_fills(ap_uint<3> border_mode) {
+#pragma HLS INLINE
+    return border_mode == BORDER_REPLICATE || border_mode == BORDER_REFLECT ||
+           border_mode == BORDER_CONSTANT;
+}
+
+// Position inside a line of size samples that position pos reads
+int border_index(int pos, int size, ap_uint<3> border_mode) {
+#pragma HLS INLINE
+    int index = pos;
+    if (border_mode == BORDER_REFLECT) {
+        index = (pos < 0) ? -pos : (pos >= size) ? 2 * (size - 1) - pos : pos;
+    }
+    // Replicate, and reflections past a line shorter than the window
+    return (index < 0) ? 0 : (index >= size) ? size - 1 : index;
+}
+
+// Tap each of the N taps centred on centre reads, and whether it lies
+// outside the line. Centres outside the frame give results that are
+// never used, so their taps are only kept in range.
+template<int N>
+void border_taps(
+    int centre,
+    int size,
+    ap_uint<3> border_mode,
+    int src[N],
+    bool outside[N]
+) {
+#pragma HLS INLINE
+    
+    const int R = (N - 1) / 2;
+    
+    BORDER_TAP_LOOP:
+    for (int i = 0; i < N; i++) {
 #pragma HLS UNROLL
-                window[i][0] = window[i][1];
-                window[i][1] = window[i][2];
-            }
-            
-            // Load new column from line buffers
-            window[0][2] = line_buffer[0][col];
-            window[1][2] = line_buffer[1][col];
-            window[2][2] = current_pixel;
-            
-            // Update line buffers
-            line_buffer[0][col] = line_buffer[1][col];
-            line_buffer[1][col] = current_pixel;
-            
-            // ====================================
-            // Apply Selected Filter
-            // ====================================
-            pixel_t output_pixel;
-            
-            // Check if we have valid 3x3 window (not at border)
-            bool valid_window = (row >= 2) && (col >= 2);
-            
-            switch (filter_select) {
-                
-                case FILTER_BYPASS:
-                    // No processing - pass through
-                    output_pixel = current_pixel;
-                    break;
-                
-                case FILTER_GRAYSCALE:
-                    // Already grayscale - pass through
-                    output_pixel = current_pixel;
-                    break;
-                
-                case FILTER_SOBEL:
-                    if (valid_window) {
-                        apply_sobel(window, output_pixel);
-                    } else {
-                        output_pixel = 0;  // Black border
-                    }
-                    break;
-                
-                case FILTER_THRESHOLD:
-                    output_pixel = (current_pixel > threshold_val) ? 255 : 0;
-                    break;
-                
-                case FILTER_GAUSSIAN:
-                    if (valid_window) {
-                        apply_gaussian(window, output_pixel);
-                    } else {
-                        output_pixel = current_pixel;
-                    }
-                    break;
-                
-                case FILTER_NEGATIVE:
-                    output_pixel = 255 - current_pixel;
-                    break;
-                
-                case FILTER_SHARPEN:
-                    if (valid_window) {
-                        apply_sharpen(window, output_pixel);
-                    } else {
-                        output_pixel = current_pixel;
-                    }
-                    break;
-                
-                default:
-                    output_pixel = current_pixel;
-                    break;
-            }
-            
-            // Write output pixel to stream
-            axis_pixel_t dst_pixel;
-            dst_pixel.data = output_pixel;
-            dst_pixel.keep = src_pixel.keep;
-            dst_pixel.strb = src_pixel.strb;
-            dst_pixel.user = src_pixel.user;
-            dst_pixel.id   = src_pixel.id;
-            dst_pixel.dest = src_pixel.dest;
-            
-            // Set TLAST at end of each row
-            dst_pixel.last = (col == width - 1) ? 1 : 0;
-            
-            dst.write(dst_pixel);
+        int pos = centre - R + i;
+        int tap = border_fills(border_mode)
+                ? border_index(pos, size, border_mode) - (centre - R) : i;
+        src[i] = (tap < 0) ? 0 : (tap >= N) ? N - 1 : tap;
+        outside[i] = (pos < 0) || (pos >= size);
+    }
+}
+
+// N x N window centred on (row, col) with the taps outside the frame
+// replaced; a plain copy for legacy borders and crop
+template<typename T, int N>
+void border_window(
+    T window[N][N],
+    T result[N][N],
+    int row,
+    int col,
+    int width,
+    int height,
+    ap_uint<3> border_mode,
+    T constant
+) {
+#pragma HLS INLINE
+    
+    int src_row[N], src_col[N];
+    bool out_row[N], out_col[N];
+    border_taps<N>(row, height, border_mode, src_row, out_row);
+    border_taps<N>(col, width, border_mode, src_col, out_col);
+    
+    BORDER_WINDOW_LOOP:
+    for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < N; j++) {
+#pragma HLS UNROLL
+            bool fill = (border_mode == BORDER_CONSTANT) && (out_row[i] || out_col[j]);
+            result[i][j] = fill ? constant : window[src_row[i]][src_col[j]];
+        }
+    }
+}
+
+// Same for a line of N taps
+template<typename T, int N>
+void border_line(
+    T line[N],
+    T result[N],
+    int centre,
+    int size,
+    ap_uint<3> border_mode,
+    T constant
+) {
+#pragma HLS INLINE
+    
+    int src[N];
+    bool outside[N];
+    border_taps<N>(centre, size, border_mode, src, outside);
+    
+    BORDER_LINE_LOOP:
+    for (int i = 0; i < N; i++) {
+#pragma HLS UNROLL
+        bool fill = (border_mode == BORDER_CONSTANT) && outside[i];
+        result[i] = fill ? constant : line[src[i]];
+    }
+}
+
+// A window of the given radius centred on (row, col) is inside the frame
+bool border_full(int row, int col, int width, int height, int radius) {
+#pragma HLS INLINE
+    return (row >= radius) && (row < height - radius) &&
+           (col >= radius) && (col < width - radius);
+}
+
+// ============================================
+// Cascaded 3x3 Window
+// ============================================
+// Pushes one value of an intermediate result into its own 3x3 window
+// and line buffers, the same way the input pixel feeds window. The
+// columns an aligned stage runs past the right edge still carry
+// results for the last columns; they live in ext.
+template<typename T, int MAX_W>
+void push_window(
+    T value,
+    int col,
+    int width,
+    T lines[KERNEL_SIZE - 1][MAX_W],
+    T ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS],
+    T window[KERNEL_SIZE][KERNEL_SIZE]
+) {
+#pragma HLS INLINE
+    
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE - 1; j++) {
+#pragma HLS UNROLL
+            window[i][j] = window[i][j + 1];
+        }
+    }
+    
+    bool in_line = (col < width);
+    int line_col = in_line ? col : 0;
+    int ext_col = in_line ? 0 : col - width;
+    T top = in_line ? lines[0][line_col] : ext[0][ext_col];
+    T mid = in_line ? lines[1][line_col] : ext[1][ext_col];
+    window[0][KERNEL_SIZE - 1] = top;
+    window[1][KERNEL_SIZE - 1] = mid;
+    window[2][KERNEL_SIZE - 1] = value;
+    if (in_line) {
+        lines[0][line_col] = mid;
+        lines[1][line_col] = value;
+    } else {
+        ext[0][ext_col] = mid;
+        ext[1][ext_col] = value;
+    }
+}
+
+// ============================================
+// Canny Edge Detector
+// ============================================
+// Sobel gradient, its magnitude and quantized direction
+void canny_gradient(
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    grad_mag_t &magnitude,
+    grad_dir_t &direction
+) {
+#pragma HLS INLINE
+    
+    pixel_sum_t gx = 0;
+    pixel_sum_t gy = 0;
+    
+    CANNY_SOBEL_LOOP:
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+            gx += window[i][j] * SOBEL_X[i][j];
+            gy += window[i][j] * SOBEL_Y[i][j];
+        }
+    }
+    
+    ap_uint<PIXEL_BITS + 2> abs_gx = (gx < 0) ? (pixel_sum_t)(-gx) : gx;
+    ap_uint<PIXEL_BITS + 2> abs_gy = (gy < 0) ? (pixel_sum_t)(-gy) : gy;
+    magnitude = abs_gx + abs_gy;
+    
+    // Compare |Gy| / |Gx| against the tangents without a divider
+    ap_uint<PIXEL_BITS + 9> gy_q7 = abs_gy * 128;
+    if (gy_q7 <= abs_gx * CANNY_TAN22_Q7) {
+        direction = CANNY_DIR_H;
+    } else if (gy_q7 >= abs_gx * CANNY_TAN67_Q7) {
+        direction = CANNY_DIR_V;
+    } else {
+        direction = ((gx < 0) == (gy < 0)) ? CANNY_DIR_D45 : CANNY_DIR_D135;
+    }
+}
+
+// The centre of the magnitude window is kept if it is a maximum
+// along its gradient direction. Ties go to the later pixel, so flat
+// ridges stay one pixel wide.
+edge_class_t canny_nms(
+    grad_mag_t mag[KERNEL_SIZE][KERNEL_SIZE],
+    grad_dir_t direction,
+    ap_uint<16> threshold_low,
+    ap_uint<32> threshold_high
+) {
+#pragma HLS INLINE
+    
+    grad_mag_t before, after;
+    switch (direction) {
+        case CANNY_DIR_H:   before = mag[1][0]; after = mag[1][2]; break;
+        case CANNY_DIR_D45: before = mag[0][0]; after = mag[2][2]; break;
+        case CANNY_DIR_V:   before = mag[0][1]; after = mag[2][1]; break;
+        default:            before = mag[0][2]; after = mag[2][0]; break;
+    }
+    
+    grad_mag_t centre = mag[1][1];
+    if (centre < before || centre <= after) {
+        return CANNY_NONE;
+    }
+    if (centre >= threshold_high) {
+        return CANNY_STRONG;
+    }
+    return (centre >= threshold_low) ? CANNY_WEAK : CANNY_NONE;
+}
+
+// Single-pass hysteresis: a weak centre is an edge when one of its
+// 8 neighbours is strong
+pixel_t canny_hysteresis(
+    edge_class_t cls[KERNEL_SIZE][KERNEL_SIZE]
+) {
+#pragma HLS INLINE
+    
+    bool strong_neighbour = false;
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+            strong_neighbour |= (cls[i][j] == CANNY_STRONG);
+        }
+    }
+    
+    bool edge = (cls[1][1] == CANNY_STRONG) ||
+                (cls[1][1] == CANNY_WEAK && strong_neighbour);
+    return edge ? PIXEL_MAX : 0;
+}
+
+// Gradient -> NMS -> hysteresis, each step a 3x3 window over the
+// previous step's output with its own line buffers, at II=1. The
+// NMS window is centred two rows and columns back and the hysteresis
+// window three; each step writes 0 where its *_valid flag is clear,
+// and the filling border modes extend the magnitudes with 0 and the
+// classes with CANNY_NONE.
+template<int MAX_W>
+void apply_canny(
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    bool gradient_valid,
+    bool nms_valid,
+    bool hysteresis_valid,
+    int row,
+    int col,
+    int width,
+    int height,
+    ap_uint<3> border_mode,
+    ap_uint<16> threshold_low,
+    ap_uint<32> threshold_high,
+    grad_mag_t mag_lines[KERNEL_SIZE - 1][MAX_W],
+    grad_mag_t mag_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS],
+    grad_mag_t mag_window[KERNEL_SIZE][KERNEL_SIZE],
+    grad_dir_t dir_lines[KERNEL_SIZE - 1][MAX_W],
+    grad_dir_t dir_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS],
+    grad_dir_t dir_window[KERNEL_SIZE][KERNEL_SIZE],
+    edge_class_t class_lines[KERNEL_SIZE - 1][MAX_W],
+    edge_class_t class_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS],
+    edge_class_t class_window[KERNEL_SIZE][KERNEL_SIZE],
+    pixel_t &result
+) {
+#pragma HLS INLINE
+    
+    grad_mag_t magnitude = 0;
+    grad_dir_t direction = CANNY_DIR_H;
+    if (gradient_valid) {
+        canny_gradient(window, magnitude, direction);
+    }
+    push_window<grad_mag_t, MAX_W>(magnitude, col, width, mag_lines, mag_ext, mag_window);
+    push_window<grad_dir_t, MAX_W>(direction, col, width, dir_lines, dir_ext, dir_window);
+    
+    grad_mag_t mag_border[KERNEL_SIZE][KERNEL_SIZE];
+    border_window<grad_mag_t, KERNEL_SIZE>(mag_window, mag_border, row - 2, col - 2,
+                                           width, height, border_mode, 0);
+    edge_class_t cls = CANNY_NONE;
+    if (nms_valid) {
+        cls = canny_nms(mag_border, dir_window[1][1], threshold_low, threshold_high);
+    }
+    push_window<edge_class_t, MAX_W>(cls, col, width, class_lines, class_ext,
+                                     class_window);
+    
+    edge_class_t class_border[KERNEL_SIZE][KERNEL_SIZE];
+    border_window<edge_class_t, KERNEL_SIZE>(class_window, class_border, row - 3,
+                                             col - 3, width, height, border_mode,
+                                             CANNY_NONE);
+    result = hysteresis_valid ? canny_hysteresis(class_border) : (pixel_t)0;
+}
+
+// ============================================
+// Separable Blur (K x K as K + K Taps)
+// ============================================
+// Runtime kernel: blur_coeffs byte i, or the binomial kernel when the
+// register is 0.
+template<int K>
+void blur_taps(
+    ap_uint<32> blur_coeffs,
+    ap_uint<8> taps[(K + 1) / 2]
+) {
+#pragma HLS INLINE
+    
+    BLUR_TAP_LOOP:
+    for (int i = 0; i < (K + 1) / 2; i++) {
+#pragma HLS UNROLL
+        taps[i] = (blur_coeffs == 0) ? (ap_uint<8>)BLUR_BINOMIAL[(K - 3) / 2][i]
+                                     : (ap_uint<8>)blur_coeffs.range(8 * i + 7, 8 * i);
+    }
+}
+
+// Symmetric 1-D dot product: mirrored samples are added first, so a
+// K-tap pass needs (K + 1) / 2 multipliers.
+template<int K, typename SAMPLE_T, typename SUM_T>
+SUM_T blur_dot(
+    SAMPLE_T samples[K],
+    ap_uint<8> taps[(K + 1) / 2]
+) {
+#pragma HLS INLINE
+    
+    const int C = (K - 1) / 2;
+    SUM_T sum = samples[C] * taps[0];
+    
+    BLUR_DOT_LOOP:
+    for (int i = 1; i <= C; i++) {
+#pragma HLS UNROLL
+        sum += (samples[C - i] + samples[C + i]) * taps[i];
+    }
+    return sum;
+}
+
+// Horizontal pass over the incoming row feeding a vertical pass over
+// the line buffer of horizontal sums. The window ends at the current
+// pixel: legacy borders take the result from row K-1, column K-1 on,
+// aligned modes as the blur centred (K-1)/2 rows and columns back.
+// constant_sum is the horizontal sum of a constant row.
+template<int K, int MAX_W>
+void apply_separable_blur(
+    pixel_t current_pixel,
+    int row,
+    int col,
+    int width,
+    int height,
+    ap_uint<3> border_mode,
+    pixel_t border_constant,
+    blur_sum_t constant_sum,
+    pixel_t row_window[K],
+    blur_sum_t sum_lines[K - 1][MAX_W],
+    blur_sum_t sum_ext[K - 1][BORDER_MAX_RADIUS],
+    ap_uint<8> taps[(K + 1) / 2],
+    pixel_t &result
+) {
+#pragma HLS INLINE
+    
+    const int R = (K - 1) / 2;
+    
+    // Horizontal pass
+    BLUR_ROW_SHIFT:
+    for (int j = 0; j < K - 1; j++) {
+#pragma HLS UNROLL
+        row_window[j] = row_window[j + 1];
+    }
+    row_window[K - 1] = current_pixel;
+    pixel_t row_taps[K];
+#pragma HLS ARRAY_PARTITION variable=row_taps complete
+    border_line<pixel_t, K>(row_window, row_taps, col - R, width, border_mode,
+                            border_constant);
+    blur_sum_t h = blur_dot<K, pixel_t, blur_sum_t>(row_taps, taps);
+    
+    // Vertical pass over the previous rows' sums
+    bool in_line = (col < width);
+    int line_col = in_line ? col : 0;
+    int ext_col = in_line ? 0 : col - width;
+    blur_sum_t column[K];
+#pragma HLS ARRAY_PARTITION variable=column complete
+    BLUR_COL_SHIFT:
+    for (int i = 0; i < K - 1; i++) {
+#pragma HLS UNROLL
+        column[i] = in_line ? sum_lines[i][line_col] : sum_ext[i][ext_col];
+    }
+    column[K - 1] = h;
+    
+    BLUR_LINE_UPDATE:
+    for (int i = 0; i < K - 1; i++) {
+#pragma HLS UNROLL
+        if (in_line) {
+            sum_lines[i][line_col] = column[i + 1];
+        } else {
+            sum_ext[i][ext_col] = column[i + 1];
         }
     }
+    
+    blur_sum_t column_taps[K];
+#pragma HLS ARRAY_PARTITION variable=column_taps complete
+    border_line<blur_sum_t, K>(column, column_taps, row - R, height, border_mode,
+                               constant_sum);
+    ap_uint<PIXEL_BITS + 16> v = blur_dot<K, blur_sum_t, ap_uint<PIXEL_BITS + 16> >(
+        column_taps, taps);
+    result = (pixel_t)(v >> 16);
+}
+
+// ============================================
+// Programmable Convolution (3x3 / 5x5)
+// ============================================
+// Unpacks conv_coeffs into a 5x5 tap grid once per frame. A 3x3
+// kernel fills the bottom-right corner (the newest rows and columns)
+// so it sees the same window as the fixed 3x3 filters, or the centre
+// when the border mode centres the window.
+void conv_taps(
+    conv_coeffs_t conv_coeffs,
+    bool size5,
+    bool centred,
+    ap_int<8> taps[CONV_MAX_SIZE][CONV_MAX_SIZE]
+) {
+#pragma HLS INLINE
+    
+    const int OFF = centred ? (CONV_MAX_SIZE - KERNEL_SIZE) / 2
+                            : CONV_MAX_SIZE - KERNEL_SIZE;
+    
+    CONV_TAP_LOOP:
+    for (int i = 0; i < CONV_MAX_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < CONV_MAX_SIZE; j++) {
+#pragma HLS UNROLL
+            int k5 = i * CONV_MAX_SIZE + j;
+            int k3 = (i - OFF) * KERNEL_SIZE + (j - OFF);
+            if (size5) {
+                taps[i][j] = (ap_int<8>)conv_coeffs.range(8 * k5 + 7, 8 * k5);
+            } else if (i >= OFF && i < OFF + KERNEL_SIZE &&
+                       j >= OFF && j < OFF + KERNEL_SIZE) {
+                taps[i][j] = (ap_int<8>)conv_coeffs.range(8 * k3 + 7, 8 * k3);
+            } else {
+                taps[i][j] = 0;
+            }
+        }
+    }
+}
+
+void apply_conv(
+    pixel_t window[CONV_MAX_SIZE][CONV_MAX_SIZE],
+    ap_int<8> taps[CONV_MAX_SIZE][CONV_MAX_SIZE],
+    ap_uint<4> shift,
+    ap_int<16> bias,
+    pixel_t &result
+) {
+#pragma HLS INLINE
+    
+    conv_sum_t sum = 0;
+    
+    CONV_LOOP:
+    for (int i = 0; i < CONV_MAX_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < CONV_MAX_SIZE; j++) {
+#pragma HLS UNROLL
+            sum += window[i][j] * taps[i][j];
+        }
+    }
+    
+    // Arithmetic shift, bias, then saturate to 0-PIXEL_MAX
+    ap_int<PIXEL_BITS + 15> value = (sum >> shift) + bias;
+    if (value < 0) {
+        result = 0;
+    } else if (value > PIXEL_MAX) {
+        result = PIXEL_MAX;
+    } else {
+        result = (pixel_t)value;
+    }
+}
+
+// ============================================
+// Per-Pixel Filter Selection
+// ============================================
+// Shared by the 1 pixel/clock kernel and every lane of the
+// multi-pixel-per-clock kernel so both produce identical output.
+pixel_t filter_pixel(
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    pixel_t current_pixel,
+    bool valid_window
+) {
+#pragma HLS INLINE
+    
+    pixel_t output_pixel;
+    
+    switch (filter_select) {
+        
+        case FILTER_BYPASS:
+            // No processing - pass through
+            output_pixel = current_pixel;
+            break;
+        
+        case FILTER_GRAYSCALE:
+            // Luma conversion happens on input - pass through
+            output_pixel = current_pixel;
+            break;
+        
+        case FILTER_SOBEL:
+            if (valid_window) {
+                apply_sobel(window, output_pixel);
+            } else {
+                output_pixel = 0;  // Black border
+            }
+            break;
+        
+        case FILTER_THRESHOLD:
+            output_pixel = (current_pixel > threshold_val) ? PIXEL_MAX : 0;
+            break;
+        
+        case FILTER_GAUSSIAN:
+            if (valid_window) {
+                apply_gaussian(window, output_pixel);
+            } else {
+                output_pixel = current_pixel;
+            }
+            break;
+        
+        case FILTER_NEGATIVE:
+            output_pixel = PIXEL_MAX - current_pixel;
+            break;
+        
+        case FILTER_SHARPEN:
+            if (valid_window) {
+                apply_sharpen(window, output_pixel);
+            } else {
+                output_pixel = current_pixel;
+            }
+            break;
+        
+        case FILTER_MEDIAN:
+            if (valid_window) {
+                apply_median(window, output_pixel);
+            } else {
+                output_pixel = current_pixel;
+            }
+            break;
+        
+        case FILTER_ERODE:
+        case FILTER_DILATE:
+            if (valid_window) {
+                apply_morph(window, filter_select == FILTER_DILATE, output_pixel);
+            } else {
+                output_pixel = current_pixel;
+            }
+            break;
+        
+        case FILTER_GRAD_X:
+        case FILTER_GRAD_Y:
+            if (valid_window) {
+                apply_gradient(window, filter_select == FILTER_GRAD_Y, output_pixel);
+            } else {
+                output_pixel = 0;  // Black border
+            }
+            break;
+        
+        default:
+            output_pixel = current_pixel;
+            break;
+    }
+    
+    return output_pixel;
+}
+
+// ============================================
+// Input Stage
+// ============================================
+// One beat from src or src_rgb (converted to luma here so every
+// filter stage sees grayscale).
+axis_pixel_t read_beat(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    ap_uint<2>  input_format
+) {
+#pragma HLS INLINE
+    
+    axis_pixel_t src_pixel;
+    if (input_format == INPUT_GRAY) {
+        src_pixel = src.read();
+    } else {
+        axis_rgb_t rgb_pixel = src_rgb.read();
+        src_pixel.data = rgb_to_gray(rgb_pixel.data, input_format);
+        src_pixel.keep = rgb_pixel.keep[0] ? -1 : 0;
+        src_pixel.strb = rgb_pixel.strb[0] ? -1 : 0;
+        src_pixel.user = rgb_pixel.user;
+        src_pixel.last = rgb_pixel.last;
+        src_pixel.id   = rgb_pixel.id;
+        src_pixel.dest = rgb_pixel.dest;
+    }
+    return src_pixel;
+}
+
+// Reads one frame of width x height pixels. Without frame_sync every
+// beat is a pixel; with it the frame is taken from the TUSER/TLAST
+// framing and repaired as described in image_processing.h.
+void read_input(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &out,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<2>  input_format,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors
+) {
+    // SOF beat that cut the previous frame short, and the error count
+    static axis_pixel_t held_sof;
+    static bool held_valid = false;
+    static frame_count_t error_count = 0;
+    
+    axis_pixel_t pad_pixel;
+    pad_pixel.data = FRAME_PAD_PIXEL;
+    pad_pixel.keep = -1;
+    pad_pixel.strb = -1;
+    pad_pixel.user = 0;
+    pad_pixel.last = 0;
+    pad_pixel.id   = 0;
+    pad_pixel.dest = 0;
+    
+    // ========================================
+    // Find Start of Frame
+    // ========================================
+    axis_pixel_t first = held_sof;
+    bool first_valid = frame_sync && held_valid;
+    held_valid = false;
+    if (frame_sync && !first_valid) {
+        bool dropped = false;
+        SOF_LOOP:
+        do {
+#pragma HLS PIPELINE II=1
+            first = read_beat(src, src_rgb, input_format);
+            dropped = dropped || !first.user;
+        } while (!first.user);
+        first_valid = true;
+        if (dropped) {
+            error_count++;
+        }
+    }
+    
+    // ========================================
+    // Frame Lines
+    // ========================================
+    bool frame_end = false;     // Early SOF seen: pad to the end
+    
+    ROW_LOOP:
+    for (int row = 0; row < height; row++) {
+#pragma HLS LOOP_TRIPCOUNT min=480 max=480
+        
+        bool line_end = false;  // TLAST seen: pad to the end of the line
+        
+        INPUT_LOOP:
+        for (int col = 0; col < width; col++) {
+#pragma HLS LOOP_TRIPCOUNT min=640 max=640
+#pragma HLS PIPELINE II=1
+            
+            axis_pixel_t src_pixel;
+            if (frame_sync && (frame_end || line_end)) {
+                src_pixel = pad_pixel;
+            } else if (first_valid) {
+                src_pixel = first;
+                first_valid = false;
+            } else {
+                src_pixel = read_beat(src, src_rgb, input_format);
+                if (frame_sync && src_pixel.user) {
+                    held_sof = src_pixel;
+                    held_valid = true;
+                    frame_end = true;
+                    error_count++;
+                    src_pixel = pad_pixel;
+                }
+            }
+            
+            if (frame_sync && !frame_end && !line_end && src_pixel.last) {
+                line_end = true;
+                if (col != width - 1) {
+                    error_count++;
+                }
+            }
+            
+            // A mid-frame SOF is never forwarded, so only TLAST needs fixing
+            if (frame_sync) {
+                src_pixel.last = (col == width - 1) ? 1 : 0;
+            }
+            
+            out.write(src_pixel);
+        }
+        
+        // Long line: drop beats up to its TLAST
+        if (frame_sync && !frame_end && !line_end) {
+            error_count++;
+            
+            EOL_LOOP:
+            while (!line_end) {
+#pragma HLS PIPELINE II=1
+                axis_pixel_t extra = read_beat(src, src_rgb, input_format);
+                if (extra.user) {
+                    held_sof = extra;
+                    held_valid = true;
+                    frame_end = true;
+                    line_end = true;
+                } else {
+                    line_end = extra.last;
+                }
+            }
+        }
+    }
+    
+    frame_errors = error_count;
+}
+
+// ============================================
+// Streaming Histogram
+// ============================================
+// Equal bins in a row of the stream are counted in a register and
+// written once the bin changes; the last bin written is forwarded, so
+// the read-modify-write of the histogram BRAM holds II=1. The
+// histogram must start cleared.
+struct hist_run_t {
+    hist_index_t value;       // Bin of the current run
+    hist_bin_t   count;       // Its count, including the run
+    hist_index_t last_value;  // Bin written most recently
+    hist_bin_t   last_count;
+};
+
+// Bin of a pixel: its top 8 bits
+hist_index_t hist_bin(pixel_t value) {
+#pragma HLS INLINE
+    return value >> PIXEL_EXTRA_BITS;
+}
+
+void hist_add(
+    hist_bin_t histogram[HIST_BINS],
+    hist_run_t &run,
+    hist_index_t value
+) {
+#pragma HLS INLINE
+    
+    if (value == run.value) {
+        run.count++;
+    } else {
+        hist_bin_t stored = (value == run.last_value) ? run.last_count : histogram[value];
+        histogram[run.value] = run.count;
+        run.last_value = run.value;
+        run.last_count = run.count;
+        run.value = value;
+        run.count = stored + 1;
+    }
+}
+
+// Writes back the open run after the last pixel
+void hist_flush(
+    hist_bin_t histogram[HIST_BINS],
+    hist_run_t &run
+) {
+#pragma HLS INLINE
+    
+    histogram[run.value] = run.count;
+}
+
+// ============================================
+// Histogram Analysis (Otsu Level, Equalization)
+// ============================================
+// Returns the level t maximising the between-class variance q0 * q1 *
+// (mu1 - mu0)^2 of the pixels <= t and > t. Weights q are in Q16 and
+// means mu in Q8, so the product fits 64 bits. A frame of one value
+// gives 0.
+// The same pass fills eq_lut, which spreads the cumulative histogram
+// above the darkest bin over 0-PIXEL_MAX (identity for a frame of one
+// bin), and clears the histogram for the next frame. sum is the sum
+// of the bins, so the level is a bin too.
+// The pass runs once between frames, so its four divisions share one
+// divider at II=4 (about 1024 cycles) instead of four at II=1.
+hist_index_t hist_analyze(
+    hist_bin_t  histogram[HIST_BINS],
+    ap_uint<32> total,
+    stats_sum_t sum,
+    pixel_t     eq_lut[LUT_ENTRIES]
+) {
+    hist_index_t level = 0;
+    ap_uint<64> best = 0;
+    hist_bin_t w0 = 0;
+    hist_bin_t cdf_min = 0;
+    stats_sum_t s0 = 0;
+    
+    ANALYZE_LOOP:
+    for (int t = 0; t < HIST_BINS; t++) {
+#pragma HLS PIPELINE II=4
+#pragma HLS ALLOCATION operation instances=udiv limit=1
+        hist_bin_t count = histogram[t];
+        histogram[t] = 0;
+        w0 += count;
+        s0 += (stats_sum_t)count * t;
+        hist_bin_t w1 = total - w0;
+        
+        if (cdf_min == 0) {
+            cdf_min = w0;
+        }
+        ap_uint<32> span = total - cdf_min;
+        eq_lut[t] = (span == 0)
+                  ? (pixel_t)((pixel_t)t << PIXEL_EXTRA_BITS)
+                  : (pixel_t)(((ap_uint<48>)(w0 - cdf_min) * PIXEL_MAX + span / 2) / span);
+        
+        if (w0 != 0 && w1 != 0) {
+            ap_uint<16> mu0 = (s0 << OTSU_MU_FRAC) / w0;
+            ap_uint<16> mu1 = ((sum - s0) << OTSU_MU_FRAC) / w1;
+            ap_uint<17> q0 = ((stats_sum_t)w0 << OTSU_Q_FRAC) / total;
+            ap_uint<32> q = q0 * ((1 << OTSU_Q_FRAC) - q0);
+            ap_uint<16> d = mu1 - mu0;
+            ap_uint<64> variance = q * (ap_uint<32>)(d * d);
+            if (variance > best) {
+                best = variance;
+                level = t;
+            }
+        }
+    }
+    return level;
+}
+
+// ============================================
+// Adaptive Threshold
+// ============================================
+// Centre above the 5x5 mean minus offset, tested as
+// 25 * (centre + offset) > sum so no divider is needed
+pixel_t apply_adaptive(
+    pixel_t window[CONV_MAX_SIZE][CONV_MAX_SIZE],
+    ap_uint<16> offset
+) {
+#pragma HLS INLINE
+    
+    ap_uint<PIXEL_BITS + 5> sum = 0;
+    ADAPTIVE_LOOP:
+    for (int i = 0; i < CONV_MAX_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < CONV_MAX_SIZE; j++) {
+#pragma HLS UNROLL
+            sum += window[i][j];
+        }
+    }
+    
+    pixel_t centre = window[CONV_MAX_SIZE / 2][CONV_MAX_SIZE / 2];
+    ap_uint<22> scaled = ADAPTIVE_TAPS * (centre + offset);
+    return (scaled > sum) ? PIXEL_MAX : 0;
+}
+
+// ============================================
+// Scaler
+// ============================================
+// Bilinear blend of the 2x2 neighbourhood (top/bottom row, left/right
+// column) with Q8 weights wx, wy
+pixel_t bilinear_pixel(
+    pixel_t top_left, pixel_t top_right,
+    pixel_t bottom_left, pixel_t bottom_right,
+    ap_uint<9> wx, ap_uint<9> wy
+) {
+#pragma HLS INLINE
+    
+    const int one = 1 << SCALE_WEIGHT_FRAC;
+    ap_uint<PIXEL_BITS + 9> top = top_left * (one - wx) + top_right * wx;
+    ap_uint<PIXEL_BITS + 9> bottom = bottom_left * (one - wx) + bottom_right * wx;
+    ap_uint<PIXEL_BITS + 18> blend = top * (one - wy) + bottom * wy;
+    return (blend + (1 << (2 * SCALE_WEIGHT_FRAC - 1))) >> (2 * SCALE_WEIGHT_FRAC);
+}
+
+// Reciprocal of a box pixel count: recip = 2^shift / count rounded
+// down, with shift = PIXEL_BITS + bits(count), so recip fits
+// PIXEL_BITS + 2 bits. Runs once per frame per count.
+void box_reciprocal(
+    box_count_t count,
+    box_recip_t &recip,
+    box_shift_t &shift
+) {
+#pragma HLS INLINE
+    
+    int bits = 0;
+    BOX_BITS_LOOP:
+    for (int i = 0; i < BOX_COUNT_BITS; i++) {
+#pragma HLS UNROLL
+        if (count[i]) {
+            bits = i + 1;
+        }
+    }
+    shift = PIXEL_BITS + bits;
+    recip = ((ap_uint<PIXEL_BITS + BOX_COUNT_BITS + 1>)1 << shift) / count;
+}
+
+// sum / count for sum < count << PIXEL_BITS. The reciprocal estimate
+// is exact or one low (sum < 2^shift), and one compare corrects it.
+pixel_t box_divide(
+    box_sum_t   sum,
+    box_count_t count,
+    box_recip_t recip,
+    box_shift_t shift
+) {
+#pragma HLS INLINE
+    
+    ap_uint<PIXEL_BITS + 1> q = (sum * recip) >> shift;
+    box_sum_t rest = sum - q * count;
+    return (rest >= count) ? (pixel_t)(q + 1) : (pixel_t)q;
+}
+
+// Resizes a width x height frame to out_width x out_height. Output
+// pixel (X, Y) leaves with the last input beat it depends on, so the
+// stage runs at the input rate; SCALE_NONE copies the frame.
+template<int MAX_W>
+void scale_stage(
+    stream_t &in,
+    stream_t &out,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<2>  scale_mode
+) {
+    if (scale_mode == SCALE_NONE) {
+        SCALE_COPY_LOOP:
+        for (int i = 0; i < width * height; i++) {
+#pragma HLS LOOP_TRIPCOUNT min=307200 max=307200
+#pragma HLS PIPELINE II=1
+            out.write(in.read());
+        }
+        return;
+    }
+    
+    bool box = (scale_mode == SCALE_BOX);
+    
+    // Box: column sums of the output row being built, and the phase
+    // of y * out_height / height
+    box_sum_t box_acc[MAX_W];
+    ap_uint<16> box_rows = 0;
+    ap_uint<16> y_phase = 0;
+    
+    // Box: the four pixel counts, [taller][wider] than the narrow
+    // bins, and their reciprocals
+    ap_uint<16> bin_w = width / out_width;
+    ap_uint<16> bin_h = height / out_height;
+    box_count_t box_count[2][2];
+    box_recip_t box_recip[2][2];
+    box_shift_t box_shift[2][2];
+#pragma HLS ARRAY_PARTITION variable=box_count complete dim=0
+#pragma HLS ARRAY_PARTITION variable=box_recip complete dim=0
+#pragma HLS ARRAY_PARTITION variable=box_shift complete dim=0
+    BOX_RECIP_LOOP:
+    for (int i = 0; i < 4; i++) {
+        box_count[i / 2][i % 2] = (bin_w + i % 2) * (bin_h + i / 2);
+        box_reciprocal(box_count[i / 2][i % 2], box_recip[i / 2][i % 2],
+                       box_shift[i / 2][i % 2]);
+    }
+    
+    // Bilinear: previous input row and the Q16 source row
+    pixel_t prev_line[MAX_W];
+    scale_pos_t step_x = ((scale_pos_t)width << SCALE_POS_FRAC) / out_width;
+    scale_pos_t step_y = ((scale_pos_t)height << SCALE_POS_FRAC) / out_height;
+    scale_pos_t sy = (step_y >> 1) - (1 << (SCALE_POS_FRAC - 1));
+    
+    ap_uint<16> out_row = 0;
+    
+    SCALE_ROW_LOOP:
+    for (int row = 0; row < height; row++) {
+#pragma HLS LOOP_TRIPCOUNT min=480 max=480
+        
+        // Rows that finish an output row
+        bool box_row_end = (y_phase + out_height >= height);
+        ap_uint<16> iy = sy >> SCALE_POS_FRAC;
+        ap_uint<9> wy = sy.range(SCALE_POS_FRAC - 1, SCALE_POS_FRAC - SCALE_WEIGHT_FRAC);
+        bool row_emit = box ? box_row_end
+                            : (out_row < out_height && row == iy + (wy != 0));
+        
+        scale_pos_t sx = (step_x >> 1) - (1 << (SCALE_POS_FRAC - 1));
+        ap_uint<16> x_phase = 0;
+        box_sum_t h_sum = 0;
+        ap_uint<16> h_count = 0;
+        ap_uint<16> out_col = 0;
+        pixel_t prev_pixel = 0;
+        pixel_t prev_above = 0;
+        
+        SCALE_COL_LOOP:
+        for (int col = 0; col < width; col++) {
+#pragma HLS LOOP_TRIPCOUNT min=MAX_W max=MAX_W
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=box_acc inter false
+            
+            axis_pixel_t src_pixel = in.read();
+            pixel_t pixel = src_pixel.data;
+            pixel_t above = prev_line[col];
+            prev_line[col] = pixel;
+            
+            bool col_emit;
+            pixel_t value;
+            if (box) {
+                // Close the column bin on its last input pixel
+                h_sum += pixel;
+                h_count++;
+                col_emit = (x_phase + out_width >= width);
+                x_phase = col_emit ? (ap_uint<16>)(x_phase + out_width - width)
+                                   : (ap_uint<16>)(x_phase + out_width);
+                
+                // Rounded mean; only the last pixel of a box is emitted,
+                // when the counts are a full bin's
+                bool tall = (box_rows + 1 > bin_h);
+                bool wide = (h_count > bin_w);
+                box_count_t total = box_count[tall][wide];
+                box_sum_t acc = h_sum + ((box_rows == 0) ? (box_sum_t)0 : box_acc[out_col]);
+                value = box_divide(acc + total / 2, total, box_recip[tall][wide],
+                                   box_shift[tall][wide]);
+                if (col_emit) {
+                    box_acc[out_col] = acc;
+                    h_sum = 0;
+                    h_count = 0;
+                }
+            } else {
+                // Emit where the right column arrives (or the left one,
+                // for a zero weight)
+                ap_uint<16> ix = sx >> SCALE_POS_FRAC;
+                ap_uint<9> wx = sx.range(SCALE_POS_FRAC - 1,
+                                         SCALE_POS_FRAC - SCALE_WEIGHT_FRAC);
+                col_emit = (out_col < out_width && col == ix + (wx != 0));
+                
+                pixel_t left = (wx != 0) ? prev_pixel : pixel;
+                pixel_t top_left = (wy != 0) ? ((wx != 0) ? prev_above : above) : left;
+                pixel_t top_right = (wy != 0) ? above : pixel;
+                value = bilinear_pixel(top_left, top_right, left, pixel, wx, wy);
+                if (col_emit) {
+                    sx += step_x;
+                }
+            }
+            prev_pixel = pixel;
+            prev_above = above;
+            
+            if (row_emit && col_emit) {
+                axis_pixel_t dst_pixel = src_pixel;
+                dst_pixel.data = value;
+                dst_pixel.user = (out_row == 0 && out_col == 0) ? 1 : 0;
+                dst_pixel.last = (out_col == out_width - 1) ? 1 : 0;
+                out.write(dst_pixel);
+            }
+            if (col_emit) {
+                out_col++;
+            }
+        }
+        
+        box_rows = box_row_end ? (ap_uint<16>)0 : (ap_uint<16>)(box_rows + 1);
+        y_phase = box_row_end ? (ap_uint<16>)(y_phase + out_height - height)
+                              : (ap_uint<16>)(y_phase + out_height);
+        if (row_emit) {
+            out_row++;
+            sy += step_y;
+        }
+    }
+}
+
+// ============================================
+// Frame Statistics
+// ============================================
+// Forwards the last stage's output to dst and accumulates the frame
+// statistics on the way.
+void frame_stats(
+    stream_t &in,
+    stream_t &dst,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq
+) {
+    HIST_CLEAR_LOOP:
+    for (int i = 0; i < HIST_BINS; i++) {
+#pragma HLS PIPELINE II=1
+        histogram[i] = 0;
+    }
+    
+    pixel_t lo = PIXEL_MAX;
+    pixel_t hi = 0;
+    stats_sum_t sum = 0;
+    stats_sum_t sum_sq = 0;
+    
+    hist_run_t run = {0, 0, 0, 0};
+    
+    STATS_LOOP:
+    for (int i = 0; i < width * height; i++) {
+#pragma HLS LOOP_TRIPCOUNT min=307200 max=307200
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=histogram inter false
+        
+        axis_pixel_t pixel = in.read();
+        pixel_t value = pixel.data;
+        hist_add(histogram, run, hist_bin(value));
+        
+        lo = (value < lo) ? value : lo;
+        hi = (value > hi) ? value : hi;
+        sum += value;
+        sum_sq += (ap_uint<2 * PIXEL_BITS>)(value * value);
+        
+        dst.write(pixel);
+    }
+    hist_flush(histogram, run);
+    
+    stats_min = lo;
+    stats_max = hi;
+    stats_sum = sum;
+    stats_sum_sq = sum_sq;
+}
+
+// ============================================
+// Gradient Output
+// ============================================
+// Sobel sum saturated to the 16-bit fields of dst_grad
+ap_int<16> grad_field(pixel_sum_t g) {
+#pragma HLS INLINE
+    return (g > 32767) ? (ap_int<16>)32767 : (g < -32768) ? (ap_int<16>)-32768
+                                                          : (ap_int<16>)g;
+}
+
+// Orientation bin of (gx, gy) folded into 0-180 degrees: the number
+// of boundaries the vector lies at or past, each a cross product sign
+ap_uint<8> grad_orient(pixel_sum_t gx, pixel_sum_t gy) {
+#pragma HLS INLINE
+    
+    bool fold = (gy < 0) || (gy == 0 && gx < 0);
+    pixel_sum_t fx = fold ? (pixel_sum_t)(-gx) : gx;
+    pixel_sum_t fy = fold ? (pixel_sum_t)(-gy) : gy;
+    
+    ap_uint<8> bin = 0;
+    GRAD_ORIENT_LOOP:
+    for (int b = 0; b < GRAD_ORIENT_BINS - 1; b++) {
+#pragma HLS UNROLL
+        ap_int<PIXEL_BITS + 18> side = fy * GRAD_ORIENT_COS_Q14[b] -
+                                       fx * GRAD_ORIENT_SIN_Q14[b];
+        if (side >= 0) {
+            bin++;
+        }
+    }
+    return (gx == 0 && gy == 0) ? (ap_uint<8>)0 : bin;
+}
+
+// Gx, Gy, magnitude and orientation of a 3x3 window, packed as the
+// dst_grad beat lays them out
+ap_uint<64> grad_pack(pixel_t window[KERNEL_SIZE][KERNEL_SIZE]) {
+#pragma HLS INLINE
+    
+    pixel_sum_t gx = 0;
+    pixel_sum_t gy = 0;
+    
+    GRAD_PACK_LOOP:
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+        for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+            gx += window[i][j] * SOBEL_X[i][j];
+            gy += window[i][j] * SOBEL_Y[i][j];
+        }
+    }
+    
+    // Alpha-max-beta-min on the unsaturated sums
+    grad_mag_t abs_gx = (gx < 0) ? (grad_mag_t)(-gx) : (grad_mag_t)gx;
+    grad_mag_t abs_gy = (gy < 0) ? (grad_mag_t)(-gy) : (grad_mag_t)gy;
+    grad_mag_t hi = (abs_gx > abs_gy) ? abs_gx : abs_gy;
+    grad_mag_t lo = (abs_gx > abs_gy) ? abs_gy : abs_gx;
+    ap_uint<PIXEL_BITS + 10> mag = (GRAD_MAG_ALPHA_Q7 * hi + GRAD_MAG_BETA_Q7 * lo + 64)
+                                   >> 7;
+    
+    ap_uint<64> word = 0;
+    word.range(15, 0) = grad_field(gx);
+    word.range(31, 16) = grad_field(gy);
+    word.range(47, 32) = (mag > 65535) ? (ap_uint<16>)65535 : (ap_uint<16>)mag;
+    word.range(55, 48) = grad_orient(gx, gy);
+    return word;
+}
+
+// Forwards the output frame to the ROI crop and, with grad_enable,
+// writes the packed gradient of each of its pixels to dst_grad. The
+// window follows border_ctrl like a Sobel stage; aligned, the beat
+// for (row - 1, col - 1) leaves with (row, col), so the loop then
+// runs one row and column past the frame.
+template<int MAX_W>
+void grad_stage(
+    stream_t &in,
+    stream_t &out,
+    stream_grad_t &dst_grad,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+) {
+    ap_uint<3> border_mode = border_ctrl.range(BORDER_CTRL_MODE_MSB, 0);
+    pixel_t border_constant = (pixel_t)border_ctrl.range(15, BORDER_CTRL_CONST_LSB)
+                              << PIXEL_EXTRA_BITS;
+    bool aligned = (border_mode != BORDER_LEGACY) || border_ctrl[BORDER_CTRL_ALIGN_BIT];
+    int delay = (aligned && grad_enable) ? 1 : 0;
+    
+    pixel_t lines[KERNEL_SIZE - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=lines complete dim=1
+    pixel_t ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS];
+#pragma HLS ARRAY_PARTITION variable=ext complete dim=0
+    
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=window complete dim=0
+    
+    GRAD_ROW_LOOP:
+    for (int row = 0; row < height + delay; row++) {
+#pragma HLS LOOP_TRIPCOUNT min=480 max=481
+        
+        GRAD_COL_LOOP:
+        for (int col = 0; col < width + delay; col++) {
+#pragma HLS LOOP_TRIPCOUNT min=MAX_W max=MAX_W+1
+#pragma HLS PIPELINE II=1
+            
+            pixel_t value = 0;
+            if (col < width && row < height) {
+                axis_pixel_t pixel = in.read();
+                value = pixel.data;
+                out.write(pixel);
+            }
+            push_window<pixel_t, MAX_W>(value, col, width, lines, ext, window);
+            
+            pixel_t window_b[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=window_b complete dim=0
+            border_window<pixel_t, KERNEL_SIZE>(window, window_b, row - 1, col - 1,
+                                                width, height, border_mode,
+                                                border_constant);
+            bool valid = aligned ? border_fills(border_mode) ||
+                                   border_full(row - 1, col - 1, width, height, 1)
+                                 : (row >= 2) && (col >= 2);
+            
+            int out_row = row - delay;
+            int out_col = col - delay;
+            if (grad_enable && out_row >= 0 && out_col >= 0) {
+                axis_grad_t beat;
+                beat.data = valid ? grad_pack(window_b) : (ap_uint<64>)0;
+                beat.keep = -1;
+                beat.strb = -1;
+                beat.user = (out_row == 0) && (out_col == 0);
+                beat.last = (out_col == width - 1) ? 1 : 0;
+                beat.id   = 0;
+                beat.dest = 0;
+                dst_grad.write(beat);
+            }
+        }
+    }
+}
+
+// ============================================
+// Region of Interest Crop
+// ============================================
+// Field f (0 = x, 1 = y, 2 = width, 3 = height) of region r
+ap_uint<16> roi_field(roi_rects_t roi_rects, int r, int f) {
+#pragma HLS INLINE
+    return (ap_uint<16>)roi_rects.range(64 * r + 16 * f + 15, 64 * r + 16 * f);
+}
+
+// Passes only the pixels inside the active regions to dst, tagged
+// with the region index. It sits behind the statistics tap, so both
+// the filters and the statistics still see the whole frame.
+void roi_crop(
+    stream_t &in,
+    stream_t &dst,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects
+) {
+    ap_uint<16> roi_x[ROI_MAX];
+    ap_uint<16> roi_y[ROI_MAX];
+    ap_uint<16> roi_w[ROI_MAX];
+    ap_uint<16> roi_h[ROI_MAX];
+#pragma HLS ARRAY_PARTITION variable=roi_x complete
+#pragma HLS ARRAY_PARTITION variable=roi_y complete
+#pragma HLS ARRAY_PARTITION variable=roi_w complete
+#pragma HLS ARRAY_PARTITION variable=roi_h complete
+    
+    ROI_UNPACK_LOOP:
+    for (int r = 0; r < ROI_MAX; r++) {
+#pragma HLS UNROLL
+        roi_x[r] = roi_field(roi_rects, r, 0);
+        roi_y[r] = roi_field(roi_rects, r, 1);
+        roi_w[r] = roi_field(roi_rects, r, 2);
+        roi_h[r] = roi_field(roi_rects, r, 3);
+    }
+    
+    ROI_ROW_LOOP:
+    for (int row = 0; row < height; row++) {
+#pragma HLS LOOP_TRIPCOUNT min=480 max=480
+        
+        // Regions crossing this row; only the column test is left
+        // per pixel
+        bool row_hit[ROI_MAX];
+#pragma HLS ARRAY_PARTITION variable=row_hit complete
+        for (int r = 0; r < ROI_MAX; r++) {
+#pragma HLS UNROLL
+            row_hit[r] = (r < roi_count) && row >= roi_y[r] &&
+                         row < roi_y[r] + roi_h[r];
+        }
+        
+        ROI_COL_LOOP:
+        for (int col = 0; col < width; col++) {
+#pragma HLS LOOP_TRIPCOUNT min=640 max=640
+#pragma HLS PIPELINE II=1
+            
+            axis_pixel_t pixel = in.read();
+            
+            bool hit = false;
+            ap_uint<ROI_TAG_BITS> tag = 0;
+            ROI_MATCH_LOOP:
+            for (int r = 0; r < ROI_MAX; r++) {
+#pragma HLS UNROLL
+                if (row_hit[r] && col >= roi_x[r] && col < roi_x[r] + roi_w[r]) {
+                    hit = true;
+                    tag = r;
+                }
+            }
+            
+            if (roi_count == 0) {
+                dst.write(pixel);
+            } else if (hit) {
+                pixel.id = tag;
+                pixel.dest = tag;
+                pixel.user = (row == roi_y[tag] && col == roi_x[tag]) ? 1 : 0;
+                pixel.last = (col == roi_x[tag] + roi_w[tag] - 1) ? 1 : 0;
+                dst.write(pixel);
+            }
+        }
+    }
+}
+
+// ============================================
+// Chain Stage Mode
+// ============================================
+// filter_chain == 0 runs filter_select alone; otherwise byte i of
+// filter_chain is the mode of stage i (0 = bypass).
+ap_uint<8> chain_stage_mode(
+    ap_uint<8>  filter_select,
+    ap_uint<32> filter_chain,
+    int stage
+) {
+#pragma HLS INLINE
+    
+    if (filter_chain == 0) {
+        return (stage == 0) ? (ap_uint<8>)filter_select : (ap_uint<8>)FILTER_BYPASS;
+    }
+    return filter_chain.range(8 * stage + 7, 8 * stage);
+}
+
+// ============================================
+// Stage Radius and Delay
+// ============================================
+// Rows and columns a mode's window reaches past its centre
+int stage_radius(ap_uint<8> filter_mode, ap_uint<32> conv_ctrl, int blur_k) {
+#pragma HLS INLINE
+    switch (filter_mode) {
+        case FILTER_SOBEL:
+        case FILTER_GAUSSIAN:
+        case FILTER_SHARPEN:
+        case FILTER_MEDIAN:
+        case FILTER_ERODE:
+        case FILTER_DILATE:
+        case FILTER_GRAD_X:
+        case FILTER_GRAD_Y:
+            return 1;
+        case FILTER_BLUR:
+            return (blur_k - 1) / 2;
+        case FILTER_CONV:
+            return conv_ctrl[CONV_CTRL_SIZE5_BIT] ? 2 : 1;
+        case FILTER_OPEN:
+        case FILTER_CLOSE:
+        case FILTER_ADAPTIVE:
+            return 2;
+        case FILTER_CANNY:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+// Rows and columns a centred result trails the input: the radius,
+// except that the 3x3 convolution sits in the middle of the 5x5 window
+int stage_delay(ap_uint<8> filter_mode, ap_uint<32> conv_ctrl, int blur_k) {
+#pragma HLS INLINE
+    return (filter_mode == FILTER_CONV) ? CONV_MAX_SIZE / 2
+                                        : stage_radius(filter_mode, conv_ctrl, blur_k);
+}
+
+// Pixels BORDER_CROP trims off each side of the frame in stages
+// 0..stages-1
+int chain_border_crop(
+    ap_uint<8>  filter_select,
+    ap_uint<32> filter_chain,
+    ap_uint<32> conv_ctrl,
+    ap_uint<16> border_ctrl,
+    int stages
+) {
+#pragma HLS INLINE
+    
+    int crop = 0;
+    CROP_STAGE_LOOP:
+    for (int stage = 0; stage < CHAIN_STAGES; stage++) {
+#pragma HLS UNROLL
+        ap_uint<8> mode = chain_stage_mode(filter_select, filter_chain, stage);
+        if (stage < stages) {
+            crop += stage_radius(mode, conv_ctrl, BLUR_KERNEL_SIZE);
+        }
+    }
+    bool cropped = (border_ctrl.range(BORDER_CTRL_MODE_MSB, 0) == BORDER_CROP);
+    return cropped ? crop : 0;
+}
+
+// ============================================
+// Filter Stage (5x5 Window + Filter Switch)
+// ============================================
+// Each stage owns its line buffers, so cascaded stages see the
+// previous stage's output exactly as a separate frame pass would.
+// width and height are the chain input; with BORDER_CROP the stage
+// gets the frame the earlier stages left.
+template<int MAX_W, int STAGE, int BLUR_K>
+void filter_stage(
+    stream_t &in,
+    stream_t &out,
+    ap_uint<8>  filter_select,
+    ap_uint<32> filter_chain,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    ap_uint<16> border_ctrl,
+    lut_stream_t &lut_in
+) {
+    static_assert(BLUR_K == 3 || BLUR_K == 5 || BLUR_K == 7,
+                  "BLUR_KERNEL_SIZE must be 3, 5 or 7");
+    static_assert(PIXEL_BITS == 8 || PIXEL_BITS == 10 || PIXEL_BITS == 12 ||
+                  PIXEL_BITS == 16, "PIXEL_BITS must be 8, 10, 12 or 16");
+    
+    ap_uint<8> filter_mode = chain_stage_mode(filter_select, filter_chain, STAGE);
+    
+    // ========================================
+    // Border Handling
+    // ========================================
+    // Aligned modes emit the result centred delay rows and columns
+    // back, so the loop runs delay rows and columns past the frame
+    ap_uint<3> border_mode = border_ctrl.range(BORDER_CTRL_MODE_MSB, 0);
+    pixel_t border_constant = (pixel_t)border_ctrl.range(15, BORDER_CTRL_CONST_LSB)
+                              << PIXEL_EXTRA_BITS;
+    bool aligned = (border_mode != BORDER_LEGACY) || border_ctrl[BORDER_CTRL_ALIGN_BIT];
+    bool border_fill = border_fills(border_mode);
+    int delay = aligned ? stage_delay(filter_mode, conv_ctrl, BLUR_K) : 0;
+    int crop = (border_mode == BORDER_CROP) ? stage_radius(filter_mode, conv_ctrl, BLUR_K)
+                                            : 0;
+    int crop_before = chain_border_crop(filter_select, filter_chain, conv_ctrl,
+                                        border_ctrl, STAGE);
+    int in_width = width - 2 * crop_before;
+    int in_height = height - 2 * crop_before;
+    
+    // ========================================
+    // Line Buffers for 5x5 Window
+    // ========================================
+    // The 3x3 filters use the bottom-right corner of the window
+    pixel_t line_buffer[CONV_MAX_SIZE - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=line_buffer complete dim=1
+    
+    pixel_t conv_window[CONV_MAX_SIZE][CONV_MAX_SIZE];
+#pragma HLS ARRAY_PARTITION variable=conv_window complete dim=0
+    
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=window complete dim=0
+    
+    // ========================================
+    // Programmable Convolution State
+    // ========================================
+    bool conv_size5 = conv_ctrl[CONV_CTRL_SIZE5_BIT];
+    int conv_size = conv_size5 ? CONV_MAX_SIZE : KERNEL_SIZE;
+    ap_uint<4> conv_shift = conv_ctrl.range(CONV_CTRL_SHIFT_MSB, 0);
+    ap_int<16> conv_bias = conv_ctrl.range(31, CONV_CTRL_BIAS_LSB);
+    
+    ap_int<8> conv_tap[CONV_MAX_SIZE][CONV_MAX_SIZE];
+#pragma HLS ARRAY_PARTITION variable=conv_tap complete dim=0
+    conv_taps(conv_coeffs, conv_size5, aligned, conv_tap);
+    
+    // ========================================
+    // Separable Blur State
+    // ========================================
+    ap_uint<8> blur_tap[(BLUR_K + 1) / 2];
+#pragma HLS ARRAY_PARTITION variable=blur_tap complete
+    blur_taps<BLUR_K>(blur_coeffs, blur_tap);
+    
+    blur_sum_t blur_lines[BLUR_K - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=blur_lines complete dim=1
+    blur_sum_t blur_ext[BLUR_K - 1][BORDER_MAX_RADIUS];
+#pragma HLS ARRAY_PARTITION variable=blur_ext complete dim=0
+    
+    pixel_t blur_row[BLUR_K];
+#pragma HLS ARRAY_PARTITION variable=blur_row complete
+    
+    pixel_t blur_const_row[BLUR_K];
+#pragma HLS ARRAY_PARTITION variable=blur_const_row complete
+    for (int j = 0; j < BLUR_K; j++) {
+#pragma HLS UNROLL
+        blur_const_row[j] = border_constant;
+    }
+    blur_sum_t blur_const_sum = blur_dot<BLUR_K, pixel_t, blur_sum_t>(blur_const_row,
+                                                                      blur_tap);
+    
+    // ========================================
+    // Open / Close Cascade
+    // ========================================
+    // The first operation's output feeds a second 3x3 window over its
+    // own line buffers, so open/close is one pass
+    bool morph_close = (filter_mode == FILTER_CLOSE);
+    
+    pixel_t morph_lines[KERNEL_SIZE - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=morph_lines complete dim=1
+    pixel_t morph_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS];
+#pragma HLS ARRAY_PARTITION variable=morph_ext complete dim=0
+    
+    pixel_t morph_window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=morph_window complete dim=0
+    
+    // ========================================
+    // Canny State
+    // ========================================
+    // Gradient (magnitude + direction) and NMS class line buffers
+    grad_mag_t canny_mag_lines[KERNEL_SIZE - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=canny_mag_lines complete dim=1
+    grad_dir_t canny_dir_lines[KERNEL_SIZE - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=canny_dir_lines complete dim=1
+    edge_class_t canny_class_lines[KERNEL_SIZE - 1][MAX_W];
+#pragma HLS ARRAY_PARTITION variable=canny_class_lines complete dim=1
+    
+    // Results for the columns past the right edge (aligned modes)
+    grad_mag_t canny_mag_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS];
+#pragma HLS ARRAY_PARTITION variable=canny_mag_ext complete dim=0
+    grad_dir_t canny_dir_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS];
+#pragma HLS ARRAY_PARTITION variable=canny_dir_ext complete dim=0
+    edge_class_t canny_class_ext[KERNEL_SIZE - 1][BORDER_MAX_RADIUS];
+#pragma HLS ARRAY_PARTITION variable=canny_class_ext complete dim=0
+    
+    grad_mag_t canny_mag_window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=canny_mag_window complete dim=0
+    grad_dir_t canny_dir_window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=canny_dir_window complete dim=0
+    edge_class_t canny_class_window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=canny_class_window complete dim=0
+    
+    // ========================================
+    // Learned State (Otsu, Equalization)
+    // ========================================
+    // Histogram of this stage's input, kept between frames with the
+    // level (a bin) and table it gave. Only an Otsu or equalize stage
+    // gathers it and runs the analysis; the others keep their state.
+    bool learn = (filter_mode == FILTER_OTSU) || (filter_mode == FILTER_EQUALIZE);
+    static hist_bin_t input_hist[HIST_BINS];
+    static hist_index_t otsu_threshold = OTSU_LEVEL_RESET;
+    static pixel_t eq_lut[LUT_ENTRIES];
+    static bool eq_ready = false;
+    hist_run_t input_run = {0, 0, 0, 0};
+    stats_sum_t input_sum = 0;
+    
+    // ========================================
+    // Lookup Table
+    // ========================================
+    // This frame's copy of the selected lut bank
+    pixel_t lut_active[LUT_ENTRIES];
+    if (filter_mode == FILTER_LUT) {
+        LUT_LOAD_LOOP:
+        for (int i = 0; i < LUT_ENTRIES; i++) {
+#pragma HLS PIPELINE II=1
+            lut_active[i] = lut_in.read();
+        }
+    }
+
+    // ========================================
+    // Process Image Row by Row
+    // ========================================
+    ROW_LOOP:
+    for (int row = 0; row < in_height + delay; row++) {
+#pragma HLS LOOP_TRIPCOUNT min=480 max=483
+        
+        COL_LOOP:
+        for (int col = 0; col < in_width + delay; col++) {
+#pragma HLS LOOP_TRIPCOUNT min=MAX_W max=MAX_W+3
+#pragma HLS PIPELINE II=1
+#pragma HLS DEPENDENCE variable=input_hist inter false
+            
+            // Read input pixel from stream; the rows and columns past
+            // the frame have none and only ever reach replaced taps
+            bool in_line = (col < in_width);
+            bool in_frame = in_line && (row < in_height);
+            int line_col = in_line ? col : 0;
+            
+            axis_pixel_t src_pixel;
+            pixel_t current_pixel = 0;
+            if (in_frame) {
+                src_pixel = in.read();
+                current_pixel = src_pixel.data;
+                
+                if (learn) {
+                    hist_add(input_hist, input_run, hist_bin(current_pixel));
+                    input_sum += hist_bin(current_pixel);
+                }
+            }
+            
+            // Shift window columns
+            for (int i = 0; i < CONV_MAX_SIZE; i++) {
+#pragma HLS UNROLL
+                for (int j = 0; j < CONV_MAX_SIZE - 1; j++) {
+#pragma HLS UNROLL
+                    conv_window[i][j] = conv_window[i][j + 1];
+                }
+            }
+            
+            // Load new column from line buffers
+            for (int i = 0; i < CONV_MAX_SIZE - 1; i++) {
+#pragma HLS UNROLL
+                conv_window[i][CONV_MAX_SIZE - 1] = line_buffer[i][line_col];
+            }
+            conv_window[CONV_MAX_SIZE - 1][CONV_MAX_SIZE - 1] = current_pixel;
+            
+            // Update line buffers
+            if (in_line) {
+                for (int i = 0; i < CONV_MAX_SIZE - 2; i++) {
+#pragma HLS UNROLL
+                    line_buffer[i][col] = line_buffer[i + 1][col];
+                }
+                line_buffer[CONV_MAX_SIZE - 2][col] = current_pixel;
+            }
+            
+            // 3x3 window: newest rows and columns
+            for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+                for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+                    window[i][j] = conv_window[i + CONV_MAX_SIZE - KERNEL_SIZE]
+                                              [j + CONV_MAX_SIZE - KERNEL_SIZE];
+                }
+            }
+            
+            // ====================================
+            // Border Windows
+            // ====================================
+            // Legacy windows are valid once full, at the current
+            // pixel. Aligned windows are judged at their centre: the
+            // filling modes replace the taps outside the frame, legacy
+            // and crop need the whole window inside it.
+            pixel_t window_b[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=window_b complete dim=0
+            border_window<pixel_t, KERNEL_SIZE>(window, window_b, row - 1, col - 1,
+                                                in_width, in_height, border_mode,
+                                                border_constant);
+            pixel_t conv_b[CONV_MAX_SIZE][CONV_MAX_SIZE];
+#pragma HLS ARRAY_PARTITION variable=conv_b complete dim=0
+            border_window<pixel_t, CONV_MAX_SIZE>(conv_window, conv_b, row - 2, col - 2,
+                                                  in_width, in_height, border_mode,
+                                                  border_constant);
+            
+            const int BLUR_R = (BLUR_K - 1) / 2;
+            bool valid_window, valid_conv, valid_blur, valid_adaptive;
+            bool valid_second, valid_third;
+            if (aligned) {
+                valid_window = border_fill ||
+                               border_full(row - 1, col - 1, in_width, in_height, 1);
+                valid_conv = border_fill ||
+                             border_full(row - 2, col - 2, in_width, in_height,
+                                         conv_size / 2);
+                valid_blur = border_fill ||
+                             border_full(row - BLUR_R, col - BLUR_R, in_width,
+                                         in_height, BLUR_R);
+                valid_adaptive = border_fill ||
+                                 border_full(row - 2, col - 2, in_width, in_height, 2);
+                valid_second = border_fill ||
+                               border_full(row - 2, col - 2, in_width, in_height, 1);
+                valid_third = border_fill ||
+                              border_full(row - 3, col - 3, in_width, in_height, 1);
+            } else {
+                valid_window = (row >= 2) && (col >= 2);
+                valid_conv = (row >= conv_size - 1) && (col >= conv_size - 1);
+                valid_blur = (row >= BLUR_K - 1) && (col >= BLUR_K - 1);
+                valid_adaptive = (row >= CONV_MAX_SIZE - 1) && (col >= CONV_MAX_SIZE - 1);
+                valid_second = valid_window;
+                valid_third = valid_window;
+            }
+            
+            // Input pixel under the result, for the pass-through borders
+            pixel_t centre_pixel = aligned
+                ? conv_window[CONV_MAX_SIZE - 1 - delay][CONV_MAX_SIZE - 1 - delay]
+                : current_pixel;
+            pixel_t window_centre = aligned ? window[1][1] : current_pixel;
+            
+            // ====================================
+            // Apply Selected Filter
+            // ====================================
+            pixel_t output_pixel = filter_pixel(
+                filter_mode, threshold_val,
+                window_b, centre_pixel, valid_window);
+            
+            // K x K blur window; borders pass through like Gaussian
+            pixel_t blur_pixel;
+            apply_separable_blur<BLUR_K, MAX_W>(current_pixel, row, col, in_width,
+                                                in_height, border_mode, border_constant,
+                                                blur_const_sum, blur_row, blur_lines,
+                                                blur_ext, blur_tap, blur_pixel);
+            if (filter_mode == FILTER_BLUR && valid_blur) {
+                output_pixel = blur_pixel;
+            }
+            
+            // Programmable kernel; borders pass through
+            pixel_t conv_pixel;
+            apply_conv(conv_b, conv_tap, conv_shift, conv_bias, conv_pixel);
+            if (filter_mode == FILTER_CONV && valid_conv) {
+                output_pixel = conv_pixel;
+            }
+            
+            // Open: erode then dilate; close: dilate then erode.
+            // Both passes leave their borders unchanged.
+            pixel_t morph_first;
+            apply_morph(window_b, morph_close, morph_first);
+            if (!valid_window) {
+                morph_first = window_centre;
+            }
+            
+            push_window<pixel_t, MAX_W>(morph_first, col, in_width, morph_lines,
+                                        morph_ext, morph_window);
+            
+            pixel_t morph_b[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=morph_b complete dim=0
+            border_window<pixel_t, KERNEL_SIZE>(morph_window, morph_b, row - 2, col - 2,
+                                                in_width, in_height, border_mode,
+                                                border_constant);
+            pixel_t morph_second;
+            apply_morph(morph_b, !morph_close, morph_second);
+            if (filter_mode == FILTER_OPEN || filter_mode == FILTER_CLOSE) {
+                pixel_t morph_border = aligned ? morph_window[1][1] : morph_first;
+                output_pixel = valid_second ? morph_second : morph_border;
+            }
+            
+            // Canny; black border like Sobel
+            pixel_t canny_pixel;
+            apply_canny<MAX_W>(window_b, valid_window, valid_second, valid_third,
+                               row, col, in_width, in_height, border_mode,
+                               threshold_val, threshold_high,
+                               canny_mag_lines, canny_mag_ext, canny_mag_window,
+                               canny_dir_lines, canny_dir_ext, canny_dir_window,
+                               canny_class_lines, canny_class_ext, canny_class_window,
+                               canny_pixel);
+            if (filter_mode == FILTER_CANNY) {
+                output_pixel = canny_pixel;
+            }
+            
+            // Automatic thresholds; the adaptive border is black
+            if (filter_mode == FILTER_ADAPTIVE) {
+                output_pixel = valid_adaptive ? apply_adaptive(conv_b, threshold_val)
+                                              : (pixel_t)0;
+            }
+            if (filter_mode == FILTER_OTSU) {
+                output_pixel = (hist_bin(current_pixel) > otsu_threshold) ? PIXEL_MAX : 0;
+            }
+            
+            // Point-wise tables
+            if (filter_mode == FILTER_LUT) {
+                output_pixel = lut_active[hist_bin(current_pixel)];
+            }
+            if (filter_mode == FILTER_EQUALIZE) {
+                output_pixel = eq_ready ? eq_lut[hist_bin(current_pixel)] : current_pixel;
+            }
+            
+            // ====================================
+            // Write Output Pixel
+            // ====================================
+            // The result belongs to (row - delay, col - delay); crop
+            // keeps the pixels whose window fits the frame
+            int out_row = row - delay;
+            int out_col = col - delay;
+            bool emit = (out_row >= crop) && (out_row < in_height - crop) &&
+                        (out_col >= crop) && (out_col < in_width - crop);
+            if (emit) {
+                axis_pixel_t dst_pixel;
+                dst_pixel.data = output_pixel;
+                if (aligned) {
+                    dst_pixel.keep = -1;
+                    dst_pixel.strb = -1;
+                    dst_pixel.user = (out_row == crop) && (out_col == crop);
+                    dst_pixel.id   = 0;
+                    dst_pixel.dest = 0;
+                } else {
+                    dst_pixel.keep = src_pixel.keep;
+                    dst_pixel.strb = src_pixel.strb;
+                    dst_pixel.user = src_pixel.user;
+                    dst_pixel.id   = src_pixel.id;
+                    dst_pixel.dest = src_pixel.dest;
+                }
+                
+                // Set TLAST at end of each row
+                dst_pixel.last = (out_col == in_width - crop - 1) ? 1 : 0;
+                
+                out.write(dst_pixel);
+            }
+        }
+    }
+    
+    // Level and table for the next frame
+    if (learn) {
+        hist_flush(input_hist, input_run);
+        otsu_threshold = hist_analyze(input_hist, in_width * in_height, input_sum,
+                                      eq_lut);
+        eq_ready = true;
+    }
+}
+
+// ============================================
+// LUT Latch
+// ============================================
+// Copies the selected bank to every FILTER_LUT stage when the frame
+// starts; the AXI-Lite table has a single reader in the DATAFLOW
+// region and the stages keep their own copy.
+void lut_latch(
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<8>  filter_select,
+    ap_uint<32> filter_chain,
+    lut_stream_t lut_stream[CHAIN_STAGES]
+) {
+    LUT_LATCH_LOOP:
+    for (int i = 0; i < LUT_ENTRIES; i++) {
+#pragma HLS PIPELINE II=1
+        pixel_t entry = lut[lut_bank * LUT_ENTRIES + i];
+        for (int stage = 0; stage < CHAIN_STAGES; stage++) {
+#pragma HLS UNROLL
+            if (chain_stage_mode(filter_select, filter_chain, stage) == FILTER_LUT) {
+                lut_stream[stage].write(entry);
+            }
+        }
+    }
+}
+
+// ============================================
+// Filter Chain (DATAFLOW Pipeline)
+// ============================================
+// Input conversion, CHAIN_STAGES filter stages, the statistics tap,
+// the gradient output and the ROI crop run concurrently; a full
+// Gaussian -> Sobel -> Threshold chain costs one pass plus a line and
+// a pixel of latency per stage.
+template<int MAX_W>
+void image_pros_dataflow(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<16> chain_width,
+    ap_uint<16> chain_height,
+    ap_uint<16> chain_out_width,
+    ap_uint<16> chain_out_height,
+    ap_uint<16> dst_width,
+    ap_uint<16> dst_height,
+    ap_uint<2>  pre_scale,
+    ap_uint<2>  post_scale,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+) {
+#pragma HLS DATAFLOW
+    
+    stream_t input_stream;
+#pragma HLS STREAM variable=input_stream depth=2
+    stream_t stage_stream[CHAIN_STAGES + 1];
+#pragma HLS STREAM variable=stage_stream depth=2
+    stream_t output_stream;
+#pragma HLS STREAM variable=output_stream depth=2
+    stream_t grad_stream;
+#pragma HLS STREAM variable=grad_stream depth=2
+    stream_t roi_stream;
+#pragma HLS STREAM variable=roi_stream depth=2
+    lut_stream_t lut_stream[CHAIN_STAGES];
+#pragma HLS STREAM variable=lut_stream depth=2
+    
+    lut_latch(lut, lut_bank, filter_select, filter_chain, lut_stream);
+    read_input(src, src_rgb, input_stream, width, height, input_format,
+               frame_sync, frame_errors);
+    scale_stage<MAX_W>(input_stream, stage_stream[0], width, height,
+                       chain_width, chain_height, pre_scale);
+    
+    filter_stage<MAX_W, 0, BLUR_KERNEL_SIZE>(stage_stream[0], stage_stream[1],
+                                             filter_select, filter_chain, threshold_val,
+                                             chain_width, chain_height, blur_coeffs,
+                                             conv_coeffs, conv_ctrl, threshold_high,
+                                             border_ctrl, lut_stream[0]);
+    filter_stage<MAX_W, 1, BLUR_KERNEL_SIZE>(stage_stream[1], stage_stream[2],
+                                             filter_select, filter_chain, threshold_val,
+                                             chain_width, chain_height, blur_coeffs,
+                                             conv_coeffs, conv_ctrl, threshold_high,
+                                             border_ctrl, lut_stream[1]);
+    filter_stage<MAX_W, 2, BLUR_KERNEL_SIZE>(stage_stream[2], stage_stream[3],
+                                             filter_select, filter_chain, threshold_val,
+                                             chain_width, chain_height, blur_coeffs,
+                                             conv_coeffs, conv_ctrl, threshold_high,
+                                             border_ctrl, lut_stream[2]);
+    filter_stage<MAX_W, 3, BLUR_KERNEL_SIZE>(stage_stream[3], stage_stream[4],
+                                             filter_select, filter_chain, threshold_val,
+                                             chain_width, chain_height, blur_coeffs,
+                                             conv_coeffs, conv_ctrl, threshold_high,
+                                             border_ctrl, lut_stream[3]);
+    
+    scale_stage<MAX_W>(stage_stream[4], output_stream, chain_out_width,
+                       chain_out_height, dst_width, dst_height, post_scale);
+    
+    frame_stats(output_stream, grad_stream, dst_width, dst_height, histogram,
+                stats_min, stats_max, stats_sum, stats_sum_sq);
+    
+    grad_stage<MAX_W>(grad_stream, roi_stream, dst_grad, dst_width, dst_height,
+                      border_ctrl, grad_enable);
+    
+    roi_crop(roi_stream, dst, dst_width, dst_height, roi_count, roi_rects);
+}
+
+// ============================================
+// Main Image Processing Function (Templated Core)
+// ============================================
+// MAX_W sizes the line buffers; each top-level profile below
+// instantiates it once so the BRAM matches the sensor width.
+template<int MAX_W>
+void image_pros_core(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+) {
+#pragma HLS INLINE off
+
+    // ========================================
+    // Validate Frame Size
+    // ========================================
+    // A width beyond the line buffers would wrap the column index and
+    // corrupt the window, so reject the frame without touching the
+    // streams and let software reconfigure.
+    if (width > MAX_W) {
+        status = STATUS_ERR_WIDTH;
+        return;
+    }
+    
+    // ========================================
+    // Scaler Placement
+    // ========================================
+    ap_uint<2> scale_mode = scale_ctrl.range(SCALE_CTRL_MODE_MSB, 0);
+    bool scale_after = scale_ctrl[SCALE_CTRL_AFTER_BIT];
+    if (scale_mode != SCALE_NONE &&
+        (scale_mode > SCALE_BILINEAR || out_width == 0 || out_width > width ||
+         out_height == 0 || out_height > height)) {
+        status = STATUS_ERR_SCALE;
+        return;
+    }
+    
+    bool scaled = (scale_mode != SCALE_NONE);
+    bool pre_scaled = scaled && !scale_after;
+    ap_uint<16> chain_width = pre_scaled ? out_width : width;
+    ap_uint<16> chain_height = pre_scaled ? out_height : height;
+    ap_uint<2> pre_scale = scale_after ? (ap_uint<2>)SCALE_NONE : scale_mode;
+    ap_uint<2> post_scale = scale_after ? scale_mode : (ap_uint<2>)SCALE_NONE;
+    
+    // ========================================
+    // Validate Border Handling
+    // ========================================
+    // BORDER_CROP trims every stage's radius off each side; at least
+    // one pixel must be left, and a scaler behind the chain can only
+    // shrink what is.
+    int border_crop = chain_border_crop(filter_select, filter_chain, conv_ctrl,
+                                        border_ctrl, CHAIN_STAGES);
+    if (border_ctrl.range(BORDER_CTRL_MODE_MSB, 0) > BORDER_CROP ||
+        2 * border_crop >= chain_width || 2 * border_crop >= chain_height) {
+        status = STATUS_ERR_BORDER;
+        return;
+    }
+    
+    ap_uint<16> chain_out_width = chain_width - 2 * border_crop;
+    ap_uint<16> chain_out_height = chain_height - 2 * border_crop;
+    if (scaled && scale_after &&
+        (out_width > chain_out_width || out_height > chain_out_height)) {
+        status = STATUS_ERR_SCALE;
+        return;
+    }
+    ap_uint<16> dst_width = (scaled && scale_after) ? out_width : chain_out_width;
+    ap_uint<16> dst_height = (scaled && scale_after) ? out_height : chain_out_height;
+    
+    // ========================================
+    // Validate Regions of Interest
+    // ========================================
+    // Each region must be non-empty and inside the output frame, and
+    // no two may overlap, so every output pixel has one tag and each
+    // region's lines end in TLAST.
+    bool roi_ok = (roi_count <= ROI_MAX);
+    ROI_CHECK_LOOP:
+    for (int r = 0; r < ROI_MAX; r++) {
+#pragma HLS UNROLL
+        ap_uint<17> x0 = roi_field(roi_rects, r, 0);
+        ap_uint<17> y0 = roi_field(roi_rects, r, 1);
+        ap_uint<17> x1 = x0 + roi_field(roi_rects, r, 2);
+        ap_uint<17> y1 = y0 + roi_field(roi_rects, r, 3);
+        if (r < roi_count &&
+            (x1 == x0 || y1 == y0 || x1 > dst_width || y1 > dst_height)) {
+            roi_ok = false;
+        }
+        for (int q = 0; q < r; q++) {
+#pragma HLS UNROLL
+            ap_uint<17> qx0 = roi_field(roi_rects, q, 0);
+            ap_uint<17> qy0 = roi_field(roi_rects, q, 1);
+            ap_uint<17> qx1 = qx0 + roi_field(roi_rects, q, 2);
+            ap_uint<17> qy1 = qy0 + roi_field(roi_rects, q, 3);
+            if (r < roi_count && x0 < qx1 && qx0 < x1 && y0 < qy1 && qy0 < y1) {
+                roi_ok = false;
+            }
+        }
+    }
+    if (!roi_ok) {
+        status = STATUS_ERR_ROI;
+        return;
+    }
+    status = STATUS_OK;
+
+    image_pros_dataflow<MAX_W>(src, src_rgb, dst, dst_grad, filter_select, threshold_val,
+                               width, height, chain_width, chain_height,
+                               chain_out_width, chain_out_height,
+                               dst_width, dst_height, pre_scale, post_scale,
+                               input_format, filter_chain, blur_coeffs,
+                               conv_coeffs, conv_ctrl, threshold_high, histogram,
+                               stats_min, stats_max, stats_sum, stats_sum_sq,
+                               lut, lut_bank, frame_sync, frame_errors, roi_count,
+                               roi_rects, border_ctrl, grad_enable);
+}
+
+// ============================================
+// Top-Level Profiles (to be exported as IP)
+// ============================================
+// 640-pixel (VGA) profile
+void image_pros(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+) {
+#pragma HLS INTERFACE axis port=src
+#pragma HLS INTERFACE axis port=src_rgb
+#pragma HLS INTERFACE axis port=dst
+#pragma HLS INTERFACE axis port=dst_grad
+#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
+#pragma HLS INTERFACE s_axilite port=width bundle=control
+#pragma HLS INTERFACE s_axilite port=height bundle=control
+#pragma HLS INTERFACE s_axilite port=status bundle=control
+#pragma HLS INTERFACE s_axilite port=input_format bundle=control
+#pragma HLS INTERFACE s_axilite port=filter_chain bundle=control
+#pragma HLS INTERFACE s_axilite port=blur_coeffs bundle=control
+#pragma HLS INTERFACE s_axilite port=conv_coeffs bundle=control
+#pragma HLS INTERFACE s_axilite port=conv_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_high bundle=control
+#pragma HLS INTERFACE s_axilite port=histogram bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_min bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_max bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_sum bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_sum_sq bundle=control
+#pragma HLS INTERFACE s_axilite port=lut bundle=control
+#pragma HLS INTERFACE s_axilite port=lut_bank bundle=control
+#pragma HLS INTERFACE s_axilite port=frame_sync bundle=control
+#pragma HLS INTERFACE s_axilite port=frame_errors bundle=control
+#pragma HLS INTERFACE s_axilite port=scale_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=out_width bundle=control
+#pragma HLS INTERFACE s_axilite port=out_height bundle=control
+#pragma HLS INTERFACE s_axilite port=roi_count bundle=control
+#pragma HLS INTERFACE s_axilite port=roi_rects bundle=control
+#pragma HLS INTERFACE s_axilite port=border_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=grad_enable bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    image_pros_core<MAX_WIDTH>(src, src_rgb, dst, dst_grad, filter_select,
+                               threshold_val, width, height, status, input_format,
+                               filter_chain, blur_coeffs, conv_coeffs,
+                               conv_ctrl, threshold_high, histogram, stats_min,
+                               stats_max, stats_sum, stats_sum_sq, lut, lut_bank,
+                               frame_sync, frame_errors, scale_ctrl, out_width,
+                               out_height, roi_count, roi_rects, border_ctrl,
+                               grad_enable);
+}
+
+// 1920-pixel (1080p) profile
+void image_pros_1080p(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+) {
+#pragma HLS INTERFACE axis port=src
+#pragma HLS INTERFACE axis port=src_rgb
+#pragma HLS INTERFACE axis port=dst
+#pragma HLS INTERFACE axis port=dst_grad
+#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
+#pragma HLS INTERFACE s_axilite port=width bundle=control
+#pragma HLS INTERFACE s_axilite port=height bundle=control
+#pragma HLS INTERFACE s_axilite port=status bundle=control
+#pragma HLS INTERFACE s_axilite port=input_format bundle=control
+#pragma HLS INTERFACE s_axilite port=filter_chain bundle=control
+#pragma HLS INTERFACE s_axilite port=blur_coeffs bundle=control
+#pragma HLS INTERFACE s_axilite port=conv_coeffs bundle=control
+#pragma HLS INTERFACE s_axilite port=conv_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_high bundle=control
+#pragma HLS INTERFACE s_axilite port=histogram bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_min bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_max bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_sum bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_sum_sq bundle=control
+#pragma HLS INTERFACE s_axilite port=lut bundle=control
+#pragma HLS INTERFACE s_axilite port=lut_bank bundle=control
+#pragma HLS INTERFACE s_axilite port=frame_sync bundle=control
+#pragma HLS INTERFACE s_axilite port=frame_errors bundle=control
+#pragma HLS INTERFACE s_axilite port=scale_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=out_width bundle=control
+#pragma HLS INTERFACE s_axilite port=out_height bundle=control
+#pragma HLS INTERFACE s_axilite port=roi_count bundle=control
+#pragma HLS INTERFACE s_axilite port=roi_rects bundle=control
+#pragma HLS INTERFACE s_axilite port=border_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=grad_enable bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    image_pros_core<MAX_WIDTH_1080P>(src, src_rgb, dst, dst_grad, filter_select,
+                                     threshold_val, width, height, status, input_format,
+                                     filter_chain, blur_coeffs, conv_coeffs,
+                                     conv_ctrl, threshold_high, histogram, stats_min,
+                                     stats_max, stats_sum, stats_sum_sq, lut, lut_bank,
+                                     frame_sync, frame_errors, scale_ctrl, out_width,
+                                     out_height, roi_count, roi_rects, border_ctrl,
+                                     grad_enable);
+}
+
+// 4096-pixel (4K/DCI) profile
+void image_pros_4k(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+) {
+#pragma HLS INTERFACE axis port=src
+#pragma HLS INTERFACE axis port=src_rgb
+#pragma HLS INTERFACE axis port=dst
+#pragma HLS INTERFACE axis port=dst_grad
+#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
+#pragma HLS INTERFACE s_axilite port=width bundle=control
+#pragma HLS INTERFACE s_axilite port=height bundle=control
+#pragma HLS INTERFACE s_axilite port=status bundle=control
+#pragma HLS INTERFACE s_axilite port=input_format bundle=control
+#pragma HLS INTERFACE s_axilite port=filter_chain bundle=control
+#pragma HLS INTERFACE s_axilite port=blur_coeffs bundle=control
+#pragma HLS INTERFACE s_axilite port=conv_coeffs bundle=control
+#pragma HLS INTERFACE s_axilite port=conv_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_high bundle=control
+#pragma HLS INTERFACE s_axilite port=histogram bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_min bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_max bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_sum bundle=control
+#pragma HLS INTERFACE s_axilite port=stats_sum_sq bundle=control
+#pragma HLS INTERFACE s_axilite port=lut bundle=control
+#pragma HLS INTERFACE s_axilite port=lut_bank bundle=control
+#pragma HLS INTERFACE s_axilite port=frame_sync bundle=control
+#pragma HLS INTERFACE s_axilite port=frame_errors bundle=control
+#pragma HLS INTERFACE s_axilite port=scale_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=out_width bundle=control
+#pragma HLS INTERFACE s_axilite port=out_height bundle=control
+#pragma HLS INTERFACE s_axilite port=roi_count bundle=control
+#pragma HLS INTERFACE s_axilite port=roi_rects bundle=control
+#pragma HLS INTERFACE s_axilite port=border_ctrl bundle=control
+#pragma HLS INTERFACE s_axilite port=grad_enable bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    image_pros_core<MAX_WIDTH_4K>(src, src_rgb, dst, dst_grad, filter_select,
+                                  threshold_val, width, height, status, input_format,
+                                  filter_chain, blur_coeffs, conv_coeffs,
+                                  conv_ctrl, threshold_high, histogram, stats_min,
+                                  stats_max, stats_sum, stats_sum_sq, lut, lut_bank,
+                                  frame_sync, frame_errors, scale_ctrl, out_width,
+                                  out_height, roi_count, roi_rects, border_ctrl,
+                                  grad_enable);
 }
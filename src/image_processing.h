@@ -17,22 +17,78 @@
 #define MAX_WIDTH   640
 #define MAX_HEIGHT  480
 #define KERNEL_SIZE 3
+#define CHAIN_STAGES 4      // Fused filter stages (filter_chain bytes)
+
+// Separable blur (FILTER_BLUR) kernel size: 3, 5 or 7, fixed per
+// build (e.g. -DBLUR_KERNEL_SIZE=7 in the csim/csynth cflags)
+#ifndef BLUR_KERNEL_SIZE
+#define BLUR_KERNEL_SIZE 5
+#endif
+
+// Pixel depth: 8, 10, 12 or 16 bits, fixed per build like the blur
+// size (e.g. -DPIXEL_BITS=12). Every stage, line buffer and
+// accumulator is sized from it; the AXI4-Stream TDATA is the depth
+// rounded up to whole bytes, pixel in the low bits.
+#ifndef PIXEL_BITS
+#define PIXEL_BITS 8
+#endif
+
+#define PIXEL_MAX         ((1 << PIXEL_BITS) - 1)
+#define PIXEL_TDATA_BITS  ((PIXEL_BITS + 7) / 8 * 8)
+#define PIXEL_EXTRA_BITS  (PIXEL_BITS - 8)  // Bits below the top 8
+
+// Programmable convolution (FILTER_CONV): up to 5x5 signed taps
+#define CONV_MAX_SIZE 5
+#define CONV_TAPS     (CONV_MAX_SIZE * CONV_MAX_SIZE)
+
+// Line-buffer width of each synthesizable profile
+#define MAX_WIDTH_1080P 1920
+#define MAX_WIDTH_4K    4096
 
 // ============================================
 // Pixel Types
 // ============================================
-typedef ap_uint<8>  pixel_t;        // 8-bit grayscale pixel
-typedef ap_int<16>  pixel_s16_t;    // Signed 16-bit for convolution
-typedef ap_uint<24> pixel_rgb_t;    // 24-bit RGB pixel
+typedef ap_uint<PIXEL_BITS>      pixel_t;       // Grayscale pixel
+typedef ap_int<PIXEL_BITS + 8>   pixel_sum_t;   // Signed 3x3 window sums
+typedef ap_uint<24>              pixel_rgb_t;   // 24-bit RGB pixel
+typedef ap_uint<PIXEL_BITS + 8>  blur_sum_t;    // Horizontal blur sum (pixel * 256)
+typedef ap_int<PIXEL_BITS + 14>  conv_sum_t;    // 25 taps * -128 * PIXEL_MAX fits
+typedef ap_uint<PIXEL_BITS + 3>  grad_mag_t;    // Canny |Gx| + |Gy| <= 8 * PIXEL_MAX
+typedef ap_uint<2>               grad_dir_t;    // Canny direction (CANNY_DIR_*)
+typedef ap_uint<2>               edge_class_t;  // Canny NMS class (CANNY_*)
+typedef ap_uint<32>              hist_bin_t;    // Pixels per histogram bin
+typedef ap_uint<8>               hist_index_t;  // Histogram bin / table index
+typedef ap_uint<64>              stats_sum_t;   // Frame sum / sum of squares
+
+typedef ap_uint<8 * CONV_TAPS> conv_coeffs_t;   // One signed byte per tap
 
 // ============================================
 // AXI4-Stream Types
 // ============================================
-typedef ap_axiu<8, 1, 1, 1>  axis_pixel_t;      // 8-bit stream with TLAST
-typedef ap_axiu<24, 1, 1, 1> axis_rgb_t;        // 24-bit RGB stream
+typedef ap_axiu<PIXEL_TDATA_BITS, 1, 3, 3> axis_pixel_t;  // TID/TDEST = ROI
+typedef ap_axiu<24, 1, 1, 1> axis_rgb_t;        // 24-bit RGB stream (0xRRGGBB)
+
+typedef ap_axiu<64, 1, 1, 1> axis_grad_t;       // Packed gradient (dst_grad)
 
 typedef hls::stream<axis_pixel_t> stream_t;
 typedef hls::stream<axis_rgb_t>   stream_rgb_t;
+typedef hls::stream<axis_grad_t>  stream_grad_t;
+
+// ============================================
+// Multi-Pixel-Per-Clock (PPC) Stream Types
+// ============================================
+// PPC pixels are packed into one beat, PIXEL_TDATA_BITS each, pixel
+// 0 (leftmost) in the low bits. Image width must be a multiple of PPC.
+template<int PPC>
+struct ppc_stream {
+    typedef ap_uint<PIXEL_TDATA_BITS * PPC>          word_t;
+    typedef ap_axiu<PIXEL_TDATA_BITS * PPC, 1, 1, 1> beat_t;
+    typedef hls::stream<beat_t>                      stream_t;
+};
+
+typedef ppc_stream<2>::stream_t stream_ppc2_t;  // 2 pixels per beat
+typedef ppc_stream<4>::stream_t stream_ppc4_t;  // 4 pixels per beat
+typedef ppc_stream<8>::stream_t stream_ppc8_t;  // 8 pixels per beat
 
 // ============================================
 // Filter Selection Modes
@@ -44,19 +100,60 @@ typedef enum {
     FILTER_THRESHOLD  = 3,  // Binary Thresholding
     FILTER_GAUSSIAN   = 4,  // Gaussian Blur (3x3)
     FILTER_NEGATIVE   = 5,  // Image Negative/Inversion
-    FILTER_SHARPEN    = 6   // Image Sharpening
+    FILTER_SHARPEN    = 6,  // Image Sharpening
+    FILTER_BLUR       = 7,  // Separable Gaussian/box blur (BLUR_KERNEL_SIZE)
+    FILTER_CONV       = 8,  // Programmable 3x3/5x5 convolution (conv_coeffs)
+    FILTER_MEDIAN     = 9,  // Median (3x3)
+    FILTER_ERODE      = 10, // Erosion: minimum (3x3)
+    FILTER_DILATE     = 11, // Dilation: maximum (3x3)
+    FILTER_OPEN       = 12, // Opening: erode then dilate
+    FILTER_CLOSE      = 13, // Closing: dilate then erode
+    FILTER_CANNY      = 14, // Canny edges (threshold_val, threshold_high)
+    FILTER_ADAPTIVE   = 15, // 5x5 local-mean threshold (offset threshold_val)
+    FILTER_OTSU       = 16, // Threshold at the previous frame's Otsu level
+    FILTER_LUT        = 17, // 256-entry lookup table (lut, lut_bank)
+    FILTER_EQUALIZE   = 18, // Histogram equalization of the previous frame
+    FILTER_GRAD_X     = 19, // Signed Sobel Gx (two's complement)
+    FILTER_GRAD_Y     = 20  // Signed Sobel Gy (two's complement)
 } filter_mode_t;
 
+// ============================================
+// Input Formats (input_format register)
+// ============================================
+typedef enum {
+    INPUT_GRAY     = 0,  // PIXEL_BITS grayscale on src
+    INPUT_RGB_601  = 1,  // 24-bit RGB on src_rgb, BT.601 luma
+    INPUT_RGB_709  = 2   // 24-bit RGB on src_rgb, BT.709 luma
+} input_format_t;
+
+// ============================================
+// Status Codes (status output register)
+// ============================================
+typedef enum {
+    STATUS_OK         = 0,  // Frame processed
+    STATUS_ERR_WIDTH  = 1,  // Width exceeds line buffer or PPC alignment
+    STATUS_ERR_SCALE  = 2,  // Scaler output size or mode out of range
+    STATUS_ERR_ROI    = 3,  // ROI empty, outside the frame or overlapping
+    STATUS_ERR_BORDER = 4,  // Unknown border mode or frame cropped away
+    STATUS_ERR_MODE   = 5   // filter_select not implemented (PPC variants)
+} status_t;
+
 // ============================================
 // Control Register Structure
 // ============================================
 typedef struct {
-    ap_uint<3>  filter_select;   // Filter mode (0-6)
-    ap_uint<8>  threshold_val;   // Threshold value (0-255)
+    ap_uint<8>  filter_select;   // Filter mode (filter_mode_t)
+    ap_uint<16> threshold_val;   // Threshold value (0-PIXEL_MAX)
     ap_uint<16> img_width;       // Image width
     ap_uint<16> img_height;      // Image height
 } control_t;
 
+// ============================================
+// Luma Coefficients (Q8, R/G/B, sum = 256)
+// ============================================
+const int LUMA_BT601[3] = {77, 150, 29};    // 0.299, 0.587, 0.114
+const int LUMA_BT709[3] = {54, 183, 19};    // 0.2126, 0.7152, 0.0722
+
 // ============================================
 // Sobel Kernels (3x3)
 // ============================================
@@ -90,18 +187,429 @@ const int SHARPEN[3][3] = {
     { 0, -1,  0}
 };
 
+// ============================================
+// Median Sorting Network (3x3)
+// ============================================
+// 19 compare-exchanges over window[i][j] = p[3 * i + j]; afterwards
+// p[4] holds the median. Each pair is (lower, upper).
+const int MEDIAN9_NETWORK[19][2] = {
+    {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2}, {4, 5},
+    {7, 8}, {0, 3}, {5, 8}, {4, 7}, {3, 6}, {1, 4}, {2, 5}, {4, 7},
+    {4, 2}, {6, 4}, {4, 2}
+};
+
+// ============================================
+// Separable Blur Kernel (blur_coeffs register)
+// ============================================
+// Byte i holds the weight of the two taps at distance i from the
+// centre (byte 0 = centre); the full 1-D kernel must sum to 256, so
+// the 2-D result is (sum >> 16). blur_coeffs == 0 selects the
+// binomial kernel, the closest integer Gaussian of each size.
+const int BLUR_BINOMIAL[3][4] = {
+    {128, 64,  0, 0},   // K=3: [1 2 1] / 4
+    { 96, 64, 16, 0},   // K=5: [1 4 6 4 1] / 16
+    { 80, 60, 24, 4}    // K=7: [1 6 15 20 15 6 1] / 64
+};
+
+// ============================================
+// Programmable Convolution (conv_coeffs, conv_ctrl)
+// ============================================
+// conv_coeffs byte i is the signed tap at row i / size, column
+// i % size of the window (row 0 = oldest line, column 0 = leftmost).
+// conv_ctrl:
+//   bit 3~0   - right shift of the sum
+//   bit 4     - kernel size, 0 = 3x3 (bytes 0-8), 1 = 5x5 (bytes 0-24)
+//   bit 31~16 - signed bias added after the shift
+// result = clamp((sum >> shift) + bias, 0, PIXEL_MAX)
+#define CONV_CTRL_SHIFT_MSB 3
+#define CONV_CTRL_SIZE5_BIT 4
+#define CONV_CTRL_BIAS_LSB  16
+
+// ============================================
+// Canny Edge Detector (FILTER_CANNY)
+// ============================================
+// Sobel magnitude |Gx| + |Gy| (0-8 * PIXEL_MAX) is compared against
+// threshold_val (low) and threshold_high after non-maximum
+// suppression. The direction picks the neighbour pair NMS compares:
+// |Gy| / |Gx| below tan(22.5) is horizontal, above tan(67.5) vertical
+// (both in Q7), anything between is one of the diagonals.
+#define CANNY_DIR_H     0   // Left / right
+#define CANNY_DIR_D45   1   // Gx, Gy same sign: up-left / down-right
+#define CANNY_DIR_V     2   // Up / down
+#define CANNY_DIR_D135  3   // Opposite signs: up-right / down-left
+#define CANNY_TAN22_Q7  53
+#define CANNY_TAN67_Q7  309
+
+#define CANNY_NONE      0   // Suppressed or below threshold_val
+#define CANNY_WEAK      1   // threshold_val <= magnitude < threshold_high
+#define CANNY_STRONG    2   // magnitude >= threshold_high
+
+// ============================================
+// Signed Gradients (FILTER_GRAD_X, FILTER_GRAD_Y)
+// ============================================
+// The Sobel Gx or Gy of the window, saturated to the signed range of
+// a pixel (-2^(PIXEL_BITS-1) .. 2^(PIXEL_BITS-1) - 1) and written as
+// its two's complement bits. The border is 0, like Sobel.
+#define GRAD_MAX    ((1 << (PIXEL_BITS - 1)) - 1)
+#define GRAD_MIN    (-(1 << (PIXEL_BITS - 1)))
+
+// ============================================
+// Gradient Output (dst_grad, grad_enable)
+// ============================================
+// With grad_enable set, dst_grad carries one beat per pixel of the
+// output frame (before the ROI crop) holding its Sobel gradient:
+//   bit 15~0  - Gx, signed, saturated to 16 bits
+//   bit 31~16 - Gy, signed, saturated to 16 bits (positive downwards)
+//   bit 47~32 - magnitude, (123 * max + 51 * min) / 128 of |Gx| and
+//               |Gy| (alpha-max-beta-min, within 4.1% of the L2 norm),
+//               saturated to 65535
+//   bit 55~48 - orientation bin, 0 to GRAD_ORIENT_BINS - 1
+// The orientation is unsigned (0-180 degrees, as HOG bins it): bin b
+// holds the angles from 20b up to 20(b + 1) degrees, tested against
+// the boundaries in Q14 without a divider. A zero gradient is bin 0.
+// The window follows border_ctrl like a Sobel stage behind the chain:
+// the legacy border ends it at the pixel and writes 0 for row or
+// column < 2, the other settings centre it, and crop writes 0 where
+// it leaves the frame. TUSER marks the first beat, TLAST line ends.
+#define GRAD_ORIENT_BINS    9
+#define GRAD_MAG_ALPHA_Q7   123     // 0.960
+#define GRAD_MAG_BETA_Q7    51      // 0.398
+
+// cos and sin of the boundaries 20, 40, ..., 160 degrees (Q14)
+const int GRAD_ORIENT_COS_Q14[GRAD_ORIENT_BINS - 1] = {
+    15396, 12551, 8192, 2845, -2845, -8192, -12551, -15396
+};
+
+const int GRAD_ORIENT_SIN_Q14[GRAD_ORIENT_BINS - 1] = {
+    5604, 10531, 14189, 16135, 16135, 14189, 10531, 5604
+};
+
+// ============================================
+// Frame Statistics
+// ============================================
+// Histogram, min, max, sum and sum of squares of the output frame,
+// accumulated as it leaves the last chain stage. Bin n counts the
+// pixels whose top 8 bits are n (the pixels of value n at 8 bits).
+// All are valid once ap_done is set.
+#define HIST_BINS       256
+
+// ============================================
+// Automatic Thresholds (FILTER_ADAPTIVE, FILTER_OTSU)
+// ============================================
+// FILTER_ADAPTIVE outputs PIXEL_MAX where the 5x5 window centre is
+// above the window mean minus threshold_val. FILTER_OTSU thresholds at
+// the Otsu level of the previous frame that entered the same chain
+// stage in FILTER_OTSU or FILTER_EQUALIZE mode; stages in other modes
+// keep what they learned. The level is a histogram bin, so it compares
+// the top 8 bits of a pixel.
+#define ADAPTIVE_TAPS       (CONV_MAX_SIZE * CONV_MAX_SIZE)
+#define OTSU_LEVEL_RESET    128     // Level before the first frame
+#define OTSU_MU_FRAC        8       // Class means in Q8
+#define OTSU_Q_FRAC         16      // Class weights in Q16
+
+// ============================================
+// Lookup Tables (FILTER_LUT, FILTER_EQUALIZE)
+// ============================================
+// lut holds LUT_BANKS tables of LUT_ENTRIES pixels; entry n of the
+// bank lut_bank selects is the output for inputs whose top 8 bits are
+// n. The bank is latched when a frame starts, so software rewrites the
+// other one meanwhile. FILTER_EQUALIZE builds its table from the
+// histogram of the previous frame the stage learned from (as for
+// FILTER_OTSU) and passes pixels through before it.
+#define LUT_ENTRIES     256
+#define LUT_BANKS       2
+
+typedef hls::stream<pixel_t> lut_stream_t;
+
+// ============================================
+// Video Framing (frame_sync, frame_errors)
+// ============================================
+// With frame_sync set the input is framed by its sideband: a frame
+// starts at the first beat with TUSER set and every line must end
+// with TLAST on beat width - 1. Beats before the SOF are dropped, a
+// short line or frame is padded with FRAME_PAD_PIXEL, and a long line
+// is drained up to its TLAST, so exactly width x height pixels still
+// reach the filters and the next frame starts in sync. An SOF that
+// arrives early is kept and starts the next frame. Every such event
+// adds one to frame_errors, which counts from reset so software can
+// leave the IP on auto-restart and read it at any time. The output
+// always carries TUSER on its first pixel and TLAST on line ends.
+#define FRAME_PAD_PIXEL 0
+
+typedef ap_uint<32> frame_count_t;
+
+// ============================================
+// Scaler (scale_ctrl, out_width, out_height)
+// ============================================
+// Downscales the frame to out_width x out_height (1..width,
+// 1..height) on the way through, so dst carries fewer beats.
+// scale_ctrl:
+//   bit 1~0 - SCALE_NONE, SCALE_BOX or SCALE_BILINEAR
+//   bit 2   - 0 = scale the input ahead of the filter chain,
+//             1 = scale the chain output
+// SCALE_BOX averages the input pixels whose column and row map to
+// each output pixel (x * out_width / width, y * out_height / height),
+// so integer ratios give an exact N x M box. SCALE_BILINEAR samples
+// the source at ((X + 0.5) * width / out_width - 0.5, ...) from a Q16
+// step, with Q8 weights. Either way each input beat gives at most one
+// output beat. The scaler keeps two line-wide arrays: the box column
+// sums and the previous row for bilinear.
+// A box holds floor or ceil(width / out_width) columns by floor or
+// ceil(height / out_height) rows, so its mean divides by one of four
+// pixel counts whose reciprocals are set up once per frame.
+#define SCALE_CTRL_MODE_MSB  1
+#define SCALE_CTRL_AFTER_BIT 2
+#define SCALE_POS_FRAC       16     // Bilinear source position in Q16
+#define SCALE_WEIGHT_FRAC    8      // Bilinear weights in Q8
+#define BOX_COUNT_BITS       24     // 4096 x 2160 pixels in one box
+
+typedef enum {
+    SCALE_NONE     = 0,  // Output size = input size
+    SCALE_BOX      = 1,  // Area average
+    SCALE_BILINEAR = 2   // Bilinear interpolation
+} scale_mode_t;
+
+typedef ap_uint<32> scale_pos_t;                // Q16 source position (< 4096)
+typedef ap_uint<BOX_COUNT_BITS> box_count_t;            // Pixels in a box
+typedef ap_uint<PIXEL_BITS + BOX_COUNT_BITS> box_sum_t; // 4096 x 2160 x PIXEL_MAX fits
+typedef ap_uint<PIXEL_BITS + 2> box_recip_t;    // 2^shift / count, rounded down
+typedef ap_uint<6> box_shift_t;                 // PIXEL_BITS + bits of the count
+
+// ============================================
+// Regions of Interest (roi_count, roi_rects)
+// ============================================
+// With roi_count = 0 every output pixel reaches dst. Otherwise only
+// the pixels inside the first roi_count rectangles do, each beat
+// tagged with its rectangle index on TID and TDEST, so an AXIS switch
+// can route the regions to separate DMA channels. Rectangle i is
+// 64 bits of roi_rects: x, y, width, height, 16 bits each from the
+// LSB, in output-frame coordinates (after the scaler). The crop runs
+// after the last stage, so the filters still see the neighbourhood
+// outside a region. TUSER marks a region's first pixel and TLAST
+// the end of each of its lines; regions must not overlap.
+#define ROI_MAX       8
+#define ROI_TAG_BITS  3
+
+typedef ap_uint<64 * ROI_MAX> roi_rects_t;
+
+// ============================================
+// Border Handling (border_ctrl)
+// ============================================
+// border_ctrl:
+//   bit 2~0  - border mode (border_mode_t)
+//   bit 3    - centre the window on the output pixel (BORDER_LEGACY)
+//   bit 15~8 - BORDER_CONSTANT value (top 8 bits of the pixel)
+// BORDER_LEGACY without bit 3 is the original behaviour: the window
+// ends at the current pixel, so a filter of radius r writes the
+// result for input (row - r, col - r) at (row, col), and each filter
+// keeps its fixed border (0 for Sobel, Canny and the adaptive
+// threshold, the input pixel otherwise). Every other setting centres
+// the window on the output pixel: a stage of radius r runs r more
+// rows and columns to flush its last results, still at II=1, and the
+// taps outside the frame repeat the edge pixel (replicate), mirror
+// about it without repeating it (reflect) or read the constant. Open,
+// close and Canny extend the input of each of their steps the same
+// way. BORDER_CROP drops the pixels whose window leaves the frame,
+// so a stage of radius r makes the frame 2r smaller each way.
+#define BORDER_CTRL_MODE_MSB  2
+#define BORDER_CTRL_ALIGN_BIT 3
+#define BORDER_CTRL_CONST_LSB 8
+#define BORDER_MAX_RADIUS     3     // Canny, 7x7 blur
+
+typedef enum {
+    BORDER_LEGACY    = 0,  // Fixed per-filter border (bit 3: centred)
+    BORDER_REPLICATE = 1,  // aaa|abcd|ddd
+    BORDER_REFLECT   = 2,  // dcb|abcd|cba
+    BORDER_CONSTANT  = 3,  // kkk|abcd|kkk
+    BORDER_CROP      = 4   // Full windows only
+} border_mode_t;
+
 // ============================================
 // Function Prototypes
 // ============================================
 
-// Top-level function (to be exported as IP)
+// Top-level functions (to be exported as IP), one per MAX_WIDTH
+// profile. input_format selects src (grayscale) or src_rgb (converted
+// to luma on the fly). filter_chain fuses up to CHAIN_STAGES filters
+// (byte i = mode of stage i, 0 = bypass) into one pass; when it is 0
+// filter_select runs alone. blur_coeffs sets the FILTER_BLUR kernel,
+// conv_coeffs and conv_ctrl the FILTER_CONV kernel; threshold_high is
+// the upper FILTER_CANNY threshold. histogram and stats_* return the
+// statistics of the output frame. lut and lut_bank hold the
+// FILTER_LUT tables. frame_sync enables TUSER/TLAST framing and
+// frame_errors counts the framing errors since reset. scale_ctrl,
+// out_width and out_height set the scaler; dst is then out_width x
+// out_height. roi_count and roi_rects crop dst to up to ROI_MAX
+// tagged regions; the statistics still cover the whole frame.
+// border_ctrl selects the window border and alignment. threshold_val
+// and threshold_high are in pixel (and gradient) units of PIXEL_BITS.
+// grad_enable writes the packed gradient of dst to dst_grad.
+// A width above the profile maximum sets status to STATUS_ERR_WIDTH,
+// a bad scaler setting STATUS_ERR_SCALE, a bad region STATUS_ERR_ROI
+// and a bad border setting STATUS_ERR_BORDER; each leaves the streams
+// and statistics untouched.
 void image_pros(
     stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+);
+
+void image_pros_1080p(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
     stream_t &dst,
-    ap_uint<3>  filter_select,
-    ap_uint<8>  threshold_val,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+);
+
+void image_pros_4k(
+    stream_t &src,
+    stream_rgb_t &src_rgb,
+    stream_t &dst,
+    stream_grad_t &dst_grad,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status,
+    ap_uint<2>  input_format,
+    ap_uint<32> filter_chain,
+    ap_uint<32> blur_coeffs,
+    conv_coeffs_t conv_coeffs,
+    ap_uint<32> conv_ctrl,
+    ap_uint<32> threshold_high,
+    hist_bin_t  histogram[HIST_BINS],
+    pixel_t     &stats_min,
+    pixel_t     &stats_max,
+    stats_sum_t &stats_sum,
+    stats_sum_t &stats_sum_sq,
+    pixel_t     lut[LUT_BANKS * LUT_ENTRIES],
+    ap_uint<1>  lut_bank,
+    ap_uint<1>  frame_sync,
+    frame_count_t &frame_errors,
+    ap_uint<8>  scale_ctrl,
+    ap_uint<16> out_width,
+    ap_uint<16> out_height,
+    ap_uint<4>  roi_count,
+    roi_rects_t roi_rects,
+    ap_uint<16> border_ctrl,
+    ap_uint<1>  grad_enable
+);
+
+// Multi-pixel-per-clock variants (one IP per PPC value, sized for
+// MAX_WIDTH_4K). width must also be a multiple of PPC, and a mode
+// beyond the 3x3 window filters sets status to STATUS_ERR_MODE.
+void image_pros_ppc2(
+    stream_ppc2_t &src,
+    stream_ppc2_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status
+);
+
+void image_pros_ppc4(
+    stream_ppc4_t &src,
+    stream_ppc4_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status
+);
+
+void image_pros_ppc8(
+    stream_ppc8_t &src,
+    stream_ppc8_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
     ap_uint<16> width,
-    ap_uint<16> height
+    ap_uint<16> height,
+    ap_uint<8>  &status
+);
+
+// Per-pixel filter selection (shared by all PPC variants)
+pixel_t filter_pixel(
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    pixel_t window[KERNEL_SIZE][KERNEL_SIZE],
+    pixel_t current_pixel,
+    bool valid_window
+);
+
+// RGB to luma conversion (input_format INPUT_RGB_601/709)
+pixel_t rgb_to_gray(
+    pixel_rgb_t rgb,
+    ap_uint<2>  input_format
+);
+
+// Box mean without a divider (scale_stage, checked in csim test 22)
+void box_reciprocal(
+    box_count_t count,
+    box_recip_t &recip,
+    box_shift_t &shift
+);
+
+pixel_t box_divide(
+    box_sum_t   sum,
+    box_count_t count,
+    box_recip_t recip,
+    box_shift_t shift
 );
 
 // Individual filter functions
@@ -0,0 +1,253 @@
+/*
+ * Image Processing Accelerator - Multi-Pixel-Per-Clock Datapath
+ * FPGA Implementation of Image Processing Functions
+ * Target: Zynq-7020 (xc7z020clg400-1)
+ *
+ * Processes PPC pixels per clock over a wide AXI4-Stream beat.
+ * Each beat feeds PPC parallel filter lanes; lane p computes the
+ * output for column (beat * PPC + p) with exactly the same window
+ * and border rules as the 1 pixel/clock image_pros kernel.
+ *
+ * Top functions (select one with set_top):
+ *   image_pros_ppc2 - 2 pixels/clock (16-bit beat at 8 bits/pixel)
+ *   image_pros_ppc4 - 4 pixels/clock (32-bit beat at 8 bits/pixel)
+ *   image_pros_ppc8 - 8 pixels/clock (64-bit beat at 8 bits/pixel)
+ *
+ * All variants are sized for MAX_WIDTH_4K, since high-resolution
+ * sensors are what need more than 1 pixel/clock.
+ */
+
+#include "image_processing.h"
+
+// ============================================
+// Supported Modes
+// ============================================
+// The modes filter_pixel() implements on a 3x3 window; the blur,
+// convolution, cascaded, Canny, adaptive and frame-level modes need
+// more state than one window per lane.
+bool ppc_mode_supported(ap_uint<8> filter_select) {
+#pragma HLS INLINE
+    switch (filter_select) {
+        case FILTER_BYPASS:
+        case FILTER_GRAYSCALE:
+        case FILTER_SOBEL:
+        case FILTER_THRESHOLD:
+        case FILTER_GAUSSIAN:
+        case FILTER_NEGATIVE:
+        case FILTER_SHARPEN:
+        case FILTER_MEDIAN:
+        case FILTER_ERODE:
+        case FILTER_DILATE:
+        case FILTER_GRAD_X:
+        case FILTER_GRAD_Y:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ============================================
+// Templated PPC Kernel
+// ============================================
+template<int PPC, int MAX_W>
+void image_pros_ppc(
+    typename ppc_stream<PPC>::stream_t &src,
+    typename ppc_stream<PPC>::stream_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status
+) {
+#pragma HLS INLINE off
+    typedef typename ppc_stream<PPC>::word_t word_t;
+    typedef typename ppc_stream<PPC>::beat_t beat_t;
+
+    // Window spans the PPC new columns plus the two columns to their
+    // left, so every lane sees a full 3x3 neighbourhood
+    const int WIN_COLS = PPC + KERNEL_SIZE - 1;
+    const int MAX_WORDS = MAX_W / PPC;
+    const int LANE = PIXEL_TDATA_BITS;
+
+    // ========================================
+    // Validate Frame Size
+    // ========================================
+    if (width > MAX_W || (width % PPC) != 0) {
+        status = STATUS_ERR_WIDTH;
+        return;
+    }
+
+    // Reject rather than pass through a mode this kernel lacks
+    if (!ppc_mode_supported(filter_select)) {
+        status = STATUS_ERR_MODE;
+        return;
+    }
+    status = STATUS_OK;
+
+    // ========================================
+    // Line Buffers (one word = PPC columns)
+    // ========================================
+    static word_t line_buffer[2][MAX_WORDS];
+#pragma HLS ARRAY_PARTITION variable=line_buffer complete dim=1
+
+    pixel_t window[KERNEL_SIZE][WIN_COLS];
+#pragma HLS ARRAY_PARTITION variable=window complete dim=0
+
+    ap_uint<16> words = width / PPC;
+
+    // ========================================
+    // Process Image Row by Row
+    // ========================================
+    ROW_LOOP:
+    for (int row = 0; row < height; row++) {
+#pragma HLS LOOP_TRIPCOUNT min=480 max=480
+
+        COL_LOOP:
+        for (int col = 0; col < words; col++) {
+#pragma HLS LOOP_TRIPCOUNT min=MAX_WORDS max=MAX_WORDS
+#pragma HLS PIPELINE II=1
+
+            // Read PPC input pixels from stream
+            beat_t src_beat = src.read();
+
+            // Read N columns from line buffers in one access
+            word_t upper  = line_buffer[0][col];
+            word_t middle = line_buffer[1][col];
+
+            // Update line buffers
+            line_buffer[0][col] = middle;
+            line_buffer[1][col] = src_beat.data;
+
+            // Shift window left by PPC columns
+            for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+                for (int j = 0; j < KERNEL_SIZE - 1; j++) {
+#pragma HLS UNROLL
+                    window[i][j] = window[i][j + PPC];
+                }
+            }
+
+            // Load PPC new columns
+            for (int p = 0; p < PPC; p++) {
+#pragma HLS UNROLL
+                int lsb = LANE * p;
+                window[0][p + KERNEL_SIZE - 1] = upper.range(lsb + PIXEL_BITS - 1, lsb);
+                window[1][p + KERNEL_SIZE - 1] = middle.range(lsb + PIXEL_BITS - 1, lsb);
+                window[2][p + KERNEL_SIZE - 1] =
+                    src_beat.data.range(lsb + PIXEL_BITS - 1, lsb);
+            }
+
+            // ====================================
+            // Apply Selected Filter on Each Lane
+            // ====================================
+            word_t out_word = 0;
+
+            LANE_LOOP:
+            for (int p = 0; p < PPC; p++) {
+#pragma HLS UNROLL
+                pixel_t lane_window[KERNEL_SIZE][KERNEL_SIZE];
+#pragma HLS ARRAY_PARTITION variable=lane_window complete dim=0
+
+                for (int i = 0; i < KERNEL_SIZE; i++) {
+#pragma HLS UNROLL
+                    for (int j = 0; j < KERNEL_SIZE; j++) {
+#pragma HLS UNROLL
+                        lane_window[i][j] = window[i][p + j];
+                    }
+                }
+
+                int x = col * PPC + p;
+                bool valid_window = (row >= 2) && (x >= 2);
+
+                pixel_t output_pixel = filter_pixel(
+                    filter_select, threshold_val,
+                    lane_window, lane_window[2][2], valid_window);
+
+                out_word.range(LANE * p + LANE - 1, LANE * p) = output_pixel;
+            }
+
+            // Write output beat to stream
+            beat_t dst_beat;
+            dst_beat.data = out_word;
+            dst_beat.keep = src_beat.keep;
+            dst_beat.strb = src_beat.strb;
+            dst_beat.user = src_beat.user;
+            dst_beat.id   = src_beat.id;
+            dst_beat.dest = src_beat.dest;
+
+            // Set TLAST on the last beat of each row
+            dst_beat.last = (col == words - 1) ? 1 : 0;
+
+            dst.write(dst_beat);
+        }
+    }
+}
+
+// ============================================
+// Top-Level Wrappers (to be exported as IP)
+// ============================================
+void image_pros_ppc2(
+    stream_ppc2_t &src,
+    stream_ppc2_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status
+) {
+#pragma HLS INTERFACE axis port=src
+#pragma HLS INTERFACE axis port=dst
+#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
+#pragma HLS INTERFACE s_axilite port=width bundle=control
+#pragma HLS INTERFACE s_axilite port=height bundle=control
+#pragma HLS INTERFACE s_axilite port=status bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    image_pros_ppc<2, MAX_WIDTH_4K>(src, dst, filter_select, threshold_val,
+                                    width, height, status);
+}
+
+void image_pros_ppc4(
+    stream_ppc4_t &src,
+    stream_ppc4_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status
+) {
+#pragma HLS INTERFACE axis port=src
+#pragma HLS INTERFACE axis port=dst
+#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
+#pragma HLS INTERFACE s_axilite port=width bundle=control
+#pragma HLS INTERFACE s_axilite port=height bundle=control
+#pragma HLS INTERFACE s_axilite port=status bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    image_pros_ppc<4, MAX_WIDTH_4K>(src, dst, filter_select, threshold_val,
+                                    width, height, status);
+}
+
+void image_pros_ppc8(
+    stream_ppc8_t &src,
+    stream_ppc8_t &dst,
+    ap_uint<8>  filter_select,
+    ap_uint<16> threshold_val,
+    ap_uint<16> width,
+    ap_uint<16> height,
+    ap_uint<8>  &status
+) {
+#pragma HLS INTERFACE axis port=src
+#pragma HLS INTERFACE axis port=dst
+#pragma HLS INTERFACE s_axilite port=filter_select bundle=control
+#pragma HLS INTERFACE s_axilite port=threshold_val bundle=control
+#pragma HLS INTERFACE s_axilite port=width bundle=control
+#pragma HLS INTERFACE s_axilite port=height bundle=control
+#pragma HLS INTERFACE s_axilite port=status bundle=control
+#pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    image_pros_ppc<8, MAX_WIDTH_4K>(src, dst, filter_select, threshold_val,
+                                    width, height, status);
+}
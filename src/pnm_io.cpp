@@ -0,0 +1,116 @@
+/*
+ * Image Processing Accelerator - Binary PGM/PPM I/O
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include "pnm_io.h"
+
+// ============================================
+// Header Parsing
+// ============================================
+// Next header integer, skipping whitespace and # comments
+static bool read_header_int(FILE *file, int &value) {
+    int c = fgetc(file);
+    for (;;) {
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = fgetc(file);
+            }
+        } else if (isspace(c)) {
+            c = fgetc(file);
+        } else {
+            break;
+        }
+    }
+    if (!isdigit(c)) {
+        return false;
+    }
+    value = 0;
+    while (isdigit(c)) {
+        value = value * 10 + (c - '0');
+        if (value > 65535) {
+            return false;
+        }
+        c = fgetc(file);
+    }
+    // Exactly one whitespace byte ends the header value
+    return isspace(c);
+}
+
+// ============================================
+// Read / Write
+// ============================================
+bool pnm_read(const char *path, pnm_image_t &image) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open %s\n", path);
+        return false;
+    }
+
+    char magic[2];
+    int maxval = 0;
+    bool ok = fread(magic, 1, 2, file) == 2 && magic[0] == 'P' &&
+              (magic[1] == '5' || magic[1] == '6') &&
+              read_header_int(file, image.width) &&
+              read_header_int(file, image.height) &&
+              read_header_int(file, maxval) &&
+              image.width > 0 && image.height > 0;
+
+    if (!ok || maxval != 255) {
+        fprintf(stderr, "Error: %s is not an 8-bit binary PGM/PPM\n", path);
+        fclose(file);
+        return false;
+    }
+
+    image.channels = (magic[1] == '6') ? 3 : 1;
+    size_t size = (size_t)image.width * image.height * image.channels;
+    image.data.resize(size);
+    if (fread(image.data.data(), 1, size, file) != size) {
+        fprintf(stderr, "Error: %s is truncated\n", path);
+        fclose(file);
+        return false;
+    }
+
+    fclose(file);
+    return true;
+}
+
+bool pnm_write(const char *path, const pnm_image_t &image) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open %s\n", path);
+        return false;
+    }
+
+    size_t size = (size_t)image.width * image.height * image.channels;
+    fprintf(file, "P%c\n%d %d\n255\n", (image.channels == 3) ? '6' : '5',
+            image.width, image.height);
+    bool ok = fwrite(image.data.data(), 1, size, file) == size;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        fprintf(stderr, "Error: Cannot write %s\n", path);
+    }
+    return ok;
+}
+
+bool pnm_write_gray(const char *path, const uint8_t *pixels, int width, int height) {
+    pnm_image_t image;
+    image.width = width;
+    image.height = height;
+    image.channels = 1;
+    image.data.assign(pixels, pixels + (size_t)width * height);
+    return pnm_write(path, image);
+}
+
+// ============================================
+// Hash
+// ============================================
+uint64_t pnm_hash(const uint8_t *data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,35 @@
+/*
+ * Image Processing Accelerator - Binary PGM/PPM I/O
+ * Whole-file P5 (grayscale) and P6 (RGB) images for the testbench
+ *
+ * Pixel data is read and written with one fread/fwrite, so full-HD
+ * frames load in milliseconds. Only maxval 255 (8-bit samples) is
+ * supported; header comments are skipped.
+ */
+
+#ifndef PNM_IO_H
+#define PNM_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct pnm_image_t {
+    int width;
+    int height;
+    int channels;               // 1 = P5, 3 = P6 (R, G, B per pixel)
+    std::vector<uint8_t> data;  // Row-major, width * channels bytes per row
+};
+
+// Returns false with a message on stderr if the file is missing,
+// not P5/P6, not 8-bit or truncated.
+bool pnm_read(const char *path, pnm_image_t &image);
+bool pnm_write(const char *path, const pnm_image_t &image);
+
+// P5 from a packed grayscale buffer
+bool pnm_write_gray(const char *path, const uint8_t *pixels, int width, int height);
+
+// 64-bit FNV-1a, used as golden-output hash
+uint64_t pnm_hash(const uint8_t *data, size_t size);
+
+#endif // PNM_IO_H
@@ -5,9 +5,20 @@
 
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include "image_processing.h"
+#include "cpu_ref.h"
+#include "cpu_tiled.h"
+#include "pnm_io.h"
 
 using namespace std;
 
@@ -15,6 +26,39 @@ using namespace std;
 #define TEST_WIDTH  64
 #define TEST_HEIGHT 64
 
+// Golden-image manifest (run_hls.tcl copies src/golden next to csim)
+#define GOLDEN_MANIFEST "golden/manifest.txt"
+
+// Signature shared by the image_pros profiles
+typedef void (*image_pros_fn_t)(stream_t &, stream_rgb_t &, stream_t &, stream_grad_t &,
+                                ap_uint<8>, ap_uint<16>, ap_uint<16>, ap_uint<16>,
+                                ap_uint<8> &,
+                                ap_uint<2>, ap_uint<32>, ap_uint<32>, conv_coeffs_t,
+                                ap_uint<32>, ap_uint<32>, hist_bin_t *, pixel_t &,
+                                pixel_t &, stats_sum_t &, stats_sum_t &, pixel_t *,
+                                ap_uint<1>, ap_uint<1>, frame_count_t &, ap_uint<8>,
+                                ap_uint<16>, ap_uint<16>, ap_uint<4>, roi_rects_t,
+                                ap_uint<16>, ap_uint<1>);
+
+// Statistics outputs of the most recent image_pros call
+struct dut_stats_t {
+    hist_bin_t histogram[HIST_BINS];
+    pixel_t min;
+    pixel_t max;
+    stats_sum_t sum;
+    stats_sum_t sum_sq;
+};
+dut_stats_t dut_stats;
+
+// lut memory of the image_pros calls that do not set a table (all 0)
+pixel_t dut_lut[LUT_BANKS * LUT_ENTRIES];
+
+// frame_errors of the most recent image_pros call
+frame_count_t dut_frame_errors;
+
+// dst_grad of the image_pros calls (empty unless grad_enable is set)
+stream_grad_t dut_grad;
+
 // ============================================
 // Generate Test Pattern Image
 // ============================================
@@ -40,39 +84,104 @@ void generate_test_image(pixel_t image[TEST_HEIGHT][TEST_WIDTH]) {
 // Save Image as PGM (Portable GrayMap)
 // ============================================
 void save_pgm(const char* filename, pixel_t image[TEST_HEIGHT][TEST_WIDTH]) {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error: Cannot open " << filename << endl;
-        return;
-    }
-    
-    // PGM header
-    file << "P2" << endl;
-    file << TEST_WIDTH << " " << TEST_HEIGHT << endl;
-    file << "255" << endl;
+    static uint8_t pixels[TEST_HEIGHT * TEST_WIDTH];
     
-    // Pixel data
     for (int y = 0; y < TEST_HEIGHT; y++) {
         for (int x = 0; x < TEST_WIDTH; x++) {
-            file << (int)image[y][x];
-            if (x < TEST_WIDTH - 1) file << " ";
+            pixels[y * TEST_WIDTH + x] = image[y][x];
         }
-        file << endl;
     }
+    pnm_write_gray(filename, pixels, TEST_WIDTH, TEST_HEIGHT);
+}
+
+// ============================================
+// Check Frame Statistics
+// ============================================
+// Compares the statistics image_pros reported with the frame it wrote
+template<typename T>
+int check_stats(const T *output, int size) {
+    static hist_bin_t histogram[HIST_BINS];
+    int min_val = PIXEL_MAX, max_val = 0;
+    uint64_t sum = 0, sum_sq = 0;
     
-    file.close();
-    cout << "Saved: " << filename << endl;
+    for (int i = 0; i < HIST_BINS; i++) {
+        histogram[i] = 0;
+    }
+    for (int i = 0; i < size; i++) {
+        int val = output[i];
+        histogram[val >> PIXEL_EXTRA_BITS]++;
+        if (val < min_val) min_val = val;
+        if (val > max_val) max_val = val;
+        sum += val;
+        sum_sq += (uint64_t)val * val;
+    }
+    
+    int errors = 0;
+    for (int i = 0; i < HIST_BINS; i++) {
+        if (dut_stats.histogram[i] != histogram[i]) {
+            cout << "ERROR: Histogram bin " << i << " is " << dut_stats.histogram[i]
+                 << ", expected " << histogram[i] << endl;
+            errors++;
+            break;
+        }
+    }
+    if (dut_stats.min != min_val || dut_stats.max != max_val ||
+        dut_stats.sum != sum || dut_stats.sum_sq != sum_sq) {
+        cout << "ERROR: Frame statistics min " << dut_stats.min << " max "
+             << dut_stats.max << " sum " << dut_stats.sum << " sum_sq "
+             << dut_stats.sum_sq << ", expected " << min_val << " " << max_val
+             << " " << sum << " " << sum_sq << endl;
+        errors++;
+    }
+    return errors;
+}
+
+// Streams a width x height frame through kernel (bypass) and checks
+// the reported statistics against it
+int test_stats(image_pros_fn_t kernel, const uint8_t *input, int width, int height) {
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            axis_pixel_t pixel;
+            pixel.data = input[y * width + x];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;
+            pixel.last = (x == width - 1) ? 1 : 0;
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+    }
+    
+    ap_uint<8> status;
+    kernel(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_BYPASS, 0, width,
+           height, status, INPUT_GRAY, 0, 0, 0, 0, 0, dut_stats.histogram, dut_stats.min,
+           dut_stats.max, dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+           dut_frame_errors, 0, 0, 0, 0, 0, 0, 0);
+    while (!dst_stream.empty()) {
+        dst_stream.read();
+    }
+    
+    return (status != STATUS_OK) + check_stats(input, width * height);
 }
 
 // ============================================
 // Run Single Filter Test
 // ============================================
+// The conv and Canny high threshold registers default to 0
 int test_filter(
     pixel_t input[TEST_HEIGHT][TEST_WIDTH],
     pixel_t output[TEST_HEIGHT][TEST_WIDTH],
-    ap_uint<3> filter_mode,
-    ap_uint<8> threshold,
-    const char* filter_name
+    ap_uint<8> filter_mode,
+    ap_uint<16> threshold,
+    const char* filter_name,
+    conv_coeffs_t conv_coeffs = 0,
+    ap_uint<32> conv_ctrl = 0,
+    ap_uint<32> threshold_high = 0
 ) {
     cout << "\n========================================" << endl;
     cout << "Testing: " << filter_name << endl;
@@ -80,6 +189,7 @@ int test_filter(
     
     // Create streams
     stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
     stream_t dst_stream;
     
     // Load input image into stream
@@ -98,15 +208,46 @@ int test_filter(
     }
     
     // Call DUT (Device Under Test)
+    ap_uint<8> status;
     image_pros(
         src_stream,
+        src_rgb_stream,
         dst_stream,
+        dut_grad,
         filter_mode,
         threshold,
         TEST_WIDTH,
-        TEST_HEIGHT
+        TEST_HEIGHT,
+        status,
+        INPUT_GRAY,
+        0,
+        0,
+        conv_coeffs,
+        conv_ctrl,
+        threshold_high,
+        dut_stats.histogram,
+        dut_stats.min,
+        dut_stats.max,
+        dut_stats.sum,
+        dut_stats.sum_sq,
+        dut_lut,
+        0,
+        0,
+        dut_frame_errors,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0
     );
     
+    if (status != STATUS_OK) {
+        cout << "ERROR: Unexpected status " << (int)status << endl;
+        return 1;
+    }
+    
     // Read output from stream
     for (int y = 0; y < TEST_HEIGHT; y++) {
         for (int x = 0; x < TEST_WIDTH; x++) {
@@ -115,118 +256,2952 @@ int test_filter(
         }
     }
     
-    // Calculate statistics
-    int min_val = 255, max_val = 0;
-    long sum = 0;
+    // Statistics come from the DUT, not a second pass over the frame
+    cout << "Output Statistics:" << endl;
+    cout << "  Min pixel value: " << dut_stats.min << endl;
+    cout << "  Max pixel value: " << dut_stats.max << endl;
+    cout << "  Avg pixel value: " << (dut_stats.sum / (TEST_WIDTH * TEST_HEIGHT)) << endl;
+    
+    return check_stats(&output[0][0], TEST_WIDTH * TEST_HEIGHT);
+}
+
+// ============================================
+// Run Multi-Pixel-Per-Clock Test
+// ============================================
+// Streams the image through a PPC kernel and checks it bit for bit
+// against the 1 pixel/clock output in reference.
+template<int PPC>
+int test_ppc(
+    void (*kernel)(typename ppc_stream<PPC>::stream_t &,
+                   typename ppc_stream<PPC>::stream_t &,
+                   ap_uint<8>, ap_uint<16>, ap_uint<16>, ap_uint<16>,
+                   ap_uint<8> &),
+    pixel_t input[TEST_HEIGHT][TEST_WIDTH],
+    pixel_t reference[TEST_HEIGHT][TEST_WIDTH],
+    ap_uint<8> filter_mode,
+    ap_uint<16> threshold
+) {
+    const int LANE = PIXEL_TDATA_BITS;
+    typename ppc_stream<PPC>::stream_t src_stream;
+    typename ppc_stream<PPC>::stream_t dst_stream;
     
+    // Pack PPC pixels per beat
     for (int y = 0; y < TEST_HEIGHT; y++) {
-        for (int x = 0; x < TEST_WIDTH; x++) {
-            int val = output[y][x];
-            if (val < min_val) min_val = val;
-            if (val > max_val) max_val = val;
-            sum += val;
+        for (int x = 0; x < TEST_WIDTH; x += PPC) {
+            typename ppc_stream<PPC>::beat_t beat;
+            for (int p = 0; p < PPC; p++) {
+                beat.data.range(LANE * p + LANE - 1, LANE * p) = input[y][x + p];
+            }
+            beat.keep = -1;
+            beat.strb = -1;
+            beat.user = (y == 0 && x == 0) ? 1 : 0;  // SOF
+            beat.last = (x + PPC == TEST_WIDTH) ? 1 : 0; // EOL
+            beat.id = 0;
+            beat.dest = 0;
+            src_stream.write(beat);
         }
     }
     
-    cout << "Output Statistics:" << endl;
-    cout << "  Min pixel value: " << min_val << endl;
-    cout << "  Max pixel value: " << max_val << endl;
-    cout << "  Avg pixel value: " << (sum / (TEST_WIDTH * TEST_HEIGHT)) << endl;
+    ap_uint<8> status;
+    kernel(src_stream, dst_stream, filter_mode, threshold,
+           TEST_WIDTH, TEST_HEIGHT, status);
+    
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x += PPC) {
+            typename ppc_stream<PPC>::beat_t beat = dst_stream.read();
+            if (beat.last != ((x + PPC == TEST_WIDTH) ? 1 : 0)) {
+                cout << "ERROR: PPC=" << PPC << " TLAST mismatch at ("
+                     << x << "," << y << ")" << endl;
+                errors++;
+            }
+            for (int p = 0; p < PPC; p++) {
+                pixel_t val = beat.data.range(LANE * p + PIXEL_BITS - 1, LANE * p);
+                if (val != reference[y][x + p]) {
+                    cout << "ERROR: PPC=" << PPC << " mismatch at ("
+                         << x + p << "," << y << ")" << endl;
+                    errors++;
+                }
+            }
+        }
+    }
     
-    return 0;
+    cout << "  PPC=" << PPC << ": "
+         << (errors ? "MISMATCH" : "bit-exact") << endl;
+    return errors;
 }
 
 // ============================================
-// Main Testbench
+// Run Fused Filter Chain Test
 // ============================================
-int main() {
-    cout << "========================================" << endl;
-    cout << " Image Processing Accelerator Testbench" << endl;
-    cout << "========================================" << endl;
-    cout << "Image size: " << TEST_WIDTH << " x " << TEST_HEIGHT << endl;
+// Runs the chain in one image_pros pass and checks it against one
+// full-frame pass per stage.
+int test_chain(
+    pixel_t input[TEST_HEIGHT][TEST_WIDTH],
+    const ap_uint<8> modes[],
+    int num_stages,
+    ap_uint<8> threshold,
+    const char* chain_name
+) {
+    static pixel_t expected[TEST_HEIGHT][TEST_WIDTH];
+    static pixel_t scratch[TEST_HEIGHT][TEST_WIDTH];
     
-    // Allocate images
-    static pixel_t input_image[TEST_HEIGHT][TEST_WIDTH];
-    static pixel_t output_image[TEST_HEIGHT][TEST_WIDTH];
+    // Reference: separate frame round trips
+    memcpy(expected, input, sizeof(expected));
+    ap_uint<32> filter_chain = 0;
+    for (int i = 0; i < num_stages; i++) {
+        test_filter(expected, scratch, modes[i], threshold, chain_name);
+        memcpy(expected, scratch, sizeof(expected));
+        filter_chain.range(8 * i + 7, 8 * i) = modes[i];
+    }
     
-    // Generate test pattern
-    generate_test_image(input_image);
-    save_pgm("input.pgm", input_image);
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
     
-    int errors = 0;
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            axis_pixel_t pixel;
+            pixel.data = input[y][x];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;  // SOF
+            pixel.last = (x == TEST_WIDTH - 1) ? 1 : 0; // EOL
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+    }
     
-    // ========================================
-    // Test 1: Bypass (No Processing)
-    // ========================================
-    errors += test_filter(input_image, output_image, 
-                         FILTER_BYPASS, 128, "BYPASS");
-    save_pgm("output_bypass.pgm", output_image);
+    // filter_select is ignored once filter_chain is non-zero
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_NEGATIVE,
+               threshold, TEST_WIDTH, TEST_HEIGHT, status, INPUT_GRAY,
+               filter_chain, 0, 0, 0, 0, dut_stats.histogram, dut_stats.min,
+               dut_stats.max, dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+           dut_frame_errors, 0, 0, 0, 0, 0, 0, 0);
     
-    // Verify bypass outputs same as input
+    int errors = (status == STATUS_OK) ? 0 : 1;
     for (int y = 0; y < TEST_HEIGHT; y++) {
         for (int x = 0; x < TEST_WIDTH; x++) {
-            if (input_image[y][x] != output_image[y][x]) {
-                cout << "ERROR: Bypass mismatch at (" << x << "," << y << ")" << endl;
+            axis_pixel_t pixel = dst_stream.read();
+            if (pixel.data != expected[y][x]) {
+                cout << "ERROR: Chain mismatch at (" << x << "," << y << ")" << endl;
                 errors++;
             }
         }
     }
     
-    // ========================================
-    // Test 2: Sobel Edge Detection
-    // ========================================
-    errors += test_filter(input_image, output_image, 
-                         FILTER_SOBEL, 128, "SOBEL EDGE DETECTION");
-    save_pgm("output_sobel.pgm", output_image);
+    cout << "  Fused chain: " << (errors ? "MISMATCH" : "matches separate passes") << endl;
+    return errors;
+}
+
+// ============================================
+// Run Wide-Frame Test on a MAX_WIDTH Profile
+// ============================================
+// Streams a width x height gradient frame through kernel and returns
+// its status; output pixels are stored row-major in output.
+ap_uint<8> run_profile(
+    image_pros_fn_t kernel,
+    ap_uint<8> filter_mode,
+    int width,
+    int height,
+    pixel_t *output,
+    int &beats_left
+) {
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
     
-    // ========================================
-    // Test 3: Threshold
-    // ========================================
-    errors += test_filter(input_image, output_image, 
-                         FILTER_THRESHOLD, 100, "THRESHOLD (val=100)");
-    save_pgm("output_threshold.pgm", output_image);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            axis_pixel_t pixel;
+            pixel.data = ((x / 8) * 7 + y * 13) % 256;
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;
+            pixel.last = (x == width - 1) ? 1 : 0;
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+    }
     
-    // Verify threshold outputs are binary
+    ap_uint<8> status;
+    kernel(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_mode, 128,
+           width, height, status, INPUT_GRAY, 0, 0, 0, 0, 0, dut_stats.histogram,
+           dut_stats.min, dut_stats.max, dut_stats.sum, dut_stats.sum_sq,
+           dut_lut, 0, 0, dut_frame_errors, 0, 0, 0, 0, 0, 0, 0);
+    
+    int i = 0;
+    while (!dst_stream.empty()) {
+        output[i++] = dst_stream.read().data;
+    }
+    beats_left = src_stream.size();
+    
+    return status;
+}
+
+// ============================================
+// Run RGB Input Test
+// ============================================
+// Streams an RGB version of the image on src_rgb and checks the output
+// against the grayscale path fed with independently computed luma.
+int test_rgb(
+    pixel_t input[TEST_HEIGHT][TEST_WIDTH],
+    ap_uint<8> filter_mode,
+    ap_uint<2> input_format,
+    const char* filter_name
+) {
+    static pixel_t luma[TEST_HEIGHT][TEST_WIDTH];
+    static pixel_t expected[TEST_HEIGHT][TEST_WIDTH];
+    
+    const int *k = (input_format == INPUT_RGB_709) ? LUMA_BT709 : LUMA_BT601;
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    
+    // Derive colour channels from the gray pattern
     for (int y = 0; y < TEST_HEIGHT; y++) {
         for (int x = 0; x < TEST_WIDTH; x++) {
-            if (output_image[y][x] != 0 && output_image[y][x] != 255) {
-                cout << "ERROR: Threshold output not binary at (" << x << "," << y << ")" << endl;
-                errors++;
-            }
+            int r = input[y][x];
+            int g = (input[y][x] + 4 * x) % 256;
+            int b = 255 - input[y][x];
+            luma[y][x] = (k[0] * r + k[1] * g + k[2] * b + 128) >> 8;
+            
+            axis_rgb_t pixel;
+            pixel.data = (r << 16) | (g << 8) | b;
+            pixel.keep = 7;
+            pixel.strb = 7;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;  // SOF
+            pixel.last = (x == TEST_WIDTH - 1) ? 1 : 0; // EOL
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_rgb_stream.write(pixel);
         }
     }
     
-    // ========================================
-    // Test 4: Gaussian Blur
-    // ========================================
-    errors += test_filter(input_image, output_image, 
-                         FILTER_GAUSSIAN, 128, "GAUSSIAN BLUR");
-    save_pgm("output_gaussian.pgm", output_image);
+    test_filter(luma, expected, filter_mode, 100, filter_name);
     
-    // ========================================
-    // Test 5: Negative
-    // ========================================
-    errors += test_filter(input_image, output_image, 
-                         FILTER_NEGATIVE, 128, "NEGATIVE");
-    save_pgm("output_negative.pgm", output_image);
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_mode, 100,
+               TEST_WIDTH, TEST_HEIGHT, status, input_format, 0, 0, 0, 0, 0,
+               dut_stats.histogram, dut_stats.min, dut_stats.max, dut_stats.sum,
+               dut_stats.sum_sq, dut_lut, 0, 0, dut_frame_errors, 0, 0, 0, 0, 0, 0,
+               0);
     
-    // Verify negative: output = 255 - input
+    int errors = (status == STATUS_OK) ? 0 : 1;
     for (int y = 0; y < TEST_HEIGHT; y++) {
         for (int x = 0; x < TEST_WIDTH; x++) {
-            pixel_t expected = 255 - input_image[y][x];
-            if (output_image[y][x] != expected) {
-                cout << "ERROR: Negative mismatch at (" << x << "," << y << ")" << endl;
+            axis_pixel_t pixel = dst_stream.read();
+            if (pixel.data != expected[y][x]) {
+                cout << "ERROR: RGB mismatch at (" << x << "," << y << ")" << endl;
                 errors++;
             }
         }
     }
     
-    // ========================================
-    // Test 6: Sharpen
-    // ========================================
-    errors += test_filter(input_image, output_image, 
-                         FILTER_SHARPEN, 128, "SHARPEN");
-    save_pgm("output_sharpen.pgm", output_image);
+    cout << "  RGB input: " << (errors ? "MISMATCH" : "matches luma path") << endl;
+    return errors;
+}
+
+// ============================================
+// CPU Reference Configuration
+// ============================================
+// This build's blur size with every coefficient register 0
+cpu_ref_config_t build_config() {
+    cpu_ref_config_t config;
+    cpu_ref_config_init(&config);
+    config.blur_kernel_size = BLUR_KERNEL_SIZE;
+    return config;
+}
+
+// conv_coeffs register from its 32-bit words, bits 31~0 first
+conv_coeffs_t conv_register(const uint32_t words[CPU_REF_CONV_WORDS]) {
+    conv_coeffs_t coeffs = 0;
+    for (int i = 0; i < CPU_REF_CONV_WORDS; i++) {
+        int msb = (32 * i + 31 < 8 * CONV_TAPS) ? 32 * i + 31 : 8 * CONV_TAPS - 1;
+        coeffs.range(msb, 32 * i) = words[i];
+    }
+    return coeffs;
+}
+
+// Packs a size x size kernel (row-major) into config
+void set_conv(cpu_ref_config_t &config, const int *taps, int size,
+              int shift, int bias) {
+    memset(config.conv_coeffs, 0, sizeof(config.conv_coeffs));
+    for (int i = 0; i < size * size; i++) {
+        config.conv_coeffs[i / 4] |= (uint32_t)(taps[i] & 0xFF) << (8 * (i % 4));
+    }
+    config.conv_ctrl = (shift & 0xF) | ((size == 5) << CONV_CTRL_SIZE5_BIT) |
+                       ((uint32_t)(bias & 0xFFFF) << CONV_CTRL_BIAS_LSB);
+}
+
+// ============================================
+// Run CPU Reference Equivalence Test
+// ============================================
+// Streams a width x height frame through image_pros and checks every
+// supported CPU reference ISA against it byte for byte.
+int test_cpu_ref(
+    const uint8_t *input,
+    int width,
+    int height,
+    ap_uint<8> filter_select,
+    ap_uint<32> filter_chain,
+    ap_uint<8> threshold,
+    const cpu_ref_config_t &config = build_config()
+) {
+    static uint8_t expected[MAX_WIDTH * MAX_HEIGHT];
+    static uint8_t actual[MAX_WIDTH * MAX_HEIGHT];
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            axis_pixel_t pixel;
+            pixel.data = input[y * width + x];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;  // SOF
+            pixel.last = (x == width - 1) ? 1 : 0;  // EOL
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+    }
+    
+    // config.lut goes to bank 1 and its complement to bank 0, so a
+    // wrong bank select shows
+    static pixel_t lut[LUT_BANKS * LUT_ENTRIES];
+    for (int i = 0; i < LUT_ENTRIES; i++) {
+        lut[i] = 255 - config.lut[i];
+        lut[LUT_ENTRIES + i] = config.lut[i];
+    }
+    
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_select,
+               threshold, width, height, status, INPUT_GRAY, filter_chain,
+               config.blur_coeffs, conv_register(config.conv_coeffs),
+               config.conv_ctrl, config.threshold_high, dut_stats.histogram,
+               dut_stats.min, dut_stats.max, dut_stats.sum, dut_stats.sum_sq,
+               lut, 1, 0, dut_frame_errors, 0, 0, 0, 0, 0, 0, 0);
+    
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    for (int i = 0; i < width * height; i++) {
+        expected[i] = dst_stream.read().data;
+    }
+    errors += check_stats(expected, width * height);
+    
+    for (int isa = CPU_ISA_SCALAR; isa < CPU_ISA_COUNT; isa++) {
+        if (!cpu_ref_isa_supported((cpu_isa_t)isa)) {
+            continue;
+        }
+        cpu_ref_filter_chain(input, actual, width, height, filter_select,
+                             filter_chain, threshold, (cpu_isa_t)isa, &config);
+        for (int i = 0; i < width * height; i++) {
+            if (actual[i] != expected[i]) {
+                cout << "ERROR: CPU reference (" << cpu_ref_isa_name((cpu_isa_t)isa)
+                     << ") mismatch at (" << i % width << "," << i / width
+                     << ") mode " << filter_select << " chain 0x" << hex
+                     << filter_chain << dec << endl;
+                errors++;
+                break;
+            }
+        }
+    }
+    
+    return errors;
+}
+
+// Sets the learned state of every chain stage from input: one
+// unchecked frame per stage, with only that stage in filter_mode
+// (FILTER_OTSU or FILTER_EQUALIZE), tracked in config.
+void learn_stages(
+    const uint8_t *input,
+    int width,
+    int height,
+    ap_uint<8> filter_mode,
+    cpu_ref_config_t &config
+) {
+    for (int stage = 0; stage < CHAIN_STAGES; stage++) {
+        stream_t src_stream;
+        stream_rgb_t src_rgb_stream;
+        stream_t dst_stream;
+        for (int i = 0; i < width * height; i++) {
+            axis_pixel_t pixel;
+            pixel.data = input[i];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (i == 0) ? 1 : 0;  // SOF
+            pixel.last = (i % width == width - 1) ? 1 : 0;  // EOL
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+        
+        ap_uint<32> filter_chain = (ap_uint<32>)filter_mode << (8 * stage);
+        ap_uint<8> status;
+        image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_BYPASS, 0,
+                   width, height, status, INPUT_GRAY, filter_chain, config.blur_coeffs,
+                   conv_register(config.conv_coeffs), config.conv_ctrl,
+                   config.threshold_high, dut_stats.histogram, dut_stats.min,
+                   dut_stats.max, dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+                   dut_frame_errors, 0, 0, 0, 0, 0, 0, 0);
+        while (!dst_stream.empty()) {
+            dst_stream.read();
+        }
+        cpu_ref_learn_frame(input, width, height, FILTER_BYPASS, filter_chain, 0,
+                            CPU_ISA_SCALAR, &config);
+    }
+}
+
+// ============================================
+// Video Framing
+// ============================================
+// Appends the first rows rows of a frame to src with SOF/EOL sideband.
+// Beat drop_col of row damaged_row is left out, or with extra set an
+// additional beat carries that row's TLAST instead.
+void push_frame(
+    stream_t &src,
+    const uint8_t *input,
+    int width,
+    int rows,
+    int damaged_row = -1,
+    int drop_col = -1,
+    bool extra = false
+) {
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < width; x++) {
+            if (y == damaged_row && x == drop_col) {
+                continue;
+            }
+            axis_pixel_t pixel;
+            pixel.data = input[y * width + x];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;  // SOF
+            pixel.last = (x == width - 1 && !(extra && y == damaged_row)) ? 1 : 0;
+            pixel.id = 0;
+            pixel.dest = 0;
+            src.write(pixel);
+        }
+        if (extra && y == damaged_row) {
+            axis_pixel_t pixel;
+            pixel.data = 0xAA;
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = 0;
+            pixel.last = 1;
+            pixel.id = 0;
+            pixel.dest = 0;
+            src.write(pixel);
+        }
+    }
+}
+
+// Runs one frame_sync frame from src into output and checks the
+// output framing; errors_added is the frame_errors increase.
+int run_framed(
+    stream_t &src,
+    ap_uint<8> filter_select,
+    int width,
+    int height,
+    uint8_t *output,
+    int &errors_added
+) {
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    frame_count_t errors_before = dut_frame_errors;
+    
+    ap_uint<8> status;
+    image_pros(src, src_rgb_stream, dst_stream, dut_grad, filter_select, 0, width,
+               height, status, INPUT_GRAY, 0, 0, 0, 0, 0, dut_stats.histogram,
+               dut_stats.min, dut_stats.max, dut_stats.sum, dut_stats.sum_sq,
+               dut_lut, 0, 1, dut_frame_errors, 0, 0, 0, 0, 0, 0, 0);
+    errors_added = (int)(dut_frame_errors - errors_before);
+    
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    for (int i = 0; i < width * height; i++) {
+        axis_pixel_t pixel = dst_stream.read();
+        output[i] = pixel.data;
+        bool sof = (i == 0);
+        bool eol = (i % width == width - 1);
+        if (pixel.user != sof || pixel.last != eol) {
+            cout << "ERROR: Output framing at (" << i % width << "," << i / width
+                 << ")" << endl;
+            errors++;
+            break;
+        }
+    }
+    if (!dst_stream.empty()) {
+        cout << "ERROR: Extra output beats" << endl;
+        errors++;
+    }
+    return errors;
+}
+
+// ============================================
+// Run Scaler Test
+// ============================================
+// Streams a width x height frame through image_pros with the scaler
+// set and checks size, framing and pixels against the CPU reference
+// (scale, then filter, or the other way round).
+int test_scale(
+    const uint8_t *input,
+    int width,
+    int height,
+    ap_uint<8> filter_select,
+    ap_uint<32> filter_chain,
+    ap_uint<8> scale_ctrl,
+    int out_width,
+    int out_height
+) {
+    static uint8_t actual[MAX_WIDTH * MAX_HEIGHT];
+    static uint8_t expected[MAX_WIDTH * MAX_HEIGHT];
+    static uint8_t scratch[MAX_WIDTH * MAX_HEIGHT];
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    push_frame(src_stream, input, width, height);
+    
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_select, 100,
+               width, height, status, INPUT_GRAY, filter_chain, 0, 0, 0, 0,
+               dut_stats.histogram, dut_stats.min, dut_stats.max, dut_stats.sum,
+               dut_stats.sum_sq, dut_lut, 0, 0, dut_frame_errors, scale_ctrl,
+               out_width, out_height, 0, 0, 0, 0);
+    
+    int out_size = out_width * out_height;
+    int beats = 0;
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    while (!dst_stream.empty()) {
+        axis_pixel_t pixel = dst_stream.read();
+        if (beats < out_size) {
+            actual[beats] = pixel.data;
+        }
+        bool sof = (beats == 0);
+        bool eol = (beats % out_width == out_width - 1);
+        if (errors == 0 && (pixel.user != sof || pixel.last != eol)) {
+            cout << "ERROR: Scaled framing at beat " << beats << endl;
+            errors++;
+        }
+        beats++;
+    }
+    if (beats != out_size) {
+        cout << "ERROR: Scaler wrote " << beats << " beats, expected " << out_size
+             << endl;
+        errors++;
+    }
+    if (errors) {
+        return errors;
+    }
+    errors += check_stats(actual, out_size);
+    
+    int scale_mode = scale_ctrl.range(SCALE_CTRL_MODE_MSB, 0);
+    if (scale_ctrl[SCALE_CTRL_AFTER_BIT]) {
+        cpu_ref_filter_chain(input, scratch, width, height, filter_select,
+                             filter_chain, 100, CPU_ISA_SCALAR);
+        cpu_ref_scale(scratch, width, height, expected, out_width, out_height,
+                      scale_mode);
+    } else {
+        cpu_ref_scale(input, width, height, scratch, out_width, out_height, scale_mode);
+        cpu_ref_filter_chain(scratch, expected, out_width, out_height, filter_select,
+                             filter_chain, 100, CPU_ISA_SCALAR);
+    }
+    for (int i = 0; i < out_size; i++) {
+        if (actual[i] != expected[i]) {
+            cout << "ERROR: Scaler 0x" << hex << scale_ctrl << dec << " " << width
+                 << "x" << height << " -> " << out_width << "x" << out_height
+                 << " mismatch at (" << i % out_width << "," << i / out_width << ")"
+                 << endl;
+            errors++;
+            break;
+        }
+    }
+    return errors;
+}
+
+// ============================================
+// Run ROI Test
+// ============================================
+// rects[i] = {x, y, width, height} in output-frame coordinates
+roi_rects_t pack_rois(const int rects[][4], int count) {
+    roi_rects_t packed = 0;
+    for (int i = 0; i < count; i++) {
+        for (int f = 0; f < 4; f++) {
+            packed.range(64 * i + 16 * f + 15, 64 * i + 16 * f) = rects[i][f];
+        }
+    }
+    return packed;
+}
+
+// Runs the frame once in full and once cropped to the regions; the
+// cropped beats must be the full output's pixels inside the regions,
+// in raster order, tagged and framed per region, with the same
+// statistics.
+int test_roi(
+    const uint8_t *input,
+    int width,
+    int height,
+    ap_uint<8> filter_select,
+    ap_uint<32> filter_chain,
+    ap_uint<8> scale_ctrl,
+    int out_width,
+    int out_height,
+    const int rects[][4],
+    int count
+) {
+    static uint8_t full[MAX_WIDTH * MAX_HEIGHT];
+    int errors = 0;
+    
+    for (int pass = 0; pass < 2; pass++) {
+        stream_t src_stream;
+        stream_rgb_t src_rgb_stream;
+        stream_t dst_stream;
+        push_frame(src_stream, input, width, height);
+        
+        ap_uint<8> status;
+        image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_select, 100,
+                   width, height, status, INPUT_GRAY, filter_chain, 0, 0, 0, 0,
+                   dut_stats.histogram, dut_stats.min, dut_stats.max, dut_stats.sum,
+                   dut_stats.sum_sq, dut_lut, 0, 0, dut_frame_errors, scale_ctrl,
+                   out_width, out_height, pass ? count : 0,
+                   pass ? pack_rois(rects, count) : (roi_rects_t)0, 0, 0);
+        if (status != STATUS_OK) {
+            cout << "ERROR: ROI frame status " << status << endl;
+            return 1;
+        }
+        
+        if (pass == 0) {
+            for (int i = 0; i < out_width * out_height; i++) {
+                full[i] = dst_stream.read().data;
+            }
+            errors += check_stats(full, out_width * out_height);
+            continue;
+        }
+        
+        // Statistics still describe the whole output frame
+        errors += check_stats(full, out_width * out_height);
+        for (int y = 0; y < out_height && errors == 0; y++) {
+            for (int x = 0; x < out_width && errors == 0; x++) {
+                int tag = -1;
+                for (int r = 0; r < count; r++) {
+                    if (x >= rects[r][0] && x < rects[r][0] + rects[r][2] &&
+                        y >= rects[r][1] && y < rects[r][1] + rects[r][3]) {
+                        tag = r;
+                    }
+                }
+                if (tag < 0) {
+                    continue;
+                }
+                if (dst_stream.empty()) {
+                    cout << "ERROR: ROI output ends before (" << x << "," << y << ")"
+                         << endl;
+                    errors++;
+                    break;
+                }
+                axis_pixel_t pixel = dst_stream.read();
+                bool sof = (x == rects[tag][0] && y == rects[tag][1]);
+                bool eol = (x == rects[tag][0] + rects[tag][2] - 1);
+                if (pixel.data != full[y * out_width + x] || pixel.dest != tag ||
+                    pixel.id != tag || pixel.user != sof || pixel.last != eol) {
+                    cout << "ERROR: ROI " << tag << " beat at (" << x << "," << y
+                         << ") data " << pixel.data << " dest " << pixel.dest
+                         << " user " << pixel.user << " last " << pixel.last << endl;
+                    errors++;
+                }
+            }
+        }
+        if (!dst_stream.empty()) {
+            cout << "ERROR: Extra ROI output beats" << endl;
+            errors++;
+        }
+    }
+    return errors;
+}
+
+// ============================================
+// Run Border Mode Test
+// ============================================
+// Streams a width x height frame through image_pros with
+// config.border_ctrl and checks size, framing, statistics and pixels
+// against the CPU reference (scaler as in test_scale). output, if
+// given, receives the frame.
+int test_border(
+    const uint8_t *input,
+    int width,
+    int height,
+    ap_uint<8> filter_select,
+    ap_uint<32> filter_chain,
+    ap_uint<8> threshold,
+    const cpu_ref_config_t &config,
+    ap_uint<8> scale_ctrl = 0,
+    int out_width = 0,
+    int out_height = 0,
+    uint8_t *output = 0
+) {
+    static uint8_t actual[MAX_WIDTH * MAX_HEIGHT];
+    static uint8_t expected[MAX_WIDTH * MAX_HEIGHT];
+    static uint8_t scratch[MAX_WIDTH * MAX_HEIGHT];
+    
+    // Crop trims every stage; a scaler in front sets the chain size
+    int modes[CPU_REF_CHAIN_STAGES];
+    int num_modes = cpu_ref_chain_modes(filter_select, filter_chain, modes);
+    int crop = 0;
+    for (int i = 0; i < num_modes; i++) {
+        crop += cpu_ref_border_crop(modes[i], &config);
+    }
+    int scale_mode = scale_ctrl.range(SCALE_CTRL_MODE_MSB, 0);
+    bool after = scale_ctrl[SCALE_CTRL_AFTER_BIT];
+    int chain_w = (scale_mode != SCALE_NONE && !after) ? out_width : width;
+    int chain_h = (scale_mode != SCALE_NONE && !after) ? out_height : height;
+    int dst_w = (scale_mode != SCALE_NONE && after) ? out_width : chain_w - 2 * crop;
+    int dst_h = (scale_mode != SCALE_NONE && after) ? out_height : chain_h - 2 * crop;
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    push_frame(src_stream, input, width, height);
+    
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_select,
+               threshold, width, height, status, INPUT_GRAY, filter_chain,
+               config.blur_coeffs, conv_register(config.conv_coeffs), config.conv_ctrl,
+               config.threshold_high, dut_stats.histogram, dut_stats.min,
+               dut_stats.max, dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+               dut_frame_errors, scale_ctrl, out_width, out_height, 0, 0,
+               config.border_ctrl, 0);
+    
+    int out_size = dst_w * dst_h;
+    int beats = 0;
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    while (!dst_stream.empty()) {
+        axis_pixel_t pixel = dst_stream.read();
+        if (beats < out_size) {
+            actual[beats] = pixel.data;
+        }
+        bool sof = (beats == 0);
+        bool eol = (beats % dst_w == dst_w - 1);
+        if (errors == 0 && (pixel.user != sof || pixel.last != eol)) {
+            cout << "ERROR: Border framing at beat " << beats << endl;
+            errors++;
+        }
+        beats++;
+    }
+    if (beats != out_size) {
+        cout << "ERROR: Border mode 0x" << hex << config.border_ctrl << dec
+             << " wrote " << beats << " beats, expected " << out_size << endl;
+        errors++;
+    }
+    if (errors) {
+        return errors;
+    }
+    errors += check_stats(actual, out_size);
+    if (output) {
+        memcpy(output, actual, out_size);
+    }
+    
+    if (scale_mode != SCALE_NONE && after) {
+        cpu_ref_filter_chain(input, scratch, width, height, filter_select,
+                             filter_chain, threshold, CPU_ISA_SCALAR, &config);
+        cpu_ref_scale(scratch, width - 2 * crop, height - 2 * crop, expected,
+                      out_width, out_height, scale_mode);
+    } else if (scale_mode != SCALE_NONE) {
+        cpu_ref_scale(input, width, height, scratch, out_width, out_height, scale_mode);
+        cpu_ref_filter_chain(scratch, expected, out_width, out_height, filter_select,
+                             filter_chain, threshold, CPU_ISA_SCALAR, &config);
+    } else {
+        cpu_ref_filter_chain(input, expected, width, height, filter_select,
+                             filter_chain, threshold, CPU_ISA_SCALAR, &config);
+    }
+    for (int i = 0; i < out_size; i++) {
+        if (actual[i] != expected[i]) {
+            cout << "ERROR: Border mode 0x" << hex << config.border_ctrl << dec
+                 << " filter " << filter_select << " chain 0x" << hex << filter_chain
+                 << dec << " " << width << "x" << height << " mismatch at ("
+                 << i % dst_w << "," << i / dst_w << ")" << endl;
+            errors++;
+            break;
+        }
+    }
+    return errors;
+}
+
+// ============================================
+// Run Gradient Output Test
+// ============================================
+// Streams a width x height frame through image_pros with grad_enable
+// set and checks dst against the CPU reference and every dst_grad
+// beat against cpu_ref_gradient() of the frame dst carried. grad, if
+// given, receives the beats.
+int test_grad(
+    const uint8_t *input,
+    int width,
+    int height,
+    ap_uint<8> filter_select,
+    const cpu_ref_config_t &config,
+    uint64_t *grad = 0
+) {
+    static uint8_t frame[MAX_WIDTH * MAX_HEIGHT];
+    static uint8_t expected_frame[MAX_WIDTH * MAX_HEIGHT];
+    static uint64_t actual[MAX_WIDTH * MAX_HEIGHT];
+    static uint64_t expected[MAX_WIDTH * MAX_HEIGHT];
+    
+    int crop = cpu_ref_border_crop(filter_select, &config);
+    int dst_w = width - 2 * crop;
+    int dst_h = height - 2 * crop;
+    int out_size = dst_w * dst_h;
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    push_frame(src_stream, input, width, height);
+    
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, filter_select, 0,
+               width, height, status, INPUT_GRAY, 0, config.blur_coeffs,
+               conv_register(config.conv_coeffs), config.conv_ctrl,
+               config.threshold_high, dut_stats.histogram, dut_stats.min,
+               dut_stats.max, dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+               dut_frame_errors, 0, 0, 0, 0, 0, config.border_ctrl, 1);
+    
+    // dst is unchanged by the gradient tap
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    int beats = 0;
+    while (!dst_stream.empty()) {
+        axis_pixel_t pixel = dst_stream.read();
+        if (beats < out_size) {
+            frame[beats] = pixel.data;
+        }
+        beats++;
+    }
+    cpu_ref_filter(input, expected_frame, width, height, filter_select, 0,
+                   CPU_ISA_SCALAR, &config);
+    if (beats != out_size || memcmp(frame, expected_frame, out_size) != 0) {
+        cout << "ERROR: Gradient tap changed dst (border 0x" << hex
+             << config.border_ctrl << dec << ")" << endl;
+        errors++;
+    }
+    
+    beats = 0;
+    while (!dut_grad.empty()) {
+        axis_grad_t beat = dut_grad.read();
+        if (beats < out_size) {
+            actual[beats] = beat.data.to_uint64();
+        }
+        bool sof = (beats == 0);
+        bool eol = (beats % dst_w == dst_w - 1);
+        if (errors == 0 && (beat.user != sof || beat.last != eol)) {
+            cout << "ERROR: Gradient framing at beat " << beats << endl;
+            errors++;
+        }
+        beats++;
+    }
+    if (beats != out_size) {
+        cout << "ERROR: Gradient output wrote " << beats << " beats, expected "
+             << out_size << endl;
+        errors++;
+    }
+    if (errors) {
+        return errors;
+    }
+    if (grad) {
+        memcpy(grad, actual, out_size * sizeof(uint64_t));
+    }
+    
+    cpu_ref_gradient(frame, expected, dst_w, dst_h, &config);
+    for (int i = 0; i < out_size; i++) {
+        if (actual[i] != expected[i]) {
+            cout << "ERROR: Gradient border 0x" << hex << config.border_ctrl
+                 << " filter " << dec << filter_select << " " << width << "x" << height
+                 << " is 0x" << hex << actual[i] << " at (" << dec << i % dst_w << ","
+                 << i / dst_w << "), expected 0x" << hex << expected[i] << dec << endl;
+            errors++;
+            break;
+        }
+    }
+    return errors;
+}
+
+// ============================================
+// Golden-Image Regression Cases
+// ============================================
+// One manifest line per case, fields separated by whitespace:
+//   name input format mode threshold chain hash golden
+// input   image file (P5 for gray, P6 for RGB formats) relative to the
+//         manifest, or gen:gradient:WxH / gen:noise:WxH
+// format  gray, rgb601 or rgb709 (input_format register)
+// mode    filter_select, by name or number
+// chain   filter_chain register, e.g. 0x030204 (0 = filter_select)
+// hash    pnm_hash() of the output, - if not recorded yet
+// golden  expected output P5 relative to the manifest, or -
+const char* GOLDEN_MODES[] = {
+    "bypass", "grayscale", "sobel", "threshold", "gaussian", "negative", "sharpen",
+    "blur", "conv", "median", "erode", "dilate", "open", "close", "canny",
+    "adaptive", "otsu", "lut", "equalize"
+};
+
+struct golden_case_t {
+    string name;
+    string input;
+    string format;
+    string mode;
+    int threshold;
+    string chain;
+    string hash;
+    string golden;
+};
+
+// Narrowest MAX_WIDTH profile that holds the frame
+image_pros_fn_t golden_kernel(int width) {
+    if (width <= MAX_WIDTH) return image_pros;
+    if (width <= MAX_WIDTH_1080P) return image_pros_1080p;
+    return image_pros_4k;
+}
+
+bool golden_input(const string &dir, const string &spec, pnm_image_t &image) {
+    if (spec.compare(0, 4, "gen:") != 0) {
+        return pnm_read((dir + spec).c_str(), image);
+    }
+    
+    char pattern[16];
+    if (sscanf(spec.c_str(), "gen:%15[a-z]:%dx%d", pattern,
+               &image.width, &image.height) != 3 ||
+        image.width <= 0 || image.height <= 0) {
+        cout << "ERROR: Bad generator " << spec << endl;
+        return false;
+    }
+    image.channels = 1;
+    image.data.resize((size_t)image.width * image.height);
+    
+    unsigned int seed = 12345;
+    for (int y = 0; y < image.height; y++) {
+        for (int x = 0; x < image.width; x++) {
+            uint8_t value;
+            if (string(pattern) == "noise") {
+                seed = seed * 1103515245 + 12345;
+                value = (seed >> 16) & 0xFF;
+            } else {
+                value = ((x / 8) * 7 + y * 13) % 256;   // As run_profile
+            }
+            image.data[(size_t)y * image.width + x] = value;
+        }
+    }
+    return true;
+}
+
+int parse_golden_mode(const string &mode) {
+    for (int i = 0; i < (int)(sizeof(GOLDEN_MODES) / sizeof(GOLDEN_MODES[0])); i++) {
+        if (mode == GOLDEN_MODES[i]) {
+            return i;
+        }
+    }
+    return atoi(mode.c_str());
+}
+
+// Streams one case through image_pros; returns its error count and
+// stores the output hash in hash_out
+int run_golden_case(const string &dir, const golden_case_t &tc, bool update,
+                    char hash_out[17]) {
+    pnm_image_t input;
+    if (!golden_input(dir, tc.input, input)) {
+        return 1;
+    }
+    
+    int format = (tc.format == "rgb601") ? INPUT_RGB_601 :
+                 (tc.format == "rgb709") ? INPUT_RGB_709 : INPUT_GRAY;
+    if (input.channels != ((format == INPUT_GRAY) ? 1 : 3)) {
+        cout << "ERROR: " << tc.name << ": " << tc.input
+             << " does not match format " << tc.format << endl;
+        return 1;
+    }
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    const uint8_t *p = input.data.data();
+    
+    for (int y = 0; y < input.height; y++) {
+        for (int x = 0; x < input.width; x++) {
+            bool sof = (y == 0 && x == 0);
+            bool eol = (x == input.width - 1);
+            if (format == INPUT_GRAY) {
+                axis_pixel_t pixel;
+                pixel.data = *p++;
+                pixel.keep = 1;
+                pixel.strb = 1;
+                pixel.user = sof;
+                pixel.last = eol;
+                pixel.id = 0;
+                pixel.dest = 0;
+                src_stream.write(pixel);
+            } else {
+                axis_rgb_t pixel;
+                pixel.data = (p[0] << 16) | (p[1] << 8) | p[2];
+                p += 3;
+                pixel.keep = 7;
+                pixel.strb = 7;
+                pixel.user = sof;
+                pixel.last = eol;
+                pixel.id = 0;
+                pixel.dest = 0;
+                src_rgb_stream.write(pixel);
+            }
+        }
+    }
+    
+    ap_uint<8> status;
+    golden_kernel(input.width)(src_stream, src_rgb_stream, dst_stream, dut_grad,
+                               parse_golden_mode(tc.mode), tc.threshold,
+                               input.width, input.height, status, format,
+                               (unsigned int)strtoul(tc.chain.c_str(), 0, 0),
+                               0, 0, 0, 0, dut_stats.histogram, dut_stats.min,
+                               dut_stats.max, dut_stats.sum, dut_stats.sum_sq,
+                               dut_lut, 0, 0, dut_frame_errors, 0, 0, 0, 0, 0, 0,
+                               0);
+    if (status != STATUS_OK) {
+        cout << "ERROR: " << tc.name << ": status " << (int)status << endl;
+        return 1;
+    }
+    
+    pnm_image_t output;
+    output.width = input.width;
+    output.height = input.height;
+    output.channels = 1;
+    output.data.resize((size_t)input.width * input.height);
+    for (size_t i = 0; i < output.data.size(); i++) {
+        output.data[i] = dst_stream.read().data;
+    }
+    snprintf(hash_out, 17, "%016llx",
+             (unsigned long long)pnm_hash(output.data.data(), output.data.size()));
+    
+    if (update) {
+        if (tc.golden != "-" && !pnm_write((dir + tc.golden).c_str(), output)) {
+            return 1;
+        }
+        return 0;
+    }
+    
+    int errors = 0;
+    if (tc.hash != hash_out) {
+        cout << "ERROR: " << tc.name << ": hash " << hash_out
+             << ", expected " << tc.hash << endl;
+        errors++;
+    }
+    
+    if (tc.golden != "-") {
+        pnm_image_t golden;
+        if (!pnm_read((dir + tc.golden).c_str(), golden) ||
+            golden.width != output.width || golden.height != output.height ||
+            golden.channels != 1) {
+            cout << "ERROR: " << tc.name << ": unusable golden " << tc.golden << endl;
+            return errors + 1;
+        }
+        long diffs = 0;
+        for (size_t i = 0; i < output.data.size(); i++) {
+            if (output.data[i] != golden.data[i]) {
+                if (diffs == 0) {
+                    cout << "ERROR: " << tc.name << ": first difference at ("
+                         << i % output.width << "," << i / output.width << "): "
+                         << (int)output.data[i] << " vs golden "
+                         << (int)golden.data[i] << endl;
+                }
+                diffs++;
+            }
+        }
+        if (diffs) {
+            cout << "  " << diffs << " pixels differ, output saved as "
+                 << tc.name << "_actual.pgm" << endl;
+            pnm_write((tc.name + "_actual.pgm").c_str(), output);
+            errors++;
+        }
+    }
+    
+    return errors;
+}
+
+// Runs every case in the manifest. With update set, records the
+// current output as golden instead: hashes are rewritten in the
+// manifest and golden images regenerated.
+int run_golden(const char* manifest, bool update) {
+    cout << "\n========================================" << endl;
+    cout << "Testing: GOLDEN IMAGES (" << manifest << ")" << endl;
+    cout << "========================================" << endl;
+    
+    ifstream file(manifest);
+    if (!file.is_open()) {
+        cout << "ERROR: Cannot open manifest " << manifest << endl;
+        return 1;
+    }
+    
+    string path(manifest);
+    size_t slash = path.find_last_of('/');
+    string dir = (slash == string::npos) ? "" : path.substr(0, slash + 1);
+    
+    vector<string> lines;
+    string line;
+    int errors = 0;
+    int cases = 0;
+    clock_t start = clock();
+    
+    while (getline(file, line)) {
+        golden_case_t tc;
+        istringstream fields(line);
+        if (line.empty() || line[0] == '#' ||
+            !(fields >> tc.name >> tc.input >> tc.format >> tc.mode >>
+              tc.threshold >> tc.chain >> tc.hash >> tc.golden)) {
+            if (!line.empty() && line[0] != '#') {
+                cout << "ERROR: Bad manifest line: " << line << endl;
+                errors++;
+            }
+            lines.push_back(line);
+            continue;
+        }
+        
+        clock_t t0 = clock();
+        char hash[17];
+        int case_errors = run_golden_case(dir, tc, update, hash);
+        errors += case_errors;
+        cases++;
+        cout << "  " << tc.name << ": " << (case_errors ? "FAIL" : "ok") << " ("
+             << (clock() - t0) * 1000 / CLOCKS_PER_SEC << " ms)" << endl;
+        
+        char buf[512];
+        snprintf(buf, sizeof(buf), "%-18s %-24s %-7s %-10s %3d %-9s %-16s %s",
+                 tc.name.c_str(), tc.input.c_str(), tc.format.c_str(),
+                 tc.mode.c_str(), tc.threshold, tc.chain.c_str(),
+                 case_errors ? tc.hash.c_str() : hash, tc.golden.c_str());
+        lines.push_back(buf);
+    }
+    file.close();
+    
+    if (update && errors == 0) {
+        ofstream out(manifest);
+        for (size_t i = 0; i < lines.size(); i++) {
+            out << lines[i] << "\n";
+        }
+        cout << "  Manifest updated" << endl;
+    }
+    
+    cout << "  " << cases << " golden cases in "
+         << (clock() - start) * 1000 / CLOCKS_PER_SEC << " ms" << endl;
+    return errors;
+}
+
+// ============================================
+// Pixel Depth Model
+// ============================================
+// Test 25 registers: the binomial blur (blur_coeffs 0), a signed 3x3
+// kernel whose results clip at both ends, and the Canny high
+// threshold (threshold_val is the low one)
+const int DEPTH_CONV[9] = {
+    -1, -1,  0,
+    -1,  5,  1,
+     0,  1,  1
+};
+#define DEPTH_CONV_SHIFT  2
+#define DEPTH_CONV_BIAS   (-(16 << PIXEL_EXTRA_BITS))
+#define DEPTH_CANNY_HIGH  (300 << PIXEL_EXTRA_BITS)
+
+// Sobel sums of the legacy window ending at (x, y)
+void depth_sobel(pixel_t image[TEST_HEIGHT][TEST_WIDTH], int x, int y,
+                 int &gx, int &gy) {
+    gx = 0;
+    gy = 0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            gx += image[y - 2 + i][x - 2 + j] * SOBEL_X[i][j];
+            gy += image[y - 2 + i][x - 2 + j] * SOBEL_Y[i][j];
+        }
+    }
+}
+
+// Canny magnitude and direction at (x, y); 0 before row and column 2
+int depth_canny_mag(pixel_t image[TEST_HEIGHT][TEST_WIDTH], int x, int y, int &dir) {
+    dir = CANNY_DIR_H;
+    if (y < 2 || x < 2) {
+        return 0;
+    }
+    int gx, gy;
+    depth_sobel(image, x, y, gx, gy);
+    int ax = abs(gx), ay = abs(gy);
+    if (ay * 128 <= ax * CANNY_TAN22_Q7) {
+        dir = CANNY_DIR_H;
+    } else if (ay * 128 >= ax * CANNY_TAN67_Q7) {
+        dir = CANNY_DIR_V;
+    } else {
+        dir = ((gx < 0) == (gy < 0)) ? CANNY_DIR_D45 : CANNY_DIR_D135;
+    }
+    return ax + ay;
+}
+
+// NMS class of the magnitude window ending at (x, y), centred on
+// (x - 1, y - 1)
+int depth_canny_class(pixel_t image[TEST_HEIGHT][TEST_WIDTH], int x, int y,
+                      int threshold) {
+    if (y < 2 || x < 2) {
+        return CANNY_NONE;
+    }
+    int mag[3][3], dir, centre_dir;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            mag[i][j] = depth_canny_mag(image, x - 2 + j, y - 2 + i, dir);
+        }
+    }
+    depth_canny_mag(image, x - 1, y - 1, centre_dir);
+    
+    int before, after;
+    switch (centre_dir) {
+        case CANNY_DIR_H:   before = mag[1][0]; after = mag[1][2]; break;
+        case CANNY_DIR_D45: before = mag[0][0]; after = mag[2][2]; break;
+        case CANNY_DIR_V:   before = mag[0][1]; after = mag[2][1]; break;
+        default:            before = mag[0][2]; after = mag[2][0]; break;
+    }
+    if (mag[1][1] < before || mag[1][1] <= after) {
+        return CANNY_NONE;
+    }
+    if (mag[1][1] >= DEPTH_CANNY_HIGH) {
+        return CANNY_STRONG;
+    }
+    return (mag[1][1] >= threshold) ? CANNY_WEAK : CANNY_NONE;
+}
+
+// Scalar model of the point filters, the 3x3 filters, the blur, the
+// convolution, Canny and the signed gradients at PIXEL_BITS, for the
+// builds cpu_ref (8-bit) does not cover. Legacy windows end at
+// (x, y): the 3x3 ones are valid from row and column 2, the blur from
+// BLUR_KERNEL_SIZE - 1, and Canny's hysteresis window is centred one
+// row and column back over classes centred one further.
+int depth_model(pixel_t image[TEST_HEIGHT][TEST_WIDTH], int x, int y, int mode,
+                int threshold) {
+    int centre = image[y][x];
+    if (mode == FILTER_THRESHOLD) {
+        return (centre > threshold) ? PIXEL_MAX : 0;
+    }
+    if (mode == FILTER_NEGATIVE) {
+        return PIXEL_MAX - centre;
+    }
+    if (mode == FILTER_BYPASS) {
+        return centre;
+    }
+    if (mode == FILTER_BLUR) {
+        const int K = BLUR_KERNEL_SIZE, C = (K - 1) / 2;
+        if (y < K - 1 || x < K - 1) {
+            return centre;
+        }
+        int64_t sum = 0;
+        for (int i = 0; i < K; i++) {
+            for (int j = 0; j < K; j++) {
+                int wy = BLUR_BINOMIAL[(K - 3) / 2][abs(i - C)];
+                int wx = BLUR_BINOMIAL[(K - 3) / 2][abs(j - C)];
+                sum += (int64_t)wy * wx * image[y - K + 1 + i][x - K + 1 + j];
+            }
+        }
+        return (int)(sum >> 16);
+    }
+    if (y < 2 || x < 2) {
+        bool black = (mode == FILTER_SOBEL || mode == FILTER_GRAD_X ||
+                      mode == FILTER_GRAD_Y || mode == FILTER_CANNY);
+        return black ? 0 : centre;
+    }
+    if (mode == FILTER_CANNY) {
+        bool strong = false;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                strong |= (depth_canny_class(image, x - 2 + j, y - 2 + i, threshold) ==
+                           CANNY_STRONG);
+            }
+        }
+        int cls = depth_canny_class(image, x - 1, y - 1, threshold);
+        bool edge = (cls == CANNY_STRONG) || (cls == CANNY_WEAK && strong);
+        return edge ? PIXEL_MAX : 0;
+    }
+    
+    int p[9];
+    int gx, gy, gauss = 0, sharp = 0, conv = 0;
+    depth_sobel(image, x, y, gx, gy);
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            int v = image[y - 2 + i][x - 2 + j];
+            p[3 * i + j] = v;
+            gauss += v * GAUSSIAN[i][j];
+            sharp += v * SHARPEN[i][j];
+            conv += v * DEPTH_CONV[3 * i + j];
+        }
+    }
+    sort(p, p + 9);
+    
+    switch (mode) {
+        case FILTER_SOBEL:    return min(abs(gx) + abs(gy), PIXEL_MAX);
+        case FILTER_GAUSSIAN: return gauss >> 4;
+        case FILTER_SHARPEN:  return max(0, min(sharp, PIXEL_MAX));
+        case FILTER_MEDIAN:   return p[4];
+        case FILTER_ERODE:    return p[0];
+        case FILTER_DILATE:   return p[8];
+        case FILTER_CONV:
+            return max(0, min((conv >> DEPTH_CONV_SHIFT) + DEPTH_CONV_BIAS, PIXEL_MAX));
+        default: {
+            int g = (mode == FILTER_GRAD_X) ? gx : gy;
+            return max(GRAD_MIN, min(g, GRAD_MAX)) & PIXEL_MAX;
+        }
+    }
+}
+
+// Scaler model at PIXEL_BITS, as cpu_ref_scale()
+void depth_scale(pixel_t image[TEST_HEIGHT][TEST_WIDTH], int out_width, int out_height,
+                 int scale_mode, pixel_t output[TEST_HEIGHT][TEST_WIDTH]) {
+    if (scale_mode == SCALE_BOX) {
+        // Input row/column y belongs to output row y * out_height / height
+        for (int oy = 0, y0 = 0; oy < out_height; oy++) {
+            int y1 = y0;
+            while (y1 < TEST_HEIGHT && y1 * out_height / TEST_HEIGHT == oy) {
+                y1++;
+            }
+            for (int ox = 0, x0 = 0; ox < out_width; ox++) {
+                int x1 = x0;
+                while (x1 < TEST_WIDTH && x1 * out_width / TEST_WIDTH == ox) {
+                    x1++;
+                }
+                int64_t sum = 0;
+                for (int y = y0; y < y1; y++) {
+                    for (int x = x0; x < x1; x++) {
+                        sum += image[y][x];
+                    }
+                }
+                int64_t total = (x1 - x0) * (y1 - y0);
+                output[oy][ox] = (sum + total / 2) / total;
+                x0 = x1;
+            }
+            y0 = y1;
+        }
+        return;
+    }
+    
+    uint32_t step_x = ((uint32_t)TEST_WIDTH << 16) / out_width;
+    uint32_t step_y = ((uint32_t)TEST_HEIGHT << 16) / out_height;
+    uint32_t sy = (step_y >> 1) - 32768;
+    for (int oy = 0; oy < out_height; oy++, sy += step_y) {
+        int y0 = sy >> 16;
+        int64_t wy = (sy >> 8) & 255;
+        int y1 = wy ? y0 + 1 : y0;
+        uint32_t sx = (step_x >> 1) - 32768;
+        for (int ox = 0; ox < out_width; ox++, sx += step_x) {
+            int x0 = sx >> 16;
+            int64_t wx = (sx >> 8) & 255;
+            int x1 = wx ? x0 + 1 : x0;
+            int64_t t = (int64_t)image[y0][x0] * (256 - wx) + image[y0][x1] * wx;
+            int64_t b = (int64_t)image[y1][x0] * (256 - wx) + image[y1][x1] * wx;
+            output[oy][ox] = (t * (256 - wy) + b * wy + 32768) >> 16;
+        }
+    }
+}
+
+// Scales input to out_width x out_height ahead of a bypass chain and
+// checks the pixels and statistics against depth_scale()
+int test_depth_scale(pixel_t input[TEST_HEIGHT][TEST_WIDTH], int scale_mode,
+                     int out_width, int out_height, const char* name) {
+    static pixel_t expected[TEST_HEIGHT][TEST_WIDTH];
+    static pixel_t actual[TEST_HEIGHT * TEST_WIDTH];
+    
+    stream_t src_stream;
+    stream_rgb_t src_rgb_stream;
+    stream_t dst_stream;
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            axis_pixel_t pixel;
+            pixel.data = input[y][x];
+            pixel.keep = 1;
+            pixel.strb = 1;
+            pixel.user = (y == 0 && x == 0) ? 1 : 0;  // SOF
+            pixel.last = (x == TEST_WIDTH - 1) ? 1 : 0; // EOL
+            pixel.id = 0;
+            pixel.dest = 0;
+            src_stream.write(pixel);
+        }
+    }
+    
+    ap_uint<8> status;
+    image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_BYPASS, 0,
+               TEST_WIDTH, TEST_HEIGHT, status, INPUT_GRAY, 0, 0, 0, 0, 0,
+               dut_stats.histogram, dut_stats.min, dut_stats.max, dut_stats.sum,
+               dut_stats.sum_sq, dut_lut, 0, 0, dut_frame_errors, scale_mode,
+               out_width, out_height, 0, 0, 0, 0);
+    
+    int errors = (status == STATUS_OK) ? 0 : 1;
+    int beats = 0;
+    while (!dst_stream.empty()) {
+        axis_pixel_t pixel = dst_stream.read();
+        if (beats < out_width * out_height) {
+            actual[beats] = pixel.data;
+        }
+        beats++;
+    }
+    if (beats != out_width * out_height) {
+        cout << "ERROR: " << name << " wrote " << beats << " pixels, expected "
+             << out_width * out_height << endl;
+        return errors + 1;
+    }
+    
+    depth_scale(input, out_width, out_height, scale_mode, expected);
+    for (int i = 0; i < out_width * out_height; i++) {
+        int x = i % out_width, y = i / out_width;
+        if (actual[i] != expected[y][x]) {
+            cout << "ERROR: " << name << " is " << actual[i] << " at (" << x << ","
+                 << y << "), expected " << expected[y][x] << endl;
+            errors++;
+            break;
+        }
+    }
+    return errors + check_stats(actual, out_width * out_height);
+}
+
+// ============================================
+// Main Testbench
+// ============================================
+// Optional arguments: golden manifest path, and --update-golden to
+// record the current outputs as the new golden set.
+int main(int argc, char **argv) {
+#if PIXEL_BITS == 8
+    const char* manifest = GOLDEN_MANIFEST;
+    bool update_golden = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update-golden") == 0) {
+            update_golden = true;
+        } else {
+            manifest = argv[i];
+        }
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
+    
+    cout << "========================================" << endl;
+    cout << " Image Processing Accelerator Testbench" << endl;
+    cout << "========================================" << endl;
+    cout << "Image size: " << TEST_WIDTH << " x " << TEST_HEIGHT << endl;
+    cout << "Pixel depth: " << PIXEL_BITS << " bits" << endl;
+    
+    // Allocate images
+    static pixel_t input_image[TEST_HEIGHT][TEST_WIDTH];
+    static pixel_t output_image[TEST_HEIGHT][TEST_WIDTH];
+    
+    // Generate test pattern
+    generate_test_image(input_image);
+    save_pgm("input.pgm", input_image);
+    
+    int errors = 0;
+    
+    // Tests 1-24 check against cpu_ref and the golden images, which
+    // model the 8-bit build; Test 25 runs at every depth
+#if PIXEL_BITS == 8
+    // ========================================
+    // Test 1: Bypass (No Processing)
+    // ========================================
+    errors += test_filter(input_image, output_image, 
+                         FILTER_BYPASS, 128, "BYPASS");
+    save_pgm("output_bypass.pgm", output_image);
+    
+    // Verify bypass outputs same as input
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            if (input_image[y][x] != output_image[y][x]) {
+                cout << "ERROR: Bypass mismatch at (" << x << "," << y << ")" << endl;
+                errors++;
+            }
+        }
+    }
+    
+    // ========================================
+    // Test 2: Sobel Edge Detection
+    // ========================================
+    errors += test_filter(input_image, output_image, 
+                         FILTER_SOBEL, 128, "SOBEL EDGE DETECTION");
+    save_pgm("output_sobel.pgm", output_image);
+    
+    // ========================================
+    // Test 3: Threshold
+    // ========================================
+    errors += test_filter(input_image, output_image, 
+                         FILTER_THRESHOLD, 100, "THRESHOLD (val=100)");
+    save_pgm("output_threshold.pgm", output_image);
+    
+    // Verify threshold outputs are binary
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            if (output_image[y][x] != 0 && output_image[y][x] != 255) {
+                cout << "ERROR: Threshold output not binary at (" << x << "," << y << ")" << endl;
+                errors++;
+            }
+        }
+    }
+    
+    // ========================================
+    // Test 4: Gaussian Blur
+    // ========================================
+    errors += test_filter(input_image, output_image, 
+                         FILTER_GAUSSIAN, 128, "GAUSSIAN BLUR");
+    save_pgm("output_gaussian.pgm", output_image);
+    
+    // ========================================
+    // Test 5: Negative
+    // ========================================
+    errors += test_filter(input_image, output_image, 
+                         FILTER_NEGATIVE, 128, "NEGATIVE");
+    save_pgm("output_negative.pgm", output_image);
+    
+    // Verify negative: output = 255 - input
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            pixel_t expected = 255 - input_image[y][x];
+            if (output_image[y][x] != expected) {
+                cout << "ERROR: Negative mismatch at (" << x << "," << y << ")" << endl;
+                errors++;
+            }
+        }
+    }
+    
+    // ========================================
+    // Test 6: Sharpen
+    // ========================================
+    errors += test_filter(input_image, output_image, 
+                         FILTER_SHARPEN, 128, "SHARPEN");
+    save_pgm("output_sharpen.pgm", output_image);
+    
+    // ========================================
+    // Test 7: Multi-Pixel-Per-Clock Datapath
+    // ========================================
+    // Modes 7-8 and 12-18 need more than the 3x3 window and are
+    // rejected by the PPC variants (checked in Test 10)
+    const int ppc_modes[] = {
+        FILTER_BYPASS, FILTER_GRAYSCALE, FILTER_SOBEL, FILTER_THRESHOLD,
+        FILTER_GAUSSIAN, FILTER_NEGATIVE, FILTER_SHARPEN,
+        FILTER_MEDIAN, FILTER_ERODE, FILTER_DILATE
+    };
+    const char* ppc_names[] = {
+        "PPC BYPASS", "PPC GRAYSCALE", "PPC SOBEL", "PPC THRESHOLD",
+        "PPC GAUSSIAN", "PPC NEGATIVE", "PPC SHARPEN",
+        "PPC MEDIAN", "PPC ERODE", "PPC DILATE"
+    };
+    
+    for (int m = 0; m < 10; m++) {
+        int mode = ppc_modes[m];
+        errors += test_filter(input_image, output_image,
+                              mode, 100, ppc_names[m]);
+        errors += test_ppc<2>(image_pros_ppc2, input_image, output_image, mode, 100);
+        errors += test_ppc<4>(image_pros_ppc4, input_image, output_image, mode, 100);
+        errors += test_ppc<8>(image_pros_ppc8, input_image, output_image, mode, 100);
+    }
+    
+    // ========================================
+    // Test 8: RGB Input with On-the-Fly Luma
+    // ========================================
+    errors += test_rgb(input_image, FILTER_GRAYSCALE, INPUT_RGB_601,
+                       "RGB BT.601 GRAYSCALE");
+    errors += test_rgb(input_image, FILTER_GRAYSCALE, INPUT_RGB_709,
+                       "RGB BT.709 GRAYSCALE");
+    errors += test_rgb(input_image, FILTER_SOBEL, INPUT_RGB_601,
+                       "RGB BT.601 SOBEL");
+    
+    // ========================================
+    // Test 9: Fused Filter Chains
+    // ========================================
+    const ap_uint<8> edge_chain[] = {FILTER_GAUSSIAN, FILTER_SOBEL, FILTER_THRESHOLD};
+    errors += test_chain(input_image, edge_chain, 3, 60,
+                         "CHAIN GAUSSIAN -> SOBEL -> THRESHOLD");
+    
+    const ap_uint<8> full_chain[] = {FILTER_SHARPEN, FILTER_GAUSSIAN,
+                                     FILTER_NEGATIVE, FILTER_SOBEL};
+    errors += test_chain(input_image, full_chain, 4, 128,
+                         "CHAIN SHARPEN -> GAUSSIAN -> NEGATIVE -> SOBEL");
+    
+    // ========================================
+    // Test 10: MAX_WIDTH Profiles
+    // ========================================
+    cout << "\n========================================" << endl;
+    cout << "Testing: MAX_WIDTH PROFILES" << endl;
+    cout << "========================================" << endl;
+    
+    const int WIDE_W = MAX_WIDTH_1080P;
+    const int WIDE_H = 8;
+    static pixel_t wide_1080p[WIDE_W * WIDE_H];
+    static pixel_t wide_4k[WIDE_W * WIDE_H];
+    int beats_left;
+    
+    // Overflowing width must be rejected without consuming input
+    ap_uint<8> status = run_profile(image_pros, FILTER_SOBEL, WIDE_W, WIDE_H,
+                                    wide_1080p, beats_left);
+    if (status != STATUS_ERR_WIDTH || beats_left != WIDE_W * WIDE_H) {
+        cout << "ERROR: 640 profile accepted a " << WIDE_W << " wide frame" << endl;
+        errors++;
+    }
+    
+    // 1080p and 4K profiles must agree on a full-HD wide frame
+    for (int mode = FILTER_BYPASS; mode <= FILTER_ADAPTIVE; mode++) {
+        status = run_profile(image_pros_1080p, mode, WIDE_W, WIDE_H,
+                             wide_1080p, beats_left);
+        errors += (status != STATUS_OK);
+        status = run_profile(image_pros_4k, mode, WIDE_W, WIDE_H,
+                             wide_4k, beats_left);
+        errors += (status != STATUS_OK);
+        
+        if (memcmp(wide_1080p, wide_4k, sizeof(wide_4k)) != 0) {
+            cout << "ERROR: 1080p/4K profile mismatch in mode " << mode << endl;
+            errors++;
+        }
+    }
+    
+    // PPC kernels reject widths that are not a multiple of PPC
+    {
+        stream_ppc4_t src_stream, dst_stream;
+        image_pros_ppc4(src_stream, dst_stream, FILTER_BYPASS, 128,
+                        TEST_WIDTH + 2, TEST_HEIGHT, status);
+        if (status != STATUS_ERR_WIDTH) {
+            cout << "ERROR: PPC=4 accepted an unaligned width" << endl;
+            errors++;
+        }
+    }
+    
+    // and modes beyond the 3x3 window, without touching the streams
+    const int ppc_rejected[] = {
+        FILTER_BLUR, FILTER_CONV, FILTER_OPEN, FILTER_CLOSE, FILTER_CANNY,
+        FILTER_ADAPTIVE, FILTER_OTSU, FILTER_LUT, FILTER_EQUALIZE, FILTER_GRAD_Y + 1
+    };
+    for (int m = 0; m < 10; m++) {
+        stream_ppc4_t src_stream, dst_stream;
+        ppc_stream<4>::beat_t beat;
+        beat.data = 0;
+        beat.last = 0;
+        src_stream.write(beat);
+        image_pros_ppc4(src_stream, dst_stream, ppc_rejected[m], 128,
+                        TEST_WIDTH, TEST_HEIGHT, status);
+        if (status != STATUS_ERR_MODE || src_stream.size() != 1 || !dst_stream.empty()) {
+            cout << "ERROR: PPC=4 accepted mode " << ppc_rejected[m] << endl;
+            errors++;
+        }
+    }
+    cout << "  Width checks and profile comparison done" << endl;
+    
+    // ========================================
+    // Test 11: CPU Reference Engine
+    // ========================================
+    cout << "\n========================================" << endl;
+    cout << "Testing: CPU REFERENCE ENGINE" << endl;
+    cout << "========================================" << endl;
+    
+    // Test image plus an odd-sized noise frame, so every SIMD width
+    // ends in a scalar tail and the 8-bit clamps are hit
+    const int ODD_W = 333;
+    const int ODD_H = 23;
+    static uint8_t test_frame[TEST_WIDTH * TEST_HEIGHT];
+    static uint8_t odd_frame[ODD_W * ODD_H];
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            test_frame[y * TEST_WIDTH + x] = input_image[y][x];
+        }
+    }
+    unsigned int seed = 12345;
+    for (int i = 0; i < ODD_W * ODD_H; i++) {
+        seed = seed * 1103515245 + 12345;
+        odd_frame[i] = (seed >> 16) & 0xFF;
+    }
+    
+    // CPU side of this build's registers (blur_coeffs = 0)
+    const cpu_ref_config_t hw_config = build_config();
+    
+    int cpu_errors = 0;
+    for (int mode = FILTER_BYPASS; mode <= FILTER_ADAPTIVE; mode++) {
+        cpu_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                   mode, 0, 100);
+        cpu_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, mode, 0, 100);
+    }
+    for (int mode = FILTER_GRAD_X; mode <= FILTER_GRAD_Y; mode++) {
+        cpu_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT, mode, 0, 0);
+        cpu_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, mode, 0, 0);
+    }
+    // Chains, including a mode beyond filter_mode_t (passes through)
+    cpu_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                               0x03020004, 60);
+    cpu_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_NEGATIVE,
+                               0x02054006, 128);
+    
+    // Full-HD row width against the 1080p profile
+    for (int mode = FILTER_BYPASS; mode <= FILTER_ADAPTIVE; mode++) {
+        static pixel_t pattern[WIDE_W * WIDE_H];
+        static uint8_t wide_in[WIDE_W * WIDE_H];
+        static uint8_t wide_out[WIDE_W * WIDE_H];
+        
+        run_profile(image_pros_1080p, FILTER_BYPASS, WIDE_W, WIDE_H,
+                    pattern, beats_left);
+        run_profile(image_pros_1080p, mode, WIDE_W, WIDE_H,
+                    wide_1080p, beats_left);
+        for (int i = 0; i < WIDE_W * WIDE_H; i++) {
+            wide_in[i] = pattern[i];
+        }
+        cpu_ref_filter(wide_in, wide_out, WIDE_W, WIDE_H, mode, 128,
+                       cpu_ref_best_isa(), &hw_config);
+        for (int i = 0; i < WIDE_W * WIDE_H; i++) {
+            if (wide_out[i] != wide_1080p[i]) {
+                cout << "ERROR: CPU reference 1080p mismatch in mode " << mode << endl;
+                cpu_errors++;
+                break;
+            }
+        }
+    }
+    errors += cpu_errors;
+    cout << "  CPU reference: " << (cpu_errors ? "MISMATCH" : "bit-exact")
+         << " (best ISA " << cpu_ref_isa_name(cpu_ref_best_isa()) << ")" << endl;
+    
+    // Informational full-HD throughput per ISA
+    {
+        const int HD_W = 1920;
+        const int HD_H = 1080;
+        const int HD_RUNS = 10;
+        uint8_t *hd_in = new uint8_t[HD_W * HD_H];
+        uint8_t *hd_out = new uint8_t[HD_W * HD_H];
+        for (int i = 0; i < HD_W * HD_H; i++) {
+            hd_in[i] = (i * 7) & 0xFF;
+        }
+        for (int isa = CPU_ISA_SCALAR; isa < CPU_ISA_COUNT; isa++) {
+            if (!cpu_ref_isa_supported((cpu_isa_t)isa)) {
+                continue;
+            }
+            clock_t t0 = clock();
+            for (int i = 0; i < HD_RUNS; i++) {
+                cpu_ref_filter(hd_in, hd_out, HD_W, HD_H, FILTER_SOBEL, 0,
+                               (cpu_isa_t)isa);
+            }
+            double seconds = (double)(clock() - t0) / CLOCKS_PER_SEC;
+            if (seconds > 0) {
+                cout << "  1920x1080 Sobel, " << cpu_ref_isa_name((cpu_isa_t)isa)
+                     << ": " << (int)(HD_RUNS / seconds) << " fps" << endl;
+            }
+        }
+        delete[] hd_in;
+        delete[] hd_out;
+    }
+    
+    // ========================================
+    // Test 12: Tiled Multithreaded CPU Fallback
+    // ========================================
+    cout << "\n========================================" << endl;
+    cout << "Testing: TILED CPU FALLBACK" << endl;
+    cout << "========================================" << endl;
+    
+    int tiled_errors = 0;
+    
+    // Bands of 3 rows on a 4K-wide frame against image_pros_4k
+    {
+        const int K4_W = MAX_WIDTH_4K;
+        const int K4_H = 16;
+        static pixel_t pattern[K4_W * K4_H];
+        static pixel_t hw_out[K4_W * K4_H];
+        static uint8_t k4_in[K4_W * K4_H];
+        static uint8_t k4_out[K4_W * K4_H];
+        cpu_pool_t *pool = cpu_pool_create(4);
+        
+        run_profile(image_pros_4k, FILTER_BYPASS, K4_W, K4_H, pattern, beats_left);
+        for (int i = 0; i < K4_W * K4_H; i++) {
+            k4_in[i] = pattern[i];
+        }
+        for (int mode = FILTER_BYPASS; mode <= FILTER_ADAPTIVE; mode++) {
+            run_profile(image_pros_4k, mode, K4_W, K4_H, hw_out, beats_left);
+            cpu_tiled_filter(pool, k4_in, k4_out, K4_W, K4_H, mode, 128, 3,
+                             cpu_ref_best_isa(), &hw_config);
+            for (int i = 0; i < K4_W * K4_H; i++) {
+                if (k4_out[i] != hw_out[i]) {
+                    cout << "ERROR: Tiled 4K mismatch in mode " << mode << endl;
+                    tiled_errors++;
+                    break;
+                }
+            }
+        }
+        cpu_pool_destroy(pool);
+    }
+    
+    // Full 4K frame: every thread count and band size must match the
+    // single-threaded reference, including 1-row bands (all halo)
+    {
+        const int UHD_W = 3840;
+        const int UHD_H = 2160;
+        const int thread_counts[] = {1, 3, 8};
+        const int band_sizes[] = {0, 1, 7};
+        uint8_t *uhd_in = new uint8_t[UHD_W * UHD_H];
+        uint8_t *uhd_ref = new uint8_t[UHD_W * UHD_H];
+        uint8_t *uhd_out = new uint8_t[UHD_W * UHD_H];
+        unsigned int uhd_seed = 777;
+        for (int i = 0; i < UHD_W * UHD_H; i++) {
+            uhd_seed = uhd_seed * 1103515245 + 12345;
+            uhd_in[i] = (uhd_seed >> 16) & 0xFF;
+        }
+        
+        // A 5x5 kernel so FILTER_CONV reads a 4-row halo, and a high
+        // threshold so Canny keeps both weak and strong pixels
+        cpu_ref_config_t uhd_config = hw_config;
+        uhd_config.threshold_high = 300;
+        int ramp_taps[CONV_TAPS];
+        for (int i = 0; i < CONV_TAPS; i++) {
+            ramp_taps[i] = i - CONV_TAPS / 2;
+        }
+        set_conv(uhd_config, ramp_taps, CONV_MAX_SIZE, 4, 128);
+        
+        for (int t = 0; t < 3; t++) {
+            cpu_pool_t *pool = cpu_pool_create(thread_counts[t]);
+            for (int b = 0; b < 3; b++) {
+                for (int mode = FILTER_SOBEL; mode <= FILTER_EQUALIZE; mode++) {
+                    cpu_ref_filter(uhd_in, uhd_ref, UHD_W, UHD_H, mode, 100,
+                                   cpu_ref_best_isa(), &uhd_config);
+                    cpu_tiled_filter(pool, uhd_in, uhd_out, UHD_W, UHD_H, mode,
+                                     100, band_sizes[b], cpu_ref_best_isa(),
+                                     &uhd_config);
+                    if (memcmp(uhd_ref, uhd_out, UHD_W * UHD_H) != 0) {
+                        cout << "ERROR: Tiled mismatch, " << thread_counts[t]
+                             << " threads, band " << band_sizes[b]
+                             << ", mode " << mode << endl;
+                        tiled_errors++;
+                    }
+                }
+            }
+            
+            cpu_ref_filter_chain(uhd_in, uhd_ref, UHD_W, UHD_H, FILTER_BYPASS,
+                                 0x03020004, 60, cpu_ref_best_isa());
+            cpu_tiled_filter_chain(pool, uhd_in, uhd_out, UHD_W, UHD_H,
+                                   FILTER_BYPASS, 0x03020004, 60, 0,
+                                   cpu_ref_best_isa());
+            if (memcmp(uhd_ref, uhd_out, UHD_W * UHD_H) != 0) {
+                cout << "ERROR: Tiled chain mismatch, " << thread_counts[t]
+                     << " threads" << endl;
+                tiled_errors++;
+            }
+            cpu_pool_destroy(pool);
+        }
+        
+        // Informational 4K throughput, one thread against all cores
+        cpu_pool_t *single = cpu_pool_create(1);
+        cpu_pool_t *all = cpu_pool_create(0);
+        cpu_pool_t *pools[] = {single, all};
+        for (int p = 0; p < 2; p++) {
+            const int UHD_RUNS = 20;
+            // clock() sums CPU time over threads; use the wall clock
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            for (int i = 0; i < UHD_RUNS; i++) {
+                cpu_tiled_filter(pools[p], uhd_in, uhd_out, UHD_W, UHD_H,
+                                 FILTER_SOBEL, 0, 0, cpu_ref_best_isa());
+            }
+            double seconds = chrono::duration<double>(
+                chrono::steady_clock::now() - t0).count();
+            cout << "  3840x2160 Sobel, " << cpu_pool_threads(pools[p])
+                 << " thread(s): " << (int)(UHD_RUNS / seconds) << " fps, "
+                 << cpu_pool_steals(pools[p]) << " steals" << endl;
+        }
+        cpu_pool_destroy(single);
+        cpu_pool_destroy(all);
+        
+        delete[] uhd_in;
+        delete[] uhd_ref;
+        delete[] uhd_out;
+    }
+    
+    errors += tiled_errors;
+    cout << "  Tiled fallback: " << (tiled_errors ? "MISMATCH" : "matches hardware") << endl;
+    
+    // ========================================
+    // Test 13: Golden-Image Regression
+    // ========================================
+    errors += run_golden(manifest, update_golden);
+    
+    // ========================================
+    // Test 14: Separable Blur
+    // ========================================
+    errors += test_filter(input_image, output_image, FILTER_BLUR, 100, "BLUR");
+    save_pgm("output_blur.pgm", output_image);
+    
+    int blur_errors = 0;
+#if BLUR_KERNEL_SIZE == 3
+    // Binomial K=3 taps (128, 64) are the [1 2 1] Gaussian exactly
+    static pixel_t blur_image[TEST_HEIGHT][TEST_WIDTH];
+    memcpy(blur_image, output_image, sizeof(blur_image));
+    errors += test_filter(input_image, output_image, FILTER_GAUSSIAN, 100, "GAUSSIAN");
+    if (memcmp(blur_image, output_image, sizeof(blur_image)) != 0) {
+        cout << "ERROR: K=3 binomial blur differs from Gaussian" << endl;
+        blur_errors++;
+    }
+#endif
+    
+    // Binomial, box (all taps 0x33) and all-0xFF taps, which wrap the
+    // 16-bit horizontal and 24-bit vertical sums
+    const uint32_t blur_words[] = {0, 0x33333333, 0xFFFFFFFF};
+    cpu_ref_config_t blur_config = build_config();
+    for (int i = 0; i < 3; i++) {
+        blur_config.blur_coeffs = blur_words[i];
+        blur_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                    FILTER_BLUR, 0, 100, blur_config);
+        blur_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H,
+                                    FILTER_BLUR, 0, 100, blur_config);
+    }
+    // Blur inside a chain: Sharpen -> Blur -> Sobel
+    blur_config.blur_coeffs = 0x33333333;
+    blur_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                                0x00020706, 100, blur_config);
+    errors += blur_errors;
+    cout << "  Separable blur (K=" << BLUR_KERNEL_SIZE << "): "
+         << (blur_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+    // ========================================
+    // Test 15: Programmable Convolution
+    // ========================================
+    cout << "\n========================================" << endl;
+    cout << "Testing: PROGRAMMABLE CONVOLUTION" << endl;
+    cout << "========================================" << endl;
+    
+    int conv_errors = 0;
+    cpu_ref_config_t conv_config = build_config();
+    
+    // The fixed 3x3 kernels loaded as coefficients give the same frame
+    const int gaussian_taps[9] = {1, 2, 1, 2, 4, 2, 1, 2, 1};
+    const int sharpen_taps[9] = {0, -1, 0, -1, 5, -1, 0, -1, 0};
+    const int *fixed_taps[2] = {gaussian_taps, sharpen_taps};
+    const int fixed_shift[2] = {4, 0};
+    const int fixed_mode[2] = {FILTER_GAUSSIAN, FILTER_SHARPEN};
+    for (int i = 0; i < 2; i++) {
+        static uint8_t fixed_out[ODD_W * ODD_H];
+        static uint8_t conv_out[ODD_W * ODD_H];
+        
+        set_conv(conv_config, fixed_taps[i], KERNEL_SIZE, fixed_shift[i], 0);
+        conv_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_CONV, 0, 100,
+                                    conv_config);
+        cpu_ref_filter(odd_frame, fixed_out, ODD_W, ODD_H, fixed_mode[i], 100,
+                       CPU_ISA_SCALAR);
+        cpu_ref_filter(odd_frame, conv_out, ODD_W, ODD_H, FILTER_CONV, 100,
+                       CPU_ISA_SCALAR, &conv_config);
+        if (memcmp(fixed_out, conv_out, sizeof(conv_out)) != 0) {
+            cout << "ERROR: Coefficient kernel differs from mode "
+                 << fixed_mode[i] << endl;
+            conv_errors++;
+        }
+    }
+    
+    // Random 3x3 and 5x5 kernels with positive and negative bias, then
+    // all -128 and all 127 taps to hit both saturation limits
+    unsigned int conv_seed = 4242;
+    for (int k = 0; k < 6; k++) {
+        int taps[CONV_TAPS];
+        for (int i = 0; i < CONV_TAPS; i++) {
+            conv_seed = conv_seed * 1103515245 + 12345;
+            taps[i] = (k == 4) ? -128 : (k == 5) ? 127 : (int)((conv_seed >> 16) & 0xFF) - 128;
+        }
+        int size = (k % 2) ? CONV_MAX_SIZE : KERNEL_SIZE;
+        set_conv(conv_config, taps, size, (k < 4) ? 3 + 2 * k : 0, (k < 2) ? 128 : -40);
+        conv_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                    FILTER_CONV, 0, 100, conv_config);
+        conv_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H,
+                                    FILTER_CONV, 0, 100, conv_config);
+    }
+    
+    // Inside a chain: Conv (last 5x5 kernel) -> Blur -> Threshold
+    conv_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                                0x00030708, 100, conv_config);
+    errors += conv_errors;
+    cout << "  Programmable convolution: "
+         << (conv_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+    // ========================================
+    // Test 16: Median and Morphology
+    // ========================================
+    const char* morph_names[] = {"MEDIAN", "ERODE", "DILATE", "OPEN", "CLOSE"};
+    const char* morph_files[] = {
+        "output_median.pgm", "output_erode.pgm", "output_dilate.pgm",
+        "output_open.pgm", "output_close.pgm"
+    };
+    for (int mode = FILTER_MEDIAN; mode <= FILTER_CLOSE; mode++) {
+        errors += test_filter(input_image, output_image, mode, 100,
+                              morph_names[mode - FILTER_MEDIAN]);
+        save_pgm(morph_files[mode - FILTER_MEDIAN], output_image);
+    }
+    
+    int morph_errors = 0;
+    static uint8_t morph_out[ODD_W * ODD_H];
+    static uint8_t morph_ref[ODD_W * ODD_H];
+    
+    // Rank filters against a plain sort of each window
+    for (int mode = FILTER_MEDIAN; mode <= FILTER_DILATE; mode++) {
+        int rank = (mode == FILTER_MEDIAN) ? 4 : (mode == FILTER_ERODE) ? 0 : 8;
+        cpu_ref_filter(odd_frame, morph_out, ODD_W, ODD_H, mode, 0, CPU_ISA_SCALAR);
+        for (int y = 2; y < ODD_H; y++) {
+            for (int x = 2; x < ODD_W; x++) {
+                uint8_t p[9];
+                for (int i = 0; i < 9; i++) {
+                    p[i] = odd_frame[(y - 2 + i / 3) * ODD_W + x - 2 + i % 3];
+                }
+                std::sort(p, p + 9);
+                if (morph_out[y * ODD_W + x] != p[rank]) {
+                    cout << "ERROR: " << morph_names[mode - FILTER_MEDIAN]
+                         << " is not rank " << rank << " at (" << x << ","
+                         << y << ")" << endl;
+                    morph_errors++;
+                    y = ODD_H;
+                    break;
+                }
+            }
+        }
+    }
+    
+    // Open/close in one stage equal erode/dilate as two chain stages
+    const uint32_t morph_chains[2] = {
+        FILTER_ERODE | (FILTER_DILATE << 8), FILTER_DILATE | (FILTER_ERODE << 8)
+    };
+    for (int i = 0; i < 2; i++) {
+        int mode = FILTER_OPEN + i;
+        morph_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                                     morph_chains[i], 100);
+        cpu_ref_filter(odd_frame, morph_out, ODD_W, ODD_H, mode, 0, CPU_ISA_SCALAR);
+        cpu_ref_filter_chain(odd_frame, morph_ref, ODD_W, ODD_H, FILTER_BYPASS,
+                             morph_chains[i], 0, CPU_ISA_SCALAR);
+        if (memcmp(morph_out, morph_ref, sizeof(morph_out)) != 0) {
+            cout << "ERROR: " << morph_names[mode - FILTER_MEDIAN]
+                 << " differs from the two-stage chain" << endl;
+            morph_errors++;
+        }
+    }
+    
+    // Threshold -> Open cleans a binary mask: an isolated dot is
+    // removed, a 5x5 block survives (two rows and columns later, like
+    // any two cascaded 3x3 windows)
+    const int MASK_W = 32;
+    const int MASK_H = 24;
+    static uint8_t mask_in[MASK_W * MASK_H];
+    static uint8_t mask_out[MASK_W * MASK_H];
+    memset(mask_in, 20, sizeof(mask_in));
+    mask_in[16 * MASK_W + 20] = 200;
+    for (int y = 5; y < 10; y++) {
+        for (int x = 5; x < 10; x++) {
+            mask_in[y * MASK_W + x] = 200;
+        }
+    }
+    const uint32_t clean_chain = FILTER_THRESHOLD | (FILTER_OPEN << 8);
+    morph_errors += test_cpu_ref(mask_in, MASK_W, MASK_H, FILTER_BYPASS,
+                                 clean_chain, 128);
+    cpu_ref_filter_chain(mask_in, mask_out, MASK_W, MASK_H, FILTER_BYPASS,
+                         clean_chain, 128, CPU_ISA_SCALAR);
+    int white = 0;
+    for (int y = 0; y < MASK_H; y++) {
+        for (int x = 0; x < MASK_W; x++) {
+            bool in_block = (y >= 7 && y < 12 && x >= 7 && x < 12);
+            white += (mask_out[y * MASK_W + x] == 255);
+            if ((mask_out[y * MASK_W + x] == 255) != in_block) {
+                cout << "ERROR: Opened mask wrong at (" << x << "," << y << ")" << endl;
+                morph_errors++;
+                y = MASK_H;
+                break;
+            }
+        }
+    }
+    errors += morph_errors;
+    cout << "  Median/morphology: " << (morph_errors ? "MISMATCH" : "bit-exact")
+         << " (opened mask keeps " << white << " of 26 pixels)" << endl;
+    
+    // ========================================
+    // Test 17: Canny Edge Detector
+    // ========================================
+    errors += test_filter(input_image, output_image, FILTER_CANNY, 100, "CANNY");
+    save_pgm("output_canny.pgm", output_image);
+    
+    int canny_errors = 0;
+    cpu_ref_config_t canny_config = build_config();
+    
+    // low/high pairs: both classes, everything strong, nothing strong
+    const int canny_low[3] = {40, 0, 255};
+    const int canny_high[3] = {120, 0, 2040};
+    for (int i = 0; i < 3; i++) {
+        canny_config.threshold_high = canny_high[i];
+        canny_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                     FILTER_CANNY, 0, canny_low[i], canny_config);
+        canny_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H,
+                                     FILTER_CANNY, 0, canny_low[i], canny_config);
+    }
+    // Inside a chain: Gaussian -> Canny
+    canny_config.threshold_high = 120;
+    canny_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                                 FILTER_GAUSSIAN | (FILTER_CANNY << 8), 40,
+                                 canny_config);
+    
+    // A vertical and a horizontal step (magnitude 720) thin to a single
+    // line three pixels after the second gradient column/row; with a
+    // high threshold above 720 the weak line has no strong seed
+    const int STEP_W = 32;
+    const int STEP_H = 24;
+    static uint8_t step_in[STEP_W * STEP_H];
+    static uint8_t step_out[STEP_W * STEP_H];
+    for (int vertical = 0; vertical < 2; vertical++) {
+        for (int y = 0; y < STEP_H; y++) {
+            for (int x = 0; x < STEP_W; x++) {
+                step_in[y * STEP_W + x] = ((vertical ? x : y) < 16) ? 20 : 200;
+            }
+        }
+        for (int high = 500; high <= 800; high += 300) {
+            canny_config.threshold_high = high;
+            canny_errors += test_cpu_ref(step_in, STEP_W, STEP_H, FILTER_CANNY,
+                                         0, 100, canny_config);
+            cpu_ref_filter(step_in, step_out, STEP_W, STEP_H, FILTER_CANNY, 100,
+                           CPU_ISA_SCALAR, &canny_config);
+            for (int y = 0; y < STEP_H; y++) {
+                for (int x = 0; x < STEP_W; x++) {
+                    bool on_line = (high < 720) &&
+                                   (vertical ? (x == 19 && y >= 4) : (y == 19 && x >= 4));
+                    if ((step_out[y * STEP_W + x] == 255) != on_line) {
+                        cout << "ERROR: Canny step edge wrong at (" << x << ","
+                             << y << "), high " << high << endl;
+                        canny_errors++;
+                        y = STEP_H;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    errors += canny_errors;
+    cout << "  Canny: " << (canny_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+    // ========================================
+    // Test 18: Frame Statistics
+    // ========================================
+    cout << "\n========================================" << endl;
+    cout << "Testing: FRAME STATISTICS" << endl;
+    cout << "========================================" << endl;
+    
+    int stats_errors = 0;
+    const int STATS_W = 640;
+    const int STATS_H = 8;
+    static uint8_t stats_in[MAX_WIDTH_4K * 24];
+    
+    // One value throughout: a single run, flushed after the last pixel
+    memset(stats_in, 77, STATS_W * STATS_H);
+    stats_errors += test_stats(image_pros, stats_in, STATS_W, STATS_H);
+    
+    // Short runs that return to recently written bins (forwarding)
+    unsigned int stats_seed = 99;
+    const uint8_t stats_values[3] = {5, 9, 200};
+    for (int i = 0; i < STATS_W * STATS_H; i++) {
+        stats_seed = stats_seed * 1103515245 + 12345;
+        stats_in[i] = stats_values[(stats_seed >> 16) % 3];
+    }
+    stats_errors += test_stats(image_pros, stats_in, STATS_W, STATS_H);
+    
+    // 4K rows of 255: sum of squares passes 2^32
+    memset(stats_in, 255, sizeof(stats_in));
+    stats_errors += test_stats(image_pros_4k, stats_in, MAX_WIDTH_4K, 24);
+    
+    // A rejected frame leaves the previous statistics in place
+    ap_uint<8> stats_status = run_profile(image_pros, FILTER_BYPASS, WIDE_W, WIDE_H,
+                                          wide_1080p, beats_left);
+    if (stats_status != STATUS_ERR_WIDTH || dut_stats.sum != (stats_sum_t)255 * sizeof(stats_in)) {
+        cout << "ERROR: Rejected frame changed the statistics" << endl;
+        stats_errors++;
+    }
+    errors += stats_errors;
+    cout << "  Frame statistics: " << (stats_errors ? "MISMATCH" : "match the output") << endl;
+    
+    // ========================================
+    // Test 19: Automatic Thresholds
+    // ========================================
+    errors += test_filter(input_image, output_image, FILTER_ADAPTIVE, 8, "ADAPTIVE");
+    save_pgm("output_adaptive.pgm", output_image);
+    
+    int auto_errors = 0;
+    const int adaptive_offsets[3] = {0, 8, 255};
+    for (int i = 0; i < 3; i++) {
+        auto_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                    FILTER_ADAPTIVE, 0, adaptive_offsets[i]);
+        auto_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H,
+                                    FILTER_ADAPTIVE, 0, adaptive_offsets[i]);
+    }
+    
+    // Dark dots on a ramp: only the dots fall below their local mean,
+    // two rows and columns after the dot itself
+    {
+        static uint8_t dots_in[TEST_WIDTH * TEST_HEIGHT];
+        static uint8_t dots_out[TEST_WIDTH * TEST_HEIGHT];
+        for (int y = 0; y < TEST_HEIGHT; y++) {
+            for (int x = 0; x < TEST_WIDTH; x++) {
+                int background = 4 * x;
+                bool dot = (y % 8 == 4) && (x % 8 == 4);
+                dots_in[y * TEST_WIDTH + x] = dot ? max(background - 60, 0) : background;
+            }
+        }
+        auto_errors += test_cpu_ref(dots_in, TEST_WIDTH, TEST_HEIGHT,
+                                    FILTER_ADAPTIVE, 0, 8);
+        cpu_ref_filter(dots_in, dots_out, TEST_WIDTH, TEST_HEIGHT, FILTER_ADAPTIVE, 8,
+                       CPU_ISA_SCALAR);
+        for (int y = 4; y < TEST_HEIGHT; y++) {
+            for (int x = 4; x < TEST_WIDTH; x++) {
+                bool dot = ((y - 2) % 8 == 4) && ((x - 2) % 8 == 4);
+                if (dots_out[y * TEST_WIDTH + x] != (dot ? 0 : 255)) {
+                    cout << "ERROR: Adaptive threshold at (" << x << "," << y << ")" << endl;
+                    auto_errors++;
+                    y = TEST_HEIGHT;
+                    break;
+                }
+            }
+        }
+    }
+    
+    // Two clusters with a gap: Otsu splits at the top of the dark one
+    static uint8_t otsu_in[TEST_WIDTH * TEST_HEIGHT];
+    unsigned int otsu_seed = 4242;
+    int dark_max = 0;
+    for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+        otsu_seed = otsu_seed * 1103515245 + 12345;
+        int r = otsu_seed >> 16;
+        if (r & 1) {
+            otsu_in[i] = 150 + (r >> 1) % 70;
+        } else {
+            otsu_in[i] = 20 + (r >> 1) % 40;
+            dark_max = max(dark_max, (int)otsu_in[i]);
+        }
+    }
+    uint8_t otsu_found = cpu_ref_otsu_level(otsu_in, sizeof(otsu_in));
+    if (otsu_found != dark_max) {
+        cout << "ERROR: Otsu level " << (int)otsu_found << ", expected "
+             << dark_max << endl;
+        auto_errors++;
+    }
+    
+    // The levels come from the previous Otsu or equalize frame, so
+    // image_pros still holds those of earlier tests; set every stage
+    cpu_ref_config_t otsu_config = build_config();
+    learn_stages(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_OTSU, otsu_config);
+    auto_errors += test_cpu_ref(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_OTSU, 0, 0,
+                                otsu_config);
+    cpu_ref_learn_frame(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_OTSU, 0, 0,
+                        CPU_ISA_SCALAR, &otsu_config);
+    
+    // A frame in another mode skips the analysis and keeps the level
+    auto_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_SOBEL, 0, 0,
+                                otsu_config);
+    auto_errors += test_cpu_ref(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_OTSU, 0, 0,
+                                otsu_config);
+    cpu_ref_learn_frame(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_OTSU, 0, 0,
+                        CPU_ISA_SCALAR, &otsu_config);
+    
+    // Each chain stage learns from its own input: the second Otsu sees
+    // the negated binary frame on the second pass
+    const uint32_t otsu_chain = FILTER_GAUSSIAN | (FILTER_OTSU << 8) |
+                                (FILTER_NEGATIVE << 16) | (FILTER_OTSU << 24);
+    for (int pass = 0; pass < 2; pass++) {
+        auto_errors += test_cpu_ref(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS,
+                                    otsu_chain, 0, otsu_config);
+        cpu_ref_learn_frame(otsu_in, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS,
+                            otsu_chain, 0, CPU_ISA_SCALAR, &otsu_config);
+    }
+    errors += auto_errors;
+    cout << "  Auto threshold: " << (auto_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+    // ========================================
+    // Test 20: Lookup Tables
+    // ========================================
+    // Gamma 0.5 through bank 0 of the shared lut memory
+    cpu_ref_config_t lut_config = build_config();
+    for (int i = 0; i < LUT_ENTRIES; i++) {
+        lut_config.lut[i] = (uint8_t)(sqrt(i / 255.0) * 255 + 0.5);
+        dut_lut[i] = lut_config.lut[i];
+    }
+    errors += test_filter(input_image, output_image, FILTER_LUT, 0, "LUT (GAMMA 0.5)");
+    save_pgm("output_lut.pgm", output_image);
+    for (int i = 0; i < LUT_BANKS * LUT_ENTRIES; i++) {
+        dut_lut[i] = 0;
+    }
+    
+    int lut_errors = 0;
+    lut_errors += test_cpu_ref(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_LUT, 0, 0,
+                               lut_config);
+    lut_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_LUT, 0, 0, lut_config);
+    lut_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                               FILTER_GAUSSIAN | (FILTER_LUT << 8) | (FILTER_LUT << 24),
+                               0, lut_config);
+    
+    // Negative and threshold are tables too
+    {
+        static uint8_t point_out[ODD_W * ODD_H];
+        static uint8_t lut_out[ODD_W * ODD_H];
+        const int point_modes[2] = {FILTER_NEGATIVE, FILTER_THRESHOLD};
+        for (int m = 0; m < 2; m++) {
+            for (int i = 0; i < LUT_ENTRIES; i++) {
+                lut_config.lut[i] = (point_modes[m] == FILTER_NEGATIVE) ? 255 - i
+                                  : (i > 100) ? 255 : 0;
+            }
+            lut_errors += test_cpu_ref(odd_frame, ODD_W, ODD_H, FILTER_LUT, 0, 0,
+                                       lut_config);
+            cpu_ref_filter(odd_frame, point_out, ODD_W, ODD_H, point_modes[m], 100,
+                           CPU_ISA_SCALAR);
+            cpu_ref_filter(odd_frame, lut_out, ODD_W, ODD_H, FILTER_LUT, 0,
+                           CPU_ISA_SCALAR, &lut_config);
+            if (memcmp(point_out, lut_out, sizeof(lut_out)) != 0) {
+                cout << "ERROR: LUT differs from mode " << point_modes[m] << endl;
+                lut_errors++;
+            }
+        }
+    }
+    
+    // Equalization of a low-contrast frame (values 100-131) learned
+    // from the frame before: the output spans 0-255
+    static uint8_t flat_in[TEST_WIDTH * TEST_HEIGHT];
+    unsigned int flat_seed = 31;
+    for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+        flat_seed = flat_seed * 1103515245 + 12345;
+        flat_in[i] = 100 + ((flat_seed >> 16) & 31);
+    }
+    cpu_ref_config_t eq_config = build_config();
+    learn_stages(flat_in, TEST_WIDTH, TEST_HEIGHT, FILTER_EQUALIZE, eq_config);
+    lut_errors += test_cpu_ref(flat_in, TEST_WIDTH, TEST_HEIGHT, FILTER_EQUALIZE, 0, 0,
+                               eq_config);
+    if (dut_stats.min != 0 || dut_stats.max != 255) {
+        cout << "ERROR: Equalized range " << dut_stats.min << "-" << dut_stats.max
+             << endl;
+        lut_errors++;
+    }
+    cpu_ref_learn_frame(flat_in, TEST_WIDTH, TEST_HEIGHT, FILTER_EQUALIZE, 0, 0,
+                        CPU_ISA_SCALAR, &eq_config);
+    
+    // Per-stage tables in a chain, next to a programmed LUT
+    for (int i = 0; i < LUT_ENTRIES; i++) {
+        eq_config.lut[i] = (uint8_t)(i / 2);
+    }
+    const uint32_t eq_chain = FILTER_GAUSSIAN | (FILTER_EQUALIZE << 8) |
+                              (FILTER_LUT << 16) | (FILTER_EQUALIZE << 24);
+    for (int pass = 0; pass < 2; pass++) {
+        lut_errors += test_cpu_ref(flat_in, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS,
+                                   eq_chain, 0, eq_config);
+        cpu_ref_learn_frame(flat_in, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS, eq_chain,
+                            0, CPU_ISA_SCALAR, &eq_config);
+    }
+    errors += lut_errors;
+    cout << "  Lookup tables: " << (lut_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+    // ========================================
+    // Test 21: Video Framing
+    // ========================================
+    int framing_errors = 0;
+    {
+        static uint8_t framed_out[TEST_WIDTH * TEST_HEIGHT];
+        static uint8_t framed_ref[TEST_WIDTH * TEST_HEIGHT];
+        stream_t framed_src;
+        int added;
+        
+        // Case: stray beats before the SOF, short line, long line,
+        // early SOF; expected output and frame_errors increase
+        struct framing_case_t {
+            const char *name;
+            int stray;
+            int rows;
+            int damaged_row;
+            int drop_col;
+            bool extra;
+            int expected_errors;
+        };
+        const framing_case_t cases[] = {
+            {"clean",        0, TEST_HEIGHT, -1, -1, false, 0},
+            {"stray beats",  5, TEST_HEIGHT, -1, -1, false, 1},
+            {"short line",   0, TEST_HEIGHT, 10, 20, false, 1},
+            {"long line",    0, TEST_HEIGHT,  7, -1, true,  1},
+            {"early SOF",    0, 40,          -1, -1, false, 1}
+        };
+        
+        for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+            const framing_case_t &tc = cases[c];
+            for (int i = 0; i < tc.stray; i++) {
+                axis_pixel_t pixel;
+                pixel.data = i;
+                pixel.keep = 1;
+                pixel.strb = 1;
+                pixel.user = 0;
+                pixel.last = (i == tc.stray - 1) ? 1 : 0;
+                pixel.id = 0;
+                pixel.dest = 0;
+                framed_src.write(pixel);
+            }
+            push_frame(framed_src, test_frame, TEST_WIDTH, tc.rows, tc.damaged_row,
+                       tc.drop_col, tc.extra);
+            // The early SOF belongs to a full frame queued behind it
+            if (tc.rows < TEST_HEIGHT) {
+                push_frame(framed_src, test_frame, TEST_WIDTH, TEST_HEIGHT);
+            }
+            
+            framing_errors += run_framed(framed_src, FILTER_BYPASS, TEST_WIDTH,
+                                       TEST_HEIGHT, framed_out, added);
+            if (added != tc.expected_errors) {
+                cout << "ERROR: " << tc.name << " counted " << added
+                     << " framing errors" << endl;
+                framing_errors++;
+            }
+            
+            // Repaired pixels: the damaged row loses a beat and ends in
+            // padding; a cut frame is padded after its last row
+            for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+                int x = i % TEST_WIDTH;
+                int y = i / TEST_WIDTH;
+                int expected = test_frame[i];
+                if (y >= tc.rows) {
+                    expected = FRAME_PAD_PIXEL;
+                } else if (y == tc.damaged_row && tc.drop_col >= 0 && x >= tc.drop_col) {
+                    expected = (x == TEST_WIDTH - 1) ? FRAME_PAD_PIXEL : test_frame[i + 1];
+                }
+                if (framed_out[i] != expected) {
+                    cout << "ERROR: " << tc.name << " output at (" << x << "," << y
+                         << ")" << endl;
+                    framing_errors++;
+                    break;
+                }
+            }
+        }
+        
+        // The held SOF starts the next frame in sync, under a window
+        // filter too
+        framing_errors += run_framed(framed_src, FILTER_GAUSSIAN, TEST_WIDTH,
+                                   TEST_HEIGHT, framed_out, added);
+        cpu_ref_filter(test_frame, framed_ref, TEST_WIDTH, TEST_HEIGHT, FILTER_GAUSSIAN,
+                       0, CPU_ISA_SCALAR);
+        if (added != 0 || memcmp(framed_out, framed_ref, sizeof(framed_ref)) != 0) {
+            cout << "ERROR: Frame after early SOF not in sync" << endl;
+            framing_errors++;
+        }
+        if (!framed_src.empty()) {
+            cout << "ERROR: " << framed_src.size() << " input beats left" << endl;
+            framing_errors++;
+        }
+    }
+    errors += framing_errors;
+    cout << "  Framing: " << (framing_errors ? "FAILED" : "resynchronized") << endl;
+    
+    // ========================================
+    // Test 22: Scaler
+    // ========================================
+    int scale_errors = 0;
+    {
+        static uint8_t scaled[TEST_WIDTH * TEST_HEIGHT];
+        
+        // Box at an integer ratio is the plain 2x2 mean (rounded)
+        cpu_ref_scale(test_frame, TEST_WIDTH, TEST_HEIGHT, scaled, TEST_WIDTH / 2,
+                      TEST_HEIGHT / 2, CPU_REF_SCALE_BOX);
+        for (int y = 0; y < TEST_HEIGHT / 2; y++) {
+            for (int x = 0; x < TEST_WIDTH / 2; x++) {
+                const uint8_t *p = test_frame + 2 * y * TEST_WIDTH + 2 * x;
+                int mean = (p[0] + p[1] + p[TEST_WIDTH] + p[TEST_WIDTH + 1] + 2) / 4;
+                if (scaled[y * (TEST_WIDTH / 2) + x] != mean) {
+                    cout << "ERROR: 2x2 box at (" << x << "," << y << ")" << endl;
+                    scale_errors++;
+                    y = TEST_HEIGHT;
+                    break;
+                }
+            }
+        }
+        
+        // Same size is the identity in both modes
+        for (int mode = CPU_REF_SCALE_BOX; mode <= CPU_REF_SCALE_BILINEAR; mode++) {
+            cpu_ref_scale(test_frame, TEST_WIDTH, TEST_HEIGHT, scaled, TEST_WIDTH,
+                          TEST_HEIGHT, mode);
+            if (memcmp(scaled, test_frame, sizeof(test_frame)) != 0) {
+                cout << "ERROR: Scale mode " << mode << " not identity at 1:1" << endl;
+                scale_errors++;
+            }
+        }
+        
+        // A horizontal ramp stays monotonic under bilinear scaling
+        static uint8_t ramp[TEST_WIDTH * TEST_HEIGHT];
+        for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+            ramp[i] = (uint8_t)((i % TEST_WIDTH) * 4);
+        }
+        cpu_ref_scale(ramp, TEST_WIDTH, TEST_HEIGHT, scaled, 45, 30,
+                      CPU_REF_SCALE_BILINEAR);
+        for (int i = 1; i < 45; i++) {
+            if (scaled[i] <= scaled[i - 1]) {
+                cout << "ERROR: Bilinear ramp not increasing at " << i << endl;
+                scale_errors++;
+                break;
+            }
+        }
+        
+        // The box reciprocal against a divider: every count up to a
+        // 64x64 box and the largest boxes of each profile, on both
+        // sides of every quotient step and at the top of the range
+        const uint32_t big_counts[3] = {640 * 480, 1920 * 1080, 4096 * 2160};
+        for (uint32_t i = 1; i <= 4096 + 3; i++) {
+            uint32_t count = (i <= 4096) ? i : big_counts[i - 4097];
+            box_recip_t recip;
+            box_shift_t shift;
+            box_reciprocal(count, recip, shift);
+            for (uint64_t q = 0; q <= PIXEL_MAX; q++) {
+                uint64_t sums[3] = {q * count, q * count + count - 1,
+                                    q * count + count / 2};
+                for (int k = 0; k < 3; k++) {
+                    uint64_t mean = box_divide(sums[k], count, recip, shift);
+                    if (mean != sums[k] / count) {
+                        cout << "ERROR: Box mean of " << sums[k] << " / " << count
+                             << endl;
+                        scale_errors++;
+                        q = PIXEL_MAX;
+                        i = 4096 + 3;
+                        break;
+                    }
+                }
+            }
+        }
+        
+        // Hardware against the reference: integer and fractional
+        // ratios, ahead of and behind the filter chain
+        const int sizes[][2] = {
+            {32, 32}, {48, 40}, {21, 13}, {48, 64}, {64, 64}, {1, 1}, {64, 7}
+        };
+        const uint32_t scale_chain = FILTER_GAUSSIAN | (FILTER_SOBEL << 8);
+        for (int mode = SCALE_BOX; mode <= SCALE_BILINEAR; mode++) {
+            for (int after = 0; after < 2; after++) {
+                ap_uint<8> ctrl = mode | (after << SCALE_CTRL_AFTER_BIT);
+                for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                    scale_errors += test_scale(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                               FILTER_BYPASS, scale_chain, ctrl,
+                                               sizes[i][0], sizes[i][1]);
+                }
+                scale_errors += test_scale(odd_frame, ODD_W, ODD_H, FILTER_SHARPEN, 0,
+                                           ctrl, 100, 17);
+                scale_errors += test_scale(odd_frame, ODD_W, ODD_H, FILTER_SHARPEN, 0,
+                                           ctrl, ODD_W / 3, ODD_H);
+            }
+        }
+        
+        // Out-of-range settings are rejected before the stream is read
+        const int bad_ctrl[3][3] = {
+            {SCALE_BOX, TEST_WIDTH + 1, TEST_HEIGHT},
+            {SCALE_BILINEAR, TEST_WIDTH, 0},
+            {3, 8, 8}
+        };
+        for (int i = 0; i < 3; i++) {
+            stream_t src_stream;
+            stream_rgb_t src_rgb_stream;
+            stream_t dst_stream;
+            push_frame(src_stream, test_frame, TEST_WIDTH, TEST_HEIGHT);
+            ap_uint<8> status;
+            image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_BYPASS,
+                       0, TEST_WIDTH, TEST_HEIGHT, status, INPUT_GRAY, 0, 0, 0, 0, 0,
+                       dut_stats.histogram, dut_stats.min, dut_stats.max,
+                       dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+                       dut_frame_errors, bad_ctrl[i][0], bad_ctrl[i][1],
+                       bad_ctrl[i][2], 0, 0, 0, 0);
+            if (status != STATUS_ERR_SCALE ||
+                src_stream.size() != TEST_WIDTH * TEST_HEIGHT || !dst_stream.empty()) {
+                cout << "ERROR: Scaler setting " << i << " not rejected" << endl;
+                scale_errors++;
+            }
+        }
+    }
+    errors += scale_errors;
+    cout << "  Scaler: " << (scale_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+    // ========================================
+    // Test 23: Regions of Interest
+    // ========================================
+    int roi_errors = 0;
+    {
+        // Corners and edges, where the window reaches outside the
+        // region; Sobel must match the full-frame output there
+        const int corners[][4] = {
+            {0, 0, 9, 7}, {TEST_WIDTH - 5, 0, 5, 12}, {20, 30, 1, 1},
+            {0, TEST_HEIGHT - 3, TEST_WIDTH, 3}
+        };
+        roi_errors += test_roi(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_SOBEL, 0, 0,
+                               TEST_WIDTH, TEST_HEIGHT, corners, 4);
+        
+        // Eight regions sharing rows, listed out of raster order, on a
+        // fused chain
+        const int grid[ROI_MAX][4] = {
+            {48, 2, 10, 20}, {0, 2, 16, 20}, {16, 2, 16, 20}, {32, 2, 16, 20},
+            {3, 40, 4, 4}, {60, 40, 4, 24}, {10, 41, 40, 10}, {10, 60, 40, 4}
+        };
+        roi_errors += test_roi(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS,
+                               FILTER_GAUSSIAN | (FILTER_SOBEL << 8), 0, TEST_WIDTH,
+                               TEST_HEIGHT, grid, ROI_MAX);
+        const int strips[][4] = {{300, 0, 33, 4}, {0, 0, 300, 1}, {100, 5, 150, 18}};
+        roi_errors += test_roi(odd_frame, ODD_W, ODD_H, FILTER_MEDIAN, 0, 0, ODD_W,
+                               ODD_H, strips, 3);
+        
+        // Regions are in scaled coordinates
+        const int half[][4] = {{4, 4, 24, 8}, {0, 20, 32, 12}};
+        roi_errors += test_roi(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_SOBEL, 0,
+                               SCALE_BOX, TEST_WIDTH / 2, TEST_HEIGHT / 2, half, 2);
+        
+        // Empty, outside, overlapping and too many regions are rejected
+        const int bad[][4] = {
+            {0, 0, 0, 4}, {TEST_WIDTH - 4, 0, 5, 4}, {0, TEST_HEIGHT, 4, 1},
+            {8, 8, 8, 8}, {15, 15, 4, 4}
+        };
+        const int bad_cases[][2] = {{0, 1}, {1, 1}, {2, 1}, {3, 2}, {3, 9}};
+        for (int i = 0; i < 5; i++) {
+            stream_t src_stream;
+            stream_rgb_t src_rgb_stream;
+            stream_t dst_stream;
+            push_frame(src_stream, test_frame, TEST_WIDTH, TEST_HEIGHT);
+            int first = bad_cases[i][0];
+            int count = bad_cases[i][1];
+            roi_rects_t rects = (count > ROI_MAX) ? pack_rois(grid, ROI_MAX)
+                                                  : pack_rois(bad + first, count);
+            ap_uint<8> status;
+            image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_BYPASS,
+                       0, TEST_WIDTH, TEST_HEIGHT, status, INPUT_GRAY, 0, 0, 0, 0, 0,
+                       dut_stats.histogram, dut_stats.min, dut_stats.max,
+                       dut_stats.sum, dut_stats.sum_sq, dut_lut, 0, 0,
+                       dut_frame_errors, 0, 0, 0, count, rects, 0, 0);
+            if (status != STATUS_ERR_ROI ||
+                src_stream.size() != TEST_WIDTH * TEST_HEIGHT || !dst_stream.empty()) {
+                cout << "ERROR: ROI setting " << i << " not rejected" << endl;
+                roi_errors++;
+            }
+        }
+    }
+    errors += roi_errors;
+    cout << "  Regions of interest: " << (roi_errors ? "MISMATCH" : "cropped") << endl;
+    
+    // ========================================
+    // Test 24: Border Modes
+    // ========================================
+    int border_errors = 0;
+    {
+        static uint8_t probe[TEST_WIDTH * TEST_HEIGHT];
+        static uint8_t result[TEST_WIDTH * TEST_HEIGHT];
+        cpu_ref_config_t config = build_config();
+        
+        // A centred Gaussian peaks on an impulse; the legacy window
+        // peaks one row and column later
+        memset(probe, 0, sizeof(probe));
+        probe[20 * TEST_WIDTH + 30] = 255;
+        const int peak_ctrl[3] = {BORDER_LEGACY, 1 << BORDER_CTRL_ALIGN_BIT,
+                                  BORDER_REPLICATE};
+        for (int i = 0; i < 3; i++) {
+            config.border_ctrl = peak_ctrl[i];
+            border_errors += test_border(probe, TEST_WIDTH, TEST_HEIGHT,
+                                         FILTER_GAUSSIAN, 0, 0, config, 0, 0, 0,
+                                         result);
+            int peak = 0;
+            for (int p = 1; p < TEST_WIDTH * TEST_HEIGHT; p++) {
+                peak = (result[p] > result[peak]) ? p : peak;
+            }
+            int expected_peak = (i == 0) ? 21 * TEST_WIDTH + 31 : 20 * TEST_WIDTH + 30;
+            if (peak != expected_peak) {
+                cout << "ERROR: Border 0x" << hex << peak_ctrl[i] << dec
+                     << " peak at (" << peak % TEST_WIDTH << "," << peak / TEST_WIDTH
+                     << ")" << endl;
+                border_errors++;
+            }
+        }
+        
+        // The filling modes leave no border on a flat frame
+        memset(probe, 90, sizeof(probe));
+        const int fill_ctrl[3] = {BORDER_REPLICATE, BORDER_REFLECT,
+                                  BORDER_CONSTANT | (90 << BORDER_CTRL_CONST_LSB)};
+        const int flat_modes[6][2] = {
+            {FILTER_SOBEL, 0}, {FILTER_GAUSSIAN, 90}, {FILTER_BLUR, 90},
+            {FILTER_MEDIAN, 90}, {FILTER_CLOSE, 90}, {FILTER_CANNY, 0}
+        };
+        for (int f = 0; f < 3; f++) {
+            config.border_ctrl = fill_ctrl[f];
+            for (int m = 0; m < 6; m++) {
+                border_errors += test_border(probe, TEST_WIDTH, TEST_HEIGHT,
+                                             flat_modes[m][0], 0, 40, config, 0, 0, 0,
+                                             result);
+                for (int p = 0; p < TEST_WIDTH * TEST_HEIGHT; p++) {
+                    if (result[p] != flat_modes[m][1]) {
+                        cout << "ERROR: Border 0x" << hex << fill_ctrl[f] << dec
+                             << " filter " << flat_modes[m][0] << " not flat at ("
+                             << p % TEST_WIDTH << "," << p / TEST_WIDTH << ")" << endl;
+                        border_errors++;
+                        break;
+                    }
+                }
+            }
+        }
+        
+        // Every window filter in every mode against the CPU reference
+        const int border_ctrl[5] = {
+            1 << BORDER_CTRL_ALIGN_BIT, BORDER_REPLICATE, BORDER_REFLECT,
+            BORDER_CONSTANT | (77 << BORDER_CTRL_CONST_LSB), BORDER_CROP
+        };
+        const int conv3[9] = {1, 2, 0, -1, 4, 1, 0, -2, 3};
+        const int conv5[25] = {
+            1, 0, 2, 0, -1,  0, 3, 1, -2, 0,  2, 1, 6, 1, 0,
+            -1, 0, 1, 2, 1,  0, 1, 0, 0, 2
+        };
+        // {filter, threshold, conv size}
+        const int window_modes[16][3] = {
+            {FILTER_SOBEL, 0, 0}, {FILTER_GAUSSIAN, 0, 0}, {FILTER_SHARPEN, 0, 0},
+            {FILTER_MEDIAN, 0, 0}, {FILTER_ERODE, 0, 0}, {FILTER_DILATE, 0, 0},
+            {FILTER_BLUR, 0, 0}, {FILTER_CONV, 0, 3}, {FILTER_CONV, 0, 5},
+            {FILTER_OPEN, 0, 0}, {FILTER_CLOSE, 0, 0}, {FILTER_CANNY, 40, 0},
+            {FILTER_ADAPTIVE, 5, 0}, {FILTER_THRESHOLD, 100, 0},
+            {FILTER_GRAD_X, 0, 0}, {FILTER_GRAD_Y, 0, 0}
+        };
+        config.threshold_high = 120;
+        for (int b = 0; b < 5; b++) {
+            config.border_ctrl = border_ctrl[b];
+            for (int m = 0; m < 16; m++) {
+                if (window_modes[m][2] == 5) {
+                    set_conv(config, conv5, 5, 4, -20);
+                } else {
+                    set_conv(config, conv3, 3, 2, 10);
+                }
+                border_errors += test_border(test_frame, TEST_WIDTH, TEST_HEIGHT,
+                                             window_modes[m][0], 0, window_modes[m][1],
+                                             config);
+            }
+            
+            // Fused chain on an odd frame; crop shrinks it stage by stage
+            set_conv(config, conv3, 3, 2, 10);
+            border_errors += test_border(odd_frame, ODD_W, ODD_H, FILTER_BYPASS,
+                                         FILTER_GAUSSIAN | (FILTER_OPEN << 8) |
+                                         (FILTER_CANNY << 16) | (FILTER_BLUR << 24),
+                                         40, config);
+            
+            // Frames smaller than the window, where reflect runs out
+            if (border_ctrl[b] != BORDER_CROP) {
+                border_errors += test_border(test_frame, 3, 2, FILTER_CANNY, 0, 40,
+                                             config);
+                set_conv(config, conv5, 5, 4, -20);
+                border_errors += test_border(test_frame, 2, 3, FILTER_CONV, 0, 0,
+                                             config);
+                border_errors += test_border(test_frame, 1, 1, FILTER_BLUR, 0, 0,
+                                             config);
+            }
+        }
+        
+        // Crop ahead of and behind the scaler
+        set_conv(config, conv3, 3, 2, 10);
+        config.border_ctrl = BORDER_CROP;
+        border_errors += test_border(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_SOBEL, 0,
+                                     0, config, SCALE_BOX, 32, 32);
+        border_errors += test_border(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_SOBEL, 0,
+                                     0, config, SCALE_BILINEAR |
+                                     (1 << SCALE_CTRL_AFTER_BIT), 31, 20);
+        
+        // Unknown modes, frames cropped away and a scaler asked to
+        // grow the cropped frame are rejected
+        const int bad_border[3][5] = {
+            // border_ctrl, filter_chain, width, height, scale_ctrl
+            {5, FILTER_SOBEL, TEST_WIDTH, TEST_HEIGHT, 0},
+            {BORDER_CROP, FILTER_CANNY | (FILTER_SOBEL << 8), 8, 40, 0},
+            {BORDER_CROP, FILTER_SOBEL, TEST_WIDTH, TEST_HEIGHT,
+             SCALE_BOX | (1 << SCALE_CTRL_AFTER_BIT)}
+        };
+        for (int i = 0; i < 3; i++) {
+            stream_t src_stream;
+            stream_rgb_t src_rgb_stream;
+            stream_t dst_stream;
+            int width = bad_border[i][2];
+            int height = bad_border[i][3];
+            push_frame(src_stream, test_frame, width, height);
+            ap_uint<8> status;
+            image_pros(src_stream, src_rgb_stream, dst_stream, dut_grad, FILTER_BYPASS,
+                       0, width, height, status, INPUT_GRAY, bad_border[i][1], 0, 0, 0,
+                       0, dut_stats.histogram, dut_stats.min, dut_stats.max, dut_stats.sum,
+                       dut_stats.sum_sq, dut_lut, 0, 0,
+                       dut_frame_errors, bad_border[i][4], width, height, 0, 0,
+                       bad_border[i][0], 0);
+            int expected = (i == 2) ? STATUS_ERR_SCALE : STATUS_ERR_BORDER;
+            if (status != expected || (int)src_stream.size() != width * height ||
+                !dst_stream.empty()) {
+                cout << "ERROR: Border setting " << i << " not rejected" << endl;
+                border_errors++;
+            }
+        }
+    }
+    errors += border_errors;
+    cout << "  Border modes: " << (border_errors ? "MISMATCH" : "bit-exact") << endl;
+#endif
+    
+    // ========================================
+    // Test 25: Pixel Depth
+    // ========================================
+    // The test pattern scaled to PIXEL_BITS with noise in the low bits
+    // and a full-scale bar, so Sobel, sharpen, the convolution and the
+    // gradients clip. Canny, the scalers and the statistics are checked
+    // against the scalar model too.
+    int depth_errors = 0;
+    {
+        static pixel_t depth_in[TEST_HEIGHT][TEST_WIDTH];
+        for (int y = 0; y < TEST_HEIGHT; y++) {
+            for (int x = 0; x < TEST_WIDTH; x++) {
+                int low = (x * 7 + y * 13) & ((1 << PIXEL_EXTRA_BITS) - 1);
+                depth_in[y][x] = (input_image[y][x] << PIXEL_EXTRA_BITS) | low;
+            }
+        }
+        for (int x = 8; x < 12; x++) {
+            depth_in[8][x] = PIXEL_MAX;
+        }
+        
+        const int depth_threshold = (100 << PIXEL_EXTRA_BITS) + 3;
+        const int depth_modes[14] = {
+            FILTER_BYPASS, FILTER_THRESHOLD, FILTER_NEGATIVE, FILTER_SOBEL,
+            FILTER_GAUSSIAN, FILTER_SHARPEN, FILTER_MEDIAN, FILTER_ERODE,
+            FILTER_DILATE, FILTER_GRAD_X, FILTER_GRAD_Y, FILTER_BLUR, FILTER_CONV,
+            FILTER_CANNY
+        };
+        const char* depth_names[14] = {
+            "DEPTH BYPASS", "DEPTH THRESHOLD", "DEPTH NEGATIVE", "DEPTH SOBEL",
+            "DEPTH GAUSSIAN", "DEPTH SHARPEN", "DEPTH MEDIAN", "DEPTH ERODE",
+            "DEPTH DILATE", "DEPTH GRAD X", "DEPTH GRAD Y", "DEPTH BLUR", "DEPTH CONV",
+            "DEPTH CANNY"
+        };
+        cpu_ref_config_t depth_config = build_config();
+        set_conv(depth_config, DEPTH_CONV, 3, DEPTH_CONV_SHIFT, DEPTH_CONV_BIAS);
+        
+        static pixel_t depth_expected[TEST_HEIGHT][TEST_WIDTH];
+        for (int m = 0; m < 14; m++) {
+            int mode = depth_modes[m];
+            depth_errors += test_filter(depth_in, output_image, mode, depth_threshold,
+                                        depth_names[m],
+                                        conv_register(depth_config.conv_coeffs),
+                                        depth_config.conv_ctrl, DEPTH_CANNY_HIGH);
+            for (int y = 0; y < TEST_HEIGHT; y++) {
+                for (int x = 0; x < TEST_WIDTH; x++) {
+                    depth_expected[y][x] = depth_model(depth_in, x, y, mode,
+                                                       depth_threshold);
+                }
+            }
+            
+            bool grad_max = false, grad_min = false;
+            for (int y = 0; y < TEST_HEIGHT; y++) {
+                for (int x = 0; x < TEST_WIDTH; x++) {
+                    int expected = depth_expected[y][x];
+                    if (output_image[y][x] != expected) {
+                        cout << "ERROR: " << depth_names[m] << " is " << output_image[y][x]
+                             << " at (" << x << "," << y << "), expected " << expected
+                             << endl;
+                        depth_errors++;
+                        y = TEST_HEIGHT;
+                        break;
+                    }
+                    grad_max |= (output_image[y][x] == GRAD_MAX);
+                    grad_min |= (output_image[y][x] == (GRAD_MIN & PIXEL_MAX));
+                }
+            }
+            
+            // Statistics of the model frame, so they do not depend on
+            // the DUT output
+            depth_errors += check_stats(&depth_expected[0][0], TEST_WIDTH * TEST_HEIGHT);
+            
+            // Full scale reaches the output, and the edges saturate
+            bool clipped = (mode == FILTER_GRAD_X || mode == FILTER_GRAD_Y)
+                         ? (grad_max && grad_min) : (dut_stats.max == PIXEL_MAX);
+            if ((mode == FILTER_BYPASS || mode == FILTER_SOBEL ||
+                 mode == FILTER_SHARPEN || mode == FILTER_GRAD_X ||
+                 mode == FILTER_GRAD_Y || mode == FILTER_CONV ||
+                 mode == FILTER_CANNY) && !clipped) {
+                cout << "ERROR: " << depth_names[m] << " does not reach full scale"
+                     << endl;
+                depth_errors++;
+            }
+            if (mode == FILTER_CONV && dut_stats.min != 0) {
+                cout << "ERROR: DEPTH CONV does not clip at 0" << endl;
+                depth_errors++;
+            }
+            
+            // The PPC kernels have no blur, convolution or Canny
+            if (m < 11) {
+                depth_errors += test_ppc<2>(image_pros_ppc2, depth_in, output_image,
+                                            mode, depth_threshold);
+                depth_errors += test_ppc<8>(image_pros_ppc8, depth_in, output_image,
+                                            mode, depth_threshold);
+            }
+        }
+        
+        // Both scalers, with ratios that do not divide the frame
+        depth_errors += test_depth_scale(depth_in, SCALE_BOX, 40, 24, "DEPTH BOX");
+        depth_errors += test_depth_scale(depth_in, SCALE_BILINEAR, 48, 29,
+                                         "DEPTH BILINEAR");
+    }
+    errors += depth_errors;
+    cout << "  Pixel depth " << PIXEL_BITS << ": "
+         << (depth_errors ? "MISMATCH" : "bit-exact") << endl;
+    
+#if PIXEL_BITS == 8
+    // ========================================
+    // Test 26: Gradient Output
+    // ========================================
+    // dst_grad against the CPU reference in every border mode, then
+    // the magnitude and bins of a ring frame against the exact norm
+    // and angle
+    int grad_errors = 0;
+    {
+        // No test so far set grad_enable
+        if (!dut_grad.empty()) {
+            cout << "ERROR: dst_grad written with grad_enable clear" << endl;
+            grad_errors++;
+        }
+        
+        cpu_ref_config_t config = build_config();
+        const int grad_ctrl[6] = {
+            BORDER_LEGACY, 1 << BORDER_CTRL_ALIGN_BIT, BORDER_REPLICATE, BORDER_REFLECT,
+            BORDER_CONSTANT | (77 << BORDER_CTRL_CONST_LSB), BORDER_CROP
+        };
+        for (int b = 0; b < 6; b++) {
+            config.border_ctrl = grad_ctrl[b];
+            grad_errors += test_grad(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS,
+                                     config);
+            grad_errors += test_grad(test_frame, TEST_WIDTH, TEST_HEIGHT, FILTER_GAUSSIAN,
+                                     config);
+            grad_errors += test_grad(odd_frame, ODD_W, ODD_H, FILTER_SHARPEN, config);
+        }
+        
+        // Rings give every orientation and the largest gradients
+        static uint8_t ring[TEST_WIDTH * TEST_HEIGHT];
+        static uint64_t grad[TEST_WIDTH * TEST_HEIGHT];
+        for (int y = 0; y < TEST_HEIGHT; y++) {
+            for (int x = 0; x < TEST_WIDTH; x++) {
+                double r = hypot(x - 31.5, y - 29.5);
+                ring[y * TEST_WIDTH + x] = (fmod(r, 12.0) < 6.0) ? 255 : 0;
+            }
+        }
+        config.border_ctrl = BORDER_REPLICATE;
+        grad_errors += test_grad(ring, TEST_WIDTH, TEST_HEIGHT, FILTER_BYPASS, config,
+                                 grad);
+        
+        int bin_seen[GRAD_ORIENT_BINS] = {0};
+        for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT && grad_errors == 0; i++) {
+            int gx = (int16_t)(grad[i] & 0xFFFF);
+            int gy = (int16_t)((grad[i] >> 16) & 0xFFFF);
+            int mag = (int)((grad[i] >> 32) & 0xFFFF);
+            int bin = (int)((grad[i] >> 48) & 0xFF);
+            if (gx == 0 && gy == 0) {
+                continue;
+            }
+            
+            // Alpha-max-beta-min stays within 4.1% (plus rounding)
+            double norm = hypot(gx, gy);
+            bool mag_ok = fabs(mag - norm) <= 0.041 * norm + 0.5;
+            
+            // Unsigned angle, 20 degrees per bin
+            double angle = atan2(gy, gx) * 45.0 / atan(1.0);
+            angle += (angle < 0) ? 180.0 : 0.0;
+            angle -= (angle >= 180.0) ? 180.0 : 0.0;
+            bool bin_ok = bin < GRAD_ORIENT_BINS && angle > 20.0 * bin - 0.01 &&
+                          angle < 20.0 * (bin + 1) + 0.01;
+            if (!mag_ok || !bin_ok) {
+                cout << "ERROR: Gradient (" << gx << "," << gy << ") gave magnitude "
+                     << mag << " bin " << bin << endl;
+                grad_errors++;
+                break;
+            }
+            bin_seen[bin]++;
+        }
+        for (int b = 0; b < GRAD_ORIENT_BINS; b++) {
+            if (bin_seen[b] == 0) {
+                cout << "ERROR: Orientation bin " << b << " never used" << endl;
+                grad_errors++;
+            }
+        }
+    }
+    errors += grad_errors;
+    cout << "  Gradient output: " << (grad_errors ? "MISMATCH" : "bit-exact") << endl;
+#endif
     
     // ========================================
     // Summary
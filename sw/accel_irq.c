@@ -0,0 +1,98 @@
+/*
+ * Image Processing Accelerator - Interrupt-Driven Completion
+ * ap_done interrupt of image_pros through microblaze_0_axi_intc
+ */
+
+#include <stddef.h>
+#include "accel_irq.h"
+
+#define QUEUE_MASK  (ACCEL_IRQ_QUEUE_SIZE - 1)
+
+// ============================================
+// Setup
+// ============================================
+int accel_irq_init(accel_irq_t *irq, XImage_pros *ip, XIntc *intc,
+                   uint8_t intr_id) {
+    irq->ip = ip;
+    irq->head = 0;
+    irq->tail = 0;
+    irq->frames = 0;
+    irq->overruns = 0;
+    irq->callback = NULL;
+    irq->callback_ref = NULL;
+
+    if (XIntc_Connect(intc, intr_id, accel_irq_handler, irq) != XST_SUCCESS) {
+        return ACCEL_IRQ_ERR_CONNECT;
+    }
+    XIntc_Enable(intc, intr_id);
+
+    // Drop anything latched before the handler existed
+    XImage_pros_InterruptClear(ip, XImage_pros_InterruptGetStatus(ip));
+    XImage_pros_InterruptEnable(ip, ACCEL_IRQ_DONE);
+    XImage_pros_InterruptGlobalEnable(ip);
+
+    return ACCEL_IRQ_OK;
+}
+
+void accel_irq_set_callback(accel_irq_t *irq, accel_irq_callback_t callback,
+                            void *ref) {
+    irq->callback_ref = ref;
+    irq->callback = callback;
+}
+
+// ============================================
+// Interrupt Handler
+// ============================================
+void accel_irq_handler(void *ref) {
+    accel_irq_t *irq = (accel_irq_t *)ref;
+    u32 isr = XImage_pros_InterruptGetStatus(irq->ip);
+
+    // ISR bits toggle on write: clearing releases the interrupt line
+    XImage_pros_InterruptClear(irq->ip, isr);
+    if (!(isr & ACCEL_IRQ_DONE)) {
+        return;
+    }
+
+    accel_event_t event;
+    event.frame = irq->frames++;
+    event.status = XImage_pros_Get_status(irq->ip);
+
+    uint32_t head = irq->head;
+    if (head - irq->tail == ACCEL_IRQ_QUEUE_SIZE) {
+        irq->overruns++;
+    } else {
+        irq->events[head & QUEUE_MASK].frame = event.frame;
+        irq->events[head & QUEUE_MASK].status = event.status;
+        irq->head = head + 1;
+    }
+
+    if (irq->callback) {
+        irq->callback(irq->callback_ref, &event);
+    }
+}
+
+// ============================================
+// Consumer
+// ============================================
+int accel_irq_pop(accel_irq_t *irq, accel_event_t *event) {
+    uint32_t tail = irq->tail;
+
+    if (tail == irq->head) {
+        return 0;
+    }
+    event->frame = irq->events[tail & QUEUE_MASK].frame;
+    event->status = irq->events[tail & QUEUE_MASK].status;
+    irq->tail = tail + 1;
+    return 1;
+}
+
+int accel_irq_wait(accel_irq_t *irq, accel_event_t *event,
+                   uint32_t max_polls) {
+    // Only local memory is polled; the AXI-Lite bus stays free
+    for (uint32_t i = 0; i < max_polls; i++) {
+        if (accel_irq_pop(irq, event)) {
+            return ACCEL_IRQ_OK;
+        }
+    }
+    return ACCEL_IRQ_ERR_TIMEOUT;
+}
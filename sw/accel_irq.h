@@ -0,0 +1,71 @@
+/*
+ * Image Processing Accelerator - Interrupt-Driven Completion
+ * ap_done interrupt of image_pros through microblaze_0_axi_intc
+ *
+ * The ISR acknowledges the IP (XImage_pros_InterruptGetStatus /
+ * InterruptClear), records one event per finished frame in a small
+ * single-producer ring and runs an optional callback. Software waits
+ * on that ring in local memory instead of spinning on AP_CTRL over
+ * AXI-Lite.
+ */
+
+#ifndef ACCEL_IRQ_H
+#define ACCEL_IRQ_H
+
+#include <stdint.h>
+#include "ximage_pros.h"
+#include "xintc.h"
+
+// ============================================
+// Definitions
+// ============================================
+#define ACCEL_IRQ_DONE          0x01    // IER/ISR bit: ap_done
+#define ACCEL_IRQ_READY         0x02    // IER/ISR bit: ap_ready
+#define ACCEL_IRQ_QUEUE_SIZE    8       // Power of two
+
+#define ACCEL_IRQ_OK            0
+#define ACCEL_IRQ_ERR_CONNECT   -20     // XIntc_Connect failed
+#define ACCEL_IRQ_ERR_TIMEOUT   -21     // No frame finished in time
+
+typedef struct {
+    uint32_t frame;                     // Sequence number since init
+    uint32_t status;                    // image_pros status register
+} accel_event_t;
+
+// Runs in interrupt context
+typedef void (*accel_irq_callback_t)(void *ref, const accel_event_t *event);
+
+typedef struct {
+    XImage_pros *ip;
+    volatile accel_event_t events[ACCEL_IRQ_QUEUE_SIZE];
+    volatile uint32_t head;             // Written by the ISR
+    volatile uint32_t tail;             // Written by the consumer
+    volatile uint32_t frames;           // ap_done interrupts since init
+    volatile uint32_t overruns;         // Events dropped on a full queue
+    accel_irq_callback_t callback;
+    void *callback_ref;
+} accel_irq_t;
+
+// ============================================
+// Function Prototypes
+// ============================================
+
+// Connect the handler to an initialised interrupt controller and
+// enable the IP's ap_done interrupt.
+int accel_irq_init(accel_irq_t *irq, XImage_pros *ip, XIntc *intc,
+                   uint8_t intr_id);
+
+void accel_irq_set_callback(accel_irq_t *irq, accel_irq_callback_t callback,
+                            void *ref);
+
+// Interrupt handler (installed by accel_irq_init)
+void accel_irq_handler(void *ref);
+
+// Take the oldest event; returns 1 if one was available.
+int accel_irq_pop(accel_irq_t *irq, accel_event_t *event);
+
+// Wait for the next event for at most max_polls checks of the queue.
+int accel_irq_wait(accel_irq_t *irq, accel_event_t *event,
+                   uint32_t max_polls);
+
+#endif // ACCEL_IRQ_H
@@ -0,0 +1,319 @@
+/*
+ * Image Processing Accelerator - image_pros C Model
+ * Host-side timing model of the accelerator's s_axilite control
+ */
+
+#include <string.h>
+#include "frame_queue.h"
+#include "dma_model.h"
+#include "accel_model.h"
+
+// ============================================
+// Model State
+// ============================================
+#define ACCEL_MODEL_REG_WORDS       (0x400 / 4)     // Up to the lut memory
+#define ACCEL_MODEL_START_CYCLES    8       // ap_start to first pixel
+#define ACCEL_MODEL_CHAIN_STAGES    4
+
+// Registers not used by frame_queue.h
+#define IP_GIE                  0x04
+#define IP_IER                  0x08
+#define IP_ISR                  0x0C
+#define IP_FILTER_SELECT        0x10
+#define IP_THRESHOLD_VAL        0x18
+#define IP_STATUS_CTRL          0x34
+#define IP_FILTER_CHAIN         0x40
+#define IP_LUT_BANK             0xB0
+#define IP_SCALE_CTRL           0xC8
+#define IP_OUT_WIDTH            0xD0
+#define IP_OUT_HEIGHT           0xD8
+#define IP_ROI_COUNT            0xE0
+#define IP_ROI_RECTS            0xE8    // 2 words per region
+#define IP_BORDER_CTRL          0x128
+#define IP_LUT                  0x200   // 2 banks of 256 bytes
+
+#define AP_CTRL_INTERRUPT       0x200
+#define ISR_DONE                0x01
+#define ISR_READY               0x02
+
+#define STATUS_OK               0
+#define STATUS_ERR_WIDTH        1
+#define STATUS_ERR_SCALE        2
+#define STATUS_ERR_ROI          3
+#define STATUS_ERR_BORDER       4
+
+#define ACCEL_MODEL_ROI_MAX     8
+#define ACCEL_MODEL_BORDER_CROP 4
+
+static uint32_t regs[ACCEL_MODEL_REG_WORDS];
+static uint64_t now;                // Shared CPU/IP clock
+static uint64_t ip_time;            // Time the IP has been simulated up to
+static int busy;                    // Between ap_start and ap_done
+static int start_pending;           // ap_start written while busy
+static uint16_t frame_w;            // Latched at ap_start
+static uint16_t frame_h;            // Rows to process (0 if rejected)
+static uint32_t frame_lut;          // lut bank offset, latched at ap_start
+static uint32_t frame_rows;         // Rows finished in this frame
+static uint32_t rows_in;            // Rows delivered by MM2S, not yet processed
+static uint32_t frames_done;
+
+// ============================================
+// Helpers
+// ============================================
+#define REG(off)    regs[(off) / 4]
+
+static void raise_irq(uint32_t bit) {
+    if (REG(IP_IER) & bit) {
+        REG(IP_ISR) |= bit;
+    }
+}
+
+// ============================================
+// Pixel Path (point filters only)
+// ============================================
+static uint8_t point_filter(uint8_t mode, uint8_t pixel) {
+    switch (mode) {
+        case 3:     // Threshold
+            return (pixel > (uint8_t)REG(IP_THRESHOLD_VAL)) ? 255 : 0;
+        case 5:     // Negative
+            return 255 - pixel;
+        case 17:    // Lookup table, 4 entries per word
+            return (uint8_t)(REG(IP_LUT + frame_lut + (pixel & ~3u)) >> (8 * (pixel & 3)));
+        default:    // Bypass, grayscale and window filters
+            return pixel;
+    }
+}
+
+static void device(void *ctx, const uint8_t *in, uint8_t *out, uint32_t len) {
+    uint32_t chain = REG(IP_FILTER_CHAIN);
+    (void)ctx;
+
+    for (uint32_t i = 0; i < len; i++) {
+        uint8_t pixel = in[i];
+        if (chain == 0) {
+            pixel = point_filter((uint8_t)REG(IP_FILTER_SELECT), pixel);
+        } else {
+            for (int s = 0; s < ACCEL_MODEL_CHAIN_STAGES; s++) {
+                pixel = point_filter((uint8_t)(chain >> (8 * s)), pixel);
+            }
+        }
+        out[i] = pixel;
+    }
+    rows_in++;
+}
+
+// ============================================
+// Register Validation
+// ============================================
+// Same checks and order as image_pros_core(), except that the border
+// crop is not subtracted from the frame (window filters pass through
+// here, so their radius is unknown)
+static uint32_t frame_status(void) {
+    uint32_t width = REG(IP_WIDTH) & 0xFFFF;
+    uint32_t height = REG(IP_HEIGHT) & 0xFFFF;
+    uint32_t scale_mode = REG(IP_SCALE_CTRL) & 0x3;
+    uint32_t out_w = REG(IP_OUT_WIDTH) & 0xFFFF;
+    uint32_t out_h = REG(IP_OUT_HEIGHT) & 0xFFFF;
+    uint32_t roi_count = REG(IP_ROI_COUNT) & 0xF;
+
+    if (width > ACCEL_MODEL_MAX_WIDTH) {
+        return STATUS_ERR_WIDTH;
+    }
+    if (scale_mode != 0 &&
+        (scale_mode > 2 || out_w == 0 || out_w > width || out_h == 0 || out_h > height)) {
+        return STATUS_ERR_SCALE;
+    }
+    if ((REG(IP_BORDER_CTRL) & 0x7) > ACCEL_MODEL_BORDER_CROP) {
+        return STATUS_ERR_BORDER;
+    }
+
+    uint32_t dst_w = scale_mode ? out_w : width;
+    uint32_t dst_h = scale_mode ? out_h : height;
+    if (roi_count > ACCEL_MODEL_ROI_MAX) {
+        return STATUS_ERR_ROI;
+    }
+    for (uint32_t r = 0; r < roi_count; r++) {
+        uint32_t xy = REG(IP_ROI_RECTS + 8 * r);
+        uint32_t wh = REG(IP_ROI_RECTS + 8 * r + 4);
+        uint32_t x0 = xy & 0xFFFF, y0 = xy >> 16;
+        uint32_t x1 = x0 + (wh & 0xFFFF), y1 = y0 + (wh >> 16);
+        if (x1 == x0 || y1 == y0 || x1 > dst_w || y1 > dst_h) {
+            return STATUS_ERR_ROI;
+        }
+        for (uint32_t q = 0; q < r; q++) {
+            uint32_t qxy = REG(IP_ROI_RECTS + 8 * q);
+            uint32_t qwh = REG(IP_ROI_RECTS + 8 * q + 4);
+            uint32_t qx0 = qxy & 0xFFFF, qy0 = qxy >> 16;
+            uint32_t qx1 = qx0 + (qwh & 0xFFFF), qy1 = qy0 + (qwh >> 16);
+            if (x0 < qx1 && qx0 < x1 && y0 < qy1 && qy0 < y1) {
+                return STATUS_ERR_ROI;
+            }
+        }
+    }
+    return STATUS_OK;
+}
+
+// ============================================
+// Control Sequencing
+// ============================================
+static void start_frame(void) {
+    busy = 1;
+    start_pending = 0;
+    frame_w = (uint16_t)REG(IP_WIDTH);
+    frame_h = (uint16_t)REG(IP_HEIGHT);
+    frame_lut = (REG(IP_LUT_BANK) & 1) * 256;
+    frame_rows = 0;
+    ip_time += ACCEL_MODEL_START_CYCLES;
+
+    REG(IP_AP_CTRL) = (REG(IP_AP_CTRL) & ~AP_CTRL_IDLE) | AP_CTRL_START;
+
+    // A rejected frame returns at once without touching the streams
+    REG(IP_STATUS) = frame_status();
+    if (REG(IP_STATUS) != STATUS_OK) {
+        frame_h = 0;
+    }
+}
+
+static void finish_frame(void) {
+    busy = 0;
+    frames_done++;
+
+    REG(IP_AP_CTRL) |= AP_CTRL_DONE | AP_CTRL_READY;
+    REG(IP_STATUS_CTRL) = 1;
+    raise_irq(ISR_DONE | ISR_READY);
+
+    if ((REG(IP_AP_CTRL) & AP_CTRL_AUTO_RESTART) || start_pending) {
+        start_frame();
+    } else {
+        REG(IP_AP_CTRL) = (REG(IP_AP_CTRL) & ~AP_CTRL_START) | AP_CTRL_IDLE;
+    }
+}
+
+// One row per step: the IP streams a row in width cycles once its
+// input row has arrived, then releases that output row to S2MM.
+static void run_until(uint64_t t) {
+    while (busy && ip_time <= t) {
+        if (frame_rows == frame_h) {
+            finish_frame();
+        } else if (rows_in == 0) {
+            ip_time = t;        // Starved: blocked on the input stream
+            break;
+        } else if (ip_time + frame_w <= t) {
+            ip_time += frame_w;
+            rows_in--;
+            frame_rows++;
+            dma_model_release(1);
+        } else {
+            break;
+        }
+    }
+    if (!busy && ip_time < t) {
+        ip_time = t;
+    }
+}
+
+static void poll_hook(void *ctx) {
+    (void)ctx;
+    accel_model_advance(ACCEL_MODEL_READ_CYCLES);
+}
+
+// A DMA reset flushes the input rows that have not been processed
+static void reset_hook(void *ctx) {
+    (void)ctx;
+    rows_in = 0;
+}
+
+// ============================================
+// Register Access
+// ============================================
+uint32_t accel_model_read(uintptr_t base, uint32_t offset) {
+    uint32_t value;
+    (void)base;
+
+    accel_model_advance(ACCEL_MODEL_READ_CYCLES);
+    if (offset >= sizeof(regs)) {
+        return 0;
+    }
+
+    value = REG(offset);
+    switch (offset) {
+        case IP_AP_CTRL:    // ap_done and ap_ready clear on read
+            REG(offset) &= ~(AP_CTRL_DONE | AP_CTRL_READY);
+            if ((REG(IP_GIE) & 1) && (REG(IP_ISR) & REG(IP_IER))) {
+                value |= AP_CTRL_INTERRUPT;
+            }
+            break;
+        case IP_STATUS_CTRL:
+            REG(offset) = 0;
+            break;
+        default:
+            break;
+    }
+    return value;
+}
+
+void accel_model_write(uintptr_t base, uint32_t offset, uint32_t value) {
+    (void)base;
+
+    run_until(now);
+    if (offset >= sizeof(regs)) {
+        return;
+    }
+
+    switch (offset) {
+        case IP_AP_CTRL:
+            REG(offset) = (REG(offset) & ~AP_CTRL_AUTO_RESTART) |
+                          (value & AP_CTRL_AUTO_RESTART);
+            if (value & AP_CTRL_START) {
+                if (busy) {
+                    start_pending = 1;
+                } else {
+                    start_frame();
+                }
+            }
+            break;
+        case IP_ISR:        // Toggle on write
+            REG(offset) ^= value & (ISR_DONE | ISR_READY);
+            break;
+        case IP_STATUS:     // Read-only
+        case IP_STATUS_CTRL:
+            break;
+        default:
+            REG(offset) = value;
+            break;
+    }
+}
+
+// ============================================
+// Model Control
+// ============================================
+void accel_model_reset(void) {
+    memset(regs, 0, sizeof(regs));
+    REG(IP_AP_CTRL) = AP_CTRL_IDLE;
+
+    now = 0;
+    ip_time = 0;
+    busy = 0;
+    start_pending = 0;
+    frame_rows = 0;
+    rows_in = 0;
+    frames_done = 0;
+
+    dma_model_set_device(device, NULL);
+    dma_model_set_poll_hook(poll_hook, NULL);
+    dma_model_set_reset_hook(reset_hook, NULL);
+    dma_model_gate(1);
+}
+
+void accel_model_advance(uint64_t cycles) {
+    now += cycles;
+    run_until(now);
+}
+
+uint64_t accel_model_now(void) {
+    return now;
+}
+
+uint32_t accel_model_frames(void) {
+    return frames_done;
+}
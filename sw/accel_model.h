@@ -0,0 +1,42 @@
+/*
+ * Image Processing Accelerator - image_pros C Model
+ * Host-side timing model of the accelerator's s_axilite control
+ *
+ * Lets frame_queue.c (built with -DFRAME_DMA_MODEL) run on a Linux
+ * host. The model plugs into dma_model.c as its stream device and
+ * keeps one cycle clock for the IP and the CPU:
+ *   - the IP processes one pixel per cycle once started, in order,
+ *     and stalls when its input rows have not arrived yet;
+ *   - each output row is released to S2MM when the IP finishes it;
+ *   - every register read costs ACCEL_MODEL_READ_CYCLES, so polling
+ *     software lets time pass, and accel_model_advance() accounts
+ *     for CPU work such as staging a frame.
+ * ap_start/ap_done/ap_idle/ap_ready, auto_restart, the status
+ * register and ISR/IER/GIE follow the Vitis HLS register map. The
+ * width, scaler, region and border registers are checked like the IP
+ * does and a bad setting rejects the frame with its status code, but
+ * a valid scaler or region setting is not applied to the data. Pixel
+ * data is transformed for the point filters (bypass, grayscale,
+ * threshold, negative, lookup table); window filters pass pixels
+ * through, as bit-exact results are covered by the HLS testbench.
+ */
+
+#ifndef ACCEL_MODEL_H
+#define ACCEL_MODEL_H
+
+#include <stdint.h>
+
+#define ACCEL_MODEL_READ_CYCLES     16      // AXI-Lite read round trip
+#define ACCEL_MODEL_MAX_WIDTH       640     // image_pros line buffers
+
+// Register access (offsets as in frame_queue.h)
+uint32_t accel_model_read(uintptr_t base, uint32_t offset);
+void accel_model_write(uintptr_t base, uint32_t offset, uint32_t value);
+
+// Model control: reset installs the model as the dma_model device
+void accel_model_reset(void);
+void accel_model_advance(uint64_t cycles);  // Let CPU time pass
+uint64_t accel_model_now(void);             // Cycles since reset
+uint32_t accel_model_frames(void);          // Frames finished (ap_done)
+
+#endif // ACCEL_MODEL_H
@@ -0,0 +1,49 @@
+/*
+ * Image Processing Accelerator - Blur Coefficients
+ * blur_coeffs register values for the separable blur (FILTER_BLUR)
+ */
+
+#include <math.h>
+#include "blur_coeffs.h"
+
+#define BLUR_COEFFS_MAX_HALF    3       // Kernel size 7
+#define BLUR_COEFFS_SCALE       256     // 1-D kernel sum
+
+uint32_t blur_coeffs_gaussian(float sigma, int kernel_size) {
+    float weight[BLUR_COEFFS_MAX_HALF + 1];
+    float total = 0.0f;
+    int taps[BLUR_COEFFS_MAX_HALF + 1];
+    int half = (kernel_size - 1) / 2;
+    int outer = 0;
+    uint32_t coeffs = 0;
+    int i;
+
+    if (kernel_size != 3 && kernel_size != 5 && kernel_size != 7) {
+        return BLUR_COEFFS_BINOMIAL;
+    }
+
+    for (i = 0; i <= half; i++) {
+        weight[i] = (sigma > 0.0f) ? expf(-(float)(i * i) / (2.0f * sigma * sigma)) : 1.0f;
+        total += (i == 0) ? weight[i] : 2.0f * weight[i];
+    }
+
+    // Round the outer taps; the centre takes the remainder so the
+    // kernel sums to exactly 256
+    for (i = 1; i <= half; i++) {
+        taps[i] = (int)(weight[i] * BLUR_COEFFS_SCALE / total + 0.5f);
+        outer += 2 * taps[i];
+    }
+    taps[0] = BLUR_COEFFS_SCALE - outer;
+
+    // A very small sigma rounds every outer tap to 0, and a centre of
+    // 256 does not fit in a byte
+    if (taps[0] > 255) {
+        taps[0] = 254;
+        taps[1] = 1;
+    }
+
+    for (i = 0; i <= half; i++) {
+        coeffs |= (uint32_t)taps[i] << (8 * i);
+    }
+    return coeffs;
+}
@@ -0,0 +1,22 @@
+/*
+ * Image Processing Accelerator - Blur Coefficients
+ * blur_coeffs register values for the separable blur (FILTER_BLUR)
+ *
+ * The kernel size is fixed when the IP is built (BLUR_KERNEL_SIZE);
+ * sigma is chosen at run time by packing a quantized Gaussian into
+ * blur_coeffs. Byte i is the tap at distance i from the centre and
+ * the 1-D kernel sums to 256, so the IP needs no divider.
+ */
+
+#ifndef BLUR_COEFFS_H
+#define BLUR_COEFFS_H
+
+#include <stdint.h>
+
+#define BLUR_COEFFS_BINOMIAL    0       // Built-in binomial kernel
+
+// Sampled Gaussian for a kernel_size (3, 5 or 7) IP; sigma <= 0 gives
+// a box filter. Returns BLUR_COEFFS_BINOMIAL for other sizes.
+uint32_t blur_coeffs_gaussian(float sigma, int kernel_size);
+
+#endif // BLUR_COEFFS_H
@@ -0,0 +1,41 @@
+/*
+ * Image Processing Accelerator - Convolution Coefficients
+ * conv_coeffs / conv_ctrl register values for FILTER_CONV
+ */
+
+#include "conv_coeffs.h"
+
+#define CONV_COEFFS_WORDS       7       // 25 taps, a byte each
+#define CONV_CTRL_SIZE5         0x10    // conv_ctrl bit 4
+#define CONV_CTRL_BIAS_LSB      16
+
+int conv_coeffs_pack(const int8_t *taps, int size, int shift, int bias,
+                     XImage_pros_Conv_coeffs *coeffs, uint32_t *ctrl) {
+    uint32_t words[CONV_COEFFS_WORDS] = {0};
+    int i;
+
+    if (size != 3 && size != 5) {
+        return CONV_COEFFS_ERR_SIZE;
+    }
+    if (shift < 0 || shift > 15) {
+        return CONV_COEFFS_ERR_SHIFT;
+    }
+    if (bias < -32768 || bias > 32767) {
+        return CONV_COEFFS_ERR_BIAS;
+    }
+
+    for (i = 0; i < size * size; i++) {
+        words[i / 4] |= (uint32_t)(uint8_t)taps[i] << (8 * (i % 4));
+    }
+
+    coeffs->word_0 = words[0];
+    coeffs->word_1 = words[1];
+    coeffs->word_2 = words[2];
+    coeffs->word_3 = words[3];
+    coeffs->word_4 = words[4];
+    coeffs->word_5 = words[5];
+    coeffs->word_6 = words[6];
+    *ctrl = (uint32_t)shift | ((size == 5) ? CONV_CTRL_SIZE5 : 0) |
+            ((uint32_t)(uint16_t)bias << CONV_CTRL_BIAS_LSB);
+    return CONV_COEFFS_OK;
+}
@@ -0,0 +1,27 @@
+/*
+ * Image Processing Accelerator - Convolution Coefficients
+ * conv_coeffs / conv_ctrl register values for FILTER_CONV
+ *
+ * Taps are signed bytes, row-major, packed four per register word
+ * (tap 0 in bits 7~0 of word_0). The IP computes
+ * clamp((sum >> shift) + bias, 0, 255), so a kernel that sums to
+ * 2^shift keeps the image brightness.
+ */
+
+#ifndef CONV_COEFFS_H
+#define CONV_COEFFS_H
+
+#include <stdint.h>
+#include "ximage_pros.h"
+
+#define CONV_COEFFS_OK          0
+#define CONV_COEFFS_ERR_SIZE    -1      // Size is not 3 or 5
+#define CONV_COEFFS_ERR_SHIFT   -2      // Shift outside 0-15
+#define CONV_COEFFS_ERR_BIAS    -3      // Bias outside int16_t
+
+// size * size taps, row-major. Fills both register values or leaves
+// them untouched and returns an error.
+int conv_coeffs_pack(const int8_t *taps, int size, int shift, int bias,
+                     XImage_pros_Conv_coeffs *coeffs, uint32_t *ctrl);
+
+#endif // CONV_COEFFS_H
@@ -0,0 +1,356 @@
+/*
+ * Image Processing Accelerator - AXI DMA C Model
+ * Host-side model of axi_dma_0 in scatter-gather mode
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "frame_dma.h"
+#include "dma_model.h"
+
+// ============================================
+// Model State
+// ============================================
+#define DMA_MODEL_REG_WORDS     (0x48 / 4)
+#define DMA_MODEL_MAX_PACKET    65536
+
+// Descriptor status error bits
+#define DESC_STS_DEC_ERR        0x40000000
+#define DMASR_DEC_ERR           0x00000040
+
+typedef struct packet {
+    uint8_t *data;
+    uint32_t len;
+    uint32_t offset;            // Bytes already written by S2MM
+    struct packet *next;
+} packet_t;
+
+typedef struct {
+    uint32_t ctrl_off;          // DMACR offset of this channel
+    int has_tail;               // TAILDESC written since reset
+    int cur_done;               // Descriptor at CURDESC is complete
+} channel_t;
+
+static uint32_t regs[DMA_MODEL_REG_WORDS];
+static channel_t mm2s = { DMA_MM2S_DMACR, 0, 0 };
+static channel_t s2mm = { DMA_S2MM_DMACR, 0, 0 };
+
+// MM2S packet being assembled and packets waiting for S2MM
+static uint8_t tx_packet[DMA_MODEL_MAX_PACKET];
+static uint32_t tx_len;
+static packet_t *fifo_head;
+static packet_t *fifo_tail;
+static uint32_t packets_done;
+
+static dma_model_device_fn device_fn;
+static void *device_ctx;
+
+// S2MM gating for timed devices
+static int gated;
+static uint32_t credits;            // Packets released but not yet started
+static dma_model_poll_fn poll_fn;
+static void *poll_ctx;
+static dma_model_reset_fn reset_fn;
+static void *reset_ctx;
+
+// ============================================
+// Helpers
+// ============================================
+#define REG(off)    regs[(off) / 4]
+
+static frame_dma_desc_t *desc_at(uint32_t lsb, uint32_t msb) {
+    return (frame_dma_desc_t *)(uintptr_t)(((uint64_t)msb << 32) | lsb);
+}
+
+static uint8_t *buffer_of(frame_dma_desc_t *desc) {
+    return (uint8_t *)(uintptr_t)(((uint64_t)desc->buffer_addr_msb << 32) |
+                                  desc->buffer_addr);
+}
+
+static void loopback(void *ctx, const uint8_t *in, uint8_t *out, uint32_t len) {
+    (void)ctx;
+    memcpy(out, in, len);
+}
+
+static void fifo_clear(void) {
+    while (fifo_head) {
+        packet_t *next = fifo_head->next;
+        free(fifo_head->data);
+        free(fifo_head);
+        fifo_head = next;
+    }
+    fifo_tail = NULL;
+}
+
+static void fifo_push(const uint8_t *data, uint32_t len) {
+    packet_t *pkt = (packet_t *)malloc(sizeof(packet_t));
+    pkt->data = (uint8_t *)malloc(len ? len : 1);
+    pkt->len = len;
+    pkt->offset = 0;
+    pkt->next = NULL;
+    device_fn(device_ctx, data, pkt->data, len);
+
+    if (fifo_tail) {
+        fifo_tail->next = pkt;
+    } else {
+        fifo_head = pkt;
+    }
+    fifo_tail = pkt;
+}
+
+static void fifo_pop(void) {
+    packet_t *pkt = fifo_head;
+    fifo_head = pkt->next;
+    if (!fifo_head) {
+        fifo_tail = NULL;
+    }
+    free(pkt->data);
+    free(pkt);
+}
+
+// ============================================
+// Channel Sequencing
+// ============================================
+// A channel has work while it runs and CURDESC has not reached a
+// completed tail descriptor.
+static int channel_has_work(channel_t *ch) {
+    uint32_t sr = REG(ch->ctrl_off + 4);
+    uint32_t cur = REG(ch->ctrl_off + 8);
+    uint32_t tail = REG(ch->ctrl_off + 0x10);
+
+    if (!(REG(ch->ctrl_off) & DMACR_RS) || (sr & DMASR_HALTED) || !ch->has_tail) {
+        return 0;
+    }
+    return !(ch->cur_done && cur == tail);
+}
+
+static frame_dma_desc_t *channel_next(channel_t *ch) {
+    frame_dma_desc_t *desc = desc_at(REG(ch->ctrl_off + 8), REG(ch->ctrl_off + 0x0C));
+
+    if (ch->cur_done) {
+        REG(ch->ctrl_off + 8) = desc->next_desc;
+        REG(ch->ctrl_off + 0x0C) = desc->next_desc_msb;
+        desc = desc_at(desc->next_desc, desc->next_desc_msb);
+        ch->cur_done = 0;
+    }
+    return desc;
+}
+
+static void channel_complete(channel_t *ch, frame_dma_desc_t *desc,
+                             uint32_t status) {
+    desc->status = status | DESC_STS_CMPLT;
+    ch->cur_done = 1;
+
+    REG(ch->ctrl_off + 4) |= DMASR_IOC_IRQ;
+    if (REG(ch->ctrl_off + 8) == REG(ch->ctrl_off + 0x10)) {
+        REG(ch->ctrl_off + 4) |= DMASR_IDLE;
+    }
+}
+
+static void channel_error(channel_t *ch, frame_dma_desc_t *desc) {
+    desc->status = DESC_STS_DEC_ERR;
+    REG(ch->ctrl_off + 4) |= DMASR_DEC_ERR | DMASR_ERR_IRQ | DMASR_HALTED;
+}
+
+// ============================================
+// MM2S: memory -> stream device
+// ============================================
+static int mm2s_step(void) {
+    if (!channel_has_work(&mm2s)) {
+        return 0;
+    }
+
+    frame_dma_desc_t *desc = channel_next(&mm2s);
+    uint8_t *buffer = buffer_of(desc);
+    uint32_t len = desc->control & DESC_CTRL_LEN_MASK;
+
+    if (!buffer || tx_len + len > DMA_MODEL_MAX_PACKET) {
+        channel_error(&mm2s, desc);
+        return 0;
+    }
+
+    memcpy(&tx_packet[tx_len], buffer, len);
+    tx_len += len;
+
+    // TLAST closes the packet and hands it to the device
+    if (desc->control & DESC_CTRL_EOF) {
+        fifo_push(tx_packet, tx_len);
+        tx_len = 0;
+    }
+
+    channel_complete(&mm2s, desc, len);
+    return 1;
+}
+
+// ============================================
+// S2MM: stream device -> memory
+// ============================================
+static int s2mm_step(void) {
+    if (!fifo_head || !channel_has_work(&s2mm)) {
+        return 0;
+    }
+
+    frame_dma_desc_t *desc = channel_next(&s2mm);
+    uint8_t *buffer = buffer_of(desc);
+    uint32_t len = desc->control & DESC_CTRL_LEN_MASK;
+
+    if (!buffer) {
+        channel_error(&s2mm, desc);
+        return 0;
+    }
+
+    packet_t *pkt = fifo_head;
+    if (pkt->offset == 0 && gated) {
+        if (credits == 0) {
+            return 0;
+        }
+        credits--;
+    }
+
+    uint32_t status = (pkt->offset == 0) ? DESC_STS_RXSOF : 0;
+    uint32_t count = pkt->len - pkt->offset;
+    if (count > len) {
+        count = len;
+    }
+
+    memcpy(buffer, pkt->data + pkt->offset, count);
+    pkt->offset += count;
+
+    // A packet ending early completes the descriptor short
+    if (pkt->offset == pkt->len) {
+        status |= DESC_STS_RXEOF;
+        fifo_pop();
+        packets_done++;
+    }
+
+    channel_complete(&s2mm, desc, status | count);
+    return 1;
+}
+
+static void run_engine(void) {
+    int progress = 1;
+    while (progress) {
+        progress = mm2s_step();
+        progress |= s2mm_step();
+    }
+}
+
+// ============================================
+// Register Access
+// ============================================
+uint32_t dma_model_read(uintptr_t base, uint32_t offset) {
+    (void)base;
+    if (poll_fn) {
+        poll_fn(poll_ctx);
+    }
+    if (offset >= sizeof(regs)) {
+        return 0;
+    }
+    return REG(offset);
+}
+
+void dma_model_write(uintptr_t base, uint32_t offset, uint32_t value) {
+    (void)base;
+    channel_t *ch = (offset < DMA_S2MM_DMACR) ? &mm2s : &s2mm;
+    uint32_t reg = offset - ch->ctrl_off;
+
+    if (offset >= sizeof(regs)) {
+        return;
+    }
+
+    switch (reg) {
+        case 0x00:  // DMACR
+            if (value & DMACR_RESET) {
+                // Soft reset affects both channels and completes at once
+                dma_model_reset();
+                if (reset_fn) {
+                    reset_fn(reset_ctx);
+                }
+                return;
+            }
+            REG(offset) = value;
+            if (value & DMACR_RS) {
+                REG(offset + 4) &= ~DMASR_HALTED;
+                run_engine();
+            } else {
+                REG(offset + 4) |= DMASR_HALTED;
+            }
+            break;
+
+        case 0x04:  // DMASR: interrupt bits are write-one-to-clear
+            REG(offset) &= ~(value & (DMASR_IOC_IRQ | DMASR_ERR_IRQ));
+            break;
+
+        case 0x08:  // CURDESC: only while halted
+        case 0x0C:
+            if (REG(ch->ctrl_off + 4) & DMASR_HALTED) {
+                REG(offset) = value;
+                ch->cur_done = 0;
+            }
+            break;
+
+        case 0x10:  // TAILDESC: starts fetching descriptors
+            REG(offset) = value;
+            ch->has_tail = 1;
+            REG(ch->ctrl_off + 4) &= ~DMASR_IDLE;
+            run_engine();
+            break;
+
+        default:
+            REG(offset) = value;
+            break;
+    }
+}
+
+// ============================================
+// Model Control
+// ============================================
+void dma_model_reset(void) {
+    dma_model_device_fn fn = device_fn;
+    void *ctx = device_ctx;
+
+    memset(regs, 0, sizeof(regs));
+    REG(DMA_MM2S_DMASR) = DMASR_HALTED | DMASR_SG_INCLD;
+    REG(DMA_S2MM_DMASR) = DMASR_HALTED | DMASR_SG_INCLD;
+    mm2s.has_tail = 0;
+    mm2s.cur_done = 0;
+    s2mm.has_tail = 0;
+    s2mm.cur_done = 0;
+
+    fifo_clear();
+    tx_len = 0;
+    packets_done = 0;
+    credits = 0;
+
+    device_fn = fn ? fn : loopback;
+    device_ctx = ctx;
+}
+
+void dma_model_set_device(dma_model_device_fn fn, void *ctx) {
+    device_fn = fn ? fn : loopback;
+    device_ctx = ctx;
+}
+
+uint32_t dma_model_packets(void) {
+    return packets_done;
+}
+
+void dma_model_gate(int enable) {
+    gated = enable;
+    credits = 0;
+}
+
+void dma_model_release(uint32_t packets) {
+    credits += packets;
+    run_engine();
+}
+
+void dma_model_set_poll_hook(dma_model_poll_fn fn, void *ctx) {
+    poll_fn = fn;
+    poll_ctx = ctx;
+}
+
+void dma_model_set_reset_hook(dma_model_reset_fn fn, void *ctx) {
+    reset_fn = fn;
+    reset_ctx = ctx;
+}
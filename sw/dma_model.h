@@ -0,0 +1,50 @@
+/*
+ * Image Processing Accelerator - AXI DMA C Model
+ * Host-side model of axi_dma_0 in scatter-gather mode
+ *
+ * Lets frame_dma.c (built with -DFRAME_DMA_MODEL) run on a Linux
+ * host. Bus addresses are host pointers. Each MM2S packet (one row)
+ * is passed through a stream device callback whose output is then
+ * written out by the S2MM channel; the default device is a loopback.
+ * Only one DMA engine is modelled, so base addresses are ignored.
+ *
+ * A device that takes time (accel_model.c) can gate the S2MM side:
+ * output packets are then only written once the device releases
+ * them, and a poll hook runs on every register read so time moves
+ * on while software busy-waits. A reset hook tells the device that a
+ * soft reset dropped the packets in flight.
+ */
+
+#ifndef DMA_MODEL_H
+#define DMA_MODEL_H
+
+#include <stdint.h>
+
+// Stream device between MM2S and S2MM: transforms one packet of len
+// bytes from in to out
+typedef void (*dma_model_device_fn)(void *ctx, const uint8_t *in,
+                                    uint8_t *out, uint32_t len);
+
+// Called before every register read
+typedef void (*dma_model_poll_fn)(void *ctx);
+
+// Called after a soft reset (DMACR reset bit) has flushed the stream
+typedef void (*dma_model_reset_fn)(void *ctx);
+
+// Register access (offsets as in frame_dma.h)
+uint32_t dma_model_read(uintptr_t base, uint32_t offset);
+void dma_model_write(uintptr_t base, uint32_t offset, uint32_t value);
+
+// Model control
+void dma_model_reset(void);
+void dma_model_set_device(dma_model_device_fn fn, void *ctx);
+uint32_t dma_model_packets(void);   // Packets transferred since reset
+
+// Timed devices: with the gate enabled S2MM only writes packets the
+// device has released. Gate and hooks survive a soft reset.
+void dma_model_gate(int enable);
+void dma_model_release(uint32_t packets);
+void dma_model_set_poll_hook(dma_model_poll_fn fn, void *ctx);
+void dma_model_set_reset_hook(dma_model_reset_fn fn, void *ctx);
+
+#endif // DMA_MODEL_H
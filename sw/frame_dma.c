@@ -0,0 +1,237 @@
+/*
+ * Image Processing Accelerator - AXI DMA Frame Transport
+ * Scatter-gather driver for axi_dma_0 (MM2S -> image_pros -> S2MM)
+ */
+
+#include <stddef.h>
+#include "frame_dma.h"
+
+// ============================================
+// Platform Access
+// ============================================
+#ifdef FRAME_DMA_MODEL
+#include "dma_model.h"
+#define DMA_READ(base, off)         dma_model_read((base), (off))
+#define DMA_WRITE(base, off, val)   dma_model_write((base), (off), (val))
+#define DMA_FLUSH(addr, len)        ((void)(addr), (void)(len))
+#define DMA_INVALIDATE(addr, len)   ((void)(addr), (void)(len))
+#else
+#include "xil_io.h"
+#include "xil_cache.h"
+#define DMA_READ(base, off)         Xil_In32((base) + (off))
+#define DMA_WRITE(base, off, val)   Xil_Out32((base) + (off), (val))
+#define DMA_FLUSH(addr, len)        Xil_DCacheFlushRange((UINTPTR)(addr), (len))
+#define DMA_INVALIDATE(addr, len)   Xil_DCacheInvalidateRange((UINTPTR)(addr), (len))
+#endif
+
+#define DMA_RESET_POLLS         1000
+
+// ============================================
+// Address Helpers
+// ============================================
+static uint32_t addr_lsb(const volatile void *ptr) {
+    return (uint32_t)(uintptr_t)ptr;
+}
+
+static uint32_t addr_msb(const volatile void *ptr) {
+    return (uint32_t)((uint64_t)(uintptr_t)ptr >> 32);
+}
+
+// ============================================
+// Ring Setup
+// ============================================
+static void ring_init(frame_dma_ring_t *ring, frame_dma_desc_t *descs,
+                      uint32_t count) {
+    ring->descs = descs;
+    ring->count = count;
+    ring->head = 0;
+    ring->done = 0;
+    ring->pending = 0;
+    ring->completed = 0;
+
+    // Link descriptors into a circular chain
+    for (uint32_t i = 0; i < count; i++) {
+        frame_dma_desc_t *next = &descs[(i + 1) % count];
+        descs[i].next_desc = addr_lsb(next);
+        descs[i].next_desc_msb = addr_msb(next);
+        descs[i].buffer_addr = 0;
+        descs[i].buffer_addr_msb = 0;
+        descs[i].control = 0;
+        descs[i].status = 0;
+    }
+    DMA_FLUSH(descs, count * sizeof(frame_dma_desc_t));
+}
+
+// ============================================
+// Engine Reset and Channel Start
+// ============================================
+// A soft reset through either DMACR resets the whole engine, so it
+// is issued once before both channels are started.
+static int engine_reset(uintptr_t base) {
+    DMA_WRITE(base, DMA_MM2S_DMACR, DMACR_RESET);
+    for (int i = 0; i < DMA_RESET_POLLS; i++) {
+        if (!(DMA_READ(base, DMA_MM2S_DMACR) & DMACR_RESET)) {
+            return FRAME_DMA_OK;
+        }
+    }
+    return FRAME_DMA_ERR_RESET;
+}
+
+static void channel_start(uintptr_t base, uint32_t ctrl_off,
+                          uint32_t cur_off, frame_dma_ring_t *ring) {
+    // CURDESC may only be written while halted
+    DMA_WRITE(base, cur_off + 4, addr_msb(&ring->descs[0]));
+    DMA_WRITE(base, cur_off, addr_lsb(&ring->descs[0]));
+    DMA_WRITE(base, ctrl_off, DMACR_RS);
+}
+
+int frame_dma_init(frame_dma_t *dma, uintptr_t base_addr,
+                   frame_dma_desc_t *mm2s_descs,
+                   frame_dma_desc_t *s2mm_descs,
+                   uint32_t count) {
+    dma->base_addr = base_addr;
+    ring_init(&dma->mm2s, mm2s_descs, count);
+    ring_init(&dma->s2mm, s2mm_descs, count);
+
+    if (engine_reset(base_addr) != FRAME_DMA_OK) {
+        return FRAME_DMA_ERR_RESET;
+    }
+
+    channel_start(base_addr, DMA_MM2S_DMACR, DMA_MM2S_CURDESC, &dma->mm2s);
+    channel_start(base_addr, DMA_S2MM_DMACR, DMA_S2MM_CURDESC, &dma->s2mm);
+
+    return FRAME_DMA_OK;
+}
+
+// ============================================
+// Queue Frame
+// ============================================
+// Fill one descriptor per row and return the last one filled.
+static frame_dma_desc_t *ring_fill(frame_dma_ring_t *ring,
+                                   const uint8_t *buffer,
+                                   uint16_t width, uint16_t height,
+                                   uint32_t stride, uint32_t flags) {
+    frame_dma_desc_t *desc = NULL;
+
+    for (uint16_t y = 0; y < height; y++) {
+        const uint8_t *row = buffer + (uint32_t)y * stride;
+
+        desc = &ring->descs[ring->head];
+        desc->buffer_addr = addr_lsb(row);
+        desc->buffer_addr_msb = addr_msb(row);
+        desc->control = flags | (width & DESC_CTRL_LEN_MASK);
+        desc->status = 0;
+
+        ring->head = (ring->head + 1) % ring->count;
+        ring->pending++;
+    }
+
+    return desc;
+}
+
+int frame_dma_queue_frame(frame_dma_t *dma,
+                          const uint8_t *src, uint8_t *dst,
+                          uint16_t width, uint16_t height,
+                          uint32_t stride) {
+    return frame_dma_queue_scaled(dma, src, dst, width, height, stride,
+                                  width, height, stride);
+}
+
+int frame_dma_queue_scaled(frame_dma_t *dma,
+                           const uint8_t *src, uint8_t *dst,
+                           uint16_t width, uint16_t height, uint32_t stride,
+                           uint16_t out_width, uint16_t out_height,
+                           uint32_t out_stride) {
+    if (height == 0) {
+        return FRAME_DMA_OK;
+    }
+    if (dma->mm2s.pending + height > dma->mm2s.count ||
+        dma->s2mm.pending + out_height > dma->s2mm.count) {
+        return FRAME_DMA_ERR_RING;
+    }
+
+    DMA_FLUSH(src, (uint32_t)(height - 1) * stride + width);
+    DMA_INVALIDATE(dst, (uint32_t)(out_height - 1) * out_stride + out_width);
+
+    // Every source row is one packet: TLAST at end of line
+    frame_dma_desc_t *mm2s_tail = ring_fill(&dma->mm2s, src, width, height,
+                                            stride, DESC_CTRL_SOF | DESC_CTRL_EOF);
+    frame_dma_desc_t *s2mm_tail = ring_fill(&dma->s2mm, dst, out_width, out_height,
+                                            out_stride, 0);
+
+    DMA_FLUSH(dma->mm2s.descs, dma->mm2s.count * sizeof(frame_dma_desc_t));
+    DMA_FLUSH(dma->s2mm.descs, dma->s2mm.count * sizeof(frame_dma_desc_t));
+
+    // Arm the receive side first so no output beat is stalled
+    DMA_WRITE(dma->base_addr, DMA_S2MM_TAILDESC_MSB, addr_msb(s2mm_tail));
+    DMA_WRITE(dma->base_addr, DMA_S2MM_TAILDESC, addr_lsb(s2mm_tail));
+    DMA_WRITE(dma->base_addr, DMA_MM2S_TAILDESC_MSB, addr_msb(mm2s_tail));
+    DMA_WRITE(dma->base_addr, DMA_MM2S_TAILDESC, addr_lsb(mm2s_tail));
+
+    return FRAME_DMA_OK;
+}
+
+// ============================================
+// Completion
+// ============================================
+// Reclaim completed descriptors in order; returns -1 on error.
+static int ring_reclaim(frame_dma_ring_t *ring) {
+    while (ring->pending > 0) {
+        frame_dma_desc_t *desc = &ring->descs[ring->done];
+        DMA_INVALIDATE(desc, sizeof(frame_dma_desc_t));
+
+        uint32_t status = desc->status;
+        if (status & DESC_STS_ERR_MASK) {
+            return -1;
+        }
+        if (!(status & DESC_STS_CMPLT)) {
+            break;
+        }
+
+        desc->status = 0;
+        ring->done = (ring->done + 1) % ring->count;
+        ring->pending--;
+        ring->completed++;
+    }
+    return 0;
+}
+
+int frame_dma_poll(frame_dma_t *dma) {
+    uint32_t dmasr = DMA_READ(dma->base_addr, DMA_MM2S_DMASR) |
+                     DMA_READ(dma->base_addr, DMA_S2MM_DMASR);
+
+    if ((dmasr & DMASR_ERR_MASK) ||
+        ring_reclaim(&dma->mm2s) != 0 ||
+        ring_reclaim(&dma->s2mm) != 0) {
+        return FRAME_DMA_ERR_BUS;
+    }
+
+    return (int)(dma->mm2s.pending + dma->s2mm.pending);
+}
+
+int frame_dma_wait(frame_dma_t *dma, uint32_t max_polls) {
+    for (uint32_t i = 0; i < max_polls; i++) {
+        int pending = frame_dma_poll(dma);
+        if (pending <= 0) {
+            return pending;
+        }
+    }
+    return FRAME_DMA_ERR_TIMEOUT;
+}
+
+// ============================================
+// Abort
+// ============================================
+int frame_dma_abort(frame_dma_t *dma) {
+    if (engine_reset(dma->base_addr) != FRAME_DMA_OK) {
+        return FRAME_DMA_ERR_RESET;
+    }
+
+    ring_init(&dma->mm2s, dma->mm2s.descs, dma->mm2s.count);
+    ring_init(&dma->s2mm, dma->s2mm.descs, dma->s2mm.count);
+
+    channel_start(dma->base_addr, DMA_MM2S_DMACR, DMA_MM2S_CURDESC, &dma->mm2s);
+    channel_start(dma->base_addr, DMA_S2MM_DMACR, DMA_S2MM_CURDESC, &dma->s2mm);
+
+    return FRAME_DMA_OK;
+}
@@ -0,0 +1,142 @@
+/*
+ * Image Processing Accelerator - AXI DMA Frame Transport
+ * Scatter-gather driver for axi_dma_0 (MM2S -> image_pros -> S2MM)
+ *
+ * Frames are described with one buffer descriptor per row, so each
+ * row is one AXI4-Stream packet (TLAST at end of line) and frames
+ * may use any line stride.
+ *
+ * Build with -DFRAME_DMA_MODEL to run against the C model of the
+ * DMA engine (dma_model.c) on a Linux host.
+ */
+
+#ifndef FRAME_DMA_H
+#define FRAME_DMA_H
+
+#include <stdint.h>
+
+// ============================================
+// AXI DMA Register Offsets (PG021, SG mode)
+// ============================================
+#define DMA_MM2S_DMACR          0x00    // MM2S control
+#define DMA_MM2S_DMASR          0x04    // MM2S status
+#define DMA_MM2S_CURDESC        0x08    // MM2S current descriptor
+#define DMA_MM2S_CURDESC_MSB    0x0C
+#define DMA_MM2S_TAILDESC       0x10    // MM2S tail descriptor
+#define DMA_MM2S_TAILDESC_MSB   0x14
+#define DMA_S2MM_DMACR          0x30    // S2MM control
+#define DMA_S2MM_DMASR          0x34    // S2MM status
+#define DMA_S2MM_CURDESC        0x38    // S2MM current descriptor
+#define DMA_S2MM_CURDESC_MSB    0x3C
+#define DMA_S2MM_TAILDESC       0x40    // S2MM tail descriptor
+#define DMA_S2MM_TAILDESC_MSB   0x44
+
+// DMACR bits
+#define DMACR_RS                0x00000001  // Run/stop
+#define DMACR_RESET             0x00000004  // Soft reset (self-clearing)
+#define DMACR_IOC_IRQ_EN        0x00001000  // Interrupt on complete
+#define DMACR_ERR_IRQ_EN        0x00004000  // Interrupt on error
+
+// DMASR bits
+#define DMASR_HALTED            0x00000001
+#define DMASR_IDLE              0x00000002
+#define DMASR_SG_INCLD          0x00000008
+#define DMASR_ERR_MASK          0x00000770  // Int/Slv/Dec + SG errors
+#define DMASR_IOC_IRQ           0x00001000
+#define DMASR_ERR_IRQ           0x00004000
+
+// Descriptor control bits
+#define DESC_CTRL_SOF           0x08000000  // MM2S: start of packet
+#define DESC_CTRL_EOF           0x04000000  // MM2S: end of packet (TLAST)
+#define DESC_CTRL_LEN_MASK      0x007FFFFF  // c_sg_length_width = 23
+
+// Descriptor status bits
+#define DESC_STS_CMPLT          0x80000000
+#define DESC_STS_ERR_MASK       0x70000000  // DecErr/SlvErr/IntErr
+#define DESC_STS_RXSOF          0x08000000
+#define DESC_STS_RXEOF          0x04000000
+#define DESC_STS_LEN_MASK       0x007FFFFF
+
+// ============================================
+// Return Codes
+// ============================================
+#define FRAME_DMA_OK            0
+#define FRAME_DMA_ERR_RESET     -1      // Channel did not leave reset
+#define FRAME_DMA_ERR_RING      -2      // Not enough free descriptors
+#define FRAME_DMA_ERR_BUS       -3      // DMA reported a bus/SG error
+#define FRAME_DMA_ERR_TIMEOUT   -4      // Frame did not complete
+
+// ============================================
+// Scatter-Gather Descriptor (64-byte aligned)
+// ============================================
+typedef struct {
+    volatile uint32_t next_desc;        // 0x00
+    volatile uint32_t next_desc_msb;    // 0x04
+    volatile uint32_t buffer_addr;      // 0x08
+    volatile uint32_t buffer_addr_msb;  // 0x0C
+    volatile uint32_t reserved[2];      // 0x10
+    volatile uint32_t control;          // 0x18
+    volatile uint32_t status;           // 0x1C
+    volatile uint32_t app[5];           // 0x20
+    uint32_t pad[3];                    // Pad to 64 bytes
+} __attribute__((aligned(64))) frame_dma_desc_t;
+
+// ============================================
+// Descriptor Ring (one per channel)
+// ============================================
+typedef struct {
+    frame_dma_desc_t *descs;    // Ring storage (DMA-visible memory)
+    uint32_t count;             // Number of descriptors
+    uint32_t head;              // Next descriptor to fill
+    uint32_t done;              // Oldest descriptor not yet reclaimed
+    uint32_t pending;           // Descriptors handed to hardware
+    uint32_t completed;         // Descriptors reclaimed since init (wraps)
+} frame_dma_ring_t;
+
+typedef struct {
+    uintptr_t base_addr;        // axi_dma_0 S_AXI_LITE base
+    frame_dma_ring_t mm2s;      // Source frames (memory -> image_pros)
+    frame_dma_ring_t s2mm;      // Destination frames (image_pros -> memory)
+} frame_dma_t;
+
+// ============================================
+// Function Prototypes
+// ============================================
+
+// Reset both channels, link the descriptor rings and start the
+// engine. Each ring needs at least one descriptor per image row.
+int frame_dma_init(frame_dma_t *dma, uintptr_t base_addr,
+                   frame_dma_desc_t *mm2s_descs,
+                   frame_dma_desc_t *s2mm_descs,
+                   uint32_t count);
+
+// Queue one width x height frame: src rows are streamed into the
+// accelerator and its output rows are written to dst. stride is the
+// distance between rows in bytes for both buffers.
+int frame_dma_queue_frame(frame_dma_t *dma,
+                          const uint8_t *src, uint8_t *dst,
+                          uint16_t width, uint16_t height,
+                          uint32_t stride);
+
+// Same, for an accelerator that resizes the frame (image_pros scaler):
+// dst receives out_height rows of out_width bytes, out_stride apart.
+int frame_dma_queue_scaled(frame_dma_t *dma,
+                           const uint8_t *src, uint8_t *dst,
+                           uint16_t width, uint16_t height, uint32_t stride,
+                           uint16_t out_width, uint16_t out_height,
+                           uint32_t out_stride);
+
+// Reclaim completed descriptors. Returns the number of descriptors
+// still pending on both channels, or FRAME_DMA_ERR_BUS.
+int frame_dma_poll(frame_dma_t *dma);
+
+// Poll until every queued frame has completed.
+int frame_dma_wait(frame_dma_t *dma, uint32_t max_polls);
+
+// Drop every queued frame: reset the engine, relink both rings and
+// restart the channels. Needed after the accelerator rejects a frame
+// (image_pros status != 0), which leaves its descriptors pending for
+// the next frame. The completed counters restart at 0.
+int frame_dma_abort(frame_dma_t *dma);
+
+#endif // FRAME_DMA_H
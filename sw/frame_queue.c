@@ -0,0 +1,189 @@
+/*
+ * Image Processing Accelerator - Multi-Buffered Frame Queue
+ * Keeps image_pros running back to back across a ring of frame slots
+ */
+
+#include <stddef.h>
+#include "frame_queue.h"
+
+// ============================================
+// Platform Access
+// ============================================
+#ifdef FRAME_DMA_MODEL
+#include "accel_model.h"
+#define IP_READ(base, off)          accel_model_read((base), (off))
+#define IP_WRITE(base, off, val)    accel_model_write((base), (off), (val))
+#else
+#include "xil_io.h"
+#define IP_READ(base, off)          Xil_In32((base) + (off))
+#define IP_WRITE(base, off, val)    Xil_Out32((base) + (off), (val))
+#endif
+
+// IP status code of an accepted frame; every other code (width,
+// scaler, regions, border) rejects it without touching the streams
+#define IP_STATUS_OK            0
+
+// ============================================
+// Initialisation
+// ============================================
+int frame_queue_init(frame_queue_t *q, uintptr_t ip_base, frame_dma_t *dma,
+                     uint8_t *const src[], uint8_t *const dst[],
+                     uint32_t num_slots, uint16_t width, uint16_t height) {
+    if (num_slots < 2 || num_slots > FRAME_QUEUE_MAX_SLOTS ||
+        width == 0 || height == 0) {
+        return FRAME_QUEUE_ERR_ARG;
+    }
+    if (num_slots * height > dma->mm2s.count ||
+        num_slots * height > dma->s2mm.count) {
+        return FRAME_QUEUE_ERR_ARG;
+    }
+
+    q->ip_base = ip_base;
+    q->dma = dma;
+    q->num_slots = num_slots;
+    q->width = width;
+    q->height = height;
+    q->stage_idx = 0;
+    q->queue_idx = 0;
+    q->done_idx = 0;
+    q->rows_seen = dma->s2mm.completed;
+    q->frames_done = 0;
+    q->running = 0;
+
+    for (uint32_t i = 0; i < num_slots; i++) {
+        q->slots[i].src = src[i];
+        q->slots[i].dst = dst[i];
+        q->slots[i].state = SLOT_FREE;
+    }
+
+    IP_WRITE(ip_base, IP_WIDTH, width);
+    IP_WRITE(ip_base, IP_HEIGHT, height);
+
+    return FRAME_QUEUE_OK;
+}
+
+// ============================================
+// Producer Side
+// ============================================
+uint8_t *frame_queue_stage(frame_queue_t *q) {
+    frame_slot_t *slot = &q->slots[q->stage_idx];
+
+    if (slot->state == SLOT_FREE) {
+        slot->state = SLOT_STAGING;
+    }
+    return (slot->state == SLOT_STAGING) ? slot->src : NULL;
+}
+
+int frame_queue_submit(frame_queue_t *q) {
+    frame_slot_t *slot = &q->slots[q->stage_idx];
+
+    if (slot->state != SLOT_STAGING) {
+        return FRAME_QUEUE_ERR_STATE;
+    }
+
+    int ret = frame_dma_queue_frame(q->dma, slot->src, slot->dst,
+                                    q->width, q->height, q->width);
+    if (ret != FRAME_DMA_OK) {
+        return ret;
+    }
+
+    slot->state = SLOT_QUEUED;
+    q->stage_idx = (q->stage_idx + 1) % q->num_slots;
+
+    // Started once: from here on the IP re-arms itself after each
+    // frame (XImage_pros_EnableAutoRestart + XImage_pros_Start)
+    if (!q->running) {
+        IP_WRITE(q->ip_base, IP_AP_CTRL, AP_CTRL_AUTO_RESTART);
+        IP_WRITE(q->ip_base, IP_AP_CTRL, AP_CTRL_AUTO_RESTART | AP_CTRL_START);
+        q->running = 1;
+    }
+
+    return FRAME_QUEUE_OK;
+}
+
+// ============================================
+// Consumer Side
+// ============================================
+// Move frames whose last S2MM row has been reclaimed to DONE.
+static int retire_frames(frame_queue_t *q) {
+    int pending = frame_dma_poll(q->dma);
+    if (pending < 0) {
+        return pending;
+    }
+
+    while (q->slots[q->queue_idx].state == SLOT_QUEUED &&
+           q->dma->s2mm.completed - q->rows_seen >= q->height) {
+        q->rows_seen += q->height;
+        q->slots[q->queue_idx].state = SLOT_DONE;
+        q->queue_idx = (q->queue_idx + 1) % q->num_slots;
+        q->frames_done++;
+    }
+    return FRAME_QUEUE_OK;
+}
+
+// Drop every queued frame after the IP rejected one: its rows would
+// otherwise feed the next frame. Only the slot being staged (if any)
+// is left, and the ring restarts there.
+static int drop_frames(frame_queue_t *q) {
+    frame_queue_stop(q);
+    int ret = frame_dma_abort(q->dma);
+
+    for (uint32_t i = 0; i < q->num_slots; i++) {
+        if (q->slots[i].state == SLOT_QUEUED) {
+            q->slots[i].state = SLOT_FREE;
+        }
+    }
+    q->queue_idx = q->stage_idx;
+    q->done_idx = q->stage_idx;
+    q->rows_seen = q->dma->s2mm.completed;
+    return ret;
+}
+
+uint8_t *frame_queue_complete(frame_queue_t *q, int *err) {
+    frame_slot_t *slot = &q->slots[q->done_idx];
+    int ret = FRAME_QUEUE_OK;
+
+    if (slot->state == SLOT_QUEUED) {
+        ret = retire_frames(q);
+        // A rejected frame never consumes the stream
+        if (ret == FRAME_QUEUE_OK && slot->state == SLOT_QUEUED &&
+            IP_READ(q->ip_base, IP_STATUS) != IP_STATUS_OK) {
+            ret = (drop_frames(q) == FRAME_DMA_OK) ? FRAME_QUEUE_ERR_STATUS
+                                                   : FRAME_DMA_ERR_RESET;
+        }
+    }
+
+    if (err) {
+        *err = ret;
+    }
+    return (ret == FRAME_QUEUE_OK && slot->state == SLOT_DONE) ? slot->dst : NULL;
+}
+
+int frame_queue_release(frame_queue_t *q) {
+    frame_slot_t *slot = &q->slots[q->done_idx];
+
+    if (slot->state != SLOT_DONE) {
+        return FRAME_QUEUE_ERR_STATE;
+    }
+
+    slot->state = SLOT_FREE;
+    q->done_idx = (q->done_idx + 1) % q->num_slots;
+    return FRAME_QUEUE_OK;
+}
+
+uint32_t frame_queue_in_flight(const frame_queue_t *q) {
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < q->num_slots; i++) {
+        if (q->slots[i].state == SLOT_QUEUED) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void frame_queue_stop(frame_queue_t *q) {
+    // Clearing auto_restart only stops the next re-arm
+    IP_WRITE(q->ip_base, IP_AP_CTRL, 0);
+    q->running = 0;
+}
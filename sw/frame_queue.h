@@ -0,0 +1,110 @@
+/*
+ * Image Processing Accelerator - Multi-Buffered Frame Queue
+ * Keeps image_pros running back to back across a ring of frame slots
+ *
+ * The IP is started once with auto-restart enabled, so it re-arms
+ * itself after every frame and blocks on its input stream until the
+ * next frame arrives. Software stages frame k+1 (and k+2 with three
+ * slots) while frame k is being processed; completion is tracked per
+ * frame from the S2MM descriptors of frame_dma.c.
+ *
+ * Slots move FREE -> STAGING -> QUEUED -> DONE -> FREE, always in
+ * ring order. Build with -DFRAME_DMA_MODEL to run against the DMA and
+ * accelerator models (dma_model.c, accel_model.c) on a Linux host.
+ */
+
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <stdint.h>
+#include "frame_dma.h"
+
+// ============================================
+// image_pros Control Register (s_axilite)
+// ============================================
+#define IP_AP_CTRL              0x00
+#define IP_WIDTH                0x20
+#define IP_HEIGHT               0x28
+#define IP_STATUS               0x30
+
+#define AP_CTRL_START           0x01
+#define AP_CTRL_DONE            0x02
+#define AP_CTRL_IDLE            0x04
+#define AP_CTRL_READY           0x08
+#define AP_CTRL_AUTO_RESTART    0x80
+
+// ============================================
+// Limits and Return Codes
+// ============================================
+#define FRAME_QUEUE_MAX_SLOTS   3       // Double or triple buffering
+
+#define FRAME_QUEUE_OK          0
+#define FRAME_QUEUE_ERR_ARG     -10     // Bad slot count or frame size
+#define FRAME_QUEUE_ERR_STATE   -11     // No slot in the required state
+#define FRAME_QUEUE_ERR_STATUS  -12     // IP rejected the frame (status != 0)
+
+typedef enum {
+    SLOT_FREE = 0,      // Owned by software, unused
+    SLOT_STAGING,       // Handed out by frame_queue_stage()
+    SLOT_QUEUED,        // Descriptors queued, owned by hardware
+    SLOT_DONE           // Output ready, handed out by frame_queue_complete()
+} frame_slot_state_t;
+
+typedef struct {
+    uint8_t *src;                   // Input frame (DMA-visible)
+    uint8_t *dst;                   // Output frame (DMA-visible)
+    frame_slot_state_t state;
+} frame_slot_t;
+
+typedef struct {
+    uintptr_t ip_base;              // image_pros s_axi_control base
+    frame_dma_t *dma;
+    frame_slot_t slots[FRAME_QUEUE_MAX_SLOTS];
+    uint32_t num_slots;
+    uint16_t width;
+    uint16_t height;
+    uint32_t stage_idx;             // Next slot to stage
+    uint32_t queue_idx;             // Oldest slot owned by hardware
+    uint32_t done_idx;              // Oldest slot with output ready
+    uint32_t rows_seen;             // s2mm.completed already assigned to frames
+    uint32_t frames_done;           // Frames completed since init
+    int running;                    // IP started with auto-restart
+} frame_queue_t;
+
+// ============================================
+// Function Prototypes
+// ============================================
+
+// Bind num_slots src/dst buffer pairs (2 or 3) to an initialised
+// frame_dma. The DMA rings need num_slots * height descriptors. The
+// filter registers are left to the caller; width and height are
+// written here and must not change while the queue runs.
+int frame_queue_init(frame_queue_t *q, uintptr_t ip_base, frame_dma_t *dma,
+                     uint8_t *const src[], uint8_t *const dst[],
+                     uint32_t num_slots, uint16_t width, uint16_t height);
+
+// Next free source buffer to fill, or NULL while every slot is busy.
+uint8_t *frame_queue_stage(frame_queue_t *q);
+
+// Hand the staged buffer to the hardware. The first submit starts the
+// IP in auto-restart mode.
+int frame_queue_submit(frame_queue_t *q);
+
+// Oldest finished output frame, or NULL if none is ready yet. Sets
+// *err (if given) to a negative code on a DMA or IP error. On
+// FRAME_QUEUE_ERR_STATUS the IP is stopped and every queued frame is
+// dropped (frame_dma_abort), so their slots are free again; fix the
+// registers and stage the frames again.
+uint8_t *frame_queue_complete(frame_queue_t *q, int *err);
+
+// Return the slot handed out by frame_queue_complete() to the pool.
+int frame_queue_release(frame_queue_t *q);
+
+// Frames owned by hardware.
+uint32_t frame_queue_in_flight(const frame_queue_t *q);
+
+// Stop re-arming the IP. It finishes the current frame and, having
+// already restarted, idles on its input stream until the next start.
+void frame_queue_stop(frame_queue_t *q);
+
+#endif // FRAME_QUEUE_H
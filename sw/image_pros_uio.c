@@ -0,0 +1,505 @@
+/*
+ * Image Processing Accelerator - Linux Zero-Copy Frame API
+ * Multi-instance UIO handles and DMA-visible frame buffers
+ */
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "image_pros_uio.h"
+
+#define MAX_UIO_DEVICES     64
+
+// ============================================
+// sysfs Helpers
+// ============================================
+// snprintf into a path buffer; -1 if it does not fit
+static int make_path(char *path, const char *fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    int n = vsnprintf(path, IMAGE_PROS_UIO_PATH_SIZE, fmt, args);
+    va_end(args);
+    return (n < 0 || n >= IMAGE_PROS_UIO_PATH_SIZE) ? -1 : 0;
+}
+
+static int read_line(const char *path, char *line, size_t size) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        return -1;
+    }
+    char *s = fgets(line, (int)size, fp);
+    fclose(fp);
+    if (!s) {
+        return -1;
+    }
+    line[strcspn(line, "\n")] = 0;
+    return 0;
+}
+
+// Accepts "0x..." (UIO, phys_addr) and decimal (u-dma-buf size)
+static int read_u64(const char *path, uint64_t *value) {
+    char line[IMAGE_PROS_UIO_NAME_SIZE];
+    char *end;
+
+    if (read_line(path, line, sizeof(line)) != 0) {
+        return -1;
+    }
+    *value = strtoull(line, &end, 0);
+    return (end == line) ? -1 : 0;
+}
+
+// uio number of the index-th device called name, in numeric order
+static int find_uio(const char *root, const char *name, int index) {
+    int nums[MAX_UIO_DEVICES];
+    int count = 0;
+    char path[IMAGE_PROS_UIO_PATH_SIZE];
+    char line[IMAGE_PROS_UIO_NAME_SIZE];
+    struct dirent *entry;
+
+    DIR *dir = opendir(root);
+    if (!dir) {
+        return -1;
+    }
+    while ((entry = readdir(dir)) != NULL && count < MAX_UIO_DEVICES) {
+        if (strncmp(entry->d_name, "uio", 3) != 0) {
+            continue;
+        }
+        if (make_path(path, "%s/%s/name", root, entry->d_name) == 0 &&
+            read_line(path, line, sizeof(line)) == 0 && strcmp(line, name) == 0) {
+            nums[count++] = atoi(entry->d_name + 3);
+        }
+    }
+    closedir(dir);
+
+    if (index < 0 || index >= count) {
+        return -1;
+    }
+    // Selection of the index-th smallest number
+    for (int i = 0; i <= index; i++) {
+        for (int j = i + 1; j < count; j++) {
+            if (nums[j] < nums[i]) {
+                int tmp = nums[i];
+                nums[i] = nums[j];
+                nums[j] = tmp;
+            }
+        }
+    }
+    return nums[index];
+}
+
+// ============================================
+// Real Backend: /sys/class + /dev
+// ============================================
+static int dev_open_node(const image_pros_backend_t *be, const char *node,
+                         int *irq_fd) {
+    char path[IMAGE_PROS_UIO_PATH_SIZE];
+    (void)be;
+
+    make_path(path, "/dev/%s", node);
+    int fd = open(path, O_RDWR | O_SYNC);
+    if (irq_fd) {
+        *irq_fd = fd;
+    }
+    return fd;
+}
+
+// UIO selects map n with an offset of n pages
+static off_t dev_map_offset(const image_pros_backend_t *be, const char *node,
+                            int map) {
+    (void)be;
+    return (strncmp(node, "uio", 3) == 0) ? (off_t)map * getpagesize() : 0;
+}
+
+const image_pros_backend_t image_pros_uio_backend = {
+    "/sys/class/uio",
+    "/sys/class/u-dma-buf",
+    dev_open_node,
+    dev_map_offset,
+    NULL
+};
+
+// ============================================
+// Accelerator Handle
+// ============================================
+static int map_region(image_pros_uio_t *dev, int map) {
+    image_pros_buf_t *region = &dev->maps[map];
+
+    if (region->virt) {
+        return IMAGE_PROS_UIO_OK;
+    }
+    void *virt = mmap(NULL, region->size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      dev->fd, dev->backend->map_offset(dev->backend, dev->node, map));
+    if (virt == MAP_FAILED) {
+        return IMAGE_PROS_UIO_ERR_MAP;
+    }
+    region->virt = virt;
+    return IMAGE_PROS_UIO_OK;
+}
+
+int image_pros_uio_open(image_pros_uio_t *dev, const image_pros_backend_t *be,
+                        const char *name, int index) {
+    char path[IMAGE_PROS_UIO_PATH_SIZE];
+
+    memset(dev, 0, sizeof(*dev));
+    dev->backend = be;
+    dev->fd = -1;
+    dev->irq_fd = -1;
+
+    dev->uio_num = find_uio(be->uio_root, name, index);
+    if (dev->uio_num < 0) {
+        return IMAGE_PROS_UIO_ERR_NOT_FOUND;
+    }
+    snprintf(dev->node, sizeof(dev->node), "uio%d", dev->uio_num);
+
+    // Maps are numbered without gaps
+    for (int n = 0; n < IMAGE_PROS_UIO_MAX_MAPS; n++) {
+        uint64_t addr, size;
+        make_path(path, "%s/%s/maps/map%d/addr", be->uio_root, dev->node, n);
+        if (read_u64(path, &addr) != 0) {
+            break;
+        }
+        make_path(path, "%s/%s/maps/map%d/size", be->uio_root, dev->node, n);
+        if (read_u64(path, &size) != 0) {
+            break;
+        }
+        dev->maps[n].phys = addr;
+        dev->maps[n].size = (size_t)size;
+        dev->num_maps = n + 1;
+    }
+    if (dev->num_maps == 0) {
+        return IMAGE_PROS_UIO_ERR_MAP;
+    }
+
+    dev->fd = be->open_node(be, dev->node, &dev->irq_fd);
+    if (dev->fd < 0) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+
+    // NOTE: slave interface 'Control' is uioN/map0
+    if (map_region(dev, 0) != IMAGE_PROS_UIO_OK) {
+        image_pros_uio_close(dev);
+        return IMAGE_PROS_UIO_ERR_MAP;
+    }
+    dev->ip.Control_BaseAddress = (u64)(uintptr_t)dev->maps[0].virt;
+    dev->ip.IsReady = XIL_COMPONENT_IS_READY;
+
+    return IMAGE_PROS_UIO_OK;
+}
+
+int image_pros_uio_close(image_pros_uio_t *dev) {
+    for (int n = 0; n < dev->num_maps; n++) {
+        if (dev->maps[n].virt) {
+            munmap(dev->maps[n].virt, dev->maps[n].size);
+            dev->maps[n].virt = NULL;
+        }
+    }
+    if (dev->irq_fd >= 0 && dev->irq_fd != dev->fd) {
+        close(dev->irq_fd);
+    }
+    if (dev->fd >= 0) {
+        close(dev->fd);
+    }
+    dev->fd = -1;
+    dev->irq_fd = -1;
+    dev->ip.IsReady = 0;
+
+    return IMAGE_PROS_UIO_OK;
+}
+
+int image_pros_uio_map(image_pros_uio_t *dev, int map, image_pros_buf_t *buf) {
+    if (map < 1 || map >= dev->num_maps) {
+        return IMAGE_PROS_UIO_ERR_MAP;
+    }
+    int ret = map_region(dev, map);
+    if (ret == IMAGE_PROS_UIO_OK) {
+        *buf = dev->maps[map];
+    }
+    return ret;
+}
+
+int image_pros_uio_wait_irq(image_pros_uio_t *dev, int timeout_ms) {
+    struct pollfd pfd;
+    uint32_t irq_on = 1;
+    uint32_t irq_count;
+
+    // Writing 1 re-enables the (level) interrupt masked by the kernel
+    if (write(dev->irq_fd, &irq_on, sizeof(irq_on)) != sizeof(irq_on)) {
+        return IMAGE_PROS_UIO_ERR_IO;
+    }
+
+    pfd.fd = dev->irq_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int ret = poll(&pfd, 1, timeout_ms);
+    if (ret == 0) {
+        return IMAGE_PROS_UIO_ERR_TIMEOUT;
+    }
+    if (ret < 0 || !(pfd.revents & POLLIN) ||
+        read(dev->irq_fd, &irq_count, sizeof(irq_count)) != sizeof(irq_count)) {
+        return IMAGE_PROS_UIO_ERR_IO;
+    }
+
+    XImage_pros_InterruptClear(&dev->ip, XImage_pros_InterruptGetStatus(&dev->ip));
+    return IMAGE_PROS_UIO_OK;
+}
+
+// ============================================
+// u-dma-buf (CMA) Buffers
+// ============================================
+int image_pros_udmabuf_open(const image_pros_backend_t *be, const char *name,
+                            image_pros_buf_t *buf) {
+    char path[IMAGE_PROS_UIO_PATH_SIZE];
+    uint64_t phys, size;
+
+    make_path(path, "%s/%s/phys_addr", be->udmabuf_root, name);
+    if (read_u64(path, &phys) != 0) {
+        return IMAGE_PROS_UIO_ERR_NOT_FOUND;
+    }
+    make_path(path, "%s/%s/size", be->udmabuf_root, name);
+    if (read_u64(path, &size) != 0) {
+        return IMAGE_PROS_UIO_ERR_NOT_FOUND;
+    }
+
+    int fd = be->open_node(be, name, NULL);
+    if (fd < 0) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+    // The mapping keeps the buffer alive after close()
+    void *virt = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, be->map_offset(be, name, 0));
+    close(fd);
+    if (virt == MAP_FAILED) {
+        return IMAGE_PROS_UIO_ERR_MAP;
+    }
+
+    buf->virt = virt;
+    buf->phys = phys;
+    buf->size = (size_t)size;
+    return IMAGE_PROS_UIO_OK;
+}
+
+int image_pros_buf_close(image_pros_buf_t *buf) {
+    if (buf->virt) {
+        munmap(buf->virt, buf->size);
+        buf->virt = NULL;
+    }
+    return IMAGE_PROS_UIO_OK;
+}
+
+image_pros_buf_t image_pros_buf_slice(const image_pros_buf_t *buf,
+                                      size_t offset, size_t size) {
+    image_pros_buf_t slice = { NULL, 0, 0 };
+
+    if (offset <= buf->size && size <= buf->size - offset) {
+        slice.virt = (uint8_t *)buf->virt + offset;
+        slice.phys = buf->phys + offset;
+        slice.size = size;
+    }
+    return slice;
+}
+
+// ============================================
+// Fake Backend
+// ============================================
+static image_pros_fake_node_t *fake_node(const image_pros_fake_t *fake,
+                                         const char *name) {
+    for (int i = 0; i < fake->num_nodes; i++) {
+        if (strcmp(fake->nodes[i].name, name) == 0) {
+            return (image_pros_fake_node_t *)&fake->nodes[i];
+        }
+    }
+    return NULL;
+}
+
+static int fake_open_node(const image_pros_backend_t *be, const char *node,
+                          int *irq_fd) {
+    image_pros_fake_node_t *fn = fake_node((const image_pros_fake_t *)be->ctx, node);
+    if (!fn) {
+        return -1;
+    }
+    if (irq_fd) {
+        *irq_fd = dup(fn->irq_fd[0]);
+    }
+    return dup(fn->mem_fd);
+}
+
+static off_t fake_map_offset(const image_pros_backend_t *be, const char *node,
+                             int map) {
+    image_pros_fake_node_t *fn = fake_node((const image_pros_fake_t *)be->ctx, node);
+    return fn ? fn->offsets[map] : 0;
+}
+
+static int write_file(const char *dir, const char *file, const char *text) {
+    char path[IMAGE_PROS_UIO_PATH_SIZE];
+    make_path(path, "%s/%s", dir, file);
+
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        return -1;
+    }
+    fprintf(fp, "%s\n", text);
+    fclose(fp);
+    return 0;
+}
+
+static int write_u64(const char *dir, const char *file, const char *fmt,
+                     uint64_t value) {
+    char text[IMAGE_PROS_UIO_NAME_SIZE];
+    snprintf(text, sizeof(text), fmt, (unsigned long long)value);
+    return write_file(dir, file, text);
+}
+
+static image_pros_fake_node_t *fake_new_node(image_pros_fake_t *fake,
+                                             const char *name, size_t size) {
+    if (fake->num_nodes == IMAGE_PROS_FAKE_MAX_NODES) {
+        return NULL;
+    }
+    image_pros_fake_node_t *fn = &fake->nodes[fake->num_nodes];
+
+    memset(fn, 0, sizeof(*fn));
+    snprintf(fn->name, sizeof(fn->name), "%s", name);
+    fn->irq_fd[0] = -1;
+    fn->irq_fd[1] = -1;
+    fn->mem_fd = memfd_create(name, MFD_CLOEXEC);
+    if (fn->mem_fd < 0 || ftruncate(fn->mem_fd, (off_t)size) != 0) {
+        return NULL;
+    }
+    fake->num_nodes++;
+    return fn;
+}
+
+int image_pros_fake_init(image_pros_fake_t *fake) {
+    memset(fake, 0, sizeof(*fake));
+    make_path(fake->root, "/tmp/image_pros_fake_XXXXXX");
+    if (!mkdtemp(fake->root)) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+    make_path(fake->uio_root, "%s/uio", fake->root);
+    make_path(fake->udmabuf_root, "%s/u-dma-buf", fake->root);
+    if (mkdir(fake->uio_root, 0755) != 0 || mkdir(fake->udmabuf_root, 0755) != 0) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+
+    fake->backend.uio_root = fake->uio_root;
+    fake->backend.udmabuf_root = fake->udmabuf_root;
+    fake->backend.open_node = fake_open_node;
+    fake->backend.map_offset = fake_map_offset;
+    fake->backend.ctx = fake;
+    return IMAGE_PROS_UIO_OK;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag,
+                        struct FTW *ftw) {
+    (void)sb;
+    (void)flag;
+    (void)ftw;
+    return remove(path);
+}
+
+void image_pros_fake_destroy(image_pros_fake_t *fake) {
+    for (int i = 0; i < fake->num_nodes; i++) {
+        image_pros_fake_node_t *fn = &fake->nodes[i];
+        close(fn->mem_fd);
+        if (fn->irq_fd[0] >= 0) {
+            close(fn->irq_fd[0]);
+            close(fn->irq_fd[1]);
+        }
+    }
+    fake->num_nodes = 0;
+    nftw(fake->root, remove_entry, 8, FTW_DEPTH | FTW_PHYS);
+}
+
+int image_pros_fake_add_uio(image_pros_fake_t *fake, int uio_num,
+                            const char *name, const uint64_t addrs[],
+                            const size_t sizes[], int num_maps) {
+    char node[IMAGE_PROS_UIO_NAME_SIZE];
+    char dir[IMAGE_PROS_UIO_PATH_SIZE];
+    char map_dir[IMAGE_PROS_UIO_PATH_SIZE];
+    off_t offsets[IMAGE_PROS_UIO_MAX_MAPS];
+    off_t total = 0;
+    long page = getpagesize();
+
+    if (num_maps < 1 || num_maps > IMAGE_PROS_UIO_MAX_MAPS) {
+        return IMAGE_PROS_UIO_ERR_MAP;
+    }
+    // Maps back to back in one memfd, each page aligned
+    for (int n = 0; n < num_maps; n++) {
+        offsets[n] = total;
+        total += (off_t)((sizes[n] + page - 1) / page * page);
+    }
+
+    snprintf(node, sizeof(node), "uio%d", uio_num);
+    image_pros_fake_node_t *fn = fake_new_node(fake, node, (size_t)total);
+    if (!fn || socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fn->irq_fd) != 0) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+    memcpy(fn->offsets, offsets, sizeof(off_t) * num_maps);
+
+    make_path(dir, "%s/%s", fake->uio_root, node);
+    make_path(map_dir, "%s/maps", dir);
+    if (mkdir(dir, 0755) != 0 || mkdir(map_dir, 0755) != 0 ||
+        write_file(dir, "name", name) != 0) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+
+    // Same layout and formats as the kernel's uio class
+    for (int n = 0; n < num_maps; n++) {
+        make_path(map_dir, "%s/maps/map%d", dir, n);
+        mkdir(map_dir, 0755);
+        write_u64(map_dir, "addr", "0x%llx", addrs[n]);
+        write_u64(map_dir, "size", "0x%llx", sizes[n]);
+    }
+    return IMAGE_PROS_UIO_OK;
+}
+
+int image_pros_fake_add_udmabuf(image_pros_fake_t *fake, int num,
+                                uint64_t phys, size_t size) {
+    char node[IMAGE_PROS_UIO_NAME_SIZE];
+    char dir[IMAGE_PROS_UIO_PATH_SIZE];
+
+    snprintf(node, sizeof(node), "udmabuf%d", num);
+    if (!fake_new_node(fake, node, size)) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+
+    make_path(dir, "%s/%s", fake->udmabuf_root, node);
+    if (mkdir(dir, 0755) != 0 ||
+        write_u64(dir, "phys_addr", "0x%llx", phys) != 0 ||
+        write_u64(dir, "size", "%llu", size) != 0) {
+        return IMAGE_PROS_UIO_ERR_OPEN;
+    }
+    return IMAGE_PROS_UIO_OK;
+}
+
+int image_pros_fake_irq(image_pros_fake_t *fake, int uio_num) {
+    char node[IMAGE_PROS_UIO_NAME_SIZE];
+    uint32_t enable;
+
+    snprintf(node, sizeof(node), "uio%d", uio_num);
+    image_pros_fake_node_t *fn = fake_node(fake, node);
+    if (!fn || fn->irq_fd[1] < 0) {
+        return IMAGE_PROS_UIO_ERR_NOT_FOUND;
+    }
+
+    // Drain the enable writes so the socket never fills
+    while (recv(fn->irq_fd[1], &enable, sizeof(enable), MSG_DONTWAIT) > 0) {
+    }
+
+    fn->irq_count++;
+    if (write(fn->irq_fd[1], &fn->irq_count, sizeof(fn->irq_count)) !=
+        sizeof(fn->irq_count)) {
+        return IMAGE_PROS_UIO_ERR_IO;
+    }
+    return IMAGE_PROS_UIO_OK;
+}
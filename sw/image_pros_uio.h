@@ -0,0 +1,143 @@
+/*
+ * Image Processing Accelerator - Linux Zero-Copy Frame API
+ * Multi-instance UIO handles and DMA-visible frame buffers
+ *
+ * Each handle owns one /dev/uioN. map0 is the s_axi_control register
+ * block and backs an XImage_pros instance, so the generated driver
+ * API (Set_*, Start, Interrupt*) works per handle. Further UIO maps,
+ * e.g. a reserved-memory frame region, and u-dma-buf (CMA) buffers
+ * are mapped as image_pros_buf_t: the user address to fill and the
+ * bus address to program into the DMA, so frames are never copied.
+ *
+ * sysfs and device node access goes through a backend. The fake
+ * backend builds a UIO-like sysfs tree in a temporary directory with
+ * memfd-backed maps and a socketpair as interrupt line, so the API
+ * can be unit-tested on any Linux box.
+ */
+
+#ifndef IMAGE_PROS_UIO_H
+#define IMAGE_PROS_UIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "ximage_pros.h"
+
+// ============================================
+// Limits and Return Codes
+// ============================================
+#define IMAGE_PROS_UIO_MAX_MAPS     5
+#define IMAGE_PROS_UIO_NAME_SIZE    64
+#define IMAGE_PROS_UIO_PATH_SIZE    256
+#define IMAGE_PROS_FAKE_MAX_NODES   4
+
+#define IMAGE_PROS_UIO_OK           0
+#define IMAGE_PROS_UIO_ERR_NOT_FOUND -30    // No such UIO/u-dma-buf device
+#define IMAGE_PROS_UIO_ERR_OPEN     -31     // Device node could not be opened
+#define IMAGE_PROS_UIO_ERR_MAP      -32     // Map missing or mmap failed
+#define IMAGE_PROS_UIO_ERR_TIMEOUT  -33     // No interrupt in time
+#define IMAGE_PROS_UIO_ERR_IO       -34     // Interrupt read/write failed
+
+// ============================================
+// Buffers
+// ============================================
+typedef struct {
+    void *virt;                 // User mapping (NULL until mapped)
+    uint64_t phys;              // Bus address for the DMA
+    size_t size;
+} image_pros_buf_t;
+
+// ============================================
+// Backend
+// ============================================
+typedef struct image_pros_backend {
+    const char *uio_root;       // Class directory holding uioN/
+    const char *udmabuf_root;   // Class directory holding udmabufN/
+    // Open device node ("uio0", "udmabuf0"); for UIO nodes also
+    // returns the fd that carries interrupts.
+    int (*open_node)(const struct image_pros_backend *be, const char *node,
+                     int *irq_fd);
+    // mmap offset of a map within the node's fd
+    off_t (*map_offset)(const struct image_pros_backend *be, const char *node,
+                        int map);
+    void *ctx;
+} image_pros_backend_t;
+
+// /sys/class/uio, /sys/class/u-dma-buf and /dev
+extern const image_pros_backend_t image_pros_uio_backend;
+
+// ============================================
+// Accelerator Handle
+// ============================================
+typedef struct {
+    const image_pros_backend_t *backend;
+    int fd;
+    int irq_fd;
+    int uio_num;
+    char node[IMAGE_PROS_UIO_NAME_SIZE];
+    image_pros_buf_t maps[IMAGE_PROS_UIO_MAX_MAPS];
+    int num_maps;
+    XImage_pros ip;             // Control registers (map0)
+} image_pros_uio_t;
+
+// Open the index-th UIO device called name (several instances of the
+// IP share one name) and map its control registers.
+int image_pros_uio_open(image_pros_uio_t *dev, const image_pros_backend_t *be,
+                        const char *name, int index);
+int image_pros_uio_close(image_pros_uio_t *dev);
+
+// Map UIO map n (n >= 1); the mapping is owned by the handle.
+int image_pros_uio_map(image_pros_uio_t *dev, int map, image_pros_buf_t *buf);
+
+// Re-arm and wait for the IP interrupt, then clear its ISR. A
+// negative timeout waits forever.
+int image_pros_uio_wait_irq(image_pros_uio_t *dev, int timeout_ms);
+
+// ============================================
+// u-dma-buf (CMA) Buffers
+// ============================================
+// Map /dev/<name> (e.g. "udmabuf0") with its physical address.
+int image_pros_udmabuf_open(const image_pros_backend_t *be, const char *name,
+                            image_pros_buf_t *buf);
+int image_pros_buf_close(image_pros_buf_t *buf);
+
+// Sub-buffer, e.g. one frame of a larger region; size 0 on overrun.
+image_pros_buf_t image_pros_buf_slice(const image_pros_buf_t *buf,
+                                      size_t offset, size_t size);
+
+// ============================================
+// Fake UIO Backend (unit tests)
+// ============================================
+typedef struct {
+    char name[IMAGE_PROS_UIO_NAME_SIZE];    // "uio0", "udmabuf1", ...
+    int mem_fd;                             // memfd holding all maps
+    int irq_fd[2];                          // [0] library, [1] test side
+    off_t offsets[IMAGE_PROS_UIO_MAX_MAPS];
+    uint32_t irq_count;
+} image_pros_fake_node_t;
+
+typedef struct {
+    image_pros_backend_t backend;           // Pass &fake->backend
+    char root[IMAGE_PROS_UIO_PATH_SIZE];
+    char uio_root[IMAGE_PROS_UIO_PATH_SIZE];
+    char udmabuf_root[IMAGE_PROS_UIO_PATH_SIZE];
+    image_pros_fake_node_t nodes[IMAGE_PROS_FAKE_MAX_NODES];
+    int num_nodes;
+} image_pros_fake_t;
+
+int image_pros_fake_init(image_pros_fake_t *fake);
+void image_pros_fake_destroy(image_pros_fake_t *fake);
+
+// Add uio<uio_num> named name with num_maps maps (map0 = registers)
+int image_pros_fake_add_uio(image_pros_fake_t *fake, int uio_num,
+                            const char *name, const uint64_t addrs[],
+                            const size_t sizes[], int num_maps);
+
+// Add udmabuf<num> of size bytes at bus address phys
+int image_pros_fake_add_udmabuf(image_pros_fake_t *fake, int num,
+                                uint64_t phys, size_t size);
+
+// Raise the interrupt of uio<uio_num> once
+int image_pros_fake_irq(image_pros_fake_t *fake, int uio_num);
+
+#endif // IMAGE_PROS_UIO_H
@@ -11,6 +11,14 @@
 #include "xparameters.h"
 #include "xil_io.h"
 #include "xil_printf.h"
+#include "xil_exception.h"
+#include "xintc.h"
+#include "ximage_pros.h"
+#include "frame_dma.h"
+#include "frame_queue.h"
+#include "accel_irq.h"
+#include "blur_coeffs.h"
+#include "conv_coeffs.h"
 
 // ============================================
 // Hardware Address Definitions
@@ -19,6 +27,9 @@
 #define IMG_PROC_BASE_ADDR      XPAR_IMAGE_PROCESSING_0_S_AXI_CONTROL_BASEADDR
 #define GPIO_BASE_ADDR          XPAR_AXI_GPIO_0_BASEADDR
 #define IMAGE_BRAM_BASE_ADDR    XPAR_AXI_BRAM_CTRL_0_S_AXI_BASEADDR
+#define DMA_BASE_ADDR           XPAR_AXI_DMA_0_BASEADDR
+#define INTC_DEVICE_ID          XPAR_MICROBLAZE_0_AXI_INTC_DEVICE_ID
+#define IMG_PROC_INTR_ID        XPAR_MICROBLAZE_0_AXI_INTC_IMAGE_PROS_0_INTERRUPT_INTR
 
 // ============================================
 // Image Processing IP Register Offsets
@@ -32,6 +43,27 @@
 #define THRESHOLD_VAL_OFFSET    0x18    // Threshold value
 #define WIDTH_OFFSET            0x20    // Image width
 #define HEIGHT_OFFSET           0x28    // Image height
+#define STATUS_OFFSET           0x30    // Frame status (read-only)
+#define INPUT_FORMAT_OFFSET     0x38    // Input stream format
+#define FILTER_CHAIN_OFFSET     0x40    // Fused filter chain (byte/stage)
+#define BLUR_COEFFS_OFFSET      0x48    // Separable blur taps (byte/tap)
+#define CONV_COEFFS_OFFSET      0x50    // Convolution taps, 7 words
+#define CONV_CTRL_OFFSET        0x70    // Convolution shift/size/bias
+#define THRESHOLD_HIGH_OFFSET   0x78    // Canny high threshold
+#define STATS_MIN_OFFSET        0x80    // Output frame statistics (read-only)
+#define STATS_MAX_OFFSET        0x88
+#define STATS_SUM_OFFSET        0x90    // 64-bit, low word first
+#define STATS_SUM_SQ_OFFSET     0xA0    // 64-bit, low word first
+#define LUT_BANK_OFFSET         0xB0    // FILTER_LUT bank select
+#define FRAME_SYNC_OFFSET       0xB8    // TUSER/TLAST framing enable
+#define FRAME_ERRORS_OFFSET     0xC0    // Framing errors since reset (read-only)
+#define SCALE_CTRL_OFFSET       0xC8    // Scaler mode and placement
+#define OUT_WIDTH_OFFSET        0xD0    // Scaled output width
+#define OUT_HEIGHT_OFFSET       0xD8    // Scaled output height
+#define ROI_COUNT_OFFSET        0xE0    // Active regions of interest (0 = full frame)
+#define ROI_RECTS_OFFSET        0xE8    // 2 words per region: x | y << 16, w | h << 16
+#define BORDER_CTRL_OFFSET      0x128   // Border mode, align and constant
+#define GRAD_ENABLE_OFFSET      0x130   // Packed gradient on dst_grad
 
 // Control register bits
 #define CTRL_START_BIT          0x01
@@ -39,6 +71,13 @@
 #define CTRL_IDLE_BIT           0x04
 #define CTRL_READY_BIT          0x08
 
+// Frame status codes
+#define STATUS_OK               0
+#define STATUS_ERR_WIDTH        1       // Width exceeds IP line buffer
+#define STATUS_ERR_SCALE        2       // Scaler size or mode out of range
+#define STATUS_ERR_ROI          3       // Region empty, outside or overlapping
+#define STATUS_ERR_BORDER       4       // Unknown border mode or frame cropped away
+
 // ============================================
 // Filter Mode Definitions
 // ============================================
@@ -49,6 +88,68 @@
 #define FILTER_GAUSSIAN     4
 #define FILTER_NEGATIVE     5
 #define FILTER_SHARPEN      6
+#define FILTER_BLUR         7
+#define FILTER_CONV         8
+#define FILTER_MEDIAN       9
+#define FILTER_ERODE        10
+#define FILTER_DILATE       11
+#define FILTER_OPEN         12
+#define FILTER_CLOSE        13
+#define FILTER_CANNY        14
+#define FILTER_ADAPTIVE     15
+#define FILTER_OTSU         16
+#define FILTER_LUT          17
+#define FILTER_EQUALIZE     18
+#define FILTER_GRAD_X       19
+#define FILTER_GRAD_Y       20
+
+// scale_ctrl: mode in bit 1~0, bit 2 scales the chain output
+#define SCALE_NONE          0
+#define SCALE_BOX           1
+#define SCALE_BILINEAR      2
+#define SCALE_AFTER         0x04
+
+// border_ctrl: mode in bit 2~0, bit 3 centres legacy mode, constant in
+// bit 15~8. Crop shrinks the frame by the window radius per stage.
+#define BORDER_LEGACY       0
+#define BORDER_REPLICATE    1
+#define BORDER_REFLECT      2
+#define BORDER_CONSTANT     3
+#define BORDER_CROP         4
+#define BORDER_ALIGN        0x08
+
+// FILTER_LUT tables: two banks of 256 entries, 4 per word
+#define LUT_ENTRIES         256
+#define LUT_WORDS           (LUT_ENTRIES / 4)
+
+// Must match BLUR_KERNEL_SIZE of the IP build
+#define BLUR_KERNEL_SIZE    5
+
+// Kernels for FILTER_CONV (row-major, signed)
+static const int8_t EMBOSS_TAPS[9] = {
+    -2, -1, 0,
+    -1,  1, 1,
+     0,  1, 2
+};
+static const int8_t LOG_TAPS[25] = {
+     0,  0, -1,  0,  0,
+     0, -1, -2, -1,  0,
+    -1, -2, 16, -2, -1,
+     0, -1, -2, -1,  0,
+     0,  0, -1,  0,  0
+};
+
+// Pack up to 4 filter modes into the filter_chain register
+#define FILTER_CHAIN(s0, s1, s2, s3) \
+    ((uint32_t)(s0) | ((uint32_t)(s1) << 8) | \
+     ((uint32_t)(s2) << 16) | ((uint32_t)(s3) << 24))
+
+// ============================================
+// Input Format Definitions
+// ============================================
+#define INPUT_GRAY          0   // 8-bit grayscale stream
+#define INPUT_RGB_601       1   // 24-bit RGB stream, BT.601 luma
+#define INPUT_RGB_709       2   // 24-bit RGB stream, BT.709 luma
 
 // ============================================
 // Image Parameters
@@ -58,53 +159,92 @@
 #define IMG_SIZE    (IMG_WIDTH * IMG_HEIGHT)
 
 // ============================================
-// Test Image Data (64x64 grayscale)
+// Frame Buffers and DMA Descriptors
 // ============================================
-static uint8_t test_image[IMG_SIZE];
-static uint8_t output_image[IMG_SIZE];
+// Everything the DMA touches lives in the AXI BRAM, which both the
+// MicroBlaze and axi_dma_0 can reach. One descriptor per row, enough
+// for every slot of the streaming frame queue.
+#define NUM_FRAME_SLOTS     3       // Triple buffering
+#define SRC_FRAME_ADDR(i)   (IMAGE_BRAM_BASE_ADDR + (i) * IMG_SIZE)
+#define DST_FRAME_ADDR(i)   SRC_FRAME_ADDR(NUM_FRAME_SLOTS + (i))
+#define DESC_ADDR           SRC_FRAME_ADDR(2 * NUM_FRAME_SLOTS)
+#define DMA_RING_SIZE       (NUM_FRAME_SLOTS * IMG_HEIGHT)
+#define DMA_MAX_POLLS       1000000
+#define STREAM_FRAMES       8
+
+static uint8_t *const test_image = (uint8_t *)SRC_FRAME_ADDR(0);
+static uint8_t *const output_image = (uint8_t *)DST_FRAME_ADDR(0);
+static frame_dma_desc_t *const mm2s_descs = (frame_dma_desc_t *)DESC_ADDR;
+static frame_dma_desc_t *const s2mm_descs = (frame_dma_desc_t *)DESC_ADDR + DMA_RING_SIZE;
+
+static frame_dma_t frame_dma;
+
+// ============================================
+// Interrupts
+// ============================================
+#define IRQ_MAX_POLLS       10000000
+
+static XIntc intc;
+static XImage_pros image_pros;
+static accel_irq_t accel_irq;
 
 // ============================================
 // Generate Test Pattern
 // ============================================
-void generate_test_pattern(void) {
-    xil_printf("Generating test pattern...\n\r");
-    
+// shift moves the gradient background so streamed frames differ
+void generate_test_pattern(uint8_t* image, int shift) {
     for (int y = 0; y < IMG_HEIGHT; y++) {
         for (int x = 0; x < IMG_WIDTH; x++) {
             int idx = y * IMG_WIDTH + x;
             
             // Create pattern with edges
             if ((x >= 20 && x < 44) && (y >= 20 && y < 44)) {
-                test_image[idx] = 200;  // White square
+                image[idx] = 200;  // White square
             } else if ((x >= 16 && x < 48) && (y >= 16 && y < 48)) {
-                test_image[idx] = 128;  // Gray border
+                image[idx] = 128;  // Gray border
             } else {
-                test_image[idx] = (x + y) % 64;  // Gradient background
+                image[idx] = (x + y + shift) % 64;  // Gradient background
             }
         }
     }
 }
 
 // ============================================
-// Load Image to BRAM
+// Wait for DMA Frame Completion
 // ============================================
-void load_image_to_bram(uint8_t* image, uint32_t size) {
-    xil_printf("Loading image to BRAM...\n\r");
-    
-    for (uint32_t i = 0; i < size; i++) {
-        Xil_Out8(IMAGE_BRAM_BASE_ADDR + i, image[i]);
+int wait_frame_dma(void) {
+    int ret = frame_dma_wait(&frame_dma, DMA_MAX_POLLS);
+    if (ret != FRAME_DMA_OK) {
+        xil_printf("ERROR: DMA transfer failed (%d)\n\r", ret);
     }
+    return ret;
 }
 
 // ============================================
-// Read Image from BRAM
+// Set Up Interrupts
 // ============================================
-void read_image_from_bram(uint8_t* image, uint32_t size) {
-    xil_printf("Reading image from BRAM...\n\r");
+// image_pros ap_done -> microblaze_0_axi_intc -> MicroBlaze
+int setup_interrupts(void) {
+    XImage_pros_Config ip_config = { 0, IMG_PROC_BASE_ADDR };
     
-    for (uint32_t i = 0; i < size; i++) {
-        image[i] = Xil_In8(IMAGE_BRAM_BASE_ADDR + i);
+    XImage_pros_CfgInitialize(&image_pros, &ip_config);
+    
+    if (XIntc_Initialize(&intc, INTC_DEVICE_ID) != XST_SUCCESS) {
+        return -1;
+    }
+    if (accel_irq_init(&accel_irq, &image_pros, &intc, IMG_PROC_INTR_ID) != ACCEL_IRQ_OK) {
+        return -1;
     }
+    if (XIntc_Start(&intc, XIN_REAL_MODE) != XST_SUCCESS) {
+        return -1;
+    }
+    
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+                                 (Xil_ExceptionHandler)XIntc_InterruptHandler, &intc);
+    Xil_ExceptionEnable();
+    
+    return 0;
 }
 
 // ============================================
@@ -121,25 +261,42 @@ void configure_ip(uint8_t filter_mode, uint8_t threshold,
     Xil_Out32(IMG_PROC_BASE_ADDR + THRESHOLD_VAL_OFFSET, threshold);
     Xil_Out32(IMG_PROC_BASE_ADDR + WIDTH_OFFSET, width);
     Xil_Out32(IMG_PROC_BASE_ADDR + HEIGHT_OFFSET, height);
+    Xil_Out32(IMG_PROC_BASE_ADDR + INPUT_FORMAT_OFFSET, INPUT_GRAY);
+    Xil_Out32(IMG_PROC_BASE_ADDR + FILTER_CHAIN_OFFSET, 0);
+    Xil_Out32(IMG_PROC_BASE_ADDR + BLUR_COEFFS_OFFSET, BLUR_COEFFS_BINOMIAL);
+    Xil_Out32(IMG_PROC_BASE_ADDR + CONV_CTRL_OFFSET, 0);
+    Xil_Out32(IMG_PROC_BASE_ADDR + THRESHOLD_HIGH_OFFSET, 0);
+    
+    // AXI DMA MM2S drives TLAST but no TUSER (SOF), so frames are
+    // counted by size; frame_sync is for a video source such as VDMA
+    Xil_Out32(IMG_PROC_BASE_ADDR + FRAME_SYNC_OFFSET, 0);
+    Xil_Out32(IMG_PROC_BASE_ADDR + SCALE_CTRL_OFFSET, SCALE_NONE);
+    Xil_Out32(IMG_PROC_BASE_ADDR + ROI_COUNT_OFFSET, 0);
+    Xil_Out32(IMG_PROC_BASE_ADDR + BORDER_CTRL_OFFSET, BORDER_LEGACY);
+    
+    // dst_grad has no DMA channel in this design; leave it idle
+    Xil_Out32(IMG_PROC_BASE_ADDR + GRAD_ENABLE_OFFSET, 0);
 }
 
 // ============================================
 // Start Processing and Wait for Completion
 // ============================================
-void start_processing(void) {
-    uint32_t status;
+int start_processing(void) {
+    accel_event_t event;
     
     xil_printf("Starting image processing...\n\r");
     
     // Start the IP
     Xil_Out32(IMG_PROC_BASE_ADDR + CTRL_REG_OFFSET, CTRL_START_BIT);
     
-    // Wait for completion
-    do {
-        status = Xil_In32(IMG_PROC_BASE_ADDR + CTRL_REG_OFFSET);
-    } while (!(status & CTRL_DONE_BIT));
+    // Wait for the ap_done interrupt instead of polling AP_CTRL
+    if (accel_irq_wait(&accel_irq, &event, IRQ_MAX_POLLS) != ACCEL_IRQ_OK) {
+        xil_printf("ERROR: No ap_done interrupt\n\r");
+        return -1;
+    }
     
-    xil_printf("Processing complete!\n\r");
+    xil_printf("Processing complete! (frame %d)\n\r", event.frame);
+    return 0;
 }
 
 // ============================================
@@ -155,6 +312,53 @@ void check_ip_status(void) {
     xil_printf("\n\r");
 }
 
+// ============================================
+// Check Frame Status
+// ============================================
+int check_frame_status(void) {
+    uint32_t status = Xil_In32(IMG_PROC_BASE_ADDR + STATUS_OFFSET);
+    
+    if (status == STATUS_ERR_WIDTH) {
+        xil_printf("ERROR: Image width exceeds IP maximum\n\r");
+    } else if (status == STATUS_ERR_SCALE) {
+        xil_printf("ERROR: Scaler output size or mode out of range\n\r");
+    } else if (status == STATUS_ERR_ROI) {
+        xil_printf("ERROR: Region of interest empty, outside or overlapping\n\r");
+    } else if (status == STATUS_ERR_BORDER) {
+        xil_printf("ERROR: Unknown border mode or frame cropped away\n\r");
+    } else if (status != STATUS_OK) {
+        xil_printf("ERROR: Frame status %d\n\r", status);
+    }
+    
+    return (status == STATUS_OK) ? 0 : -1;
+}
+
+// ============================================
+// Run One Frame
+// ============================================
+// Streams test_image through the IP as configured by the caller; dst
+// receives out_width x out_height at that stride.
+int run_frame(uint16_t out_width, uint16_t out_height) {
+    int ret = frame_dma_queue_scaled(&frame_dma, test_image, output_image,
+                                     IMG_WIDTH, IMG_HEIGHT, IMG_WIDTH,
+                                     out_width, out_height, out_width);
+    if (ret != FRAME_DMA_OK) {
+        xil_printf("ERROR: DMA queue failed (%d)\n\r", ret);
+        return -1;
+    }
+    if (start_processing() != 0) {
+        return -1;
+    }
+    
+    // A rejected frame never reads its rows: drop its descriptors so
+    // the next frame does not stream them or fill the stale buffers
+    if (check_frame_status() != 0 || wait_frame_dma() != FRAME_DMA_OK) {
+        frame_dma_abort(&frame_dma);
+        return -1;
+    }
+    return 0;
+}
+
 // ============================================
 // Print Image Statistics
 // ============================================
@@ -173,6 +377,31 @@ void print_image_stats(uint8_t* image, uint32_t size, const char* name) {
                name, min_val, max_val, (uint32_t)(sum / size));
 }
 
+// ============================================
+// Print Output Frame Statistics
+// ============================================
+// Read back from the IP, which accumulates them while the frame streams
+void print_frame_stats(uint32_t size, const char* name) {
+    uint32_t histogram[256];
+    uint32_t min_val = Xil_In32(IMG_PROC_BASE_ADDR + STATS_MIN_OFFSET);
+    uint32_t max_val = Xil_In32(IMG_PROC_BASE_ADDR + STATS_MAX_OFFSET);
+    uint64_t sum = Xil_In32(IMG_PROC_BASE_ADDR + STATS_SUM_OFFSET) |
+                   ((uint64_t)Xil_In32(IMG_PROC_BASE_ADDR + STATS_SUM_OFFSET + 4) << 32);
+    uint64_t sum_sq = Xil_In32(IMG_PROC_BASE_ADDR + STATS_SUM_SQ_OFFSET) |
+                      ((uint64_t)Xil_In32(IMG_PROC_BASE_ADDR + STATS_SUM_SQ_OFFSET + 4) << 32);
+    uint32_t avg = (uint32_t)(sum / size);
+    uint32_t var = (uint32_t)(sum_sq / size) - avg * avg;
+    int peak = 0;
+    
+    XImage_pros_Read_histogram_Words(&image_pros, 0, histogram, 256);
+    for (int i = 1; i < 256; i++) {
+        if (histogram[i] > histogram[peak]) peak = i;
+    }
+    
+    xil_printf("%s - Min: %d, Max: %d, Avg: %d, Var: %d, Peak: %d (%d px)\n\r",
+               name, min_val, max_val, avg, var, peak, histogram[peak]);
+}
+
 // ============================================
 // Print Image (small preview)
 // ============================================
@@ -196,32 +425,291 @@ void run_filter_test(uint8_t filter_mode, const char* filter_name, uint8_t thres
     xil_printf("Testing: %s\n\r", filter_name);
     xil_printf("========================================\n\r");
     
-    // Load input image
-    load_image_to_bram(test_image, IMG_SIZE);
-    
     // Configure IP
     configure_ip(filter_mode, threshold, IMG_WIDTH, IMG_HEIGHT);
     
     // Check status
     check_ip_status();
     
-    // Start processing
-    start_processing();
-    
-    // Read output
-    read_image_from_bram(output_image, IMG_SIZE);
+    // Queue source/destination frames, then start processing
+    if (run_frame(IMG_WIDTH, IMG_HEIGHT) != 0) {
+        return;
+    }
     
     // Print statistics
-    print_image_stats(output_image, IMG_SIZE, "Output");
+    print_frame_stats(IMG_SIZE, "Output");
     
     // Print preview
     print_image_preview(output_image, IMG_WIDTH, IMG_HEIGHT);
 }
 
+// ============================================
+// Run Separable Blur Test
+// ============================================
+// Same kernel size as the build, sigma picked at run time
+void run_blur_test(float sigma, const char* blur_name) {
+    uint32_t coeffs = blur_coeffs_gaussian(sigma, BLUR_KERNEL_SIZE);
+    
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s, taps 0x%08x\n\r", blur_name, coeffs);
+    xil_printf("========================================\n\r");
+    
+    configure_ip(FILTER_BLUR, 128, IMG_WIDTH, IMG_HEIGHT);
+    Xil_Out32(IMG_PROC_BASE_ADDR + BLUR_COEFFS_OFFSET, coeffs);
+    
+    if (run_frame(IMG_WIDTH, IMG_HEIGHT) != 0) {
+        return;
+    }
+    
+    print_frame_stats(IMG_SIZE, "Output");
+    print_image_preview(output_image, IMG_WIDTH, IMG_HEIGHT);
+}
+
+// ============================================
+// Run Programmable Convolution Test
+// ============================================
+void run_conv_test(const int8_t *taps, int size, int shift, int bias,
+                   const char* conv_name) {
+    XImage_pros_Conv_coeffs coeffs;
+    uint32_t ctrl;
+    
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s (%dx%d)\n\r", conv_name, size, size);
+    xil_printf("========================================\n\r");
+    
+    if (conv_coeffs_pack(taps, size, shift, bias, &coeffs, &ctrl) != CONV_COEFFS_OK) {
+        xil_printf("ERROR: Invalid convolution kernel\n\r");
+        return;
+    }
+    
+    configure_ip(FILTER_CONV, 128, IMG_WIDTH, IMG_HEIGHT);
+    XImage_pros_Set_conv_coeffs(&image_pros, coeffs);
+    XImage_pros_Set_conv_ctrl(&image_pros, ctrl);
+    
+    if (run_frame(IMG_WIDTH, IMG_HEIGHT) != 0) {
+        return;
+    }
+    
+    print_frame_stats(IMG_SIZE, "Output");
+    print_image_preview(output_image, IMG_WIDTH, IMG_HEIGHT);
+}
+
+// ============================================
+// Run Fused Filter Chain Test
+// ============================================
+void run_chain_test(uint32_t chain, const char* chain_name, uint8_t threshold) {
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing chain: %s\n\r", chain_name);
+    xil_printf("========================================\n\r");
+    
+    // filter_select is ignored while filter_chain is non-zero
+    configure_ip(FILTER_BYPASS, threshold, IMG_WIDTH, IMG_HEIGHT);
+    Xil_Out32(IMG_PROC_BASE_ADDR + FILTER_CHAIN_OFFSET, chain);
+    
+    if (run_frame(IMG_WIDTH, IMG_HEIGHT) != 0) {
+        return;
+    }
+    
+    print_frame_stats(IMG_SIZE, "Output");
+    print_image_preview(output_image, IMG_WIDTH, IMG_HEIGHT);
+}
+
+// ============================================
+// Run Canny Edge Test
+// ============================================
+// Gaussian -> Canny chain; threshold is the low (weak) threshold
+void run_canny_test(uint8_t low, uint16_t high, const char* canny_name) {
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s (low %d, high %d)\n\r", canny_name, low, high);
+    xil_printf("========================================\n\r");
+    
+    configure_ip(FILTER_BYPASS, low, IMG_WIDTH, IMG_HEIGHT);
+    Xil_Out32(IMG_PROC_BASE_ADDR + FILTER_CHAIN_OFFSET,
+              FILTER_CHAIN(FILTER_GAUSSIAN, FILTER_CANNY, 0, 0));
+    XImage_pros_Set_threshold_high(&image_pros, high);
+    
+    if (run_frame(IMG_WIDTH, IMG_HEIGHT) != 0) {
+        return;
+    }
+    
+    print_frame_stats(IMG_SIZE, "Output");
+    print_image_preview(output_image, IMG_WIDTH, IMG_HEIGHT);
+}
+
+// ============================================
+// Run Lookup Table Test
+// ============================================
+// Writes the table into the bank frames are not using, then selects
+// it; the IP latches the bank when the next frame starts.
+void run_lut_test(const uint8_t *table, const char* lut_name) {
+    static uint32_t words[LUT_WORDS];
+    uint32_t bank = Xil_In32(IMG_PROC_BASE_ADDR + LUT_BANK_OFFSET) ^ 1;
+    
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s (bank %d)\n\r", lut_name, bank);
+    xil_printf("========================================\n\r");
+    
+    for (int i = 0; i < LUT_WORDS; i++) {
+        words[i] = table[4 * i] | (table[4 * i + 1] << 8) |
+                   (table[4 * i + 2] << 16) | ((uint32_t)table[4 * i + 3] << 24);
+    }
+    XImage_pros_Write_lut_Words(&image_pros, bank * LUT_WORDS, words, LUT_WORDS);
+    Xil_Out32(IMG_PROC_BASE_ADDR + LUT_BANK_OFFSET, bank);
+    
+    configure_ip(FILTER_LUT, 0, IMG_WIDTH, IMG_HEIGHT);
+    
+    if (run_frame(IMG_WIDTH, IMG_HEIGHT) != 0) {
+        return;
+    }
+    
+    print_frame_stats(IMG_SIZE, "Output");
+    print_image_preview(output_image, IMG_WIDTH, IMG_HEIGHT);
+}
+
+// ============================================
+// Run Scaler Test
+// ============================================
+// dst receives out_width x out_height; the preview reads it at that
+// stride
+void run_scale_test(uint8_t filter_mode, uint32_t scale_ctrl,
+                    uint16_t out_width, uint16_t out_height,
+                    const char* scale_name) {
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s, %dx%d -> %dx%d\n\r", scale_name,
+               IMG_WIDTH, IMG_HEIGHT, out_width, out_height);
+    xil_printf("========================================\n\r");
+    
+    configure_ip(filter_mode, 128, IMG_WIDTH, IMG_HEIGHT);
+    Xil_Out32(IMG_PROC_BASE_ADDR + SCALE_CTRL_OFFSET, scale_ctrl);
+    Xil_Out32(IMG_PROC_BASE_ADDR + OUT_WIDTH_OFFSET, out_width);
+    Xil_Out32(IMG_PROC_BASE_ADDR + OUT_HEIGHT_OFFSET, out_height);
+    
+    if (run_frame(out_width, out_height) != 0) {
+        return;
+    }
+    
+    print_frame_stats((uint32_t)out_width * out_height, "Output");
+    print_image_preview(output_image, out_width, out_height);
+}
+
+// ============================================
+// Run Region of Interest Test
+// ============================================
+// One region, so every output line is one TLAST packet and dst
+// receives it as a roi_width x roi_height frame. Several regions
+// share the stream in raster order; route them by TDEST instead.
+void run_roi_test(uint8_t filter_mode, uint16_t x, uint16_t y,
+                  uint16_t roi_width, uint16_t roi_height, const char* roi_name) {
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s, %dx%d at (%d,%d)\n\r", roi_name, roi_width, roi_height,
+               x, y);
+    xil_printf("========================================\n\r");
+    
+    configure_ip(filter_mode, 128, IMG_WIDTH, IMG_HEIGHT);
+    Xil_Out32(IMG_PROC_BASE_ADDR + ROI_RECTS_OFFSET, x | ((uint32_t)y << 16));
+    Xil_Out32(IMG_PROC_BASE_ADDR + ROI_RECTS_OFFSET + 4,
+              roi_width | ((uint32_t)roi_height << 16));
+    Xil_Out32(IMG_PROC_BASE_ADDR + ROI_COUNT_OFFSET, 1);
+    
+    if (run_frame(roi_width, roi_height) != 0) {
+        return;
+    }
+    
+    // The IP statistics cover the whole frame; scan the region itself
+    print_image_stats(output_image, (uint32_t)roi_width * roi_height, "Region");
+    print_image_preview(output_image, roi_width, roi_height);
+}
+
+// ============================================
+// Run Border Mode Test
+// ============================================
+// dst receives out_width x out_height: the input size, or smaller by
+// twice the window radius when border_ctrl crops
+void run_border_test(uint8_t filter_mode, uint32_t border_ctrl,
+                     uint16_t out_width, uint16_t out_height,
+                     const char* border_name) {
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Testing: %s, %dx%d -> %dx%d\n\r", border_name,
+               IMG_WIDTH, IMG_HEIGHT, out_width, out_height);
+    xil_printf("========================================\n\r");
+    
+    configure_ip(filter_mode, 128, IMG_WIDTH, IMG_HEIGHT);
+    Xil_Out32(IMG_PROC_BASE_ADDR + BORDER_CTRL_OFFSET, border_ctrl);
+    
+    if (run_frame(out_width, out_height) != 0) {
+        return;
+    }
+    
+    print_frame_stats((uint32_t)out_width * out_height, "Output");
+    print_image_preview(output_image, out_width, out_height);
+}
+
+// ============================================
+// Run Streaming Test (frame queue)
+// ============================================
+// Frame k+1 is generated while frame k is processed. The IP stays in
+// auto-restart afterwards, so this runs after the single-shot tests.
+void run_stream_test(uint8_t filter_mode, const char* filter_name,
+                     uint8_t threshold, int num_frames) {
+    uint8_t *const src[NUM_FRAME_SLOTS] = {
+        (uint8_t *)SRC_FRAME_ADDR(0), (uint8_t *)SRC_FRAME_ADDR(1),
+        (uint8_t *)SRC_FRAME_ADDR(2) };
+    uint8_t *const dst[NUM_FRAME_SLOTS] = {
+        (uint8_t *)DST_FRAME_ADDR(0), (uint8_t *)DST_FRAME_ADDR(1),
+        (uint8_t *)DST_FRAME_ADDR(2) };
+    frame_queue_t queue;
+    int submitted = 0;
+    int completed = 0;
+    int err;
+    
+    xil_printf("\n\r========================================\n\r");
+    xil_printf("Streaming %d frames: %s\n\r", num_frames, filter_name);
+    xil_printf("========================================\n\r");
+    
+    configure_ip(filter_mode, threshold, IMG_WIDTH, IMG_HEIGHT);
+    if (frame_queue_init(&queue, IMG_PROC_BASE_ADDR, &frame_dma, src, dst,
+                         NUM_FRAME_SLOTS, IMG_WIDTH, IMG_HEIGHT) != FRAME_QUEUE_OK) {
+        xil_printf("ERROR: Frame queue init failed\n\r");
+        return;
+    }
+    
+    while (completed < num_frames) {
+        // Keep every free slot staged and queued
+        uint8_t *frame;
+        while (submitted < num_frames && (frame = frame_queue_stage(&queue)) != NULL) {
+            generate_test_pattern(frame, submitted);
+            if (frame_queue_submit(&queue) != FRAME_QUEUE_OK) {
+                xil_printf("ERROR: Frame queue submit failed\n\r");
+                frame_queue_stop(&queue);
+                return;
+            }
+            submitted++;
+        }
+        
+        frame = frame_queue_complete(&queue, &err);
+        if (err != FRAME_QUEUE_OK) {
+            xil_printf("ERROR: Frame %d failed (%d)\n\r", completed, err);
+            break;
+        }
+        if (frame != NULL) {
+            // The IP may already be done with the next frame, so scan
+            // this buffer instead of reading its statistics registers
+            xil_printf("Frame %d: ", completed);
+            print_image_stats(frame, IMG_SIZE, "Output");
+            frame_queue_release(&queue);
+            completed++;
+        }
+    }
+    
+    frame_queue_stop(&queue);
+}
+
 // ============================================
 // Main Function
 // ============================================
 int main(void) {
+    static uint8_t lut_table[LUT_ENTRIES];
+    
     xil_printf("\n\r");
     xil_printf("========================================\n\r");
     xil_printf(" Image Processing Accelerator Demo\n\r");
@@ -229,8 +717,22 @@ int main(void) {
     xil_printf("========================================\n\r");
     xil_printf("Image Size: %d x %d\n\r", IMG_WIDTH, IMG_HEIGHT);
     
-    // Generate test pattern
-    generate_test_pattern();
+    // Start the frame DMA
+    if (frame_dma_init(&frame_dma, DMA_BASE_ADDR, mm2s_descs, s2mm_descs,
+                       DMA_RING_SIZE) != FRAME_DMA_OK) {
+        xil_printf("ERROR: DMA reset failed\n\r");
+        return -1;
+    }
+    
+    // Frame completion is reported by interrupt
+    if (setup_interrupts() != 0) {
+        xil_printf("ERROR: Interrupt setup failed\n\r");
+        return -1;
+    }
+    
+    // Generate test pattern directly in the source frame buffer
+    xil_printf("Generating test pattern...\n\r");
+    generate_test_pattern(test_image, 0);
     print_image_stats(test_image, IMG_SIZE, "Input");
     print_image_preview(test_image, IMG_WIDTH, IMG_HEIGHT);
     
@@ -241,6 +743,62 @@ int main(void) {
     run_filter_test(FILTER_GAUSSIAN, "GAUSSIAN BLUR", 128);
     run_filter_test(FILTER_NEGATIVE, "NEGATIVE", 128);
     run_filter_test(FILTER_SHARPEN, "SHARPEN", 128);
+    run_filter_test(FILTER_BLUR, "SEPARABLE BLUR (BINOMIAL)", 128);
+    run_blur_test(2.0f, "SEPARABLE BLUR (SIGMA 2.0)");
+    run_conv_test(EMBOSS_TAPS, 3, 0, 128, "EMBOSS");
+    run_conv_test(LOG_TAPS, 5, 0, 0, "LAPLACIAN OF GAUSSIAN");
+    run_filter_test(FILTER_MEDIAN, "MEDIAN", 128);
+    run_filter_test(FILTER_ERODE, "ERODE", 128);
+    run_filter_test(FILTER_DILATE, "DILATE", 128);
+    
+    // Blur, edge and binarize in a single pass
+    run_chain_test(FILTER_CHAIN(FILTER_GAUSSIAN, FILTER_SOBEL, FILTER_THRESHOLD, 0),
+                   "GAUSSIAN -> SOBEL -> THRESHOLD", 60);
+    
+    // Binarize, then remove specks and fill pinholes in the mask
+    run_chain_test(FILTER_CHAIN(FILTER_THRESHOLD, FILTER_OPEN, FILTER_CLOSE, 0),
+                   "THRESHOLD -> OPEN -> CLOSE", 100);
+    
+    // Thin edges: weak pixels kept only next to strong ones
+    run_canny_test(40, 120, "GAUSSIAN -> CANNY");
+    
+    // Local-mean binarization; Otsu learns its level from the frame
+    // before, so the second pass is thresholded at this image's level
+    run_filter_test(FILTER_ADAPTIVE, "ADAPTIVE THRESHOLD", 8);
+    run_filter_test(FILTER_OTSU, "OTSU THRESHOLD (LEARN)", 0);
+    run_filter_test(FILTER_OTSU, "OTSU THRESHOLD", 0);
+    
+    // Contrast stretch of the mid-tones through a lookup table, then
+    // equalization learned from the frame before
+    for (int i = 0; i < LUT_ENTRIES; i++) {
+        int v = 2 * (i - 64);
+        lut_table[i] = (v < 0) ? 0 : (v > 255) ? 255 : v;
+    }
+    run_lut_test(lut_table, "LUT (CONTRAST STRETCH)");
+    run_filter_test(FILTER_EQUALIZE, "HISTOGRAM EQUALIZATION (LEARN)", 0);
+    run_filter_test(FILTER_EQUALIZE, "HISTOGRAM EQUALIZATION", 0);
+    
+    // Half-size preview: 2x2 box ahead of the filter, so Sobel runs
+    // on a quarter of the pixels; then bilinear after a full-size blur
+    run_scale_test(FILTER_SOBEL, SCALE_BOX, IMG_WIDTH / 2, IMG_HEIGHT / 2,
+                   "BOX 1/2 -> SOBEL");
+    run_scale_test(FILTER_GAUSSIAN, SCALE_BILINEAR | SCALE_AFTER,
+                   IMG_WIDTH * 3 / 4, IMG_HEIGHT * 3 / 4, "GAUSSIAN -> BILINEAR 3/4");
+    
+    // Only the centre of the edge map leaves the IP; the filter still
+    // sees the pixels around the region
+    run_roi_test(FILTER_SOBEL, IMG_WIDTH / 4, IMG_HEIGHT / 4, IMG_WIDTH / 2,
+                 IMG_HEIGHT / 2, "SOBEL, CENTRE REGION");
+    
+    // Edges lined up with the input and no false edges along the frame
+    // border; then only the pixels whose whole window is in the frame
+    run_border_test(FILTER_SOBEL, BORDER_REPLICATE, IMG_WIDTH, IMG_HEIGHT,
+                    "SOBEL, REPLICATED BORDER");
+    run_border_test(FILTER_GAUSSIAN, BORDER_CROP, IMG_WIDTH - 2, IMG_HEIGHT - 2,
+                    "GAUSSIAN, CROPPED BORDER");
+    
+    // Back-to-back frames through the triple-buffered queue
+    run_stream_test(FILTER_SOBEL, "SOBEL EDGE DETECTION", 128, STREAM_FRAMES);
     
     xil_printf("\n\r========================================\n\r");
     xil_printf(" All Tests Complete!\n\r");
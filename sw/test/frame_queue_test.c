@@ -0,0 +1,342 @@
+/*
+ * Image Processing Accelerator - Frame Queue Host Test
+ * Runs frame_queue.c against the DMA and accelerator models
+ *
+ * Build and run on a Linux host:
+ *   gcc -DFRAME_DMA_MODEL -Isw sw/frame_queue.c sw/frame_dma.c \
+ *       sw/dma_model.c sw/accel_model.c sw/test/frame_queue_test.c
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "frame_queue.h"
+#include "dma_model.h"
+#include "accel_model.h"
+
+// ============================================
+// Test Configuration
+// ============================================
+#define TEST_WIDTH      64
+#define TEST_HEIGHT     64
+#define TEST_PIXELS     (TEST_WIDTH * TEST_HEIGHT)
+#define TEST_FRAMES     12
+#define STAGE_CYCLES    TEST_PIXELS     // Staging costs about one frame time
+#define MAX_POLLS       10000
+#define MIN_GAIN_X100   150             // Triple buffering vs start/poll
+
+// Registers not used by frame_queue.h
+#define IP_FILTER_SELECT    0x10
+#define IP_SCALE_CTRL       0xC8
+#define IP_OUT_WIDTH        0xD0
+#define IP_OUT_HEIGHT       0xD8
+#define IP_ROI_COUNT        0xE0
+#define IP_ROI_RECTS        0xE8
+#define IP_BORDER_CTRL      0x128
+
+#define FILTER_NEGATIVE     5
+
+static frame_dma_desc_t mm2s_descs[FRAME_QUEUE_MAX_SLOTS * TEST_HEIGHT];
+static frame_dma_desc_t s2mm_descs[FRAME_QUEUE_MAX_SLOTS * TEST_HEIGHT];
+static uint8_t src_bufs[FRAME_QUEUE_MAX_SLOTS][TEST_PIXELS];
+static uint8_t dst_bufs[FRAME_QUEUE_MAX_SLOTS][TEST_PIXELS];
+
+static frame_dma_t dma;
+static frame_queue_t queue;
+static int errors;
+
+#define CHECK(cond, msg)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("ERROR: %s (line %d)\n", (msg), __LINE__); \
+            errors++;                                       \
+        }                                                   \
+    } while (0)
+
+// ============================================
+// Helpers
+// ============================================
+// Fresh models, DMA rings and queue
+static int setup(uint32_t num_slots, uint16_t width, uint16_t height) {
+    uint8_t *src[FRAME_QUEUE_MAX_SLOTS];
+    uint8_t *dst[FRAME_QUEUE_MAX_SLOTS];
+
+    for (uint32_t i = 0; i < FRAME_QUEUE_MAX_SLOTS; i++) {
+        src[i] = src_bufs[i];
+        dst[i] = dst_bufs[i];
+    }
+    accel_model_reset();
+    if (frame_dma_init(&dma, 0, mm2s_descs, s2mm_descs,
+                       FRAME_QUEUE_MAX_SLOTS * TEST_HEIGHT) != FRAME_DMA_OK) {
+        return -1;
+    }
+    return frame_queue_init(&queue, 0, &dma, src, dst, num_slots, width, height);
+}
+
+static void fill_frame(uint8_t *buf, uint32_t frame) {
+    for (uint32_t i = 0; i < TEST_PIXELS; i++) {
+        buf[i] = (uint8_t)(frame * 31 + i);
+    }
+}
+
+static int frame_matches(const uint8_t *buf, uint32_t frame, int negate) {
+    for (uint32_t i = 0; i < TEST_PIXELS; i++) {
+        uint8_t expected = (uint8_t)(frame * 31 + i);
+        if (buf[i] != (negate ? (uint8_t)(255 - expected) : expected)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Poll frame_queue_complete() until a frame or an error comes back
+static uint8_t *wait_complete(int *err) {
+    for (uint32_t poll = 0; poll < MAX_POLLS; poll++) {
+        uint8_t *dst = frame_queue_complete(&queue, err);
+        if (dst != NULL || *err != FRAME_QUEUE_OK) {
+            return dst;
+        }
+    }
+    return NULL;
+}
+
+// ============================================
+// Test 1: Slot State Transitions
+// ============================================
+static void test_slot_states(void) {
+    int err;
+
+    printf("Test 1: Slot state transitions\n");
+    CHECK(setup(2, TEST_WIDTH, TEST_HEIGHT) == FRAME_QUEUE_OK, "queue init");
+
+    CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_ERR_STATE, "submit before stage");
+    CHECK(frame_queue_release(&queue) == FRAME_QUEUE_ERR_STATE, "release before complete");
+
+    uint8_t *src = frame_queue_stage(&queue);
+    CHECK(src == src_bufs[0] && queue.slots[0].state == SLOT_STAGING, "FREE -> STAGING");
+    CHECK(frame_queue_stage(&queue) == src, "stage twice returns the same slot");
+    fill_frame(src, 0);
+    CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_OK, "submit");
+    CHECK(queue.slots[0].state == SLOT_QUEUED, "STAGING -> QUEUED");
+    CHECK(frame_queue_in_flight(&queue) == 1, "one frame in flight");
+
+    // Fill the second slot; with both queued there is nothing to stage
+    src = frame_queue_stage(&queue);
+    CHECK(src == src_bufs[1], "second slot staged");
+    fill_frame(src, 1);
+    CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_OK, "second submit");
+    CHECK(frame_queue_stage(&queue) == NULL, "no free slot while both are queued");
+    CHECK(frame_queue_in_flight(&queue) == 2, "two frames in flight");
+
+    uint8_t *dst = wait_complete(&err);
+    CHECK(err == FRAME_QUEUE_OK && dst == dst_bufs[0], "first frame completes");
+    CHECK(queue.slots[0].state == SLOT_DONE, "QUEUED -> DONE");
+    CHECK(frame_queue_complete(&queue, &err) == dst, "complete is idempotent");
+    CHECK(frame_queue_stage(&queue) == NULL, "DONE slot is not restaged");
+    CHECK(frame_queue_release(&queue) == FRAME_QUEUE_OK, "release");
+    CHECK(queue.slots[0].state == SLOT_FREE, "DONE -> FREE");
+    CHECK(frame_queue_release(&queue) == FRAME_QUEUE_ERR_STATE, "double release");
+    CHECK(frame_queue_stage(&queue) == src_bufs[0], "released slot is staged again");
+
+    dst = wait_complete(&err);
+    CHECK(err == FRAME_QUEUE_OK && dst == dst_bufs[1], "second frame completes");
+    CHECK(frame_queue_release(&queue) == FRAME_QUEUE_OK, "second release");
+    CHECK(frame_queue_in_flight(&queue) == 0, "nothing in flight");
+    frame_queue_stop(&queue);
+}
+
+// ============================================
+// Test 2: Frame Ordering
+// ============================================
+static void test_ordering(void) {
+    uint32_t submitted = 0;
+    uint32_t completed = 0;
+    int err = FRAME_QUEUE_OK;
+
+    printf("Test 2: Frames complete in submission order\n");
+    CHECK(setup(3, TEST_WIDTH, TEST_HEIGHT) == FRAME_QUEUE_OK, "queue init");
+    accel_model_write(0, IP_FILTER_SELECT, FILTER_NEGATIVE);
+
+    while (completed < TEST_FRAMES && err == FRAME_QUEUE_OK) {
+        uint8_t *src;
+        while (submitted < TEST_FRAMES && (src = frame_queue_stage(&queue)) != NULL) {
+            fill_frame(src, submitted);
+            CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_OK, "submit");
+            submitted++;
+        }
+        uint8_t *dst = wait_complete(&err);
+        if (dst != NULL) {
+            CHECK(dst == dst_bufs[completed % 3], "slots retire in ring order");
+            CHECK(frame_matches(dst, completed, 1), "frame data out of order");
+            CHECK(frame_queue_release(&queue) == FRAME_QUEUE_OK, "release");
+            completed++;
+        }
+    }
+    CHECK(err == FRAME_QUEUE_OK, "queue error");
+    CHECK(completed == TEST_FRAMES, "every frame completed");
+    CHECK(accel_model_frames() == TEST_FRAMES, "IP finished every frame");
+    frame_queue_stop(&queue);
+}
+
+// ============================================
+// Test 3: Rejected Frames
+// ============================================
+// Each setting makes the IP return without consuming its streams
+static void test_error_status(void) {
+    static const struct {
+        const char *name;
+        uint16_t width;
+        uint16_t height;
+        uint32_t offset;
+        uint32_t value;
+    } cases[] = {
+        { "width",  ACCEL_MODEL_MAX_WIDTH + 1, 4, IP_FILTER_SELECT, 0 },
+        { "scale",  TEST_WIDTH, TEST_HEIGHT, IP_SCALE_CTRL,  1 },     // No out size
+        { "roi",    TEST_WIDTH, TEST_HEIGHT, IP_ROI_COUNT,   9 },
+        { "border", TEST_WIDTH, TEST_HEIGHT, IP_BORDER_CTRL, 5 },
+    };
+
+    printf("Test 3: IP status errors drop the slot\n");
+    for (uint32_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        int err = FRAME_QUEUE_OK;
+
+        // The wide frame is kept short enough for the slot buffers
+        CHECK(setup(2, cases[c].width, cases[c].height) == FRAME_QUEUE_OK,
+              cases[c].name);
+        accel_model_write(0, cases[c].offset, cases[c].value);
+        frame_queue_stage(&queue);
+        CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_OK, cases[c].name);
+        CHECK(wait_complete(&err) == NULL && err == FRAME_QUEUE_ERR_STATUS, cases[c].name);
+        CHECK(queue.slots[0].state == SLOT_FREE, cases[c].name);
+        frame_queue_stop(&queue);
+    }
+
+    // A valid region and scaler setting is accepted
+    int err = FRAME_QUEUE_OK;
+    CHECK(setup(2, TEST_WIDTH, TEST_HEIGHT) == FRAME_QUEUE_OK, "valid settings");
+    accel_model_write(0, IP_ROI_COUNT, 1);
+    accel_model_write(0, IP_ROI_RECTS, 0);
+    accel_model_write(0, IP_ROI_RECTS + 4, 8 | (8u << 16));
+    accel_model_write(0, IP_SCALE_CTRL, 1);
+    accel_model_write(0, IP_OUT_WIDTH, TEST_WIDTH);
+    accel_model_write(0, IP_OUT_HEIGHT, TEST_HEIGHT);
+    fill_frame(frame_queue_stage(&queue), 0);
+    frame_queue_submit(&queue);
+    CHECK(wait_complete(&err) == dst_bufs[0] && err == FRAME_QUEUE_OK, "valid settings");
+    frame_queue_stop(&queue);
+}
+
+// ============================================
+// Test 4: Recovery After a Rejected Frame
+// ============================================
+// The rejected frame's rows and output descriptors are dropped, so
+// the next valid frame lands complete in its own buffer
+static void test_recovery(void) {
+    int err = FRAME_QUEUE_OK;
+
+    printf("Test 4: A valid frame after a rejected one\n");
+    CHECK(setup(2, TEST_WIDTH, TEST_HEIGHT) == FRAME_QUEUE_OK, "queue init");
+    accel_model_write(0, IP_FILTER_SELECT, FILTER_NEGATIVE);
+    accel_model_write(0, IP_BORDER_CTRL, 5);
+    memset(dst_bufs, 0, sizeof(dst_bufs));
+
+    fill_frame(frame_queue_stage(&queue), 0);
+    CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_OK, "rejected submit");
+    CHECK(wait_complete(&err) == NULL && err == FRAME_QUEUE_ERR_STATUS, "rejected frame");
+    CHECK(frame_queue_in_flight(&queue) == 0, "rejected frame dropped");
+    CHECK(dma.mm2s.pending == 0 && dma.s2mm.pending == 0, "descriptors dropped");
+
+    accel_model_write(0, IP_BORDER_CTRL, 0);
+    uint8_t *src = frame_queue_stage(&queue);
+    CHECK(src == src_bufs[1], "ring restarts at the next slot");
+    fill_frame(src, 1);
+    CHECK(frame_queue_submit(&queue) == FRAME_QUEUE_OK, "valid submit");
+    uint8_t *dst = wait_complete(&err);
+    CHECK(err == FRAME_QUEUE_OK && dst == dst_bufs[1], "valid frame completes");
+    CHECK(dst != NULL && frame_matches(dst, 1, 1), "valid frame data");
+    CHECK(frame_matches(dst_bufs[0], 0, 0) == 0 && dst_bufs[0][0] == 0,
+          "rejected frame's buffer untouched");
+    CHECK(frame_queue_release(&queue) == FRAME_QUEUE_OK, "release");
+    frame_queue_stop(&queue);
+}
+
+// ============================================
+// Test 5: Throughput Against Single Buffering
+// ============================================
+// Start/poll sequence: stage, queue, start, wait for ap_done and the
+// last S2MM row, then stage the next frame
+static uint64_t single_buffer_cycles(void) {
+    CHECK(setup(2, TEST_WIDTH, TEST_HEIGHT) == FRAME_QUEUE_OK, "queue init");
+
+    for (uint32_t f = 0; f < TEST_FRAMES; f++) {
+        fill_frame(src_bufs[0], f);
+        accel_model_advance(STAGE_CYCLES);
+        CHECK(frame_dma_queue_frame(&dma, src_bufs[0], dst_bufs[0], TEST_WIDTH,
+                                    TEST_HEIGHT, TEST_WIDTH) == FRAME_DMA_OK, "queue frame");
+        accel_model_write(0, IP_AP_CTRL, AP_CTRL_START);
+        uint32_t poll = 0;
+        while (!(accel_model_read(0, IP_AP_CTRL) & AP_CTRL_DONE) && poll++ < MAX_POLLS) {
+        }
+        CHECK(frame_dma_wait(&dma, MAX_POLLS) == FRAME_DMA_OK, "frame DMA");
+        CHECK(frame_matches(dst_bufs[0], f, 0), "single-buffered frame data");
+    }
+    return accel_model_now();
+}
+
+static uint64_t queued_cycles(uint32_t num_slots) {
+    uint32_t submitted = 0;
+    uint32_t completed = 0;
+    int err = FRAME_QUEUE_OK;
+
+    CHECK(setup(num_slots, TEST_WIDTH, TEST_HEIGHT) == FRAME_QUEUE_OK, "queue init");
+    while (completed < TEST_FRAMES && err == FRAME_QUEUE_OK) {
+        uint8_t *src;
+        while (submitted < TEST_FRAMES && (src = frame_queue_stage(&queue)) != NULL) {
+            fill_frame(src, submitted);
+            accel_model_advance(STAGE_CYCLES);
+            frame_queue_submit(&queue);
+            submitted++;
+        }
+        uint8_t *dst = wait_complete(&err);
+        if (dst != NULL) {
+            CHECK(frame_matches(dst, completed, 0), "queued frame data");
+            frame_queue_release(&queue);
+            completed++;
+        }
+    }
+    CHECK(completed == TEST_FRAMES, "every frame completed");
+    frame_queue_stop(&queue);
+    return accel_model_now();
+}
+
+static void test_cycle_gain(void) {
+    printf("Test 5: Cycle gain over single buffering\n");
+    uint64_t single = single_buffer_cycles();
+    uint64_t double_buf = queued_cycles(2);
+    uint64_t triple_buf = queued_cycles(3);
+
+    printf("  %d frames of %dx%d: single %llu, double %llu, triple %llu cycles"
+           " (%.2fx)\n", TEST_FRAMES, TEST_WIDTH, TEST_HEIGHT,
+           (unsigned long long)single, (unsigned long long)double_buf,
+           (unsigned long long)triple_buf, (double)single / (double)triple_buf);
+    CHECK(double_buf < single, "double buffering is faster");
+    CHECK(triple_buf <= double_buf, "triple buffering is no slower");
+    CHECK(triple_buf * MIN_GAIN_X100 <= single * 100, "triple buffering gain");
+}
+
+// ============================================
+// Main
+// ============================================
+int main(void) {
+    test_slot_states();
+    test_ordering();
+    test_error_status();
+    test_recovery();
+    test_cycle_gain();
+
+    if (errors == 0) {
+        printf("ALL TESTS PASSED!\n");
+        return 0;
+    }
+    printf("FAILED with %d errors\n", errors);
+    return 1;
+}
@@ -0,0 +1,144 @@
+/*
+ * Image Processing Accelerator - Linux Zero-Copy Frame API Test
+ * Runs image_pros_uio.c against the fake UIO/u-dma-buf backend
+ *
+ * Build and run on a Linux host:
+ *   gcc -Isw -Iimage_process_platform/hw/drivers/image_pros_v1_0/src \
+ *       sw/image_pros_uio.c image_process_platform/hw/drivers/image_pros_v1_0/src/ximage_pros.c \
+ *       sw/test/image_pros_uio_test.c
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "image_pros_uio.h"
+
+// ============================================
+// Test Configuration
+// ============================================
+#define REGS_SIZE       0x10000
+#define FRAMES_PHYS     0x80000000ull
+#define FRAMES_SIZE     0x200000
+#define CMA_PHYS        0x3F000000ull
+#define CMA_SIZE        (1 << 20)
+#define FRAME_SIZE      4096
+#define IRQ_TIMEOUT_MS  20
+
+static int errors;
+
+#define CHECK(cond, msg)                                    \
+    do {                                                    \
+        if (!(cond)) {                                      \
+            printf("ERROR: %s (line %d)\n", (msg), __LINE__); \
+            errors++;                                       \
+        }                                                   \
+    } while (0)
+
+// ============================================
+// Main
+// ============================================
+int main(void) {
+    image_pros_fake_t fake;
+    image_pros_uio_t dev0, dev1, missing;
+
+    if (image_pros_fake_init(&fake) != IMAGE_PROS_UIO_OK) {
+        printf("ERROR: fake backend init\n");
+        return 1;
+    }
+
+    // Two instances of the IP, added out of order, and another device
+    uint64_t addrs0[2] = { 0x44A00000, FRAMES_PHYS };
+    size_t sizes0[2] = { REGS_SIZE, FRAMES_SIZE };
+    uint64_t addrs1[1] = { 0x44A10000 };
+    size_t sizes1[1] = { REGS_SIZE };
+    CHECK(image_pros_fake_add_uio(&fake, 3, "image_pros", addrs1, sizes1, 1) ==
+          IMAGE_PROS_UIO_OK, "add uio3");
+    CHECK(image_pros_fake_add_uio(&fake, 1, "image_pros", addrs0, sizes0, 2) ==
+          IMAGE_PROS_UIO_OK, "add uio1");
+    CHECK(image_pros_fake_add_uio(&fake, 0, "axi_gpio", addrs1, sizes1, 1) ==
+          IMAGE_PROS_UIO_OK, "add uio0");
+    CHECK(image_pros_fake_add_udmabuf(&fake, 0, CMA_PHYS, CMA_SIZE) ==
+          IMAGE_PROS_UIO_OK, "add udmabuf0");
+
+    // ========================================
+    // Test 1: Open by Index
+    // ========================================
+    printf("Test 1: image_pros_uio_open by index\n");
+    CHECK(image_pros_uio_open(&dev0, &fake.backend, "image_pros", 0) ==
+          IMAGE_PROS_UIO_OK, "open index 0");
+    CHECK(image_pros_uio_open(&dev1, &fake.backend, "image_pros", 1) ==
+          IMAGE_PROS_UIO_OK, "open index 1");
+    CHECK(dev0.uio_num == 1 && dev1.uio_num == 3, "instances in uio number order");
+    CHECK(image_pros_uio_open(&missing, &fake.backend, "image_pros", 2) ==
+          IMAGE_PROS_UIO_ERR_NOT_FOUND, "index past the last instance");
+
+    // Each handle drives its own register block
+    XImage_pros_Set_width(&dev0.ip, 640);
+    XImage_pros_Set_width(&dev1.ip, 320);
+    CHECK(XImage_pros_Get_width(&dev0.ip) == 640 &&
+          XImage_pros_Get_width(&dev1.ip) == 320, "registers per instance");
+
+    // ========================================
+    // Test 2: Extra UIO Maps
+    // ========================================
+    printf("Test 2: image_pros_uio_map\n");
+    image_pros_buf_t frames;
+    CHECK(image_pros_uio_map(&dev0, 1, &frames) == IMAGE_PROS_UIO_OK, "map1");
+    CHECK(frames.virt != NULL && frames.phys == FRAMES_PHYS &&
+          frames.size == FRAMES_SIZE, "map1 address and size");
+    if (frames.virt != NULL) {
+        memset(frames.virt, 0xAB, frames.size);
+    }
+    CHECK(XImage_pros_Get_width(&dev0.ip) == 640, "map1 does not alias the registers");
+    CHECK(image_pros_uio_map(&dev1, 1, &frames) == IMAGE_PROS_UIO_ERR_MAP,
+          "missing map");
+
+    // ========================================
+    // Test 3: u-dma-buf and Slices
+    // ========================================
+    printf("Test 3: image_pros_udmabuf_open and image_pros_buf_slice\n");
+    image_pros_buf_t cma;
+    CHECK(image_pros_udmabuf_open(&fake.backend, "udmabuf0", &cma) == IMAGE_PROS_UIO_OK,
+          "udmabuf0");
+    CHECK(cma.virt != NULL && cma.phys == CMA_PHYS && cma.size == CMA_SIZE,
+          "udmabuf0 address and size");
+    image_pros_buf_t missing_buf;
+    CHECK(image_pros_udmabuf_open(&fake.backend, "udmabuf1", &missing_buf) ==
+          IMAGE_PROS_UIO_ERR_NOT_FOUND, "missing udmabuf");
+
+    image_pros_buf_t frame = image_pros_buf_slice(&cma, FRAME_SIZE, FRAME_SIZE);
+    CHECK(frame.phys == CMA_PHYS + FRAME_SIZE &&
+          frame.virt == (uint8_t *)cma.virt + FRAME_SIZE &&
+          frame.size == FRAME_SIZE, "slice addresses");
+    if (frame.virt != NULL) {
+        ((uint8_t *)frame.virt)[0] = 7;
+        CHECK(((uint8_t *)cma.virt)[FRAME_SIZE] == 7, "slice shares the mapping");
+    }
+    image_pros_buf_t overrun = image_pros_buf_slice(&cma, cma.size - 1, 2);
+    CHECK(overrun.size == 0, "slice past the end");
+
+    // ========================================
+    // Test 4: Interrupts
+    // ========================================
+    printf("Test 4: image_pros_uio_wait_irq\n");
+    CHECK(image_pros_uio_wait_irq(&dev0, IRQ_TIMEOUT_MS) == IMAGE_PROS_UIO_ERR_TIMEOUT,
+          "timeout without an interrupt");
+    CHECK(image_pros_fake_irq(&fake, 1) == IMAGE_PROS_UIO_OK, "raise uio1");
+    CHECK(image_pros_uio_wait_irq(&dev1, IRQ_TIMEOUT_MS) == IMAGE_PROS_UIO_ERR_TIMEOUT,
+          "interrupt stays on its instance");
+    CHECK(image_pros_uio_wait_irq(&dev0, IRQ_TIMEOUT_MS) == IMAGE_PROS_UIO_OK,
+          "raised interrupt");
+    CHECK(image_pros_uio_wait_irq(&dev0, IRQ_TIMEOUT_MS) == IMAGE_PROS_UIO_ERR_TIMEOUT,
+          "interrupt consumed once");
+
+    image_pros_buf_close(&cma);
+    image_pros_uio_close(&dev0);
+    image_pros_uio_close(&dev1);
+    image_pros_fake_destroy(&fake);
+
+    if (errors == 0) {
+        printf("ALL TESTS PASSED!\n");
+        return 0;
+    }
+    printf("FAILED with %d errors\n", errors);
+    return 1;
+}
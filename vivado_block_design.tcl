@@ -48,7 +48,7 @@ create_bd_cell -type ip -vlnv xilinx.com:ip:microblaze:11.0 microblaze_0
 # Apply MicroBlaze block automation (creates local memory, debug, etc.)
 apply_bd_automation -rule xilinx.com:bd_rule:microblaze \
     -config { \
-        axi_intc {0} \
+        axi_intc {1} \
         axi_periph {Enabled} \
         cache {None} \
         clk {New Clocking Wizard} \
@@ -65,6 +65,27 @@ apply_bd_automation -rule xilinx.com:bd_rule:microblaze \
 puts "Adding Image Processing IP..."
 create_bd_cell -type ip -vlnv xilinx.com:hls:image_pros:1.0 image_pros_0
 
+# ============================================
+# Add AXI DMA for Frame Transport
+# ============================================
+# Scatter-gather DMA streams frames from memory into image_pros/src
+# (MM2S) and writes image_pros/dst back to memory (S2MM). Stream width
+# matches the 8-bit pixel stream; software queues one descriptor per
+# row so every row is one TLAST-terminated packet.
+puts "Adding AXI DMA..."
+create_bd_cell -type ip -vlnv xilinx.com:ip:axi_dma:7.1 axi_dma_0
+set_property -dict [list \
+    CONFIG.c_include_sg {1} \
+    CONFIG.c_sg_include_stscntrl_strm {0} \
+    CONFIG.c_sg_length_width {23} \
+    CONFIG.c_m_axi_mm2s_data_width {32} \
+    CONFIG.c_m_axis_mm2s_tdata_width {8} \
+    CONFIG.c_m_axi_s2mm_data_width {32} \
+    CONFIG.c_s_axis_s2mm_tdata_width {8} \
+    CONFIG.c_mm2s_burst_size {16} \
+    CONFIG.c_s2mm_burst_size {16} \
+] [get_bd_cells axi_dma_0]
+
 # ============================================
 # Add AXI GPIO for Control
 # ============================================
@@ -132,6 +153,37 @@ apply_bd_automation -rule xilinx.com:bd_rule:axi4 \
               ddr_seg {Auto} intc_ip {/microblaze_0_axi_periph} master_apm {0}} \
     [get_bd_intf_pins axi_uartlite_0/S_AXI]
 
+# Connect DMA control interface
+apply_bd_automation -rule xilinx.com:bd_rule:axi4 \
+    -config { Clk_master {/clk_wiz_1/clk_out1} Clk_slave {Auto} Clk_xbar {Auto} \
+              Master {/microblaze_0 (Periph)} Slave {/axi_dma_0/S_AXI_LITE} \
+              ddr_seg {Auto} intc_ip {/microblaze_0_axi_periph} master_apm {0}} \
+    [get_bd_intf_pins axi_dma_0/S_AXI_LITE]
+
+# Connect DMA data movers and descriptor fetch to the image BRAM
+foreach dma_master {M_AXI_SG M_AXI_MM2S M_AXI_S2MM} {
+    apply_bd_automation -rule xilinx.com:bd_rule:axi4 \
+        -config [list Clk_master {/clk_wiz_1/clk_out1} Clk_slave {Auto} Clk_xbar {Auto} \
+                      Master /axi_dma_0/$dma_master Slave {/axi_bram_ctrl_0/S_AXI} \
+                      ddr_seg {Auto} intc_ip {New AXI SmartConnect} master_apm {0}] \
+        [get_bd_intf_pins axi_dma_0/$dma_master]
+}
+
+# Connect pixel streams: DMA -> image_pros -> DMA
+connect_bd_intf_net [get_bd_intf_pins axi_dma_0/M_AXIS_MM2S] \
+                    [get_bd_intf_pins image_pros_0/src]
+connect_bd_intf_net [get_bd_intf_pins image_pros_0/dst] \
+                    [get_bd_intf_pins axi_dma_0/S_AXIS_S2MM]
+
+# Route image_pros ap_done and DMA completion to microblaze_0_axi_intc
+set_property CONFIG.NUM_PORTS {3} [get_bd_cells microblaze_0_xlconcat]
+connect_bd_net [get_bd_pins image_pros_0/interrupt] \
+               [get_bd_pins microblaze_0_xlconcat/In0]
+connect_bd_net [get_bd_pins axi_dma_0/mm2s_introut] \
+               [get_bd_pins microblaze_0_xlconcat/In1]
+connect_bd_net [get_bd_pins axi_dma_0/s2mm_introut] \
+               [get_bd_pins microblaze_0_xlconcat/In2]
+
 # Connect BRAM to BRAM Controller
 connect_bd_intf_net [get_bd_intf_pins axi_bram_ctrl_0/BRAM_PORTA] \
                     [get_bd_intf_pins blk_mem_gen_0/BRAM_PORTA]